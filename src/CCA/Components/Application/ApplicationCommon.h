@@ -377,6 +377,12 @@ WARNING
     virtual void reduceApplicationStats( bool allReduce,
                                          const ProcessorGroup* myWorld )
     { m_application_stats.reduce( allReduce, myWorld ); };      
+
+    virtual void setApplicationStatsEnabled( bool val )
+    { m_application_stats_enabled = val; };
+
+    virtual bool getApplicationStatsEnabled() const
+    { return m_application_stats_enabled; };
  
   public:
     virtual void   setDelTOverrideRestart( double val ) { m_delTOverrideRestart = val; }
@@ -538,6 +544,8 @@ WARNING
 
     ReductionInfoMapper< ApplicationStatsEnum,
                          double > m_application_stats;
+
+    bool m_application_stats_enabled{false};
     
   private:
     ApplicationCommon(const ApplicationCommon&);
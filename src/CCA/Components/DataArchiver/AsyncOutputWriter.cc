@@ -0,0 +1,333 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <CCA/Components/DataArchiver/AsyncOutputWriter.h>
+
+#include <Core/Exceptions/ErrnoException.h>
+#include <Core/Exceptions/InternalError.h>
+#include <Core/Grid/Variables/Variable.h>
+#include <Core/Parallel/Parallel.h>
+#include <Core/Util/DOUT.hpp>
+#include <Core/Util/Timers/Timers.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+#define PADSIZE 1024L
+
+using namespace Uintah;
+
+namespace {
+
+  Dout g_async_output_dbg( "DataArchiverAsync", "DataArchiver", "reports the asynchronous output writes", false );
+
+  //______________________________________________________________________
+  //
+  void
+  writeFully( int fd, const char * buffer, size_t size, const std::string & filename )
+  {
+    while( size > 0 ) {
+      ssize_t s = ::write( fd, buffer, size );
+
+      if( s == -1 ) {
+        if( errno == EINTR ) {
+          continue;
+        }
+        std::ostringstream msg;
+        msg << "AsyncOutputWriter: write to '" << filename << "' failed";
+        SCI_THROW( ErrnoException( msg.str(), errno, __FILE__, __LINE__ ) );
+      }
+      buffer += s;
+      size   -= s;
+    }
+  }
+
+}
+
+//______________________________________________________________________
+//
+AsyncOutputWriter::AsyncOutputWriter( int          numThreads
+                                    , size_t       budget
+                                    , MasterLock & domLock
+                                    )
+  : m_dom_lock( domLock )
+  , m_queues( std::max( numThreads, 1 ) )
+  , m_budget( budget )
+{
+  for( size_t i = 0; i < m_queues.size(); ++i ) {
+    m_threads.push_back( std::thread( &AsyncOutputWriter::run, this, i ) );
+  }
+}
+
+//______________________________________________________________________
+//
+AsyncOutputWriter::~AsyncOutputWriter()
+{
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_done_cv.wait( lock, [this]{ return m_jobs_in_flight == 0; } );
+    m_shutdown = true;
+  }
+  m_work_cv.notify_all();
+
+  for( auto & thread : m_threads ) {
+    thread.join();
+  }
+
+  if( m_failed ) {
+    std::cerr << "AsyncOutputWriter: unreported output error: " << m_error << "\n";
+  }
+}
+
+//______________________________________________________________________
+//
+void
+AsyncOutputWriter::submit( std::unique_ptr<Job> job )
+{
+  job->m_bytes = 0;
+  for( auto & item : job->m_items ) {
+    job->m_bytes += item.m_data.size();
+  }
+
+  const size_t queue = std::hash<std::string>()( job->m_dataFilename ) % m_queues.size();
+
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    // Back-pressure - wait for the I/O threads to catch up.
+    m_done_cv.wait( lock, [this, &job]{
+        return m_jobs_in_flight == 0 || m_bytes_in_flight + job->m_bytes <= m_budget; } );
+
+    m_bytes_in_flight += job->m_bytes;
+    ++m_jobs_in_flight;
+    m_queues[queue].m_jobs.push_back( std::move( job ) );
+  }
+  m_work_cv.notify_all();
+}
+
+//______________________________________________________________________
+//
+void
+AsyncOutputWriter::drain()
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  m_done_cv.wait( lock, [this]{ return m_jobs_in_flight == 0; } );
+
+  if( m_failed ) {
+    std::string error = m_error;
+    m_failed = false;
+    m_error.clear();
+    SCI_THROW( InternalError( "Asynchronous output failed: " + error, __FILE__, __LINE__ ) );
+  }
+}
+
+//______________________________________________________________________
+//
+size_t
+AsyncOutputWriter::bytesInFlight()
+{
+  std::lock_guard<std::mutex> lock( m_mutex );
+  return m_bytes_in_flight;
+}
+
+//______________________________________________________________________
+//
+std::map<std::string, CompressionStats>
+AsyncOutputWriter::takeCompressionStats()
+{
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  std::map<std::string, CompressionStats> stats;
+  stats.swap( m_compression_stats );
+  return stats;
+}
+
+//______________________________________________________________________
+//
+void
+AsyncOutputWriter::run( int tid )
+{
+  WorkerQueue & queue = m_queues[tid];
+
+  while( true ) {
+    std::unique_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      m_work_cv.wait( lock, [this, &queue]{ return m_shutdown || !queue.m_jobs.empty(); } );
+
+      if( queue.m_jobs.empty() ) {
+        return;  // shutdown
+      }
+      job = std::move( queue.m_jobs.front() );
+      queue.m_jobs.pop_front();
+    }
+
+    std::string error;
+    try {
+      write( *job );
+    }
+    catch( const Exception & e ) {
+      error = e.message();
+    }
+    catch( const std::exception & e ) {
+      error = e.what();
+    }
+
+    // Release the DOM under the same lock it was built with.
+    const size_t bytes = job->m_bytes;
+    {
+      std::lock_guard<Uintah::MasterLock> dom_guard( m_dom_lock );
+      job.reset();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_bytes_in_flight -= bytes;
+      --m_jobs_in_flight;
+      if( !error.empty() && !m_failed ) {
+        m_failed = true;
+        m_error  = error;
+      }
+    }
+    m_done_cv.notify_all();
+  }
+}
+
+//______________________________________________________________________
+//
+void
+AsyncOutputWriter::write( Job & job )
+{
+  Timers::Simple timer;
+  timer.start();
+
+  const char * filename = job.m_dataFilename.c_str();
+  const int    flags    = O_WRONLY|O_CREAT|O_TRUNC;
+
+  // Same retry policy as the synchronous output.
+  int tries = 1;
+  int fd    = open( filename, flags, 0666 );
+
+  while( fd == -1 ) {
+    if( tries >= 50 ) {
+      std::ostringstream msg;
+      msg << "AsyncOutputWriter: Failed to open file '" << job.m_dataFilename << "' (after 50 tries).";
+      SCI_THROW( ErrnoException( msg.str(), errno, __FILE__, __LINE__ ) );
+    }
+    fd = open( filename, flags, 0666 );
+    tries++;
+  }
+
+  struct Extent {
+    long        m_start;
+    long        m_end;
+    std::string m_compressionMode;
+  };
+
+  std::vector<Extent> extents;
+  extents.reserve( job.m_items.size() );
+
+  std::map<std::string, CompressionStats> stats;
+
+  const std::string zeros( PADSIZE, '\0' );
+  long cur = 0;
+
+  try {
+    for( auto & item : job.m_items ) {
+      std::string buffer;
+      std::string compressionMode;
+
+      Timers::Simple compress_timer;
+      compress_timer.start();
+      const size_t size = item.m_data.size();
+      std::string * out = Variable::compress( &item.m_data, &buffer, item.m_compressionMode, compressionMode );
+
+      if( item.m_compressionMode != "" && item.m_compressionMode != "none" ) {
+        stats[item.m_varName].add( item.m_compressionMode, size, out->size(), compress_timer().seconds() );
+      }
+
+      // Pad appropriately
+      if( cur % PADSIZE != 0 ) {
+        long pad = PADSIZE - cur % PADSIZE;
+        writeFully( fd, zeros.data(), pad, job.m_dataFilename );
+        cur += pad;
+      }
+
+      const long start = cur;
+      writeFully( fd, out->data(), out->size(), job.m_dataFilename );
+      cur += out->size();
+
+      extents.push_back( { start, cur, compressionMode } );
+
+      // The staged copy is no longer needed.
+      std::string().swap( item.m_data );
+    }
+  }
+  catch( ... ) {
+    close( fd );
+    throw;
+  }
+
+  if( close( fd ) == -1 ) {
+    std::ostringstream msg;
+    msg << "AsyncOutputWriter: Error closing file '" << job.m_dataFilename << "'";
+    SCI_THROW( ErrnoException( msg.str(), errno, __FILE__, __LINE__ ) );
+  }
+
+  {
+    std::lock_guard<Uintah::MasterLock> dom_guard( m_dom_lock );
+
+    for( size_t i = 0; i < job.m_items.size(); ++i ) {
+      ProblemSpecP varnode = job.m_items[i].m_varnode;
+
+      varnode->appendElement( "start",    extents[i].m_start );
+      varnode->appendElement( "end",      extents[i].m_end );
+      varnode->appendElement( "filename", job.m_dataFilebase.c_str() );
+
+      if( extents[i].m_compressionMode != "" ) {
+        varnode->appendElement( "compression", extents[i].m_compressionMode );
+      }
+    }
+
+    job.m_doc->output( job.m_xmlFilename.c_str() );
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    for( auto & stat : stats ) {
+      m_compression_stats[stat.first].add( stat.second.m_mode, stat.second.m_uncompressedBytes,
+                                           stat.second.m_compressedBytes, stat.second.m_seconds );
+    }
+  }
+
+  DOUT( g_async_output_dbg, "Rank-" << Parallel::getMPIRank() << " wrote " << job.m_dataFilename
+                            << " (" << cur << " bytes, " << job.m_items.size() << " variables) in "
+                            << timer().seconds() << " seconds" );
+}
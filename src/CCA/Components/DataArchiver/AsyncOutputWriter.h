@@ -0,0 +1,157 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CCA_COMPONENTS_DATAARCHIVER_ASYNCOUTPUTWRITER_H
+#define CCA_COMPONENTS_DATAARCHIVER_ASYNCOUTPUTWRITER_H
+
+#include <Core/IO/CompressionCodec.h>
+#include <Core/Parallel/MasterLock.h>
+#include <Core/ProblemSpec/ProblemSpec.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    AsyncOutputWriter
+
+  GENERAL INFORMATION
+    AsyncOutputWriter.h
+
+  DESCRIPTION
+    Background writer for the DataArchiver's asynchronous output mode.
+
+    The output tasks serialize every saved variable into a staging
+    buffer (see the staging OutputContext) and submit one Job per
+    data file.  The I/O threads then compress, pad and write the
+    buffers, fill in the start/end/compression entries of the
+    variables' xml nodes and write the pNNNNN.xml file.
+
+    Jobs for the same data file always go to the same I/O thread so
+    that a rewritten file (e.g. after a time step restart) is written
+    in submission order.
+
+    The staged bytes are bounded by a memory budget. submit() blocks
+    while the budget is exhausted, which throttles the simulation to
+    the speed of the file system instead of growing without bound.
+
+  WARNING
+    The xml nodes are only touched while holding the lock handed to
+    the constructor (the DataArchiver's output lock) as the DOM is not
+    thread safe.
+
+****************************************/
+
+class AsyncOutputWriter {
+
+public:
+
+  struct Item {
+    ProblemSpecP m_varnode;          // <Variable> node of the pNNNNN.xml doc
+    std::string  m_data;             // serialized, uncompressed variable
+    std::string  m_compressionMode;  // requested compression mode
+    std::string  m_varName;          // for the compression statistics
+  };
+
+  struct Job {
+    std::string       m_dataFilename;  // full path to the .data file
+    std::string       m_dataFilebase;  // name recorded in the xml
+    std::string       m_xmlFilename;   // full path to the .xml file
+    ProblemSpecP      m_doc;
+    std::vector<Item> m_items;
+    size_t            m_bytes{0};      // staged bytes, set by submit()
+  };
+
+  // 'budget' is the maximum number of staged bytes in flight.
+  AsyncOutputWriter( int numThreads, size_t budget, MasterLock & domLock );
+
+  // Waits for the pending jobs and stops the I/O threads. Errors are
+  // reported but not thrown.
+  ~AsyncOutputWriter();
+
+  // Queues the job. Blocks while the staged bytes would exceed the
+  // budget (a job larger than the budget waits for an empty queue).
+  void submit( std::unique_ptr<Job> job );
+
+  // Waits until every submitted job has been written. Throws the
+  // first error an I/O thread ran into since the last drain().
+  void drain();
+
+  size_t bytesInFlight();
+
+  // Returns and clears the compression statistics of the jobs written
+  // so far, keyed by variable name.
+  std::map<std::string, CompressionStats> takeCompressionStats();
+
+  int numThreads() const { return static_cast<int>( m_threads.size() ); }
+
+private:
+
+  struct WorkerQueue {
+    std::deque<std::unique_ptr<Job>> m_jobs;
+  };
+
+  void run( int tid );
+
+  void write( Job & job );
+
+  MasterLock & m_dom_lock;
+
+  std::mutex              m_mutex;
+  std::condition_variable m_work_cv;   // signals the I/O threads
+  std::condition_variable m_done_cv;   // signals submit() and drain()
+
+  std::vector<WorkerQueue> m_queues;
+  std::vector<std::thread> m_threads;
+
+  size_t m_budget;
+  size_t m_bytes_in_flight{0};
+  int    m_jobs_in_flight{0};
+  bool   m_shutdown{false};
+
+  std::map<std::string, CompressionStats> m_compression_stats;
+
+  // First error seen by an I/O thread.
+  bool        m_failed{false};
+  std::string m_error;
+
+  // eliminate copy, assignment and move
+  AsyncOutputWriter( const AsyncOutputWriter & )            = delete;
+  AsyncOutputWriter& operator=( const AsyncOutputWriter & ) = delete;
+  AsyncOutputWriter( AsyncOutputWriter && )                 = delete;
+  AsyncOutputWriter& operator=( AsyncOutputWriter && )      = delete;
+};
+
+} // End namespace Uintah
+
+#endif // CCA_COMPONENTS_DATAARCHIVER_ASYNCOUTPUTWRITER_H
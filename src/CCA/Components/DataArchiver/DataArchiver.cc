@@ -40,7 +40,9 @@
 #include <Core/Grid/Grid.h>
 #include <Core/Grid/Patch.h>
 #include <Core/Grid/Task.h>
+#include <Core/Grid/Variables/Variable.h>
 #include <Core/Grid/Variables/VarTypes.h>
+#include <Core/IO/CompressionCodec.h>
 #include <Core/Parallel/Parallel.h>
 #include <Core/Parallel/ProcessorGroup.h>
 #include <Core/ProblemSpec/ProblemSpec.h>
@@ -91,6 +93,8 @@ using namespace std;
 
 namespace {
   DebugStream dbg("DataArchiver", "DataArchiver", "Data archiver debug stream", false);
+
+  Dout g_compression_dbg( "DataArchiverCompression", "DataArchiver", "reports the compression ratio and speed per saved variable", false );
 #ifdef HAVE_PIDX
   DebugStream dbgPIDX ("DataArchiverPIDX", "DataArchiver", "Data archiver PIDX debug stream", false);
 #endif
@@ -134,6 +138,9 @@ DataArchiver::DataArchiver(const ProcessorGroup* myworld, int udaSuffix)
 
 DataArchiver::~DataArchiver()
 {
+  // Finish any outstanding writes while the output lock still exists.
+  m_asyncWriter.reset();
+
   VarLabel::destroy( m_sync_io_label );
 
   if(m_tmpMatSubset && m_tmpMatSubset->removeReference()) {
@@ -164,6 +171,10 @@ DataArchiver::getComponents()
 void
 DataArchiver::releaseComponents()
 {
+  // End of the run - make sure the last asynchronous output is on
+  // disk and referenced in index.xml.
+  commitAsyncOutput();
+
   releasePort( "application" );
   releasePort( "load balancer" );
 
@@ -235,6 +246,66 @@ DataArchiver::problemSetup( const ProblemSpecP    & params,
 
   m_outputDoubleAsFloat = p->findBlock("outputDoubleAsFloat") != nullptr;
 
+  // Asynchronous output - problemSetup is called again on a component
+  // switch, keep the writer (and whatever it still has to write).
+  ProblemSpecP async_ps = p->findBlock("outputAsync");
+  if( async_ps != nullptr && m_asyncWriter == nullptr ) {
+    int    threads      = 1;
+    double bufferSizeMB = 1024;
+
+    async_ps->getAttribute( "threads",      threads );
+    async_ps->getAttribute( "bufferSizeMB", bufferSizeMB );
+
+    if( threads < 1 || bufferSizeMB <= 0 ) {
+      throw ProblemSetupException( "<outputAsync> threads and bufferSizeMB must be positive", __FILE__, __LINE__ );
+    }
+
+    if( m_outputFileFormat == PIDX ) {
+      proc0cout << "WARNING: <outputAsync> does not apply to PIDX files, they are still written synchronously.\n";
+    }
+
+    m_asyncWriter.reset( scinew AsyncOutputWriter( threads, (size_t) (bufferSizeMB * 1024 * 1024), m_outputLock ) );
+
+    proc0cout << "Asynchronous output:" << std::setw(10) << " "
+              << threads << " I/O thread(s), " << bufferSizeMB << " MB staging buffer per rank.\n";
+  }
+
+  // Aggregated (N-to-M) output - created once, like the async writer.
+  ProblemSpecP aggregation_ps = p->findBlock("outputAggregation");
+  if( aggregation_ps != nullptr && m_outputAggregator == nullptr ) {
+    int aggregatorsPerNode = 0;
+    int ranksPerGroup      = 0;
+
+    aggregation_ps->getAttribute( "aggregatorsPerNode", aggregatorsPerNode );
+    aggregation_ps->getAttribute( "ranksPerGroup",      ranksPerGroup );
+
+    if( aggregatorsPerNode == 0 && ranksPerGroup == 0 ) {
+      aggregatorsPerNode = 1;
+    }
+
+    if( aggregatorsPerNode < 0 || ranksPerGroup < 0 || (aggregatorsPerNode > 0 && ranksPerGroup > 0) ) {
+      throw ProblemSetupException( "<outputAggregation> needs either a positive aggregatorsPerNode or ranksPerGroup", __FILE__, __LINE__ );
+    }
+
+    if( m_asyncWriter ) {
+      throw ProblemSetupException( "<outputAggregation> can not be combined with <outputAsync>", __FILE__, __LINE__ );
+    }
+
+    if( m_outputFileFormat == PIDX ) {
+      proc0cout << "WARNING: <outputAggregation> does not apply to PIDX files.\n";
+    }
+    else {
+      m_outputAggregator.reset( scinew OutputAggregator( d_myworld, aggregatorsPerNode, ranksPerGroup, m_outputLock ) );
+
+      if( ranksPerGroup > 0 ) {
+        proc0cout << "Aggregated output:" << std::setw(12) << " " << "one file per " << ranksPerGroup << " rank(s) and level.\n";
+      }
+      else {
+        proc0cout << "Aggregated output:" << std::setw(12) << " " << aggregatorsPerNode << " file(s) per node and level.\n";
+      }
+    }
+  }
+
   // For outputing the sim time and/or time step with the global vars
   p->get("timeStep", m_outputGlobalVarsTimeStep); // default false
   p->get("simTime",  m_outputGlobalVarsSimTime);  // default true
@@ -294,12 +365,25 @@ DataArchiver::problemSetup( const ProblemSpecP    & params,
     m_outputLastTimeStep = false; // default
   }
 
-  // set default compression mode - can be "gzip" or ""
+  // set default compression mode - can be "", "gzip" or one of the
+  // CompressionCodecRegistry modes, e.g. "shuffle+lz"
   string defaultCompressionMode = "";
   if (p->get("compression", defaultCompressionMode)) {
+    if( !Variable::isValidCompressionMode( defaultCompressionMode ) ) {
+      throw ProblemSetupException( "Unknown <compression> mode '" + defaultCompressionMode + "'", __FILE__, __LINE__ );
+    }
     VarLabel::setDefaultCompressionMode(defaultCompressionMode);
   }
 
+  // Threads used to compress each variable (the non-gzip modes only)
+  int compressionThreads = 1;
+  if( p->get( "compressionThreads", compressionThreads ) ) {
+    if( compressionThreads < 1 ) {
+      throw ProblemSetupException( "<compressionThreads> must be positive", __FILE__, __LINE__ );
+    }
+    CompressionCodecRegistry::setNumThreads( compressionThreads );
+  }
+
   if (params->findBlock("ParticlePosition")) {
     params->findBlock("ParticlePosition")->getAttribute("label",m_particlePositionName);
   }
@@ -326,6 +410,11 @@ DataArchiver::problemSetup( const ProblemSpecP    & params,
     save->getAttributes(attributes);
     saveItem.labelName       = attributes["label"];
     saveItem.compressionMode = attributes["compression"];
+
+    if( !Variable::isValidCompressionMode( saveItem.compressionMode ) ) {
+      throw ProblemSetupException( "Unknown compression mode '" + saveItem.compressionMode + "' for saving '" +
+                                   saveItem.labelName + "'", __FILE__, __LINE__ );
+    }
     
     try {
       saveItem.matls = ConsecutiveRangeSet(attributes["material"]);
@@ -1237,6 +1326,11 @@ DataArchiver::sched_allOutputTasks( const GridP      & grid,
 void
 DataArchiver::setOutputTimeStep( bool val, const GridP& grid )
 {
+  // Finish the previous asynchronous output before starting another.
+  if( val ) {
+    commitAsyncOutput();
+  }
+
   if( m_isOutputTimeStep != val )
   {
     m_isOutputTimeStep = val;
@@ -1255,6 +1349,12 @@ DataArchiver::setOutputTimeStep( bool val, const GridP& grid )
 void
 DataArchiver::setCheckpointTimeStep( bool val, const GridP& grid )
 {
+  // Finish the previous asynchronous output before starting another,
+  // in particular before an expired checkpoint is removed below.
+  if( val ) {
+    commitAsyncOutput();
+  }
+
   if( m_isCheckpointTimeStep != val )
   {
     m_isCheckpointTimeStep = val;
@@ -1697,6 +1797,17 @@ DataArchiver::writeto_xml_files( const GridP& grid )
     }
     return;
   }
+
+  // Aggregated output - the output tasks only staged the variables,
+  // every rank sends them to its aggregator now.
+  if( m_outputAggregator ) {
+    Timers::Simple aggregation_timer;
+    aggregation_timer.start();
+
+    m_outputAggregator->flush();
+
+    (*m_runtimeStats)[TotalIOTime] += aggregation_timer().seconds();
+  }
   
   double simTime = m_application->getSimTime();
   double delT    = m_application->getDelT();
@@ -1853,35 +1964,16 @@ DataArchiver::writeto_xml_files( const GridP& grid )
         ts = indexDoc->appendChild( "timesteps" );
         firstCheckpointTimeStep = (&m_checkpointsDir == baseDirs[i]);
       }
-      bool found = false;
-      for(ProblemSpecP n = ts->getFirstChild(); n != nullptr; n=n->getNextSibling()) {
-        if( n->getNodeName() == "timestep" ) {
-          int readtimestep;
-          
-          if( !n->get( readtimestep ) ){
-            throw InternalError("Error parsing timestep number", __FILE__, __LINE__);
-          }
-          if( readtimestep == dir_timestep ) {
-            found = true;
-            break;
-          }
-        }
-      }
 
       //__________________________________
-      // add timestep info - called after the sim time has been updated.
-      if( !found ) {
-        
-        string timestepindex = tname.str() + "/timestep.xml";
-        
-        ostringstream value, timeVal, deltVal;
-        value << dir_timestep;
-        ProblemSpecP newElem = ts->appendElement( "timestep",value.str().c_str() );
-        newElem->setAttribute( "href",     timestepindex.c_str() );
-        timeVal << std::setprecision(17) << simTime;
-        newElem->setAttribute( "time",     timeVal.str() );
-        deltVal << std::setprecision(17) << delT;
-        newElem->setAttribute( "oldDelt",  deltVal.str() );
+      // add timestep info - called after the sim time has been
+      // updated.  With asynchronous output the data is not on disk
+      // yet, so the time step is only referenced once it is.
+      if( m_asyncWriter ) {
+        m_pendingTimeSteps.push_back( { baseDirs[i], dir_timestep, simTime, delT } );
+      }
+      else {
+        indexAddTimeStep( indexDoc, dir_timestep, simTime, delT );
       }
 
       indexDoc->output( iname.c_str() );
@@ -2012,6 +2104,12 @@ DataArchiver::writeto_xml_files( const GridP& grid )
     } // end if m_writeMeta
   }  // loop over baseDirs
 
+  if( m_asyncWriter ) {
+    m_asyncOutputPending = true;
+  }
+
+  reportCompressionStats();
+
   double myTime = timer().seconds();
   (*m_runtimeStats)[XMLIOTime] += myTime;
   (*m_runtimeStats)[TotalIOTime ] += myTime;
@@ -2021,6 +2119,129 @@ DataArchiver::writeto_xml_files( const GridP& grid )
   }
 } // end writeto_xml_files()
 
+//______________________________________________________________________
+//  Reports and resets the compression statistics of this rank.  With
+//  asynchronous output the variables still being written are reported
+//  on a later output.
+
+void
+DataArchiver::reportCompressionStats()
+{
+  if( !g_compression_dbg ) {
+    return;
+  }
+
+  std::map<std::string, CompressionStats> stats;
+  {
+    std::lock_guard<Uintah::MasterLock> output_guard( m_outputLock );
+    stats.swap( m_compressionStats );
+  }
+
+  std::map<std::string, CompressionStats> staged;
+  if( m_asyncWriter ) {
+    staged = m_asyncWriter->takeCompressionStats();
+  }
+  else if( m_outputAggregator ) {
+    staged = m_outputAggregator->takeCompressionStats();
+  }
+
+  for( auto & stat : staged ) {
+    stats[stat.first].add( stat.second.m_mode, stat.second.m_uncompressedBytes,
+                           stat.second.m_compressedBytes, stat.second.m_seconds );
+  }
+
+  for( auto & stat : stats ) {
+    const CompressionStats & s = stat.second;
+    const double MB = s.m_uncompressedBytes / (1024.0 * 1024.0);
+
+    DOUT( true, "Rank-" << d_myworld->myRank() << " compressed " << std::left << std::setw(24) << stat.first
+                << " " << std::setw(12) << s.m_mode << std::right
+                << " " << std::setw(10) << std::fixed << std::setprecision(2) << MB << " MB"
+                << "  ratio " << std::setw(6) << (s.m_compressedBytes ? (double) s.m_uncompressedBytes / s.m_compressedBytes : 0.0)
+                << "  " << std::setw(10) << (s.m_seconds > 0 ? MB / s.m_seconds : 0.0) << " MB/s" );
+  }
+}
+
+//______________________________________________________________________
+//  Reference a time step in index.xml (unless it already is).
+
+void
+DataArchiver::indexAddTimeStep( ProblemSpecP indexDoc,
+                                const int    dir_timestep,
+                                const double simTime,
+                                const double delT )
+{
+  ProblemSpecP ts = indexDoc->findBlock( "timesteps" );
+  if( ts == nullptr ) {
+    ts = indexDoc->appendChild( "timesteps" );
+  }
+
+  for(ProblemSpecP n = ts->getFirstChild(); n != nullptr; n=n->getNextSibling()) {
+    if( n->getNodeName() == "timestep" ) {
+      int readtimestep;
+          
+      if( !n->get( readtimestep ) ){
+        throw InternalError("Error parsing timestep number", __FILE__, __LINE__);
+      }
+      if( readtimestep == dir_timestep ) {
+        return;
+      }
+    }
+  }
+
+  ostringstream tname;
+  tname << "t" << setw(5) << setfill('0') << dir_timestep;
+
+  string timestepindex = tname.str() + "/timestep.xml";
+        
+  ostringstream value, timeVal, deltVal;
+  value << dir_timestep;
+  ProblemSpecP newElem = ts->appendElement( "timestep",value.str().c_str() );
+  newElem->setAttribute( "href",     timestepindex.c_str() );
+  timeVal << std::setprecision(17) << simTime;
+  newElem->setAttribute( "time",     timeVal.str() );
+  deltVal << std::setprecision(17) << delT;
+  newElem->setAttribute( "oldDelt",  deltVal.str() );
+}
+
+//______________________________________________________________________
+//  Asynchronous output: wait until every rank has written its data
+//  files and then reference the pending time steps in index.xml.
+//  Must be called by all ranks.
+
+void
+DataArchiver::commitAsyncOutput()
+{
+  if( m_asyncWriter == nullptr || !m_asyncOutputPending ) {
+    return;
+  }
+
+  Timers::Simple timer;
+  timer.start();
+
+  m_asyncWriter->drain();
+
+  Uintah::MPI::Barrier( d_myworld->getComm() );
+
+  for( auto & pending : m_pendingTimeSteps ) {
+    string       iname    = pending.m_baseDir->getName() + "/index.xml";
+    ProblemSpecP indexDoc = loadDocument( iname );
+
+    if( indexDoc == nullptr ) {
+      continue;
+    }
+
+    indexAddTimeStep( indexDoc, pending.m_timeStep, pending.m_simTime, pending.m_delT );
+    indexDoc->output( iname.c_str() );
+  }
+
+  m_pendingTimeSteps.clear();
+  m_asyncOutputPending = false;
+
+  DOUT( dbg.active() && d_myworld->myRank() == 0,
+        "  commitAsyncOutput() waited " << timer().seconds() << " seconds" );
+}
+
 //______________________________________________________________________
 //  Update the xml file index.xml with any in situ modified variables.
 
@@ -2314,26 +2535,23 @@ DataArchiver::writeGridOriginal( const bool hasGlobals, const GridP & grid, Prob
   ProblemSpecP dataElem = rootElem->appendChild( "Data" );
 
   for( int l = 0;l < numLevels; l++ ) {
-    ostringstream lname;
-    lname << "l" << l;
 
     // Create a pxxxxx.xml file for each proc doing the outputting.
+    vector<DataFile> dataFiles;
+    getDataFiles( l, procOnLevel[l], dataFiles );
 
-    for( int i = 0; i < d_myworld->nRanks(); i++ ) {
-      if( ( i % m_loadBalancer->getNthRank() ) != 0 || !procOnLevel[l][i] ){
-        continue;
-      }
-
-      ostringstream pname;
-      pname << lname.str() << "/p" << setw(5) << setfill('0') << i << ".xml";
-
+    for( auto & dataFile : dataFiles ) {
       ostringstream procID;
-      procID << i;
+      procID << dataFile.m_proc;
 
       ProblemSpecP df = dataElem->appendChild("Datafile");
 
-      df->setAttribute( "href", pname.str() );
+      df->setAttribute( "href", dataFile.m_href );
       df->setAttribute( "proc", procID.str() );
+
+      if( dataFile.m_ranks != "" ) {
+        df->setAttribute( "ranks", dataFile.m_ranks );
+      }
     }
   }
 
@@ -2344,6 +2562,42 @@ DataArchiver::writeGridOriginal( const bool hasGlobals, const GridP & grid, Prob
 
 } // end writeGridOriginal()
 
+//______________________________________________________________________
+//  The data files of a level as listed in the <Data> section: a
+//  pxxxxx.xml file per rank doing the outputting or, with aggregated
+//  output, an axxxxx.xml file per aggregator along with the ranks
+//  whose data it holds.
+
+void
+DataArchiver::getDataFiles( int level, const vector<bool> & procOnLevel, vector<DataFile> & dataFiles ) const
+{
+  ostringstream lname;
+  lname << "l" << level;
+
+  map<int, list<int> > aggregated;
+
+  for( int i = 0; i < d_myworld->nRanks(); i++ ) {
+    if( ( i % m_loadBalancer->getNthRank() ) != 0 || !procOnLevel[i] ) {
+      continue;
+    }
+
+    if( m_outputAggregator ) {
+      aggregated[ m_outputAggregator->aggregatorOf( i ) ].push_back( i );
+      continue;
+    }
+
+    ostringstream pname;
+    pname << lname.str() << "/p" << setw(5) << setfill('0') << i << ".xml";
+
+    dataFiles.push_back( { pname.str(), i, "" } );
+  }
+
+  for( auto & group : aggregated ) {
+    ConsecutiveRangeSet ranks( group.second );
+    dataFiles.push_back( { lname.str() + "/" + OutputAggregator::filebase( group.first ) + ".xml", group.first, ranks.toString() } );
+  }
+}
+
 
 void
 DataArchiver::writeGridTextWriter( const bool hasGlobals, const string & grid_path, const GridP & grid )
@@ -2495,25 +2749,24 @@ DataArchiver::writeDataTextWriter( const bool hasGlobals, const string & data_pa
   xmlTextWriterStartElement( data_writer, BAD_CAST "Data" );
 
   for( int l = 0; l < numLevels; l++ ) {
-    ostringstream lname;
-    lname << "l" << l;
 
     // create a pxxxxx.xml file for each proc doing the outputting
-    for( int i = 0; i < d_myworld->nRanks(); i++ ) {
-      if ( i % m_loadBalancer->getNthRank() != 0 || !procOnLevel[l][i] ) {
-        continue;
-      }
-      ostringstream pname;
-      ostringstream procID;
+    vector<DataFile> dataFiles;
+    getDataFiles( l, procOnLevel[l], dataFiles );
 
-      pname << lname.str() << "/p" << setw(5) << setfill('0') << i << ".xml";
-      procID << i;
+    for( auto & dataFile : dataFiles ) {
+      ostringstream procID;
+      procID << dataFile.m_proc;
 
       xmlTextWriterStartElement( data_writer, BAD_CAST "Datafile" ); // Open <Datafile>
 
-      xmlTextWriterWriteAttribute( data_writer, BAD_CAST "href", BAD_CAST pname.str().c_str() );
+      xmlTextWriterWriteAttribute( data_writer, BAD_CAST "href", BAD_CAST dataFile.m_href.c_str() );
       xmlTextWriterWriteAttribute( data_writer, BAD_CAST "proc", BAD_CAST procID.str().c_str() );
 
+      if( dataFile.m_ranks != "" ) {
+        xmlTextWriterWriteAttribute( data_writer, BAD_CAST "ranks", BAD_CAST dataFile.m_ranks.c_str() );
+      }
+
       xmlTextWriterEndElement( data_writer ); // Close <Datafile>
     }
   }
@@ -2982,6 +3235,13 @@ DataArchiver::outputVariables( const ProcessorGroup * pg,
   // file, but also lock because xerces (DOM..) has thread-safety issues.
 
   if( m_outputFileFormat == UDA || type == CHECKPOINT_GLOBAL ) {
+
+    // Asynchronous or aggregated output - only serialize the
+    // variables here, the output thread(s) or the aggregator write
+    // them.  Checkpoint globals are always written directly.
+    std::unique_ptr<AsyncOutputWriter::Job> job;
+    const bool aggregate = m_outputAggregator && type != CHECKPOINT_GLOBAL;
+
     m_outputLock.lock(); 
     {  
       // Make sure doc's constructor is called after the lock.
@@ -3015,30 +3275,41 @@ DataArchiver::outputVariables( const ProcessorGroup * pg,
       // 71.)  Therefore I am using a while loop and counting the
       // 'tries'.
       
-      int tries = 1;
-      int flags = O_WRONLY|O_CREAT|O_TRUNC;       // file-opening flags
-      
       const char* filename = dataFilename.c_str();
-      int fd  = open( filename, flags, 0666 );
+      int fd = -1;
+
+      if( m_asyncWriter || aggregate ) {
+        job.reset( scinew AsyncOutputWriter::Job );
+        job->m_dataFilename = dataFilename;
+        job->m_dataFilebase = dataFilebase;
+        job->m_xmlFilename  = xmlFilename;
+        job->m_doc          = doc;
+      }
+      else {
+        int tries = 1;
+        int flags = O_WRONLY|O_CREAT|O_TRUNC;       // file-opening flags
       
-      while( fd == -1 ) {
+        fd = open( filename, flags, 0666 );
+      
+        while( fd == -1 ) {
 
-        if( tries >= 50 ) {
-          ostringstream msg;
+          if( tries >= 50 ) {
+            ostringstream msg;
           
-          msg << "DataArchiver::output(): Failed to open file '"
-              << dataFilename << "' (after 50 tries).";
-          throw ErrnoException( msg.str(), errno, __FILE__, __LINE__ );
-        }
+            msg << "DataArchiver::output(): Failed to open file '"
+                << dataFilename << "' (after 50 tries).";
+            throw ErrnoException( msg.str(), errno, __FILE__, __LINE__ );
+          }
 
-        fd = open( filename, flags, 0666 );
-        tries++;
-      }
+          fd = open( filename, flags, 0666 );
+          tries++;
+        }
       
-      if( tries > 1 ) {
-        proc0cout << "WARNING: There was a glitch in trying to open the "
-                  << "checkpoint file: " << dataFilename << ". "
-                  << "It took " << tries << " tries to successfully open it.";
+        if( tries > 1 ) {
+          proc0cout << "WARNING: There was a glitch in trying to open the "
+                    << "checkpoint file: " << dataFilename << ". "
+                    << "It took " << tries << " tries to successfully open it.";
+        }
       }
 
       //__________________________________
@@ -3099,6 +3370,22 @@ DataArchiver::outputVariables( const ProcessorGroup * pg,
             if( var->getBoundaryLayer() != IntVector(0,0,0) ) {
               pdElem->appendElement("boundaryLayer", var->getBoundaryLayer());
             }
+
+            // Stage the variable, the start/end of its data are
+            // filled in once it is written.
+            if( job ) {
+              AsyncOutputWriter::Item item;
+              item.m_varnode = pdElem;
+
+              OutputContext oc( &item.m_data, filename, pdElem, m_outputDoubleAsFloat && type != CHECKPOINT );
+              totalBytes += dw->emit( oc, var, matlIndex, patch );
+
+              item.m_compressionMode = oc.compressionMode;
+              item.m_varName         = var->getName();
+              job->m_items.push_back( std::move( item ) );
+              continue;
+            }
+
             // Pad appropriately
             if( cur % PADSIZE != 0 ) {
               long pad = PADSIZE-cur%PADSIZE;
@@ -3123,6 +3410,11 @@ DataArchiver::outputVariables( const ProcessorGroup * pg,
 
             pdElem->appendElement("end", oc.cur);
             pdElem->appendElement("filename", dataFilebase.c_str());
+
+            const std::string & compressionMode = var->getCompressionMode();
+            if( compressionMode != "" && compressionMode != "none" ) {
+              m_compressionStats[var->getName()].add( compressionMode, oc.uncompressedSize, oc.cur - cur, oc.compressionSeconds );
+            }
             
 #if SCI_ASSERTION_LEVEL >= 1
             struct stat st;
@@ -3143,18 +3435,29 @@ DataArchiver::outputVariables( const ProcessorGroup * pg,
       
       //__________________________________
       // close files and handles 
-      int s = close( fd );
-      if( s == -1 ) {
-        cerr << "Error closing file: " << filename << ", errno=" << errno << '\n';
-        throw ErrnoException("DataArchiver::output (close call)", errno, __FILE__, __LINE__ );
-      }
+      if( !job ) {
+        int s = close( fd );
+        if( s == -1 ) {
+          cerr << "Error closing file: " << filename << ", errno=" << errno << '\n';
+          throw ErrnoException("DataArchiver::output (close call)", errno, __FILE__, __LINE__ );
+        }
       
-      doc->output( xmlFilename.c_str() );
-      //doc->releaseDocument();
+        doc->output( xmlFilename.c_str() );
+        //doc->releaseDocument();
+      }
 
     } // end output locked section
 
     m_outputLock.unlock(); 
+
+    // Outside of the lock as it may block until the output thread(s)
+    // have caught up, and they need the lock.
+    if( job && aggregate ) {
+      m_outputAggregator->add( std::move( job ) );
+    }
+    else if( job ) {
+      m_asyncWriter->submit( std::move( job ) );
+    }
   } // end UDA or Global Var
 
 #if HAVE_PIDX
@@ -4524,10 +4827,6 @@ DataArchiver::checkpointTimeStep( const GridP& grid,
   // Sync up before every rank can use the checkpoints dir
   Uintah::MPI::Barrier( d_myworld->getComm() );
 
-  // Update the main xml file and write the xml file for this
-  // timestep.
-  writeto_xml_files( grid );
-
   // For each level get the patches associated with this processor and
   // save the requested output variables.
   for( int i = 0; i < grid->numLevels(); ++i ) {
@@ -4542,6 +4841,11 @@ DataArchiver::checkpointTimeStep( const GridP& grid,
                      nullptr, oldDW, newDW, CHECKPOINT_GLOBAL );
   }
 
+  // Update the main xml file and write the xml file for this
+  // timestep. With aggregated output this also flushes the
+  // variables staged above, as for a scheduled checkpoint.
+  writeto_xml_files( grid );
+
   m_isCheckpointTimeStep = false;
   m_checkpointPreviousTimeStep = false;
 }
@@ -25,6 +25,9 @@
 #ifndef UINTAH_HOMEBREW_DataArchiver_H
 #define UINTAH_HOMEBREW_DataArchiver_H
 
+#include <CCA/Components/DataArchiver/AsyncOutputWriter.h>
+#include <CCA/Components/DataArchiver/OutputAggregator.h>
+
 #include <CCA/Ports/Output.h>
 #include <CCA/Ports/PIDXOutputContext.h>
 
@@ -40,6 +43,10 @@
 #include <Core/Parallel/UintahParallelComponent.h>
 #include <Core/Util/Assert.h>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 namespace Uintah {
 
 class DataWarehouse;
@@ -326,6 +333,15 @@ class LoadBalancer;
     void writeDataTextWriter( const bool hasGlobals, const std::string & data_path, const GridP & grid,
                               const std::vector< std::vector<bool> > & procOnLevel );
 
+    // The pxxxxx.xml (or aggregated axxxxx.xml) files of a level.
+    struct DataFile {
+      std::string m_href;
+      int         m_proc;
+      std::string m_ranks;  // aggregated files only - the ranks whose data it holds
+    };
+
+    void getDataFiles( int level, const std::vector<bool> & procOnLevel, std::vector<DataFile> & dataFiles ) const;
+
     // Writes out the <Grid> section (associated with timestep.xml) to a separate binary file.
     void writeGridBinary(     const bool hasGlobals, const std::string & grid_path, const GridP & grid );
 
@@ -407,6 +423,16 @@ class LoadBalancer;
     //! add saved global (reduction/sole) variables to index.xml
     void indexAddGlobals();
 
+    //! reference a time step in index.xml (unless it already is)
+    void indexAddTimeStep( ProblemSpecP indexDoc,
+                           const int    dir_timestep,
+                           const double simTime,
+                           const double delT );
+
+    //! asynchronous output - wait for all ranks to finish writing
+    //! and add the pending time steps to index.xml
+    void commitAsyncOutput();
+
     // setupLocalFileSystems() and setupSharedFileSystem() are used to
     // create the UDA (versioned) directory.  setupLocalFileSystems()
     // is old method of determining which ranks should output UDA
@@ -605,6 +631,53 @@ class LoadBalancer;
 
     bool m_outputDoubleAsFloat {false};
 
+    //-----------------------------------------------------------
+    // If the <DataArchiver> section of the .ups file contains:
+    //
+    //   <outputAsync threads="1" bufferSizeMB="1024" />
+    //
+    // the output tasks only serialize the saved variables, the
+    // compression and writing is done by m_asyncWriter while the
+    // next time steps run.  A time step is only referenced in
+    // index.xml once every rank has written it, so the time steps
+    // waiting for that are kept in m_pendingTimeSteps until the next
+    // output/checkpoint time step or the end of the run.
+    //-----------------------------------------------------------
+
+    std::unique_ptr<AsyncOutputWriter> m_asyncWriter;
+
+    struct PendingTimeStep {
+      Dir  * m_baseDir;
+      int    m_timeStep;
+      double m_simTime;
+      double m_delT;
+    };
+
+    std::vector<PendingTimeStep> m_pendingTimeSteps;
+    bool m_asyncOutputPending {false};
+
+    //-----------------------------------------------------------
+    // If the <DataArchiver> section of the .ups file contains:
+    //
+    //   <outputAggregation aggregatorsPerNode="1" />
+    //   or
+    //   <outputAggregation ranksPerGroup="64" />
+    //
+    // the output tasks only serialize the saved variables and
+    // writeto_xml_files() sends them to one aggregator rank per group,
+    // which writes one data and one xml file per level.
+    //-----------------------------------------------------------
+
+    std::unique_ptr<OutputAggregator> m_outputAggregator;
+
+    //-----------------------------------------------------------
+    // Compression statistics of the synchronous output since the last
+    // report, keyed by variable name (guarded by m_outputLock).  They
+    // are reported through the DataArchiverCompression Dout.
+    std::map<std::string, CompressionStats> m_compressionStats;
+
+    void reportCompressionStats();
+
     //-----------------------------------------------------------
 
     // These four variables affect the global var output only.
@@ -0,0 +1,456 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <CCA/Components/DataArchiver/OutputAggregator.h>
+
+#include <Core/Exceptions/ErrnoException.h>
+#include <Core/Exceptions/InternalError.h>
+#include <Core/Grid/Variables/Variable.h>
+#include <Core/Malloc/Allocator.h>
+#include <Core/Parallel/ProcessorGroup.h>
+#include <Core/Util/DOUT.hpp>
+#include <Core/Util/Timers/Timers.hpp>
+
+#include <libxml/tree.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+#define PADSIZE 1024L
+
+using namespace Uintah;
+
+namespace {
+
+  Dout g_aggregation_dbg( "DataArchiverAggregation", "DataArchiver", "reports the aggregated output writes", false );
+
+  const int    AGGREGATION_TAG = 4237;
+  const size_t MAX_MESSAGE     = 1 << 30;  // bytes per MPI call
+
+  //______________________________________________________________________
+  //  Wire format helpers (the group runs on one machine type).
+  void
+  put64( std::string & out, uint64_t value )
+  {
+    out.append( (const char *) &value, sizeof( value ) );
+  }
+
+  void
+  putString( std::string & out, const std::string & value )
+  {
+    put64( out, value.size() );
+    out.append( value );
+  }
+
+  struct Reader {
+    const std::string & m_message;
+    size_t              m_pos{0};
+
+    Reader( const std::string & message ) : m_message( message ) {}
+
+    const char * take( size_t size )
+    {
+      if( size > m_message.size() - m_pos ) {
+        SCI_THROW( InternalError( "OutputAggregator: truncated message", __FILE__, __LINE__ ) );
+      }
+      const char * data = m_message.data() + m_pos;
+      m_pos += size;
+      return data;
+    }
+
+    uint64_t get64()
+    {
+      uint64_t value;
+      memcpy( &value, take( sizeof( value ) ), sizeof( value ) );
+      return value;
+    }
+
+    std::string getString()
+    {
+      const size_t size = get64();
+      return std::string( take( size ), size );
+    }
+  };
+
+  //______________________________________________________________________
+  //
+  void
+  writeFully( int fd, const char * buffer, size_t size, const std::string & filename )
+  {
+    while( size > 0 ) {
+      ssize_t s = ::write( fd, buffer, size );
+
+      if( s == -1 ) {
+        if( errno == EINTR ) {
+          continue;
+        }
+        std::ostringstream msg;
+        msg << "OutputAggregator: write to '" << filename << "' failed";
+        SCI_THROW( ErrnoException( msg.str(), errno, __FILE__, __LINE__ ) );
+      }
+      buffer += s;
+      size   -= s;
+    }
+  }
+
+}
+
+//______________________________________________________________________
+//
+struct OutputAggregator::AggregatedFile {
+  std::string  m_dataFilename;
+  std::string  m_dataFilebase;
+  std::string  m_xmlFilename;
+  int          m_fd{-1};
+  long         m_cur{0};
+  ProblemSpecP m_doc;
+};
+
+//______________________________________________________________________
+//
+OutputAggregator::OutputAggregator( const ProcessorGroup * myworld
+                                  ,       int              aggregatorsPerNode
+                                  ,       int              ranksPerGroup
+                                  ,       MasterLock     & domLock
+                                  )
+  : m_myworld( myworld )
+  , m_dom_lock( domLock )
+{
+  const int rank = myworld->myRank();
+
+  if( ranksPerGroup > 0 ) {
+    Uintah::MPI::Comm_split( myworld->getComm(), rank / ranksPerGroup, rank, &m_group_comm );
+  }
+  else {
+    // Consecutive ranks of a node form a group.
+    const int nodeRanks = myworld->myNode_nRanks();
+    const int groups    = std::min( std::max( aggregatorsPerNode, 1 ), nodeRanks );
+    const int color     = (int) ( (long) myworld->myNode_myRank() * groups / nodeRanks );
+
+    Uintah::MPI::Comm_split( myworld->getNodeComm(), color, rank, &m_group_comm );
+  }
+
+  Uintah::MPI::Comm_rank( m_group_comm, &m_group_rank );
+  Uintah::MPI::Comm_size( m_group_comm, &m_group_size );
+
+  int aggregator = rank;
+  Uintah::MPI::Bcast( &aggregator, 1, MPI_INT, 0, m_group_comm );
+
+  m_aggregators.resize( myworld->nRanks() );
+  Uintah::MPI::Allgather( &aggregator, 1, MPI_INT, m_aggregators.data(), 1, MPI_INT, myworld->getComm() );
+}
+
+//______________________________________________________________________
+//
+OutputAggregator::~OutputAggregator()
+{
+  if( !m_jobs.empty() ) {
+    std::cerr << "OutputAggregator: " << m_jobs.size() << " staged output file(s) were never written\n";
+  }
+
+  int finalized = 0;
+  Uintah::MPI::Finalized( &finalized );
+  if( !finalized && m_group_comm != MPI_COMM_NULL ) {
+    Uintah::MPI::Comm_free( &m_group_comm );
+  }
+}
+
+//______________________________________________________________________
+//
+std::string
+OutputAggregator::filebase( int aggregator )
+{
+  std::ostringstream name;
+  name << "a" << std::setw(5) << std::setfill('0') << aggregator;
+  return name.str();
+}
+
+//______________________________________________________________________
+//
+void
+OutputAggregator::add( std::unique_ptr<AsyncOutputWriter::Job> job )
+{
+  std::lock_guard<std::mutex> lock( m_mutex );
+  m_jobs.push_back( std::move( job ) );
+}
+
+//______________________________________________________________________
+//
+std::map<std::string, CompressionStats>
+OutputAggregator::takeCompressionStats()
+{
+  std::map<std::string, CompressionStats> stats;
+  stats.swap( m_compression_stats );
+  return stats;
+}
+
+//______________________________________________________________________
+//
+//  numJobs, then per job its directory, its pxxxxx.xml document and
+//  the size and compression mode of every variable, followed by the
+//  (compressed) data of all the variables.
+void
+OutputAggregator::pack( std::string & message )
+{
+  std::vector<std::unique_ptr<AsyncOutputWriter::Job>> jobs;
+  {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    jobs.swap( m_jobs );
+  }
+
+  std::string header;
+  std::vector<std::string> payloads;
+
+  put64( header, jobs.size() );
+
+  for( auto & job : jobs ) {
+    const std::string & filename = job->m_dataFilename;
+    putString( header, filename.substr( 0, filename.rfind( '/' ) ) );
+
+    xmlChar * xml  = nullptr;
+    int       size = 0;
+    xmlDocDumpMemory( job->m_doc->getNode()->doc, &xml, &size );
+    putString( header, std::string( (const char *) xml, size ) );
+    xmlFree( xml );
+
+    put64( header, job->m_items.size() );
+
+    for( auto & item : job->m_items ) {
+      std::string buffer;
+      std::string compressionMode;
+
+      Timers::Simple timer;
+      timer.start();
+      const size_t uncompressed = item.m_data.size();
+      std::string * out = Variable::compress( &item.m_data, &buffer, item.m_compressionMode, compressionMode );
+
+      if( item.m_compressionMode != "" && item.m_compressionMode != "none" ) {
+        m_compression_stats[item.m_varName].add( item.m_compressionMode, uncompressed, out->size(), timer().seconds() );
+      }
+
+      put64( header, out->size() );
+      putString( header, compressionMode );
+
+      payloads.push_back( std::string() );
+      payloads.back().swap( *out );
+      std::string().swap( item.m_data );
+    }
+  }
+
+  // The documents are released under the lock they were built with.
+  {
+    std::lock_guard<Uintah::MasterLock> dom_guard( m_dom_lock );
+    jobs.clear();
+  }
+
+  size_t total = header.size();
+  for( auto & payload : payloads ) {
+    total += payload.size();
+  }
+
+  message.clear();
+  message.reserve( total );
+  message.append( header );
+  for( auto & payload : payloads ) {
+    message.append( payload );
+    std::string().swap( payload );
+  }
+}
+
+//______________________________________________________________________
+//
+void
+OutputAggregator::unpack( const std::string & message, std::map<std::string, AggregatedFile> & files )
+{
+  Reader reader( message );
+
+  struct Extent {
+    size_t      m_size;
+    std::string m_compressionMode;
+  };
+
+  struct Entry {
+    std::string         m_dir;
+    std::string         m_xml;
+    std::vector<Extent> m_extents;
+  };
+
+  std::vector<Entry> entries( reader.get64() );
+
+  for( auto & entry : entries ) {
+    entry.m_dir = reader.getString();
+    entry.m_xml = reader.getString();
+    entry.m_extents.resize( reader.get64() );
+
+    for( auto & extent : entry.m_extents ) {
+      extent.m_size            = reader.get64();
+      extent.m_compressionMode = reader.getString();
+    }
+  }
+
+  const std::string zeros( PADSIZE, '\0' );
+  const std::string base = filebase( m_myworld->myRank() );
+
+  for( auto & entry : entries ) {
+
+    AggregatedFile & file = files[entry.m_dir];
+
+    if( file.m_fd == -1 ) {
+      file.m_dataFilebase = base + ".data";
+      file.m_dataFilename = entry.m_dir + "/" + file.m_dataFilebase;
+      file.m_xmlFilename  = entry.m_dir + "/" + base + ".xml";
+      file.m_doc          = ProblemSpec::createDocument( "Uintah_Output" );
+
+      // Same retry policy as the per rank output.
+      const int flags = O_WRONLY|O_CREAT|O_TRUNC;
+      int tries = 1;
+
+      file.m_fd = open( file.m_dataFilename.c_str(), flags, 0666 );
+      while( file.m_fd == -1 ) {
+        if( tries >= 50 ) {
+          std::ostringstream msg;
+          msg << "OutputAggregator: Failed to open file '" << file.m_dataFilename << "' (after 50 tries).";
+          SCI_THROW( ErrnoException( msg.str(), errno, __FILE__, __LINE__ ) );
+        }
+        file.m_fd = open( file.m_dataFilename.c_str(), flags, 0666 );
+        tries++;
+      }
+    }
+
+    // The member's <Variable> nodes are in the same order as its data.
+    ProblemSpecP src = scinew ProblemSpec( entry.m_xml );
+    if( src->getNode() == nullptr ) {
+      SCI_THROW( InternalError( "OutputAggregator: could not parse a staged document", __FILE__, __LINE__ ) );
+    }
+
+    size_t item = 0;
+    for( ProblemSpecP vnode = src->findBlock( "Variable" ); vnode != nullptr; vnode = vnode->findNextBlock( "Variable" ) ) {
+
+      if( item == entry.m_extents.size() ) {
+        SCI_THROW( InternalError( "OutputAggregator: more variables than data", __FILE__, __LINE__ ) );
+      }
+      const Extent & extent = entry.m_extents[item++];
+
+      // Pad appropriately
+      if( file.m_cur % PADSIZE != 0 ) {
+        long pad = PADSIZE - file.m_cur % PADSIZE;
+        writeFully( file.m_fd, zeros.data(), pad, file.m_dataFilename );
+        file.m_cur += pad;
+      }
+
+      const long start = file.m_cur;
+      writeFully( file.m_fd, reader.take( extent.m_size ), extent.m_size, file.m_dataFilename );
+      file.m_cur += extent.m_size;
+
+      ProblemSpecP varnode = file.m_doc->importNode( vnode, true );
+      file.m_doc->appendChild( varnode );
+
+      varnode->appendElement( "start",    start );
+      varnode->appendElement( "end",      file.m_cur );
+      varnode->appendElement( "filename", file.m_dataFilebase.c_str() );
+
+      if( extent.m_compressionMode != "" ) {
+        varnode->appendElement( "compression", extent.m_compressionMode );
+      }
+    }
+
+    if( item != entry.m_extents.size() ) {
+      SCI_THROW( InternalError( "OutputAggregator: more data than variables", __FILE__, __LINE__ ) );
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+void
+OutputAggregator::flush()
+{
+  Timers::Simple timer;
+  timer.start();
+
+  std::string message;
+  pack( message );
+
+  // Members send their message to the aggregator, in pieces small
+  // enough for an int count.
+  unsigned long long size = message.size();
+  std::vector<unsigned long long> sizes( m_group_size );
+
+  Uintah::MPI::Gather( &size, 1, MPI_UNSIGNED_LONG_LONG, sizes.data(), 1, MPI_UNSIGNED_LONG_LONG, 0, m_group_comm );
+
+  if( m_group_rank != 0 ) {
+    for( size_t sent = 0; sent < message.size(); sent += MAX_MESSAGE ) {
+      const int count = (int) std::min( MAX_MESSAGE, message.size() - sent );
+      Uintah::MPI::Send( &message[sent], count, MPI_BYTE, 0, AGGREGATION_TAG, m_group_comm );
+    }
+    return;
+  }
+
+  std::lock_guard<Uintah::MasterLock> dom_guard( m_dom_lock );
+
+  std::map<std::string, AggregatedFile> files;
+  size_t total = 0;
+
+  try {
+    unpack( message, files );
+    total += message.size();
+
+    for( int member = 1; member < m_group_size; ++member ) {
+      message.resize( sizes[member] );
+
+      for( size_t received = 0; received < message.size(); received += MAX_MESSAGE ) {
+        const int count = (int) std::min( MAX_MESSAGE, message.size() - received );
+        MPI_Status status;
+        Uintah::MPI::Recv( &message[received], count, MPI_BYTE, member, AGGREGATION_TAG, m_group_comm, &status );
+      }
+
+      unpack( message, files );
+      total += message.size();
+    }
+  }
+  catch( ... ) {
+    for( auto & file : files ) {
+      close( file.second.m_fd );
+    }
+    throw;
+  }
+
+  for( auto & file : files ) {
+    if( close( file.second.m_fd ) == -1 ) {
+      std::ostringstream msg;
+      msg << "OutputAggregator: Error closing file '" << file.second.m_dataFilename << "'";
+      SCI_THROW( ErrnoException( msg.str(), errno, __FILE__, __LINE__ ) );
+    }
+    file.second.m_doc->output( file.second.m_xmlFilename.c_str() );
+  }
+
+  DOUT( g_aggregation_dbg, "Rank-" << m_myworld->myRank() << " aggregated " << m_group_size << " rank(s) into "
+                           << files.size() << " file(s), " << total << " bytes in " << timer().seconds() << " seconds" );
+}
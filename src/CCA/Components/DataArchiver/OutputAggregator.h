@@ -0,0 +1,137 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CCA_COMPONENTS_DATAARCHIVER_OUTPUTAGGREGATOR_H
+#define CCA_COMPONENTS_DATAARCHIVER_OUTPUTAGGREGATOR_H
+
+#include <CCA/Components/DataArchiver/AsyncOutputWriter.h>
+
+#include <Core/IO/CompressionCodec.h>
+#include <Core/Parallel/MasterLock.h>
+#include <Core/Parallel/UintahMPI.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Uintah {
+
+class ProcessorGroup;
+
+/**************************************
+
+  CLASS
+    OutputAggregator
+
+  GENERAL INFORMATION
+    OutputAggregator.h
+
+  DESCRIPTION
+    N-to-M output for the DataArchiver's <outputAggregation> mode.
+
+    The ranks are split into groups, either a number of groups per
+    node or groups of a fixed number of consecutive ranks.  The
+    lowest rank of each group is its aggregator.  Instead of every
+    rank writing its own lN/pxxxxx.data and .xml files, the output
+    tasks stage the variables (the same Job as the asynchronous
+    output) and flush() sends them to the aggregator.  The aggregator
+    then writes a single lN/axxxxx.data and axxxxx.xml per level,
+    named after its own rank.
+
+    The variables are compressed by the rank that owns them before
+    being sent, so the compression still runs in parallel.  The
+    aggregator receives the members' data one rank at a time, so its
+    extra memory is bounded by the largest contribution of one rank.
+
+    The <Datafile> entries of timestep.xml for an aggregated file
+    carry a 'ranks' attribute, which is what DataArchive uses to find
+    the data of a patch.
+
+****************************************/
+
+class OutputAggregator {
+
+public:
+
+  // Exactly one of aggregatorsPerNode and ranksPerGroup is positive.
+  // Collective over myworld's communicator.
+  OutputAggregator( const ProcessorGroup * myworld
+                  ,       int              aggregatorsPerNode
+                  ,       int              ranksPerGroup
+                  ,       MasterLock     & domLock
+                  );
+
+  ~OutputAggregator();
+
+  // Stages a job for the next flush(). Thread safe.
+  void add( std::unique_ptr<AsyncOutputWriter::Job> job );
+
+  // Collective - writes the jobs staged on every rank of the group.
+  void flush();
+
+  // The aggregator (world rank) whose file holds 'rank's data.
+  int aggregatorOf( int rank ) const { return m_aggregators[rank]; }
+
+  // "axxxxx" - base name of the files written by 'aggregator'.
+  static std::string filebase( int aggregator );
+
+  // Returns and clears the compression statistics of this rank's
+  // variables, keyed by variable name.
+  std::map<std::string, CompressionStats> takeCompressionStats();
+
+private:
+
+  // This rank's jobs in the wire format used by flush().
+  void pack( std::string & message );
+
+  // Appends the jobs in 'message' to the aggregated files.
+  struct AggregatedFile;
+  void unpack( const std::string & message, std::map<std::string, AggregatedFile> & files );
+
+  const ProcessorGroup * m_myworld;
+  MasterLock           & m_dom_lock;
+
+  MPI_Comm m_group_comm{MPI_COMM_NULL};
+  int      m_group_rank{0};
+  int      m_group_size{1};
+
+  std::vector<int> m_aggregators;  // per world rank
+
+  std::mutex                                           m_mutex;  // guards m_jobs
+  std::vector<std::unique_ptr<AsyncOutputWriter::Job>> m_jobs;
+
+  std::map<std::string, CompressionStats> m_compression_stats;
+
+  // eliminate copy, assignment and move
+  OutputAggregator( const OutputAggregator & )            = delete;
+  OutputAggregator& operator=( const OutputAggregator & ) = delete;
+  OutputAggregator( OutputAggregator && )                 = delete;
+  OutputAggregator& operator=( OutputAggregator && )      = delete;
+};
+
+} // End namespace Uintah
+
+#endif // CCA_COMPONENTS_DATAARCHIVER_OUTPUTAGGREGATOR_H
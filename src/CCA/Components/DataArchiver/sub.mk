@@ -31,13 +31,16 @@ include $(SCIRUN_SCRIPTS)/smallso_prologue.mk
 
 SRCDIR   := CCA/Components/DataArchiver
 
-SRCS     += $(SRCDIR)/DataArchiver.cc
+SRCS     += $(SRCDIR)/AsyncOutputWriter.cc \
+            $(SRCDIR)/DataArchiver.cc \
+            $(SRCDIR)/OutputAggregator.cc
 
 PSELIBS := \
 	CCA/Ports          \
 	Core/Parallel      \
 	Core/GeometryPiece \
 	Core/Grid          \
+	Core/IO            \
 	Core/Util          \
 	Core/Disclosure    \
 	Core/Math          \
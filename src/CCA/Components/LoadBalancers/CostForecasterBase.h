@@ -66,6 +66,8 @@ namespace Uintah {
     virtual void setMinPatchSize(const std::vector<IntVector> &min_patch_size) {};
     //add the contribution for region r on level l
     virtual void addContribution(DetailedTask *task, double cost) {};
+    //predicted execution time of the task, 0 if the forecaster does not model tasks
+    virtual double predictContribution(DetailedTask *task) { return 0; }
     //finalize the contributions for this timestep
     virtual void finalizeContributions(const GridP currentGrid) {};
     //compute the weights for all patches in the grid.  Particles are provided in the num_particles vectors.
@@ -26,6 +26,7 @@
 
 #include <CCA/Components/LoadBalancers/CostModeler.h>
 #include <CCA/Components/LoadBalancers/CostModelForecaster.h>
+#include <CCA/Components/LoadBalancers/TaskCostModel.h>
 #include <CCA/Components/ProblemSpecification/ProblemSpecReader.h>
 #include <CCA/Components/Schedulers/DetailedTasks.h>
 #include <CCA/Ports/ApplicationInterface.h>
@@ -40,13 +41,16 @@
 #include <Core/Grid/Level.h>
 #include <Core/Grid/Patch.h>
 #include <Core/Grid/MaterialManager.h>
+#include <Core/Grid/Region.h>
 #include <Core/Parallel/Parallel.h>
 #include <Core/Parallel/ProcessorGroup.h>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/DebugStream.h>
 #include <Core/Util/Timers/Timers.hpp>
 
+#include <algorithm>
 #include <iostream> // debug only
+#include <map>
 #include <stack>
 #include <vector>
 
@@ -56,6 +60,8 @@ namespace {
   DebugStream doing( "DynamicLoadBalancer_doing", "LoadBalancers", "", false );
   DebugStream lb(    "DynamicLoadBalancer_lb",    "LoadBalancers", "", false );
   DebugStream dbg(   "DynamicLoadBalancer",       "LoadBalancers", "", false );
+  DebugStream migration( "DynamicLoadBalancer_migration", "LoadBalancers",
+                         "report the imbalance and the data moved by each load balance", false );
   
   double lbtimes[5] = {0,0,0,0,0};
 }
@@ -82,11 +88,11 @@ DynamicLoadBalancer::collectParticlesForRegrid( const Grid                     *
                                                 const std::vector< std::vector<Region> > & newGridRegions,
                                                 std::vector< std::vector<int> >          & particles )
 {
-  // Collect particles from the old grid's patches onto processor 0 and then distribute them
-  // (it's either this or do 2 consecutive load balances).  For now, it's safe to assume that
-  // if there is a new level or a new patch there are no particles there.
+  // Collect particles from the old grid's patches, each rank counts those on the old patches
+  // it owns and the counts are summed up on all ranks (it's either this or do 2 consecutive
+  // load balances).  For now, it's safe to assume that if there is a new level or a new patch
+  // there are no particles there.
 
-  int num_procs = d_myworld->nRanks();
   int myRank = d_myworld->myRank();
   int num_patches = 0;
 
@@ -100,29 +106,20 @@ DynamicLoadBalancer::collectParticlesForRegrid( const Grid                     *
     return;
   }
 
-  std::vector<int> recvcounts(num_procs,0); // init the counts to 0
-  int totalsize = 0;
-
   DataWarehouse* dw = m_scheduler->get_dw(0);
   if (dw == 0) {
     return;
   }
 
-  std::vector<PatchInfo> subpatchParticles;
+  std::vector<int> my_particles(num_patches, 0);
   unsigned grid_index = 0;
   for(unsigned l=0;l<newGridRegions.size();l++){
     const std::vector<Region>& level = newGridRegions[l];
     for (unsigned r = 0; r < level.size(); r++, grid_index++) {
-      const Region& region = level[r];;
+      const Region& region = level[r];
 
       if (l >= (unsigned) oldGrid->numLevels()) {
         // new patch - no particles yet
-        recvcounts[0]++;
-        totalsize++;
-        if( Uintah::Parallel::getMPIRank() == 0 ) {
-          PatchInfo pi(grid_index, 0);
-          subpatchParticles.push_back(pi);
-        }
         continue;
       }
 
@@ -131,80 +128,38 @@ DynamicLoadBalancer::collectParticlesForRegrid( const Grid                     *
       Level::selectType oldPatches;
       oldLevel->selectPatches(region.getLow(), region.getHigh(), oldPatches);
 
-      if (oldPatches.size() == 0) {
-        recvcounts[0]++;
-        totalsize++;
-        if( Uintah::Parallel::getMPIRank() == 0 ) {
-          PatchInfo pi(grid_index, 0);
-          subpatchParticles.push_back(pi);
-        }
-        continue;
-      }
-
       for (unsigned int i = 0; i < oldPatches.size(); i++) {
         const Patch* oldPatch = oldPatches[i];
 
-        recvcounts[m_processor_assignment[oldPatch->getGridIndex()]]++;
-        totalsize++;
         if (m_processor_assignment[oldPatch->getGridIndex()] == myRank) {
           IntVector low, high;
-          //loop through the materials and add up the particles
-          // the main difference between this and the above portion is that we need to grab the portion of the patch
-          // that is intersected by the other patch
+          // grab the portion of the old patch that is intersected by the region
           low = Max(region.getLow(), oldPatch->getExtraCellLowIndex());
           high = Min(region.getHigh(), oldPatch->getExtraCellHighIndex());
 
           int thisPatchParticles = 0;
-          if (dw) {
-            //loop through the materials and add up the particles
-            //   go through all materials since getting an MPMMaterial correctly would depend on MPM
-            for (unsigned int m = 0; m < m_materialManager->getNumMatls(); m++) {
-              ParticleSubset* psubset = 0;
-              if (dw->haveParticleSubset(m, oldPatch, low, high))
-                psubset = dw->getParticleSubset(m, oldPatch, low, high);
-              if (psubset)
-                thisPatchParticles += psubset->numParticles();
-            }
+          //loop through the materials and add up the particles
+          //   go through all materials since getting an MPMMaterial correctly would depend on MPM
+          for (unsigned int m = 0; m < m_materialManager->getNumMatls(); m++) {
+            ParticleSubset* psubset = 0;
+            if (dw->haveParticleSubset(m, oldPatch, low, high))
+              psubset = dw->getParticleSubset(m, oldPatch, low, high);
+            if (psubset)
+              thisPatchParticles += psubset->numParticles();
           }
-          PatchInfo p(grid_index, thisPatchParticles);
-          subpatchParticles.push_back(p);
+          my_particles[grid_index] += thisPatchParticles;
         }
       }
     }
   }
 
+  // combine all the subpatches results
   std::vector<int> num_particles(num_patches, 0);
-
   if (d_myworld->nRanks() > 1) {
-    //construct a mpi datatype for the PatchInfo
-    MPI_Datatype particletype;
-    Uintah::MPI::Type_contiguous(2, MPI_INT, &particletype);
-    Uintah::MPI::Type_commit(&particletype);
-
-    std::vector<PatchInfo> recvbuf(totalsize);
-    std::vector<int> displs(num_procs,0);
-    for (unsigned i = 1; i < displs.size(); i++) {
-      displs[i] = displs[i-1]+recvcounts[i-1];
-    }
-
-    Uintah::MPI::Gatherv(&subpatchParticles[0], recvcounts[d_myworld->myRank()], particletype, &recvbuf[0],
-        &recvcounts[0], &displs[0], particletype, 0, d_myworld->getComm());
-
-    if ( d_myworld->myRank() == 0) {
-      for (unsigned i = 0; i < recvbuf.size(); i++) {
-        PatchInfo& spi = recvbuf[i];
-        num_particles[spi.m_id] += spi.m_num_particles;
-      }
-    }
-    // combine all the subpatches results
-    Uintah::MPI::Bcast(&num_particles[0], num_particles.size(), MPI_INT,0,d_myworld->getComm());
-    Uintah::MPI::Type_free(&particletype);
+    Uintah::MPI::Allreduce(my_particles.data(), num_particles.data(), num_patches, MPI_INT, MPI_SUM, d_myworld->getComm());
   }
   else {
-    for (unsigned i = 0; i < subpatchParticles.size(); i++) {
-      PatchInfo& spi = subpatchParticles[i];
-      num_particles[spi.m_id] += spi.m_num_particles;
-    }
+    num_particles.swap(my_particles);
   }
 
   //add the number of particles to the cost array
@@ -702,7 +657,7 @@ DynamicLoadBalancer::assignPatchesFactor( const GridP & grid, bool force )
   
   //__________________________________
   //
-  bool doLoadBalancing = force || thresholdExceeded(patch_costs);
+  bool doLoadBalancing = worthLoadBalancing(patch_costs, force);
   
   if (d_myworld->myRank() == 0){
     dbg << " Time to LB: " << timer().seconds() << std::endl;
@@ -714,7 +669,9 @@ DynamicLoadBalancer::assignPatchesFactor( const GridP & grid, bool force )
 //______________________________________________________________________
 //
 bool
-DynamicLoadBalancer::thresholdExceeded( const std::vector< std::vector<double> >& patch_costs )
+DynamicLoadBalancer::thresholdExceeded( const std::vector< std::vector<double> >& patch_costs,
+                                              double & max_current,
+                                              double & max_temp )
 {
   // add up the costs each processor for the current assignment
   // and for the temp assignment, then calculate the standard deviation
@@ -778,7 +735,7 @@ DynamicLoadBalancer::thresholdExceeded( const std::vector< std::vector<double> >
       double current_cost=0, temp_cost=0;
       for(int l=0;l<num_levels;l++) {
         current_cost+=currentProcCosts[l][i];
-        temp_cost+=currentProcCosts[l][i];
+        temp_cost+=tempProcCosts[l][i];
       }
       if(current_cost>total_max_current) {
         total_max_current=current_cost;
@@ -797,6 +754,9 @@ DynamicLoadBalancer::thresholdExceeded( const std::vector< std::vector<double> >
     stats << "Total:"  << " maxCur:" << total_max_current << " maxTemp:"  << total_max_temp << " avgCur:" << total_avg_current << " avgTemp:" << total_avg_temp <<std::endl;
   }
 
+  max_current = total_max_current;
+  max_temp    = total_max_temp;
+
   // if tmp - cur is positive, it is an improvement
   if( (total_max_current-total_max_temp)/total_max_current>d_lbThreshold) {
     return true;
@@ -806,6 +766,312 @@ DynamicLoadBalancer::thresholdExceeded( const std::vector< std::vector<double> >
   }
 }
 
+//______________________________________________________________________
+//
+bool
+DynamicLoadBalancer::worthLoadBalancing( const std::vector< std::vector<double> > & patch_costs, bool force )
+{
+  const int num_procs = d_myworld->nRanks();
+
+  // the imbalance of the new assignment
+  std::vector<double> tempProcCosts(num_procs, 0);
+  for (int l = 0, i = 0; l < (int)patch_costs.size(); l++) {
+    for (int p = 0; p < (int)patch_costs[l].size(); p++, i++) {
+      tempProcCosts[m_temp_assignment[i]] += patch_costs[l][p];
+    }
+  }
+  double avg_temp = 0;
+  double max_temp = 0;
+  for (int i = 0; i < num_procs; i++) {
+    avg_temp += tempProcCosts[i];
+    max_temp  = std::max(max_temp, tempProcCosts[i]);
+  }
+  avg_temp /= num_procs;
+
+  double total_bytes, max_rank_bytes, my_sent_bytes;
+  migratedBytes(total_bytes, max_rank_bytes, my_sent_bytes);
+
+  bool doLoadBalancing = force;
+  double gain    = 0;
+  double penalty = d_migrationCost * max_rank_bytes / (1024.0 * 1024.0);
+
+  if (!force) {
+    // The assignment is kept at least until the next check, weigh what it saves until then
+    // against the time the busiest rank spends moving data.
+    double max_current = 0;
+    bool improved = thresholdExceeded(patch_costs, max_current, max_temp);
+    gain = (max_current - max_temp) * std::max(m_lb_timeStep_interval, 1);
+    doLoadBalancing = improved && gain > penalty;
+  }
+
+  if (d_myworld->myRank() == 0) {
+    migration << "DLB: imbalance " << (max_temp > 0 ? 1 - avg_temp / max_temp : 0)
+              << ", migrating " << total_bytes / (1024.0 * 1024.0) << " MB"
+              << " (busiest rank " << max_rank_bytes / (1024.0 * 1024.0) << " MB)"
+              << ", gain " << gain << ", migration cost " << penalty
+              << (force ? ", forced" : "") << (doLoadBalancing ? ", rebalancing" : ", keeping the current assignment")
+              << std::endl;
+  }
+
+  if (doLoadBalancing) {
+    (*d_runtimeStats)[LoadBalancerMigration] += my_sent_bytes;
+  }
+
+  return doLoadBalancing;
+}
+
+//______________________________________________________________________
+//
+void
+DynamicLoadBalancer::getMigrationData( const Grid * grid )
+{
+  int num_patches = 0;
+  for (int l = 0; l < grid->numLevels(); l++) {
+    num_patches += grid->getLevel(l)->numPatches();
+  }
+
+  d_migrationBytes.assign(num_patches, 0);
+  d_migrationHome.assign(num_patches, -1);
+
+  DataWarehouse* olddw = m_scheduler->get_dw(0);
+  if (olddw == nullptr || m_processor_assignment.empty()) {
+    return;
+  }
+
+  const Grid* oldGrid = olddw->getGrid();
+  const int   myRank  = d_myworld->myRank();
+
+  std::map<const Patch*, size_t> sizes;
+  olddw->getPatchDataSizes(sizes);
+
+  // Each rank adds up its part of the data on each new patch (on a regrid
+  // a new patch gets its overlap with the old patches), the largest part
+  // decides the home.
+  std::vector<double>     my_bytes(num_patches, 0);
+  std::vector<double_int> my_part(num_patches, double_int(0, myRank));
+
+  for (int l = 0, i = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    for (int p = 0; p < level->numPatches(); p++, i++) {
+      if (l >= oldGrid->numLevels()) {
+        continue;
+      }
+      const Patch* patch = level->getPatch(p);
+      Level::selectType oldPatches;
+      oldGrid->getLevel(l)->selectPatches(patch->getCellLowIndex(), patch->getCellHighIndex(), oldPatches);
+
+      for (unsigned int j = 0; j < oldPatches.size(); j++) {
+        const Patch* oldPatch = oldPatches[j];
+        if (m_processor_assignment[oldPatch->getGridIndex()] != myRank) {
+          continue;
+        }
+        std::map<const Patch*, size_t>::const_iterator iter = sizes.find(oldPatch);
+        if (iter == sizes.end()) {
+          continue;
+        }
+        IntVector low  = Max(patch->getCellLowIndex(), oldPatch->getCellLowIndex());
+        IntVector high = Min(patch->getCellHighIndex(), oldPatch->getCellHighIndex());
+        double fraction = (double)Region::getVolume(low, high) / oldPatch->getNumCells();
+        my_bytes[i]    += fraction * iter->second;
+        my_part[i].val += fraction * iter->second;
+      }
+    }
+  }
+
+  std::vector<double_int> home(num_patches);
+  if (d_myworld->nRanks() > 1) {
+    Uintah::MPI::Allreduce(my_bytes.data(), d_migrationBytes.data(), num_patches, MPI_DOUBLE, MPI_SUM, d_myworld->getComm());
+    Uintah::MPI::Allreduce(my_part.data(), home.data(), num_patches, MPI_DOUBLE_INT, MPI_MAXLOC, d_myworld->getComm());
+  }
+  else {
+    d_migrationBytes.swap(my_bytes);
+    home.swap(my_part);
+  }
+
+  for (int i = 0; i < num_patches; i++) {
+    if (home[i].val > 0) {
+      d_migrationHome[i] = home[i].loc;
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+void
+DynamicLoadBalancer::migratedBytes( double & total, double & max_rank, double & my_sent ) const
+{
+  const int num_procs = d_myworld->nRanks();
+
+  std::vector<double> sent(num_procs, 0);
+  std::vector<double> received(num_procs, 0);
+
+  total = 0;
+  for (unsigned int i = 0; i < d_migrationHome.size() && i < m_temp_assignment.size(); i++) {
+    const int home = d_migrationHome[i];
+    if (home >= 0 && home != m_temp_assignment[i]) {
+      total                            += d_migrationBytes[i];
+      sent[home]                       += d_migrationBytes[i];
+      received[m_temp_assignment[i]]   += d_migrationBytes[i];
+    }
+  }
+
+  max_rank = 0;
+  for (int p = 0; p < num_procs; p++) {
+    max_rank = std::max(max_rank, std::max(sent[p], received[p]));
+  }
+  my_sent = sent[d_myworld->myRank()];
+}
+
+//______________________________________________________________________
+//
+bool
+DynamicLoadBalancer::assignPatchesDiffusion( const GridP & grid, bool force )
+{
+  // enabled in the UPS file with: <dynamicAlgorithm>diffusion</dynamicAlgorithm>
+  //
+  // Incremental repartitioning: starting from where the data is now, only
+  // patches at the boundaries between the ranks' pieces of the space-filling
+  // curve are shifted to the neighbor piece, as long as that lowers the
+  // larger of the two costs.  Most patches stay put, so little data moves.
+  // Levels where the current assignment is not a set of pieces of the curve
+  // (the first load balance, or patches added by a regrid out of order) are
+  // cut from scratch.  The levels are balanced independently.
+  doing << d_myworld->myRank() << "   APD\n";
+
+  Timers::Simple timer;
+  timer.start();
+
+  const int num_procs = d_myworld->nRanks();
+
+  std::vector<std::vector<double> > patch_costs;
+  getCosts(grid.get_rep(), patch_costs);
+
+  int level_offset = 0;
+  for (int l = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    const int num_patches = level->numPatches();
+
+    std::vector<int> order(num_patches);
+    if (m_do_space_curve) {
+      useSFC(level, &order[0]);
+    }
+    else {
+      for (int i = 0; i < num_patches; i++) {
+        order[i] = i;
+      }
+    }
+
+    // starts[p] is the position along the curve of the first patch of rank p,
+    // starts[num_procs] is the end of the curve.
+    std::vector<int> starts(num_procs + 1, num_patches);
+    starts[0] = 0;
+
+    bool incremental = false;
+    int  last_owner  = 0;
+    for (int i = 0; i < num_patches; i++) {
+      const int home = d_migrationHome[level_offset + order[i]];
+      if (home < 0) {
+        continue;  // no data yet, goes with the patches before it
+      }
+      incremental = true;
+      if (home < last_owner) {
+        incremental = false;
+        break;
+      }
+      for (int p = last_owner + 1; p <= home; p++) {
+        starts[p] = i;
+      }
+      last_owner = home;
+    }
+
+    double total_cost = 0;
+    for (int i = 0; i < num_patches; i++) {
+      total_cost += patch_costs[l][i];
+    }
+
+    std::vector<double> loads(num_procs, 0);
+    if (incremental) {
+      for (int p = 0; p < num_procs; p++) {
+        for (int i = starts[p]; i < starts[p + 1]; i++) {
+          loads[p] += patch_costs[l][order[i]];
+        }
+      }
+
+      // diffuse the load across the boundaries until no shift helps
+      bool shifted = true;
+      for (int sweep = 0; shifted && sweep < num_procs; sweep++) {
+        shifted = false;
+        for (int p = 1; p < num_procs; p++) {
+          // from the left piece to the right one
+          while (starts[p] > starts[p - 1]) {
+            const double cost = patch_costs[l][order[starts[p] - 1]];
+            if (std::max(loads[p - 1] - cost, loads[p] + cost) >= std::max(loads[p - 1], loads[p])) {
+              break;
+            }
+            starts[p]--;
+            loads[p - 1] -= cost;
+            loads[p]     += cost;
+            shifted = true;
+          }
+          // from the right piece to the left one
+          while (starts[p] < starts[p + 1]) {
+            const double cost = patch_costs[l][order[starts[p]]];
+            if (std::max(loads[p - 1] + cost, loads[p] - cost) >= std::max(loads[p - 1], loads[p])) {
+              break;
+            }
+            starts[p]++;
+            loads[p - 1] += cost;
+            loads[p]     -= cost;
+            shifted = true;
+          }
+        }
+      }
+    }
+    else {
+      // each patch goes to the rank whose share of the cost contains its midpoint
+      starts.assign(num_procs + 1, num_patches);
+      starts[0] = 0;
+      double running = 0;
+      int owner = 0;
+      for (int i = 0; i < num_patches; i++) {
+        const double cost = patch_costs[l][order[i]];
+        const int    mid  = total_cost > 0 ? (int)((running + 0.5 * cost) * num_procs / total_cost)
+                                           : (int)((long long)i * num_procs / num_patches);
+        for (; owner < std::min(mid, num_procs - 1); owner++) {
+          starts[owner + 1] = i;
+        }
+        running += cost;
+      }
+    }
+
+    for (int p = 0; p < num_procs; p++) {
+      for (int i = starts[p]; i < starts[p + 1]; i++) {
+        m_temp_assignment[level_offset + order[i]] = p;
+      }
+    }
+
+    if (stats.active() && d_myworld->myRank() == 0) {
+      loads.assign(num_procs, 0);
+      for (int p = 0; p < num_patches; p++) {
+        loads[m_temp_assignment[level_offset + p]] += patch_costs[l][p];
+      }
+      stats << "Diffusion LoadBalance level(" << l << "): " << (incremental ? "incremental" : "new partition")
+            << " Mean: " << total_cost / num_procs << " Max: " << *std::max_element(loads.begin(), loads.end()) << std::endl;
+    }
+
+    level_offset += num_patches;
+  }
+
+  bool doLoadBalancing = worthLoadBalancing(patch_costs, force);
+
+  if (d_myworld->myRank() == 0) {
+    dbg << " Time to LB: " << timer().seconds() << std::endl;
+  }
+  doing << d_myworld->myRank() << "   APD END\n";
+
+  return doLoadBalancing;
+}
+
 //______________________________________________________________________
 //
 bool
@@ -876,6 +1142,140 @@ DynamicLoadBalancer::assignPatchesCyclic(const GridP&, bool force)
   return true;
 }
 
+//______________________________________________________________________
+//
+bool
+DynamicLoadBalancer::assignPatchesSFC( const GridP & grid, bool force )
+{
+  // enabled in the UPS file with: <dynamicAlgorithm>sfc</dynamicAlgorithm>
+  //
+  // Cuts the space-filling curve of each level into num_procs pieces of
+  // (nearly) equal cost.  No rank orders or walks the whole curve: the
+  // curve is sorted in parallel (useDistributedSFC), each rank assigns the
+  // patches of its own part of the curve from a prefix sum of the costs,
+  // and the start of every rank's piece is found with one reduction.
+  // The levels are balanced independently.
+  doing << d_myworld->myRank() << "   APSFC\n";
+
+  Timers::Simple timer;
+  timer.start();
+
+  const int num_procs = d_myworld->nRanks();
+  const int my_rank   = d_myworld->myRank();
+  MPI_Comm  comm      = d_myworld->getComm();
+
+  std::vector<std::vector<double> > patch_costs;
+  getCosts(grid.get_rep(), patch_costs);
+
+  int level_offset = 0;
+  for (int l = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    const int num_patches = level->numPatches();
+
+    // this rank's part of the curve
+    std::vector<int> local_order;
+    useDistributedSFC(level, local_order);
+
+    const int local_patches = local_order.size();
+    double local_cost = 0;
+    for (int i = 0; i < local_patches; i++) {
+      local_cost += patch_costs[l][local_order[i]];
+    }
+
+    // cost and patches of the curve before this rank's part, and the total
+    double local_vals[2] = { local_cost, (double)local_patches };
+    double before[2]     = { 0, 0 };
+    double total_cost    = local_cost;
+    if (num_procs > 1) {
+      Uintah::MPI::Exscan(local_vals, before, 2, MPI_DOUBLE, MPI_SUM, comm);
+      Uintah::MPI::Allreduce(&local_cost, &total_cost, 1, MPI_DOUBLE, MPI_SUM, comm);
+      if (my_rank == 0) {
+        before[0] = before[1] = 0;  // undefined after Exscan
+      }
+    }
+    const int first_position = (int)before[1];
+
+    // Each patch goes to the rank whose share of the total cost contains
+    // the patch's midpoint.  Equal costs are used if the costs add up to 0.
+    const bool unit_costs = !(total_cost > 0);
+    double running = unit_costs ? (double)first_position : before[0];
+    if (unit_costs) {
+      total_cost = num_patches;
+    }
+
+    // starts[p] is the curve position of the first patch owned by p or a
+    // higher rank.  Owners grow along the curve, so the starts found on
+    // all ranks combine with a MIN reduction.
+    std::vector<int> starts(num_procs, num_patches);
+    int last_owner = -1;
+    for (int i = 0; i < local_patches; i++) {
+      const double cost = unit_costs ? 1.0 : patch_costs[l][local_order[i]];
+      const int owner   = std::min(num_procs - 1, (int)((running + 0.5 * cost) * num_procs / total_cost));
+      for (int p = last_owner + 1; p <= owner; p++) {
+        starts[p] = first_position + i;
+      }
+      last_owner = std::max(last_owner, owner);
+      running   += cost;
+    }
+
+    // the whole curve, every rank needs the full assignment
+    std::vector<int> order(num_patches);
+    if (num_procs > 1) {
+      std::vector<int> all_starts(num_procs);
+      Uintah::MPI::Allreduce(&starts[0], &all_starts[0], num_procs, MPI_INT, MPI_MIN, comm);
+      starts.swap(all_starts);
+
+      std::vector<int> counts(num_procs);
+      std::vector<int> displs(num_procs, 0);
+      Uintah::MPI::Allgather(&local_patches, 1, MPI_INT, &counts[0], 1, MPI_INT, comm);
+      for (int p = 1; p < num_procs; p++) {
+        displs[p] = displs[p-1] + counts[p-1];
+      }
+      Uintah::MPI::Allgatherv(local_order.data(), local_patches, MPI_INT, &order[0], &counts[0], &displs[0], MPI_INT, comm);
+    }
+    else {
+      order = local_order;
+    }
+
+    int owner = 0;
+    for (int i = 0; i < num_patches; i++) {
+      while (owner + 1 < num_procs && starts[owner + 1] <= i) {
+        owner++;
+      }
+      m_temp_assignment[level_offset + order[i]] = owner;
+    }
+
+    //__________________________________
+    //    debugging output
+    if (stats.active() && my_rank == 0) {
+      std::vector<double> procCosts(num_procs, 0);
+      for (int p = 0; p < num_patches; p++) {
+        procCosts[m_temp_assignment[level_offset + p]] += patch_costs[l][p];
+      }
+      double meanCost = 0;
+      double maxCost  = 0;
+      for (int p = 0; p < num_procs; p++) {
+        meanCost += procCosts[p];
+        maxCost   = std::max(maxCost, procCosts[p]);
+      }
+      meanCost /= num_procs;
+      stats << "SFC LoadBalance Stats level(" << l << "):" << " Mean: " << meanCost << " Max: " << maxCost
+            << " Imbalance: " << 1 - meanCost / maxCost << std::endl;
+    }
+
+    level_offset += num_patches;
+  }
+
+  bool doLoadBalancing = worthLoadBalancing(patch_costs, force);
+
+  if (my_rank == 0) {
+    dbg << " Time to LB: " << timer().seconds() << std::endl;
+  }
+  doing << my_rank << "   APSFC END\n";
+
+  return doLoadBalancing;
+}
+
 //______________________________________________________________________
 //
 bool 
@@ -929,6 +1329,8 @@ void
 DynamicLoadBalancer::getCosts( const Grid * grid, std::vector< std::vector<double> > & costs )
 {
   costs.clear();
+
+  getMigrationData(grid);
     
   std::vector<std::vector<int> > num_particles;
 
@@ -1026,6 +1428,12 @@ DynamicLoadBalancer::possiblyDynamicallyReallocate( const GridP & grid, int stat
         case random_lb :
           dynamicAllocate = assignPatchesRandom(grid, force);
           break;
+        case sfc_lb :
+          dynamicAllocate = assignPatchesSFC(grid, force);
+          break;
+        case diffusion_lb :
+          dynamicAllocate = assignPatchesDiffusion(grid, force);
+          break;
       }
     }
     else  //regridder has called dynamic load balancer so we must dynamically Allocate
@@ -1139,6 +1547,7 @@ DynamicLoadBalancer::problemSetup( ProblemSpecP & pspec, GridP & grid, const Mat
     p->getWithDefault("gainThreshold",    threshold, 0.05);
     p->getWithDefault("doSpaceCurve",     spaceCurve, true);
     p->getWithDefault("hasParticles",     d_collectParticles, false);
+    p->getWithDefault("migrationCost",    d_migrationCost, 0);
     
     std::string costAlgo="ModelLS";
     p->get("costAlgorithm",costAlgo);
@@ -1162,6 +1571,15 @@ DynamicLoadBalancer::problemSetup( ProblemSpecP & pspec, GridP & grid, const Mat
     else if(costAlgo=="Model") {
       d_costForecaster=scinew CostModeler(d_patchCost,d_cellCost,d_extraCellCost,d_particleCost);
     }
+    else if(costAlgo=="TaskModel") {
+      int timeStepWindow;
+      bool perfCounters;
+      p->getWithDefault("profileTimeStepWindow",timeStepWindow,10);
+      p->getWithDefault("perfCounters",perfCounters,false);
+      PerfCounters::enable(perfCounters);
+      d_costForecaster=scinew TaskCostModel(d_myworld,m_scheduler,materialManager.get_rep());
+      d_costForecaster->setTimestepWindow(timeStepWindow);
+    }
     else {
       throw InternalError("Invalid CostAlgorithm in Dynamic Load Balancer\n",__FILE__,__LINE__);
     }
@@ -1183,6 +1601,12 @@ DynamicLoadBalancer::problemSetup( ProblemSpecP & pspec, GridP & grid, const Mat
   else if (dynamicAlgo == "patchFactor") {
     d_dynamicAlgorithm = patch_factor_lb;
   }
+  else if (dynamicAlgo == "sfc") {
+    d_dynamicAlgorithm = sfc_lb;
+  }
+  else if (dynamicAlgo == "diffusion") {
+    d_dynamicAlgorithm = diffusion_lb;
+  }
   else if (dynamicAlgo == "patchFactorParticles" || dynamicAlgo == "particle3") {
     // these are for backward-compatibility
     d_dynamicAlgorithm = patch_factor_lb;
@@ -1190,7 +1614,7 @@ DynamicLoadBalancer::problemSetup( ProblemSpecP & pspec, GridP & grid, const Mat
   }
   else {
     proc0cout << "Invalid Load Balancer Algorithm: " << dynamicAlgo
-              << "\nPlease select 'cyclic', 'random', 'patchFactor' (default), or 'patchFactorParticles'\n"
+              << "\nPlease select 'cyclic', 'random', 'patchFactor' (default), 'patchFactorParticles', 'sfc' or 'diffusion'\n"
               << "\nUsing 'patchFactor' load balancer\n";
     d_dynamicAlgorithm = patch_factor_lb;
   }
@@ -92,6 +92,9 @@ namespace Uintah {
     // Update the contribution for this patch.
     virtual void addContribution( DetailedTask * task ,double cost ) { d_costForecaster->addContribution(task,cost); }
 
+    // Predicted execution time of the task (only the TaskModel cost algorithm has one).
+    virtual double predictContribution( DetailedTask * task ) { return d_costForecaster->predictContribution(task); }
+
     // Finalize the contributions (updates the weight, should be called once per timestep):
     virtual void finalizeContributions( const GridP & currentGrid );
 
@@ -120,7 +123,7 @@ namespace Uintah {
 
     std::vector<IntVector> d_minPatchSize;
     CostForecasterBase * d_costForecaster{nullptr};
-    enum { static_lb, cyclic_lb, random_lb, patch_factor_lb };
+    enum { static_lb, cyclic_lb, random_lb, patch_factor_lb, sfc_lb, diffusion_lb };
 
     DynamicLoadBalancer(const DynamicLoadBalancer&);
     DynamicLoadBalancer& operator=(const DynamicLoadBalancer&);
@@ -131,8 +134,24 @@ namespace Uintah {
     bool assignPatchesFactor(const GridP& grid, bool force);
     bool assignPatchesRandom(const GridP& grid, bool force);
     bool assignPatchesCyclic(const GridP& grid, bool force);
+    bool assignPatchesSFC(const GridP& grid, bool force);
+    bool assignPatchesDiffusion(const GridP& grid, bool force);
+
+    bool thresholdExceeded(const std::vector<std::vector<double> >& patch_costs,
+                           double& max_current, double& max_temp);
+
+    /// Decides if d_tempAssignment is used: it must beat the threshold and the predicted
+    /// gain until the next check must outweigh the cost of migrating the data.  Reports
+    /// the imbalance and the bytes to migrate.
+    bool worthLoadBalancing(const std::vector<std::vector<double> >& patch_costs, bool force);
 
-    bool thresholdExceeded(const std::vector<std::vector<double> >& patch_costs);
+    /// For each patch of the grid, the bytes of patch variables in the old data warehouse
+    /// that lie on it and the rank holding most of them (-1 if none).
+    void getMigrationData(const Grid* grid);
+
+    /// Bytes that d_tempAssignment moves in total and from/to the busiest rank, and the
+    /// bytes this rank sends.
+    void migratedBytes(double& total, double& max_rank, double& my_sent) const;
 
     //Assign costs to a list of patches
     void getCosts(const Grid* grid, std::vector<std::vector<double> >&costs);
@@ -149,6 +168,11 @@ namespace Uintah {
     double d_particleCost;  //cost weight per particle
     double d_patchCost;     //cost weight per patch
     
+    double d_migrationCost{0}; //cost weight per MB migrated from/to the busiest rank
+
+    std::vector<double> d_migrationBytes; //per patch (grid index), see getMigrationData
+    std::vector<int>    d_migrationHome;
+
     int  d_dynamicAlgorithm{patch_factor_lb};
     bool d_collectParticles{false};
   };
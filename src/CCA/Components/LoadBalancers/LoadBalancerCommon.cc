@@ -239,11 +239,11 @@ LoadBalancerCommon::getOldProcessorAssignment( const Patch * patch )
 //______________________________________________________________________
 //
 void
-LoadBalancerCommon::useSFC( const LevelP & level
-                          ,       int    * order
-                          )
+LoadBalancerCommon::generateSFC( const LevelP                        & level
+                               ,       std::vector<DistributedIndex> & indices
+                               ,       std::vector<int>              & originalPatchStart
+                               )
 {
-  std::vector<DistributedIndex> indices; //output
   std::vector<double> positions;
 
   IntVector min_patch_size(INT_MAX,INT_MAX,INT_MAX);  
@@ -293,7 +293,7 @@ LoadBalancerCommon::useSFC( const LevelP & level
 
 #ifdef SFC_PARALLEL
   //compute patch starting locations
-  std::vector<int> originalPatchStart(d_myworld->nRanks(),0);
+  originalPatchStart.assign(d_myworld->nRanks(),0);
   for(int p=1;p<d_myworld->nRanks();p++) {
     originalPatchStart[p]=originalPatchStart[p-1]+originalPatchCount[p-1];
   }
@@ -331,6 +331,19 @@ LoadBalancerCommon::useSFC( const LevelP & level
   m_sfc.SetLocalSize(level->numPatches());
   m_sfc.GenerateCurve(SERIAL);
 #endif
+}
+
+//______________________________________________________________________
+//
+void
+LoadBalancerCommon::useSFC( const LevelP & level
+                          ,       int    * order
+                          )
+{
+  std::vector<DistributedIndex> indices; //output
+  std::vector<int> originalPatchStart;
+
+  generateSFC(level, indices, originalPatchStart);
   
 #ifdef SFC_PARALLEL
   if( d_myworld->nRanks() > 1 ) {
@@ -342,7 +355,8 @@ LoadBalancerCommon::useSFC( const LevelP & level
       if( displs[i] < 0 ) {
         throw InternalError("Displacements < 0",__FILE__,__LINE__);
       }
-      recvcounts[i]=originalPatchCount[i]*sizeof(DistributedIndex);
+      int end = (i+1 < recvcounts.size()) ? originalPatchStart[i+1] : level->numPatches();
+      recvcounts[i]=(end-originalPatchStart[i])*sizeof(DistributedIndex);
       if( recvcounts[i] < 0 ) {
         throw InternalError("Recvcounts < 0",__FILE__,__LINE__);
       }
@@ -395,6 +409,39 @@ LoadBalancerCommon::useSFC( const LevelP & level
 #endif
 }
 
+//______________________________________________________________________
+//
+void
+LoadBalancerCommon::useDistributedSFC( const LevelP           & level
+                                     ,       std::vector<int> & localOrder
+                                     )
+{
+  std::vector<DistributedIndex> indices;
+  std::vector<int> originalPatchStart;
+
+  generateSFC(level, indices, originalPatchStart);
+
+  // The parallel curve leaves each rank with as many entries as it put
+  // in, so the ranks' parts follow each other along the curve.
+  localOrder.resize(indices.size());
+#ifdef SFC_PARALLEL
+  for (unsigned int i = 0; i < indices.size(); i++) {
+    localOrder[i] = originalPatchStart[indices[i].p] + indices[i].i;
+  }
+#else
+  // every rank has the whole curve, keep this rank's share of it
+  const long long num_patches = level->numPatches();
+  const long long num_ranks   = d_myworld->nRanks();
+  const long long rank        = d_myworld->myRank();
+  const int begin = (rank * num_patches) / num_ranks;
+  const int end   = ((rank + 1) * num_patches) / num_ranks;
+  localOrder.resize(end - begin);
+  for (int i = begin; i < end; i++) {
+    localOrder[i - begin] = indices[i].i;
+  }
+#endif
+}
+
 //______________________________________________________________________
 //
 void
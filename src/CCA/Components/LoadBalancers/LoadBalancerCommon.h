@@ -160,6 +160,9 @@ public:
   // Cost profiling functions
   // Update the contribution for this patch.
   virtual void addContribution( DetailedTask * task, double cost );
+
+  // Predicted execution time of the task, 0 if there is no cost model.
+  virtual double predictContribution( DetailedTask * task ) { return 0; }
   
   // Finalize the contributions (updates the weight, should be called once per timestep):
   virtual void finalizeContributions( const GridP & currentGrid );
@@ -214,6 +217,10 @@ protected:
   
   // Calls space-filling curve on level, and stores results in pre-allocated output
   void useSFC( const LevelP & level, int * output) ;
+
+  // Calls space-filling curve on level, and stores only this rank's part of it (level
+  // patch indices in curve order).  The parts of ranks 0, 1, ... make up the whole curve.
+  void useDistributedSFC( const LevelP & level, std::vector<int> & localOrder );
     
   /// Creates a patchset of all patches that have work done on each processor.
   //    - There are two versions of this function.  The first works on a per level
@@ -277,6 +284,9 @@ protected:
   
 private:
 
+  // Generates the curve of the level's patches, this rank's part of it ends up in 'indices'.
+  void generateSFC( const LevelP & level, std::vector<DistributedIndex> & indices, std::vector<int> & originalPatchStart );
+
   // eliminate copy, assignment and move
   LoadBalancerCommon( const LoadBalancerCommon & )            = delete;
   LoadBalancerCommon& operator=( const LoadBalancerCommon & ) = delete;
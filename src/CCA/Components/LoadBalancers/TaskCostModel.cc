@@ -0,0 +1,544 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include <CCA/Components/LoadBalancers/TaskCostModel.h>
+#include <CCA/Components/Schedulers/DetailedTask.h>
+#include <CCA/Ports/DataWarehouse.h>
+#include <CCA/Ports/Scheduler.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/MaterialManager.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Parallel/Parallel.h>
+#include <Core/Parallel/UintahMPI.h>
+#include <Core/Util/DebugStream.h>
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+using namespace Uintah;
+
+namespace {
+  DebugStream g_task_cost_model( "TaskCostModel", "LoadBalancers", "report the predicted against the measured task costs", false );
+
+  // FNV-1a, the same on all ranks
+  uint32_t hashName( const std::string & name )
+  {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : name) {
+      hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+  }
+}
+
+//______________________________________________________________________
+//
+TaskCostModel::TaskCostModel( const ProcessorGroup  * myworld,
+                                    Scheduler       * scheduler,
+                              const MaterialManager * materialManager )
+  : d_myworld(myworld), d_scheduler(scheduler), d_materialManager(materialManager)
+{
+}
+
+//______________________________________________________________________
+//
+TaskCostModel::TaskType &
+TaskCostModel::getType( DetailedTask * dtask )
+{
+  const Task* task = dtask->getTask();
+  const uint32_t key = hashName(task->getName());
+
+  std::map<uint32_t, TaskType>::iterator iter = d_types.find(key);
+  if (iter != d_types.end()) {
+    return iter->second;
+  }
+
+  TaskType& type = d_types[key];
+  type.name      = task->getName();
+  type.materials = dtask->getMaterials() ? dtask->getMaterials()->size() : 0;
+  for (const Task::Dependency* req = task->getRequires(); req != nullptr; req = req->m_next) {
+    type.ghost = std::max(type.ghost, req->m_num_ghost_cells);
+  }
+  return type;
+}
+
+//______________________________________________________________________
+//
+int
+TaskCostModel::getParticles( const Patch * patch )
+{
+  std::map<const Patch*, int>::iterator iter = d_particles.find(patch);
+  if (iter != d_particles.end()) {
+    return iter->second;
+  }
+
+  int particles = 0;
+  DataWarehouse* dw = d_scheduler->get_dw(0);
+  if (dw) {
+    for (unsigned int m = 0; m < d_materialManager->getNumMatls(); m++) {
+      if (dw->haveParticleSubset(m, patch)) {
+        particles += dw->getParticleSubset(m, patch)->numParticles();
+      }
+    }
+  }
+  d_particles[patch] = particles;
+  return particles;
+}
+
+//______________________________________________________________________
+//
+void
+TaskCostModel::getFeatures( const Patch * patch, int particles, const TaskType & type, double x[NumFeatures] ) const
+{
+  const IntVector n = patch->getCellHighIndex() - patch->getCellLowIndex();
+  const int       g = type.ghost;
+
+  x[Constant]   = 1;
+  x[Cells]      = patch->getNumCells();
+  x[Particles]  = particles;
+  x[Materials]  = type.materials;
+  x[GhostCells] = (double)(n.x() + 2 * g) * (n.y() + 2 * g) * (n.z() + 2 * g) - x[Cells];
+  x[AMRLevel]   = patch->getLevel()->getIndex();
+}
+
+//______________________________________________________________________
+//
+double
+TaskCostModel::predict( const TaskType & type, int target, const double x[NumFeatures] ) const
+{
+  double y = 0;
+  for (int i = 0; i < NumFeatures; i++) {
+    y += type.coefs[target][i] * x[i];
+  }
+  return std::max(y, 0.0);
+}
+
+//______________________________________________________________________
+//
+double
+TaskCostModel::predictTime( const TaskType & type, const double x[NumFeatures] ) const
+{
+  // x[Constant] is 1, so Xty[.][Constant] holds the (weighted) sums of the measurements
+  if (PerfCounters::isEnabled() && type.Xty[Cycles][Constant] > 0) {
+    return predict(type, Cycles, x) * type.Xty[Time][Constant] / type.Xty[Cycles][Constant];
+  }
+  return predict(type, Time, x);
+}
+
+//______________________________________________________________________
+//
+void
+TaskCostModel::addContribution( DetailedTask * dtask, double cost )
+{
+  const PatchSubset* patches = dtask->getPatches();
+  if (patches == nullptr || patches->size() == 0) {
+    return;
+  }
+
+  TaskType& type = getType(dtask);
+
+  const uint64_t* counts = dtask->getPerfCounts();
+  const double y[NumTargets] = { cost, (double)counts[PerfCounters::Cycles], (double)counts[PerfCounters::LLCMisses] };
+
+  // split the measurements over the patches by cells
+  double num_cells = 0;
+  for (int p = 0; p < patches->size(); p++) {
+    num_cells += patches->get(p)->getNumExtraCells();
+  }
+
+  for (int p = 0; p < patches->size(); p++) {
+    const Patch* patch = patches->get(p);
+    const double fraction = patch->getNumExtraCells() / num_cells;
+
+    double x[NumFeatures];
+    getFeatures(patch, getParticles(patch), type, x);
+
+    for (int i = 0; i < NumFeatures; i++) {
+      for (int j = 0; j < NumFeatures; j++) {
+        type.xtx[i][j] += x[i] * x[j];
+      }
+    }
+
+    for (int t = 0; t < NumTargets; t++) {
+      const double measured = fraction * y[t];
+      for (int i = 0; i < NumFeatures; i++) {
+        type.xty[t][i] += measured * x[i];
+      }
+      type.measured[t] += measured;
+
+      if (type.fitted) {
+        const double predicted = (t == Time) ? predictTime(type, x) : predict(type, t, x);
+        type.predicted[t] += predicted;
+        type.error[t]     += std::fabs(predicted - measured);
+      }
+    }
+
+    const int level = patch->getLevel()->getIndex();
+    if ((int)type.samples.size() <= level) {
+      type.samples.resize(level + 1, 0);
+    }
+    type.samples[level] += 1;
+  }
+}
+
+//______________________________________________________________________
+//
+double
+TaskCostModel::predictContribution( DetailedTask * dtask )
+{
+  const PatchSubset* patches = dtask->getPatches();
+  if (patches == nullptr) {
+    return 0;
+  }
+
+  std::map<uint32_t, TaskType>::const_iterator iter = d_types.find(hashName(dtask->getTask()->getName()));
+  if (iter == d_types.end() || !iter->second.fitted) {
+    return 0;
+  }
+
+  double cost = 0;
+  for (int p = 0; p < patches->size(); p++) {
+    double x[NumFeatures];
+    getFeatures(patches->get(p), getParticles(patches->get(p)), iter->second, x);
+    cost += predictTime(iter->second, x);
+  }
+  return cost;
+}
+
+//______________________________________________________________________
+//
+void
+TaskCostModel::fit( TaskType & type )
+{
+  // Normal equations with a small ridge relative to the diagonal (the
+  // materials and the level are usually constant for a task type, which
+  // makes them collinear with the constant), solved by Cholesky.
+  double L[NumFeatures][NumFeatures];
+  for (int i = 0; i < NumFeatures; i++) {
+    for (int j = 0; j < NumFeatures; j++) {
+      L[i][j] = type.XtX[i][j];
+    }
+    L[i][i] = (L[i][i] > 0) ? L[i][i] * (1 + 1.e-6) : 1;
+  }
+
+  for (int k = 0; k < NumFeatures; k++) {
+    double sum = L[k][k];
+    for (int s = 0; s < k; s++) {
+      sum -= L[k][s] * L[k][s];
+    }
+    if (sum <= 0) {
+      // numerically singular, fall back to the mean
+      for (int t = 0; t < NumTargets; t++) {
+        std::memset(type.coefs[t], 0, sizeof(type.coefs[t]));
+        type.coefs[t][Constant] = type.Xty[t][Constant] / type.XtX[Constant][Constant];
+      }
+      type.fitted = true;
+      return;
+    }
+    L[k][k] = std::sqrt(sum);
+    for (int i = k + 1; i < NumFeatures; i++) {
+      double value = L[i][k];
+      for (int s = 0; s < k; s++) {
+        value -= L[i][s] * L[k][s];
+      }
+      L[i][k] = value / L[k][k];
+    }
+  }
+
+  for (int t = 0; t < NumTargets; t++) {
+    double z[NumFeatures];
+    for (int i = 0; i < NumFeatures; i++) {
+      double sum = type.Xty[t][i];
+      for (int j = 0; j < i; j++) {
+        sum -= L[i][j] * z[j];
+      }
+      z[i] = sum / L[i][i];
+    }
+    for (int i = NumFeatures - 1; i >= 0; i--) {
+      double sum = z[i];
+      for (int j = i + 1; j < NumFeatures; j++) {
+        sum -= L[j][i] * type.coefs[t][j];
+      }
+      type.coefs[t][i] = sum / L[i][i];
+    }
+  }
+  type.fitted = true;
+}
+
+//______________________________________________________________________
+//
+void
+TaskCostModel::finalizeContributions( const GridP currentGrid )
+{
+  const int num_levels = currentGrid->numLevels();
+  MPI_Comm  comm       = d_myworld->getComm();
+
+  //__________________________________
+  // make the task types known on all ranks
+  if (d_myworld->nRanks() > 1) {
+    std::string buffer;
+    for (std::map<uint32_t, TaskType>::iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+      if (iter->second.isNew) {
+        const int header[3] = { (int)iter->first, iter->second.materials, iter->second.ghost };
+        buffer.append((const char*)header, sizeof(header));
+        buffer.append(iter->second.name.c_str(), iter->second.name.size() + 1);
+      }
+    }
+
+    const int size = buffer.size();
+    std::vector<int> sizes(d_myworld->nRanks());
+    Uintah::MPI::Allgather(&size, 1, MPI_INT, &sizes[0], 1, MPI_INT, comm);
+
+    std::vector<int> displs(d_myworld->nRanks(), 0);
+    for (int i = 1; i < d_myworld->nRanks(); i++) {
+      displs[i] = displs[i-1] + sizes[i-1];
+    }
+    const int total = displs.back() + sizes.back();
+
+    if (total > 0) {
+      std::vector<char> all(total);
+      Uintah::MPI::Allgatherv(buffer.data(), size, MPI_CHAR, &all[0], &sizes[0], &displs[0], MPI_CHAR, comm);
+
+      for (int pos = 0; pos < total; ) {
+        int header[3];
+        std::memcpy(header, &all[pos], sizeof(header));
+        pos += sizeof(header);
+        const std::string name(&all[pos]);
+        pos += name.size() + 1;
+
+        TaskType& type = d_types[(uint32_t)header[0]];
+        if (type.name.empty()) {
+          type.name      = name;
+          type.materials = header[1];
+          type.ghost     = header[2];
+        }
+      }
+    }
+  }
+  for (std::map<uint32_t, TaskType>::iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+    iter->second.isNew = false;
+  }
+
+  //__________________________________
+  // sum up this timestep's samples of all ranks
+  const int per_type = NumFeatures * NumFeatures + NumTargets * NumFeatures + num_levels + 3 * NumTargets;
+  std::vector<double> sums(per_type * d_types.size(), 0);
+
+  double* pos = sums.data();
+  for (std::map<uint32_t, TaskType>::iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+    TaskType& type = iter->second;
+    type.samples.resize(num_levels, 0);
+
+    pos = std::copy(&type.xtx[0][0], &type.xtx[0][0] + NumFeatures * NumFeatures, pos);
+    pos = std::copy(&type.xty[0][0], &type.xty[0][0] + NumTargets * NumFeatures, pos);
+    pos = std::copy(type.samples.begin(), type.samples.end(), pos);
+    pos = std::copy(type.measured, type.measured + NumTargets, pos);
+    pos = std::copy(type.predicted, type.predicted + NumTargets, pos);
+    pos = std::copy(type.error, type.error + NumTargets, pos);
+  }
+
+  if (d_myworld->nRanks() > 1 && !sums.empty()) {
+    std::vector<double> local(sums);
+    Uintah::MPI::Allreduce(local.data(), sums.data(), sums.size(), MPI_DOUBLE, MPI_SUM, comm);
+  }
+
+  pos = sums.data();
+  for (std::map<uint32_t, TaskType>::iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+    TaskType& type = iter->second;
+
+    std::copy(pos, pos + NumFeatures * NumFeatures, &type.xtx[0][0]);
+    pos += NumFeatures * NumFeatures;
+    std::copy(pos, pos + NumTargets * NumFeatures, &type.xty[0][0]);
+    pos += NumTargets * NumFeatures;
+    std::copy(pos, pos + num_levels, type.samples.begin());
+    pos += num_levels;
+    std::copy(pos, pos + NumTargets, type.measured);
+    pos += NumTargets;
+    std::copy(pos, pos + NumTargets, type.predicted);
+    pos += NumTargets;
+    std::copy(pos, pos + NumTargets, type.error);
+    pos += NumTargets;
+  }
+
+  if (g_task_cost_model.active() && d_myworld->myRank() == 0) {
+    report();
+  }
+
+  //__________________________________
+  // fold the timestep into the models, after d_timestepWindow timesteps
+  // a sample has 1% of its weight left
+  const double decay = std::pow(0.01, 1.0 / std::max(d_timestepWindow, 1));
+
+  for (std::map<uint32_t, TaskType>::iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+    TaskType& type = iter->second;
+
+    for (int i = 0; i < NumFeatures; i++) {
+      for (int j = 0; j < NumFeatures; j++) {
+        type.XtX[i][j] = decay * type.XtX[i][j] + type.xtx[i][j];
+      }
+    }
+    for (int t = 0; t < NumTargets; t++) {
+      for (int i = 0; i < NumFeatures; i++) {
+        type.Xty[t][i] = decay * type.Xty[t][i] + type.xty[t][i];
+      }
+    }
+
+    const bool had_rate = !type.rate.empty();
+    type.rate.resize(num_levels, 0);
+    for (int l = 0; l < num_levels; l++) {
+      const double rate = type.samples[l] / currentGrid->getLevel(l)->numPatches();
+      type.rate[l] = had_rate ? decay * type.rate[l] + (1 - decay) * rate : rate;
+    }
+
+    if (type.XtX[Constant][Constant] > 0) {
+      fit(type);
+      d_hasData = true;
+    }
+
+    std::memset(type.xtx, 0, sizeof(type.xtx));
+    std::memset(type.xty, 0, sizeof(type.xty));
+    std::memset(type.measured, 0, sizeof(type.measured));
+    std::memset(type.predicted, 0, sizeof(type.predicted));
+    std::memset(type.error, 0, sizeof(type.error));
+    type.samples.assign(num_levels, 0);
+  }
+
+  d_particles.clear();
+
+  static bool warned = false;
+  if (PerfCounters::isEnabled() && !PerfCounters::available() && !warned) {
+    proc0cout << "Warning: TaskCostModel could not open the hardware counters (perf_event_open), "
+              << "using the wall times only.\n";
+    warned = true;
+  }
+}
+
+//______________________________________________________________________
+//
+void
+TaskCostModel::report() const
+{
+  const bool counters = PerfCounters::isEnabled() && PerfCounters::available();
+
+  double measured  = 0;
+  double predicted = 0;
+  double error     = 0;
+
+  std::ostringstream out;
+  out << "TaskCostModel: predicted vs. measured task times (s), all ranks\n";
+  out << std::left << std::setw(50) << "  task" << std::right
+      << std::setw(12) << "measured" << std::setw(12) << "predicted" << std::setw(10) << "error";
+  if (counters) {
+    out << std::setw(10) << "cycles" << std::setw(10) << "LLC";
+  }
+  out << "\n";
+
+  for (std::map<uint32_t, TaskType>::const_iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+    const TaskType& type = iter->second;
+    if (type.measured[Time] <= 0 || !type.fitted) {
+      continue;
+    }
+    measured  += type.measured[Time];
+    predicted += type.predicted[Time];
+    error     += type.error[Time];
+
+    // error: sum of the absolute errors of the samples relative to the measured sum
+    out << "  " << std::left << std::setw(48) << type.name << std::right
+        << std::setw(12) << type.measured[Time] << std::setw(12) << type.predicted[Time]
+        << std::setw(9) << std::setprecision(3) << 100 * type.error[Time] / type.measured[Time] << "%";
+    if (counters) {
+      for (int t = Cycles; t < NumTargets; t++) {
+        if (type.measured[t] > 0) {
+          out << std::setw(9) << 100 * type.error[t] / type.measured[t] << "%";
+        }
+        else {
+          out << std::setw(10) << "-";
+        }
+      }
+    }
+    out << std::setprecision(6) << "\n";
+  }
+
+  if (measured > 0) {
+    out << "  " << std::left << std::setw(48) << "total" << std::right
+        << std::setw(12) << measured << std::setw(12) << predicted
+        << std::setw(9) << std::setprecision(3) << 100 * error / measured << "%\n";
+  }
+
+  g_task_cost_model << out.str() << std::flush;
+}
+
+//______________________________________________________________________
+//
+void
+TaskCostModel::getWeights( const Grid                          * grid,
+                                 std::vector<std::vector<int> >  num_particles,
+                                 std::vector<std::vector<double> > & costs )
+{
+  // seconds per cell over all samples, for patches no task type has a rate for
+  double time = 0;
+  double cells = 0;
+  for (std::map<uint32_t, TaskType>::const_iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+    time  += iter->second.Xty[Time][Constant];
+    cells += iter->second.XtX[Constant][Cells];
+  }
+  const double time_per_cell = (cells > 0) ? time / cells : 1;
+
+  costs.resize(grid->numLevels());
+  for (int l = 0; l < grid->numLevels(); l++) {
+    const LevelP& level = grid->getLevel(l);
+    costs[l].assign(level->numPatches(), 0);
+
+    for (int p = 0; p < level->numPatches(); p++) {
+      const Patch* patch = level->getPatch(p);
+      const int particles = (l < (int)num_particles.size() && p < (int)num_particles[l].size()) ? num_particles[l][p] : 0;
+
+      double cost = 0;
+      for (std::map<uint32_t, TaskType>::const_iterator iter = d_types.begin(); iter != d_types.end(); iter++) {
+        const TaskType& type = iter->second;
+        if (!type.fitted || l >= (int)type.rate.size() || type.rate[l] <= 0) {
+          continue;
+        }
+        double x[NumFeatures];
+        getFeatures(patch, particles, type, x);
+        cost += type.rate[l] * predictTime(type, x);
+      }
+
+      costs[l][p] = (cost > 0) ? cost : patch->getNumCells() * time_per_cell;
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+void
+TaskCostModel::reset()
+{
+  d_types.clear();
+  d_particles.clear();
+  d_hasData = false;
+}
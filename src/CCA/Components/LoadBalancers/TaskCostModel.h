@@ -0,0 +1,176 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef UINTAH_HOMEBREW_TaskCostModel_H
+#define UINTAH_HOMEBREW_TaskCostModel_H
+
+#include <CCA/Components/LoadBalancers/CostForecasterBase.h>
+#include <Core/Grid/Grid.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Parallel/ProcessorGroup.h>
+#include <Core/Util/PerfCounters.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Uintah {
+
+  class DetailedTask;
+  class MaterialManager;
+  class Scheduler;
+
+   /**************************************
+     
+     CLASS
+       TaskCostModel 
+      
+       Learns the execution cost of each task type online and predicts
+       the cost of patches and tasks from it.
+       
+     GENERAL INFORMATION
+      
+       TaskCostModel.h
+      
+     KEYWORDS
+       TaskCostModel
+       DynamicLoadBalancer
+      
+     DESCRIPTION
+       Every execution of a task (split over its patches by cells) is a
+       sample of a linear model of the task type (task name):
+
+         cost = c0 + c1*cells + c2*particles + c3*materials
+                   + c4*ghost cells + c5*AMR level
+
+       fitted by least squares to the wall time and, if PerfCounters are
+       enabled, to the cycles and the last level cache misses.  The
+       samples of all ranks are combined at the end of every timestep and
+       older timesteps are weighted down exponentially (setTimestepWindow),
+       so every rank has the same model.
+
+       With counters the predicted time is the predicted cycles times the
+       task type's measured seconds per cycle, which is less disturbed by
+       noise in the wall times.
+
+       The model is used by the DLB (<costAlgorithm>TaskModel</costAlgorithm>):
+       the cost of a patch is the sum over the task types that run on its
+       level.  The schedulers' PredictedCost QueueAlg uses
+       predictContribution.  The debug stream TaskCostModel reports the
+       predicted against the measured costs of every timestep.
+
+     WARNING
+      
+     ****************************************/
+
+  class TaskCostModel : public CostForecasterBase {
+    public:
+
+      enum Feature {
+          Constant = 0
+        , Cells
+        , Particles
+        , Materials
+        , GhostCells
+        , AMRLevel
+        , NumFeatures
+      };
+
+      enum Target {
+          Time = 0
+        , Cycles
+        , LLCMisses
+        , NumTargets
+      };
+
+      TaskCostModel( const ProcessorGroup * myworld, Scheduler * scheduler, const MaterialManager * materialManager );
+
+      void addContribution( DetailedTask * task, double cost );
+
+      double predictContribution( DetailedTask * task );
+
+      //combine the samples of all ranks and refit the models
+      void finalizeContributions( const GridP currentGrid );
+
+      void getWeights( const Grid * grid, std::vector<std::vector<int> > num_particles, std::vector<std::vector<double> > & costs );
+
+      void setTimestepWindow( int window ) { d_timestepWindow = window; }
+
+      void reset();
+
+      bool hasData() { return d_hasData; }
+
+    private:
+
+      struct TaskType {
+        std::string name;
+        int         materials{0};
+        int         ghost{0};       //most ghost cells of any of the task's requires
+        bool        isNew{true};    //not yet known on the other ranks
+
+        //this timestep's local samples
+        double              xtx[NumFeatures][NumFeatures]{};
+        double              xty[NumTargets][NumFeatures]{};
+        std::vector<double> samples;          //per level
+        double              measured[NumTargets]{};
+        double              predicted[NumTargets]{};
+        double              error[NumTargets]{};
+
+        //the model, the same on all ranks
+        double              XtX[NumFeatures][NumFeatures]{};
+        double              Xty[NumTargets][NumFeatures]{};
+        double              coefs[NumTargets][NumFeatures]{};
+        std::vector<double> rate;             //samples per patch and timestep, per level
+        bool                fitted{false};
+      };
+
+      TaskType & getType( DetailedTask * task );
+
+      int getParticles( const Patch * patch );
+
+      void getFeatures( const Patch * patch, int particles, const TaskType & type, double x[NumFeatures] ) const;
+
+      double predict( const TaskType & type, int target, const double x[NumFeatures] ) const;
+
+      double predictTime( const TaskType & type, const double x[NumFeatures] ) const;
+
+      void fit( TaskType & type );
+
+      void report() const;
+
+      const ProcessorGroup        * d_myworld;
+      Scheduler                   * d_scheduler;
+      const MaterialManager       * d_materialManager;
+      int                           d_timestepWindow{10};
+      bool                          d_hasData{false};
+      std::map<uint32_t, TaskType>  d_types;       //by hash of the task name
+      std::map<const Patch*, int>   d_particles;   //per patch, this timestep
+  };
+
+} // End namespace Uintah
+
+
+#endif
@@ -40,6 +40,7 @@ SRCS += \
 	$(SRCDIR)/CostProfiler.cc             \
 	$(SRCDIR)/ProfileDriver.cc            \
 	$(SRCDIR)/CostModelForecaster.cc      \
+	$(SRCDIR)/TaskCostModel.cc            \
 	$(SRCDIR)/ParticleLoadBalancer.cc
 
 
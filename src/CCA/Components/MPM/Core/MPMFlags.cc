@@ -25,6 +25,7 @@
 #include <CCA/Ports/Output.h>
 
 #include <CCA/Components/MPM/Core/MPMFlags.h>
+#include <CCA/Components/MPM/Core/ParticleSort.h>
 #include <Core/Exceptions/ProblemSetupException.h>
 #include <Core/Grid/LinearInterpolator.h>
 #include <Core/Grid/AxiLinearInterpolator.h>
@@ -73,6 +74,10 @@ MPMFlags::MPMFlags(const ProcessorGroup* myworld)
   d_doThermalExpansion            =  true;
   d_refineParticles               =  false;
   d_XPIC2                         =  false;
+  d_parallelParticleLoops         =  false;
+  d_particleSortInterval          =  0;
+  d_particleSortCurve             =  "morton";
+  d_batchStressUpdate             =  false;
   d_artificialDampCoeff           =  0.0;
   d_interpolator                  =  scinew LinearInterpolator();
   d_do_contact_friction           =  false;
@@ -197,6 +202,10 @@ MPMFlags::readMPMFlags(ProblemSpecP& ps, Output* dataArchive)
   mpm_flag_ps->get("artificial_viscosity",     d_artificial_viscosity);
   mpm_flag_ps->get("refine_particles",         d_refineParticles);
   mpm_flag_ps->get("XPIC2",                    d_XPIC2);
+  mpm_flag_ps->get("parallel_particle_loops",  d_parallelParticleLoops);
+  mpm_flag_ps->get("particle_sort_interval",   d_particleSortInterval);
+  mpm_flag_ps->get("particle_sort_curve",      d_particleSortCurve);
+  mpm_flag_ps->get("batch_stress_update",      d_batchStressUpdate);
   if(d_artificial_viscosity){
     d_artificial_viscosity_heating=true;
   }
@@ -222,6 +231,10 @@ MPMFlags::readMPMFlags(ProblemSpecP& ps, Output* dataArchive)
     throw ProblemSetupException(warn.str(), __FILE__, __LINE__ );
   }
 
+  if(d_particleSortInterval > 0){
+    ParticleSort::getCurve(d_particleSortCurve);  // throws if unknown
+  }
+
   mpm_flag_ps->get("DoImplicitHeatConduction",          d_doImplicitHeatConduction);
   mpm_flag_ps->get("DoTransientImplicitHeatConduction", d_doTransientImplicitHeatConduction);
   mpm_flag_ps->get("DoExplicitHeatConduction",          d_doExplicitHeatConduction);
@@ -377,6 +390,10 @@ else{
     dbg << " Artificial Viscosity Coeff2 = " << d_artificialViscCoeff2<< endl;
     dbg << " RefineParticles             = " << d_refineParticles << endl;
     dbg << " XPIC2                       = " << d_XPIC2 << endl;
+    dbg << " Parallel particle loops     = " << d_parallelParticleLoops << endl;
+    dbg << " Particle sort interval      = " << d_particleSortInterval << endl;
+    dbg << " Particle sort curve         = " << d_particleSortCurve << endl;
+    dbg << " Batch stress update         = " << d_batchStressUpdate << endl;
     dbg << " Use Load Curves             = " << d_useLoadCurves << endl;
     dbg << " Use CBDI boundary condition = " << d_useCBDI << endl;
     dbg << " Use Cohesive Zones          = " << d_useCohesiveZones << endl;
@@ -406,6 +423,10 @@ MPMFlags::outputProblemSpec(ProblemSpecP& ps)
   ps->appendElement("artificial_viscosity_coeff2",        d_artificialViscCoeff2);
   ps->appendElement("refine_particles",                   d_refineParticles);
   ps->appendElement("XPIC2",                              d_XPIC2);
+  ps->appendElement("parallel_particle_loops",            d_parallelParticleLoops);
+  ps->appendElement("particle_sort_interval",             d_particleSortInterval);
+  ps->appendElement("particle_sort_curve",                d_particleSortCurve);
+  ps->appendElement("batch_stress_update",                d_batchStressUpdate);
   ps->appendElement("use_cohesive_zones",                 d_useCohesiveZones);
   ps->appendElement("use_load_curves",                    d_useLoadCurves);
   ps->appendElement("use_CBDI_boundary_condition",        d_useCBDI);
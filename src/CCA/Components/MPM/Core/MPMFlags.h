@@ -86,6 +86,10 @@ class Output;
     bool        doMPMOnLevel(int level, int numLevels) const;
     bool        d_refineParticles;                             // Refine particles, step toward AMR
     bool        d_XPIC2;                                       // Use Nairn's XPIC2 algorithm
+    bool        d_parallelParticleLoops;                       // Thread the particle loops within a patch (ParticleSlabs)
+    int         d_particleSortInterval;                        // Sort the particles by cell every N timesteps, 0 = never (ParticleSort)
+    std::string d_particleSortCurve;                           // Space-filling curve of the sort, morton or hilbert
+    bool        d_batchStressUpdate;                           // Update the stress of several particles at once, where the model supports it (BatchStress)
 
     double      d_artificialDampCoeff;
     double      d_artificialViscCoeff1;                        // Artificial viscosity coefficient 1
@@ -0,0 +1,184 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include <CCA/Components/MPM/Core/ParticleSlabs.h>
+
+#include <Core/Grid/Level.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Parallel/LoopThreadPool.h>
+
+#include <algorithm>
+#include <climits>
+
+using namespace Uintah;
+
+//______________________________________________________________________
+//
+std::vector<ParticleSlabs::Scratch>
+ParticleSlabs::makeScratch( ParticleInterpolator * interpolator
+                          , const Patch          * patch
+                          , bool                   parallel
+                          )
+{
+  const int slots = parallel ? LoopThreadPool::getNumThreads() : 1;
+
+  std::vector<Scratch> scratch( slots );
+  for( Scratch & s : scratch ) {
+    s.interpolator.reset( interpolator->clone( patch ) );
+    s.ni.resize( s.interpolator->size() );
+    s.S.resize( s.interpolator->size() );
+    s.d_S.resize( s.interpolator->size() );
+  }
+  return scratch;
+}
+
+//______________________________________________________________________
+//
+ParticleSlabs::ParticleSlabs( const Patch                        * patch
+                            ,       ParticleSubset               * pset
+                            , const constParticleVariable<Point> & px
+                            ,       bool                           parallel
+                            )
+  : m_parallel( parallel )
+  , m_pset( pset )
+{
+  const int slots = parallel ? LoopThreadPool::getNumThreads() : 1;
+  m_slot_low.assign( slots, INT_MIN );
+  m_slot_high.assign( slots, INT_MAX );
+
+  const int nParticles = pset->numParticles();
+
+  if( !parallel || nParticles == 0 ) {
+    m_offsets = { 0, nParticles };
+    return;
+  }
+
+  //__________________________________
+  // The slabs go along the longest axis of the particles' cells
+  // (the subset may include ghost particles outside the patch).
+  const Level* level = patch->getLevel();
+
+  std::vector<IntVector> cells( nParticles );
+  IntVector low(  INT_MAX, INT_MAX, INT_MAX );
+  IntVector high( INT_MIN, INT_MIN, INT_MIN );
+  for( int i = 0; i < nParticles; i++ ) {
+    cells[i] = level->getCellIndex( px[ *( pset->begin() + i ) ] );
+    low  = Min( low,  cells[i] );
+    high = Max( high, cells[i] );
+  }
+
+  const IntVector extent = high - low;
+  m_axis = 0;
+  for( int d = 1; d < 3; d++ ) {
+    if( extent[d] > extent[m_axis] ) {
+      m_axis = d;
+    }
+  }
+  m_low = low[m_axis];
+
+  //__________________________________
+  // Counting sort by slab, keeping the subset order within a slab.
+  const int slabs = extent[m_axis] / s_width + 1;
+  m_offsets.assign( slabs + 1, 0 );
+  for( int i = 0; i < nParticles; i++ ) {
+    m_offsets[ ( cells[i][m_axis] - m_low ) / s_width + 1 ]++;
+  }
+  for( int s = 0; s < slabs; s++ ) {
+    m_offsets[s + 1] += m_offsets[s];
+  }
+
+  std::vector<int> next( m_offsets.begin(), m_offsets.end() - 1 );
+  m_particles.resize( nParticles );
+  for( int i = 0; i < nParticles; i++ ) {
+    m_particles[ next[ ( cells[i][m_axis] - m_low ) / s_width ]++ ] = *( pset->begin() + i );
+  }
+}
+
+//______________________________________________________________________
+//
+void
+ParticleSlabs::setSlot( int slot, int slab )
+{
+  m_slot_low[slot]  = m_low + slab * s_width - s_width / 2;
+  m_slot_high[slot] = m_low + ( slab + 1 ) * s_width + s_width / 2;
+}
+
+//______________________________________________________________________
+//
+void
+ParticleSlabs::scatter( const std::function<bool(particleIndex, int)> & body )
+{
+  if( !m_parallel ) {
+    for( ParticleSubset::iterator iter = m_pset->begin(); iter != m_pset->end(); iter++ ) {
+      body( *iter, 0 );
+    }
+    return;
+  }
+
+  const int slabs = numSlabs();
+  std::vector<std::vector<particleIndex> > deferred( slabs );
+
+  for( int color = 0; color < 2; color++ ) {
+    LoopThreadPool::run( ( slabs - color + 1 ) / 2, [&]( int block, int slot ) {
+        const int slab = 2 * block + color;
+        setSlot( slot, slab );
+
+        for( int i = m_offsets[slab]; i < m_offsets[slab + 1]; i++ ) {
+          if( !body( m_particles[i], slot ) ) {
+            deferred[slab].push_back( m_particles[i] );
+          }
+        }
+      } );
+  }
+
+  // the particles reaching beyond their slab, serially
+  m_slot_low[0]  = INT_MIN;
+  m_slot_high[0] = INT_MAX;
+  for( int slab = 0; slab < slabs; slab++ ) {
+    for( particleIndex idx : deferred[slab] ) {
+      body( idx, 0 );
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+void
+ParticleSlabs::gather( const std::function<void(particleIndex, int, int)> & body )
+{
+  if( !m_parallel ) {
+    for( ParticleSubset::iterator iter = m_pset->begin(); iter != m_pset->end(); iter++ ) {
+      body( *iter, 0, 0 );
+    }
+    return;
+  }
+
+  LoopThreadPool::run( numSlabs(), [&]( int slab, int slot ) {
+      for( int i = m_offsets[slab]; i < m_offsets[slab + 1]; i++ ) {
+        body( m_particles[i], slot, slab );
+      }
+    } );
+}
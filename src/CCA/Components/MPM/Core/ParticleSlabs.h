@@ -0,0 +1,141 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef UINTAH_MPM_PARTICLESLABS_H
+#define UINTAH_MPM_PARTICLESLABS_H
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Grid/ParticleInterpolator.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Uintah {
+
+  class Patch;
+
+/**************************************
+
+  CLASS
+    ParticleSlabs
+
+  GENERAL INFORMATION
+    ParticleSlabs.h
+
+  DESCRIPTION
+    Runs the particle loops of one patch and material on the threads of
+    the LoopThreadPool (<parallel_particle_loops>).
+
+    The particles are binned into slabs of s_width cells along the
+    longest axis of their bounding box.  A particle of a slab may write
+    the nodes within s_width/2 cells of the slab, so slabs two apart
+    never write the same node:
+
+      scatter() - particle to grid loops.  The even slabs run in
+                  parallel, then the odd ones.  A particle whose nodes
+                  are not owned by its slab (owns(), e.g. a large CPDI
+                  particle) is deferred and scattered serially at the
+                  end.
+      gather()  - grid to particle loops, all slabs in parallel.  The
+                  slab index lets the caller keep partial reductions
+                  per slab and add them in slab order.
+
+    Within a slab the particles are visited in subset order, so the
+    results do not depend on the number of threads.  When not parallel
+    there is one slab holding the subset, visited in order on the
+    calling thread, which is exactly the serial loop.
+
+****************************************/
+
+  class ParticleSlabs {
+
+  public:
+
+    // Interpolation scratch of one thread.
+    struct Scratch {
+      std::unique_ptr<ParticleInterpolator> interpolator;
+      std::vector<IntVector>                ni;
+      std::vector<double>                   S;
+      std::vector<Vector>                   d_S;
+    };
+
+    // One Scratch (with a clone of 'interpolator') per thread that may run
+    // the loops of 'patch', indexed by the slot passed to the loop bodies.
+    static std::vector<Scratch> makeScratch( ParticleInterpolator * interpolator
+                                           , const Patch          * patch
+                                           , bool                   parallel
+                                           );
+
+    ParticleSlabs( const Patch                        * patch
+                 ,       ParticleSubset               * pset
+                 , const constParticleVariable<Point> & px
+                 ,       bool                           parallel
+                 );
+
+    int numSlabs() const { return m_offsets.size() - 1; }
+
+    // Calls body(idx, slot) for every particle.  The body returns false,
+    // before writing anything, if owns() is false for its nodes.
+    void scatter( const std::function<bool(particleIndex, int)> & body );
+
+    // True if the thread in 'slot' may write the nodes ni[0, NN) in the
+    // current scatter().
+    bool owns( int slot, const std::vector<IntVector> & ni, int NN ) const
+    {
+      for( int k = 0; k < NN; k++ ) {
+        const int i = ni[k][m_axis];
+        if( i < m_slot_low[slot] || i >= m_slot_high[slot] ) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Calls body(idx, slot, slab) for every particle.
+    void gather( const std::function<void(particleIndex, int, int)> & body );
+
+    // Cells per slab; particles reach at most s_width/2 cells beyond.
+    static const int s_width = 4;
+
+  private:
+
+    void setSlot( int slot, int slab );
+
+    bool                       m_parallel;
+    ParticleSubset           * m_pset;
+    int                        m_axis{0};
+    int                        m_low{0};        // first cell of slab 0 along m_axis
+    std::vector<int>           m_offsets;       // slab s holds m_particles[m_offsets[s], m_offsets[s+1])
+    std::vector<particleIndex> m_particles;     // only when parallel
+    std::vector<int>           m_slot_low;      // nodes owned by the slab a slot works on
+    std::vector<int>           m_slot_high;
+  };
+
+} // End namespace Uintah
+
+#endif // UINTAH_MPM_PARTICLESLABS_H
@@ -0,0 +1,195 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include <CCA/Components/MPM/Core/ParticleSort.h>
+
+#include <Core/Exceptions/ProblemSetupException.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Malloc/Allocator.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace Uintah;
+
+namespace {
+
+  //______________________________________________________________________
+  // Spreads the low 21 bits of v to every third bit.
+  inline uint64_t
+  spreadBits( uint64_t v )
+  {
+    v &= 0x1fffff;
+    v = ( v | v << 32 ) & 0x1f00000000ffffULL;
+    v = ( v | v << 16 ) & 0x1f0000ff0000ffULL;
+    v = ( v | v <<  8 ) & 0x100f00f00f00f00fULL;
+    v = ( v | v <<  4 ) & 0x10c30c30c30c30c3ULL;
+    v = ( v | v <<  2 ) & 0x1249249249249249ULL;
+    return v;
+  }
+}
+
+//______________________________________________________________________
+//
+ParticleSort::Curve
+ParticleSort::getCurve( const std::string & name )
+{
+  if( name == "morton" ) {
+    return Morton;
+  }
+  if( name == "hilbert" ) {
+    return Hilbert;
+  }
+  throw ProblemSetupException( "ERROR:MPM: unknown particle_sort_curve (" + name + "), use morton or hilbert",
+                               __FILE__, __LINE__ );
+}
+
+//______________________________________________________________________
+//
+long64
+ParticleSort::mortonKey( const IntVector & cell, int /* bits */ )
+{
+  return spreadBits( cell.x() ) | ( spreadBits( cell.y() ) << 1 ) | ( spreadBits( cell.z() ) << 2 );
+}
+
+//______________________________________________________________________
+// J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707
+// (2004): the cell coordinates are transformed in place into the
+// "transposed" Hilbert index, whose bits are then interleaved.
+long64
+ParticleSort::hilbertKey( const IntVector & cell, int bits )
+{
+  uint32_t X[3] = { (uint32_t) cell.x(), (uint32_t) cell.y(), (uint32_t) cell.z() };
+
+  const uint32_t M = 1u << ( bits - 1 );
+
+  // inverse undo
+  for( uint32_t Q = M; Q > 1; Q >>= 1 ) {
+    const uint32_t P = Q - 1;
+    for( int i = 0; i < 3; i++ ) {
+      if( X[i] & Q ) {
+        X[0] ^= P;                                  // invert
+      }
+      else {
+        const uint32_t t = ( X[0] ^ X[i] ) & P;     // exchange
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  X[1] ^= X[0];
+  X[2] ^= X[1];
+  uint32_t t = 0;
+  for( uint32_t Q = M; Q > 1; Q >>= 1 ) {
+    if( X[2] & Q ) {
+      t ^= Q - 1;
+    }
+  }
+  X[0] ^= t;
+  X[1] ^= t;
+  X[2] ^= t;
+
+  // X[0] holds the most significant bit of every bit triple
+  return ( spreadBits( X[0] ) << 2 ) | ( spreadBits( X[1] ) << 1 ) | spreadBits( X[2] );
+}
+
+//______________________________________________________________________
+//
+bool
+ParticleSort::sortParticles(       Curve                                curve
+                           , const Patch                              * patch
+                           ,       ParticleSubset                     * pset
+                           , const constParticleVariable<Point>       & px
+                           , const std::vector<ParticleVariableBase*> & vars
+                           )
+{
+  const unsigned int n = pset->numParticles();
+  if( n < 2 || !pset->isContiguous() ) {
+    return false;
+  }
+
+  const IntVector low    = patch->getExtraCellLowIndex();
+  const IntVector extent = patch->getExtraCellHighIndex() - low;
+  const IntVector last   = extent - IntVector( 1, 1, 1 );
+
+  int bits = 1;
+  while( bits < 21 && ( 1 << bits ) < Max( extent.x(), extent.y(), extent.z() ) ) {
+    bits++;
+  }
+
+  // Append the subset position to the key if it fits.
+  int indexBits = 0;
+  while( ( (long64) 1 << indexBits ) < n ) {
+    indexBits++;
+  }
+  if( 3 * bits + indexBits > 63 ) {
+    indexBits = 0;
+  }
+
+  const Level* level = patch->getLevel();
+
+  ParticleVariable<long64> keys( pset );
+  bool inOrder = true;
+
+  for( unsigned int i = 0; i < n; i++ ) {
+    // particles just outside the patch are clamped to its boundary cells
+    const IntVector cell = Max( IntVector( 0, 0, 0 ), Min( level->getCellIndex( px[i] ) - low, last ) );
+
+    const long64 key = ( curve == Hilbert ) ? hilbertKey( cell, bits ) : mortonKey( cell, bits );
+    keys[i] = ( indexBits > 0 ) ? ( ( key << indexBits ) | i ) : key;
+
+    if( i > 0 && keys[i] < keys[i - 1] ) {
+      inOrder = false;
+    }
+  }
+
+  if( inOrder ) {
+    return false;
+  }
+
+  ParticleSubset* order = scinew ParticleSubset( n, pset->getMatlIndex(), patch );
+  order->addReference();
+  order->sort( &keys );
+
+  std::vector<ParticleSubset*> subsets( 1, order );
+
+  for( ParticleVariableBase* var : vars ) {
+    // The clone shares the current data, the gather allocates new data.
+    ParticleVariableBase* current = var->clone();
+    std::vector<ParticleVariableBase*> srcs( 1, current );
+
+    var->gather( pset, subsets, srcs, 0 );
+    delete current;
+  }
+
+  if( order->removeReference() ) {
+    delete order;
+  }
+  return true;
+}
@@ -0,0 +1,95 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef UINTAH_MPM_PARTICLESORT_H
+#define UINTAH_MPM_PARTICLESORT_H
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Geometry/Point.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+
+#include <string>
+#include <vector>
+
+namespace Uintah {
+
+  class Patch;
+
+/**************************************
+
+  CLASS
+    ParticleSort
+
+  GENERAL INFORMATION
+    ParticleSort.h
+
+  DESCRIPTION
+    Reorders the particles of a patch along a space-filling curve
+    through its cells (<particle_sort_interval>), so that the particle
+    loops visit the grid nodes in a cache friendly order instead of the
+    arbitrary order Relocate and addParticles leave behind.
+
+    The key of a particle is the Morton (bit interleaved) or Hilbert
+    index of its cell relative to the patch, followed by its position
+    in the subset when there are bits to spare, which keeps the order
+    of the particles within a cell.  The subset is sorted by the keys
+    with ParticleSubset::sort and every variable is gathered into the
+    new order.
+
+****************************************/
+
+  class ParticleSort {
+
+  public:
+
+    enum Curve {
+        Morton
+      , Hilbert
+    };
+
+    // "morton" or "hilbert", throws a ProblemSetupException otherwise.
+    static Curve getCurve( const std::string & name );
+
+    // Keys of a cell with 0 <= cell < 2^bits along every axis, bits <= 21.
+    static long64 mortonKey( const IntVector & cell, int bits );
+    static long64 hilbertKey( const IntVector & cell, int bits );
+
+    // Sorts the particles of 'pset', which must be contiguous (as it is
+    // after a relocation), along 'curve'.  'vars' are all the variables
+    // of the particles (including the positions 'px'); their data is
+    // replaced by the reordered data.  Returns false, without touching
+    // the variables, if the particles are in order already or 'pset'
+    // is not contiguous.
+    static bool sortParticles(       Curve                                curve
+                             , const Patch                              * patch
+                             ,       ParticleSubset                     * pset
+                             , const constParticleVariable<Point>       & px
+                             , const std::vector<ParticleVariableBase*> & vars
+                             );
+  };
+
+} // End namespace Uintah
+
+#endif // UINTAH_MPM_PARTICLESORT_H
@@ -36,6 +36,8 @@ SRCS     += \
 	$(SRCDIR)/MPMDiffusionLabel.cc \
 	$(SRCDIR)/MPMFlags.cc          \
 	$(SRCDIR)/MPMLabel.cc          \
+	$(SRCDIR)/ParticleSlabs.cc     \
+	$(SRCDIR)/ParticleSort.cc      \
 	$(SRCDIR)/ImpMPMFlags.cc
 
 PSELIBS := \
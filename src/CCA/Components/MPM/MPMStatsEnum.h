@@ -0,0 +1,62 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef CCA_COMPONENTS_MPM_STATS_ENUMS_H
+#define CCA_COMPONENTS_MPM_STATS_ENUMS_H
+
+
+namespace Uintah {
+
+/**************************************
+      
+    CLASS
+      MPMStatsEnum
+      
+      
+    GENERAL INFORMATION
+      
+      MPMStatsEnum.h
+      
+      
+    KEYWORDS
+      MPM Runtime Stats Enumerations
+      
+    DESCRIPTION
+      MPM Runtime Stats Enums to be used by SerialMPM.
+      
+      
+****************************************/
+
+  // timing statistics of the particle loops and of the particle sort
+  enum MPMStatsEnum
+  {
+    ParticleLoopsTime,
+    ParticleLoopsLLCMisses,
+    ParticleSortTime,
+  };
+
+} // end namespace Uintah
+
+#endif // CCA_COMPONENTS_MPM_STATS_ENUMS_H
@@ -8,6 +8,15 @@
 #include <Core/Exceptions/NotYetImplemented.h>
 #include <Core/Exceptions/InvalidValue.h>
 
+namespace {
+  // Constant terms for inverse Langevin function expansion.
+  const double LInv0 = 1.0;
+  const double LInv1 = 2.0/10.0;
+  const double LInv2 = 33.0/525.0;
+  const double LInv3 = 76.0/3500.0;
+  const double LInv4 = 2595.0/336875.0;
+}
+
 namespace Uintah {
   ArrudaBoyce8Chain::ArrudaBoyce8Chain(ProblemSpecP & ps
                                       ,MPMFlags     * mFlag)
@@ -222,7 +231,6 @@ namespace Uintah {
   {
     // Constants
     const double oneThird = (1.0/3.0);
-    const Matrix3 Identity(1, 0, 0, 0, 1, 0, 0, 0, 1);
 
     //
     const double rho0     = matl->getInitialDensity();
@@ -230,16 +238,6 @@ namespace Uintah {
 
     Ghost::GhostType gan  = Ghost::AroundNodes;
 
-    Matrix3 F_Inc, F_New;
-    double  J_Inc, J_New;
-
-    // Constant terms for inverse Langevin function expansion.
-    const double LInv0 = 1.0;
-    const double LInv1 = 2.0/10.0;
-    const double LInv2 = 33.0/525.0;
-    const double LInv3 = 76.0/3500.0;
-    const double LInv4 = 2595.0/336875.0;
-
     // Loop over patches
     for (int patchIdx = 0; patchIdx < patches->size(); ++patchIdx) {
       const Patch*  patch = patches->get(patchIdx);
@@ -267,23 +265,15 @@ namespace Uintah {
 
       Vector pV;        // Velocity placeholder vector
       Vector waveSpeed(1.0e-30, 1.0e-30, 1.0e-30); // Placeholder for speed of sound vector
-      ParticleSubset::iterator pIter = pset->begin();
-      for (; pIter != pset->end(); ++pIter) {
-        particleIndex pIdx = *pIter;
-        pdTdt[pIdx] = 0.0;
-
-        F_New = pF_New[pIdx];
-        F_Inc = F_New*pF_Old[pIdx].Inverse();
-        J_Inc = F_Inc.Determinant();
-        J_New = F_New.Determinant();
 
+      auto checkJacobian = [&](particleIndex pIdx, double J_New) {
         if (!(J_New>0.0)) {
           constParticleVariable<long64> pParticleID;
           old_dw->get(pParticleID,  lb->pParticleIDLabel,     pset);
           std::cerr << "matl        = " << dwi                << "\n"
                     << "F_old       = " << pF_Old[pIdx]       << "\n"
-                    << "F_inc       = " << F_Inc              << "\n"
-                    << "F_new       = " << F_New              << "\n"
+                    << "F_inc       = " << pF_New[pIdx]*pF_Old[pIdx].Inverse() << "\n"
+                    << "F_new       = " << pF_New[pIdx]       << "\n"
                     << "J           = " << J_New              << "\n"
                     << "Particle ID = " << pParticleID[pIdx]  << "\n"
                     << "--ERROR-- Negative Jacobian of deformation gradient in "
@@ -292,23 +282,11 @@ namespace Uintah {
           throw InvalidValue("--Error-- : Negative Jacobian in ArrudaBoyce8Chain",
                              __FILE__, __LINE__);
         }
-//        double JInv = 1.0/J_New;
-        double JPow13  = std::cbrt(J_New); // J^(1.0/3.0)
-        double JPow23  = JPow13*JPow13;    // J^(2.0/3.0)
-
-        Matrix3 F_Bar = F_Inc/cbrt(J_Inc);
-        // Calculate left Cauchy-Green Tensor:  B = FF^T
-        Matrix3 B = F_New*F_New.Transpose();
-
-        // Functional form of CM WRT B
-        // See http://www.brown.edu/Departments/Engineering/Courses/En221/Notes/Elasticity/Elasticity.htm
-        const double B_kk = B.Trace();
-        const double dU = B_kk/(JPow23*m_betaIn*m_betaIn); // B_kk/(J^(2/3)beta^2)
-        double LangInv = LInv0 +dU*(LInv1 +dU*(LInv2 +dU*(LInv3 +dU*(LInv4))));
+      };
 
-        // Calculate Cauchy stress tensor and assign
-        pStress[pIdx] = m_shearIn*LangInv*(B-oneThird*B_kk*Identity)/(JPow23*J_New) +  // Shear contribution
-                        0.5*m_bulkIn*(J_New-1.0/J_New)*Identity;                       // Bulk contribution
+      // Everything after the stress update
+      auto finishParticle = [&](particleIndex pIdx, double J_New) {
+        pdTdt[pIdx] = 0.0;
 
         // 1.0/rho_cur = J_New/rho0;
         double c_dil = sqrt((m_bulkIn + 4.0*m_shearIn*oneThird)*J_New*rho0Inv);
@@ -316,7 +294,40 @@ namespace Uintah {
         waveSpeed[0] = Max(c_dil+fabs(pV.x()),waveSpeed.x());
         waveSpeed[1] = Max(c_dil+fabs(pV.y()),waveSpeed.y());
         waveSpeed[2] = Max(c_dil+fabs(pV.z()),waveSpeed.z());
-      } // end loop over particles
+      };
+
+      if (flag->d_batchStressUpdate) {
+        BatchStress::forEachBlock(pset, [&](const particleIndex* idx, int count) {
+          StressLanes s;
+          BatchStress::load(pF_New, idx, count, s.F_New);
+
+          BatchStress::determinant(s.F_New, s.J_New);
+          for (int l = 0; l < count; ++l) {
+            checkJacobian(idx[l], s.J_New[l]);
+          }
+
+          updateStress(s, m_shearIn, m_bulkIn, m_betaIn);
+
+          BatchStress::store(s.stress, idx, count, pStress);
+
+          for (int l = 0; l < count; ++l) {
+            finishParticle(idx[l], s.J_New[l]);
+          }
+        });
+      } else {
+        ParticleSubset::iterator pIter = pset->begin();
+        for (; pIter != pset->end(); ++pIter) {
+          particleIndex pIdx = *pIter;
+
+          double J_New = pF_New[pIdx].Determinant();
+          checkJacobian(pIdx, J_New);
+
+          updateStress(pF_New[pIdx], J_New, m_shearIn, m_bulkIn, m_betaIn,
+                       pStress[pIdx]);
+
+          finishParticle(pIdx, J_New);
+        } // end loop over particles
+      }
       waveSpeed = dx/waveSpeed;
       double delT_new = waveSpeed.minComponent();
 
@@ -326,6 +337,81 @@ namespace Uintah {
     } // end loop over patches
   } // computeStressTensor
 
+  void ArrudaBoyce8Chain::updateStress(const  Matrix3 & F_New
+                                      ,       double    J_New
+                                      ,       double    shear
+                                      ,       double    bulk
+                                      ,       double    beta
+                                      ,       Matrix3 & stress  )
+  {
+    const double  oneThird = (1.0/3.0);
+    const Matrix3 Identity(1, 0, 0, 0, 1, 0, 0, 0, 1);
+
+    double JPow13  = std::cbrt(J_New); // J^(1.0/3.0)
+    double JPow23  = JPow13*JPow13;    // J^(2.0/3.0)
+
+    // Calculate left Cauchy-Green Tensor:  B = FF^T
+    Matrix3 B = F_New*F_New.Transpose();
+
+    // Functional form of CM WRT B
+    // See http://www.brown.edu/Departments/Engineering/Courses/En221/Notes/Elasticity/Elasticity.htm
+    const double B_kk = B.Trace();
+    const double dU = B_kk/(JPow23*beta*beta); // B_kk/(J^(2/3)beta^2)
+    double LangInv = LInv0 +dU*(LInv1 +dU*(LInv2 +dU*(LInv3 +dU*(LInv4))));
+
+    // Calculate Cauchy stress tensor and assign
+    stress = shear*LangInv*(B-oneThird*B_kk*Identity)/(JPow23*J_New) +  // Shear contribution
+             0.5*bulk*(J_New-1.0/J_New)*Identity;                       // Bulk contribution
+  }
+
+  void ArrudaBoyce8Chain::updateStress(       StressLanes & s
+                                      ,       double        shear
+                                      ,       double        bulk
+                                      ,       double        beta  )
+  {
+    const int    W        = BatchStress::s_width;
+    const double oneThird = (1.0/3.0);
+
+    BatchStress::Scalars JPow23;      // J^(2.0/3.0)
+    BatchStress::cbrt(s.J_New, JPow23);
+    for (int l = 0; l < W; ++l) {
+      JPow23[l] *= JPow23[l];
+    }
+
+    // Calculate left Cauchy-Green Tensor:  B = FF^T
+    BatchStress::Tensors B;
+    BatchStress::Scalars B_kk;
+    BatchStress::multiplyTranspose(s.F_New, s.F_New, B);
+    BatchStress::trace(B, B_kk);
+
+    BatchStress::Scalars shearScale, invJ, dev, p;
+    for (int l = 0; l < W; ++l) {
+      const double J_New   = s.J_New[l];
+      const double dU      = B_kk[l]/(JPow23[l]*beta*beta);
+      const double LangInv = LInv0 +dU*(LInv1 +dU*(LInv2 +dU*(LInv3 +dU*(LInv4))));
+      shearScale[l] = shear*LangInv;
+      invJ[l]       = 1.0/(JPow23[l]*J_New);
+      dev[l]        = oneThird*B_kk[l];
+      p[l]          = 0.5*bulk*(J_New-1.0/J_New);
+    }
+
+    // Shear and, on the diagonal, bulk contribution; the diagonal has its
+    // own loops so that none of them branch.
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        if (i == j) {
+          for (int l = 0; l < W; ++l) {
+            s.stress.m[i][j][l] = ((B.m[i][j][l] - dev[l])*shearScale[l])*invJ[l] + p[l];
+          }
+        } else {
+          for (int l = 0; l < W; ++l) {
+            s.stress.m[i][j][l] = (B.m[i][j][l]*shearScale[l])*invJ[l];
+          }
+        }
+      }
+    }
+  }
+
   void ArrudaBoyce8Chain::computeStressTensorImplicit(const  PatchSubset   * patches
                                                      ,const  MPMMaterial   * matl
                                                      ,       DataWarehouse * old_dw
@@ -8,6 +8,7 @@
 #ifndef SRC_CCA_COMPONENTS_MPM_MATERIALS_CONSTITUTIVEMODEL_ARRUDABOYCE8CHAIN_H_
 #define SRC_CCA_COMPONENTS_MPM_MATERIALS_CONSTITUTIVEMODEL_ARRUDABOYCE8CHAIN_H_
 
+#include <CCA/Components/MPM/Materials/ConstitutiveModel/BatchStress.h>
 #include <CCA/Components/MPM/Materials/ConstitutiveModel/ConstitutiveModel.h>
 #include <CCA/Components/MPM/Materials/ConstitutiveModel/ImplicitCM.h>
 #include <CCA/Components/MPM/Materials/MPMMaterial.h>
@@ -91,6 +92,27 @@ namespace Uintah {
                                               ,       DataWarehouse * old_dw
                                               ,       DataWarehouse * new_dw  );
 
+      // Cauchy stress of one particle, J_New = det(F_New).
+      static void updateStress(const  Matrix3 & F_New
+                              ,       double    J_New
+                              ,       double    shear
+                              ,       double    bulk
+                              ,       double    beta
+                              ,       Matrix3 & stress  );
+
+      // Particle state of the batched stress update (<batch_stress_update>)
+      struct StressLanes {
+        BatchStress::Tensors F_New;
+        BatchStress::Scalars J_New;
+        BatchStress::Tensors stress;    // out
+      };
+
+      // The same for BatchStress::s_width particles.
+      static void updateStress(       StressLanes & s
+                              ,       double        shear
+                              ,       double        bulk
+                              ,       double        beta  );
+
       // Helper Functions
       //   Add particle variables to tracker
       virtual void addParticleState(std::vector<const VarLabel*>  & from
@@ -0,0 +1,267 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef UINTAH_MPM_BATCHSTRESS_H
+#define UINTAH_MPM_BATCHSTRESS_H
+
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Math/Matrix3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    BatchStress
+
+  GENERAL INFORMATION
+    BatchStress.h
+
+  DESCRIPTION
+    Building blocks for constitutive models that update the stress of
+    s_width particles at once (<batch_stress_update>).
+
+    The particle state of a block is loaded into lanes, a structure of
+    arrays with one array of s_width values per scalar or tensor
+    component, and the model's kernel runs every step of the update as
+    a fixed length loop over the lanes which the compiler vectorizes.
+    Branches of the per particle update become masks, e.g. a return
+    mapping computes the plastic corrector in all lanes and selects it
+    where the trial stress is outside the yield surface.
+
+    A partial block is padded with copies of its last particle, so the
+    kernels always run over all lanes; only the first 'count' lanes are
+    stored.  The tensor operations evaluate the same expressions as the
+    Matrix3 operations they replace, so a kernel agrees with the scalar
+    update up to the order of its own operations and the last bits of
+    cbrt().
+
+    Ported models: UCNH, ArrudaBoyce8Chain.
+
+****************************************/
+
+  class BatchStress {
+
+  public:
+
+    static const int s_width = 8;
+
+    // One value per lane.
+    struct Scalars {
+      double v[s_width];
+
+      double & operator[]( int lane )       { return v[lane]; }
+      double   operator[]( int lane ) const { return v[lane]; }
+    };
+
+    // One Matrix3 per lane, m[i][j][lane] = A(i,j).
+    struct Tensors {
+      double m[3][3][s_width];
+
+      void set( int lane, const Matrix3 & A )
+      {
+        for( int i = 0; i < 3; i++ ) {
+          for( int j = 0; j < 3; j++ ) {
+            m[i][j][lane] = A( i, j );
+          }
+        }
+      }
+
+      Matrix3 get( int lane ) const
+      {
+        return Matrix3( m[0][0][lane], m[0][1][lane], m[0][2][lane],
+                        m[1][0][lane], m[1][1][lane], m[1][2][lane],
+                        m[2][0][lane], m[2][1][lane], m[2][2][lane] );
+      }
+    };
+
+    //______________________________________________________________________
+    // Loading and storing the particles idx[0, count) of a block.
+
+    template<class Var>
+    static void load( const Var & var, const particleIndex * idx, int count, Scalars & s )
+    {
+      for( int l = 0; l < s_width; l++ ) {
+        s[l] = var[ idx[ std::min( l, count - 1 ) ] ];
+      }
+    }
+
+    template<class Var>
+    static void load( const Var & var, const particleIndex * idx, int count, Tensors & t )
+    {
+      for( int l = 0; l < s_width; l++ ) {
+        t.set( l, var[ idx[ std::min( l, count - 1 ) ] ] );
+      }
+    }
+
+    static void store( const Scalars & s, const particleIndex * idx, int count, ParticleVariable<double> & var )
+    {
+      for( int l = 0; l < count; l++ ) {
+        var[ idx[l] ] = s[l];
+      }
+    }
+
+    static void store( const Tensors & t, const particleIndex * idx, int count, ParticleVariable<Matrix3> & var )
+    {
+      for( int l = 0; l < count; l++ ) {
+        var[ idx[l] ] = t.get( l );
+      }
+    }
+
+    //______________________________________________________________________
+    // Lane by lane tensor algebra.  The results must not alias the
+    // arguments.
+
+    // C = A B
+    static void multiply( const Tensors & A, const Tensors & B, Tensors & C )
+    {
+      for( int i = 0; i < 3; i++ ) {
+        for( int j = 0; j < 3; j++ ) {
+          for( int l = 0; l < s_width; l++ ) {
+            C.m[i][j][l] = A.m[i][0][l] * B.m[0][j][l] + A.m[i][1][l] * B.m[1][j][l] + A.m[i][2][l] * B.m[2][j][l];
+          }
+        }
+      }
+    }
+
+    // C = A B^T
+    static void multiplyTranspose( const Tensors & A, const Tensors & B, Tensors & C )
+    {
+      for( int i = 0; i < 3; i++ ) {
+        for( int j = 0; j < 3; j++ ) {
+          for( int l = 0; l < s_width; l++ ) {
+            C.m[i][j][l] = A.m[i][0][l] * B.m[j][0][l] + A.m[i][1][l] * B.m[j][1][l] + A.m[i][2][l] * B.m[j][2][l];
+          }
+        }
+      }
+    }
+
+    static void determinant( const Tensors & a, Scalars & det )
+    {
+      for( int l = 0; l < s_width; l++ ) {
+        det[l] = a.m[0][0][l] * a.m[1][1][l] * a.m[2][2][l] +
+                 a.m[0][1][l] * a.m[1][2][l] * a.m[2][0][l] +
+                 a.m[0][2][l] * a.m[1][0][l] * a.m[2][1][l] -
+                 a.m[0][2][l] * a.m[1][1][l] * a.m[2][0][l] -
+                 a.m[0][1][l] * a.m[1][0][l] * a.m[2][2][l] -
+                 a.m[0][0][l] * a.m[1][2][l] * a.m[2][1][l];
+      }
+    }
+
+    // The determinants must not be zero.
+    static void inverse( const Tensors & a, Tensors & inv )
+    {
+      Scalars det;
+      determinant( a, det );
+
+      for( int l = 0; l < s_width; l++ ) {
+        const double s = 1.0 / det[l];
+        inv.m[0][0][l] = (  a.m[1][1][l] * a.m[2][2][l] - a.m[1][2][l] * a.m[2][1][l] ) * s;
+        inv.m[0][1][l] = ( -a.m[0][1][l] * a.m[2][2][l] + a.m[2][1][l] * a.m[0][2][l] ) * s;
+        inv.m[0][2][l] = (  a.m[0][1][l] * a.m[1][2][l] - a.m[1][1][l] * a.m[0][2][l] ) * s;
+        inv.m[1][0][l] = ( -a.m[1][0][l] * a.m[2][2][l] + a.m[2][0][l] * a.m[1][2][l] ) * s;
+        inv.m[1][1][l] = (  a.m[0][0][l] * a.m[2][2][l] - a.m[0][2][l] * a.m[2][0][l] ) * s;
+        inv.m[1][2][l] = ( -a.m[0][0][l] * a.m[1][2][l] + a.m[1][0][l] * a.m[0][2][l] ) * s;
+        inv.m[2][0][l] = (  a.m[1][0][l] * a.m[2][1][l] - a.m[2][0][l] * a.m[1][1][l] ) * s;
+        inv.m[2][1][l] = ( -a.m[0][0][l] * a.m[2][1][l] + a.m[2][0][l] * a.m[0][1][l] ) * s;
+        inv.m[2][2][l] = (  a.m[0][0][l] * a.m[1][1][l] - a.m[0][1][l] * a.m[1][0][l] ) * s;
+      }
+    }
+
+    static void trace( const Tensors & A, Scalars & tr )
+    {
+      for( int l = 0; l < s_width; l++ ) {
+        tr[l] = A.m[0][0][l] + A.m[1][1][l] + A.m[2][2][l];
+      }
+    }
+
+    // Frobenius norm, as Matrix3::Norm()
+    static void norm( const Tensors & A, Scalars & n )
+    {
+      for( int l = 0; l < s_width; l++ ) {
+        double sum = 0.0;
+        for( int i = 0; i < 3; i++ ) {
+          for( int j = 0; j < 3; j++ ) {
+            sum += A.m[i][j][l] * A.m[i][j][l];
+          }
+        }
+        n[l] = std::sqrt( sum );
+      }
+    }
+
+    // Cube roots, r = cbrt(x).  A seed from the exponent bits and three
+    // Halley steps, which run in all lanes at once unlike the libm call,
+    // agree with std::cbrt to within an ulp or two; arguments outside
+    // (1e-150, 1e150), where the steps would underflow or overflow, are
+    // left to std::cbrt.
+    static void cbrt( const Scalars & x, Scalars & r )
+    {
+      for( int l = 0; l < s_width; l++ ) {
+        uint64_t bits;
+        std::memcpy( &bits, &x.v[l], sizeof( bits ) );
+        bits = bits / 3 + 0x2A9F7893782DA1CEull;
+        std::memcpy( &r.v[l], &bits, sizeof( bits ) );
+      }
+
+      for( int step = 0; step < 3; step++ ) {
+        for( int l = 0; l < s_width; l++ ) {
+          const double y  = r[l];
+          const double y3 = y * y * y;
+          r[l] = y * ( y3 + 2.0 * x[l] ) / ( 2.0 * y3 + x[l] );
+        }
+      }
+
+      for( int l = 0; l < s_width; l++ ) {
+        if( !( x[l] > 1e-150 && x[l] < 1e150 ) ) {
+          r[l] = std::cbrt( x[l] );
+        }
+      }
+    }
+
+    //______________________________________________________________________
+    // Calls body(idx, count) for consecutive blocks of the particles of
+    // 'pset', idx[0, count) being the indices of the block's particles,
+    // count <= s_width.
+    template<class Body>
+    static void forEachBlock( ParticleSubset * pset, Body body )
+    {
+      const particleIndex * indices = pset->getPointer();
+      const int             n       = pset->numParticles();
+
+      for( int first = 0; first < n; first += s_width ) {
+        body( indices + first, ( n - first < s_width ) ? n - first : s_width );
+      }
+    }
+  };
+
+} // End namespace Uintah
+
+#endif // UINTAH_MPM_BATCHSTRESS_H
@@ -557,15 +557,10 @@ void UCNH::computeStressTensor(const PatchSubset* patches,
                                 DataWarehouse* old_dw,
                                 DataWarehouse* new_dw)
 {
-  // Constants
-  double onethird = (1.0/3.0), sqtwthds = sqrt(2.0/3.0);
-  Matrix3 Identity; Identity.Identity();
-
   // Grab initial data
   double shear    = d_initialData.tauDev;
   double bulk     = d_initialData.Bulk;
   double rho_orig = matl->getInitialDensity();
-  double flow     = 0.0;
   double K        = 0.0;
 
   Ghost::GhostType  gan = Ghost::AroundNodes;
@@ -575,14 +570,7 @@ void UCNH::computeStressTensor(const PatchSubset* patches,
     const Patch* patch = patches->get(pp);
 
     // Temporary and "get" variables
-    double delgamma = 0.0, fTrial = 0.0, IEl = 0.0, J = 0.0, Jinc = 0.0;
-    double muBar = 0.0, p = 0.0, sTnorm = 0.0, U = 0.0, W = 0.0;
     double se=0.0;     // Strain energy placeholder
-    double c_dil=0.0;  // Speed of sound
-
-    Matrix3 pBBar_new(0.0), bEB_new(0.0), bElBarTrial(0.0), pDefGradInc(0.0);
-    Matrix3 fBar(0.0), defGrad(0.0), normal(0.0);
-    Matrix3 tauDev(0.0), tauDevTrial(0.0);
     Vector WaveSpeed(1.e-12,1.e-12,1.e-12);
 
     // Get particle info and patch info
@@ -623,7 +611,6 @@ void UCNH::computeStressTensor(const PatchSubset* patches,
       pYieldStress.copyData(pYieldStress_old);
 
       // Copy initial data
-      flow  = d_initialData.FlowStress;
       K     = d_initialData.K;
     }
 
@@ -643,23 +630,10 @@ void UCNH::computeStressTensor(const PatchSubset* patches,
     new_dw->allocateAndPut(pdTdt,       lb->pdTdtLabel,            pset);
     new_dw->allocateAndPut(p_q,         lb->p_qLabel_preReloc,     pset);
 
-    ParticleSubset::iterator iter = pset->begin();
-    for(; iter != pset->end(); iter++){
-      particleIndex idx = *iter;
-      // Assign zero internal heating by default - modify if necessary.
-      pdTdt[idx] = 0.0;
-
-      pDefGradInc = pDefGrad_new[idx]*pDefGrad[idx].Inverse();
-      Jinc    = pDefGradInc.Determinant();
-      defGrad = pDefGrad_new[idx];
-
-      // 1) Get the volumetric part of the deformation
-      // 2) Compute the deformed volume and new density
-      J               = defGrad.Determinant();
-      double rho_cur  = rho_orig/J;
-
-      // Check 1: Look at Jacobian
+    // Check 1: Look at Jacobian
+    auto checkJacobian = [&](particleIndex idx, double J) {
       if (!(J > 0.0)) {
+        Matrix3 pDefGradInc = pDefGrad_new[idx]*pDefGrad[idx].Inverse();
         cerr << "matl = "  << dwi              << endl;
         cerr << "F_old = " << pDefGrad[idx]     << endl;
         cerr << "F_inc = " << pDefGradInc       << endl;
@@ -674,70 +648,28 @@ void UCNH::computeStressTensor(const PatchSubset* patches,
         throw InvalidValue("**ERROR**:Negative Jacobian in UCNH",
                             __FILE__, __LINE__);
       }
+    };
 
-      // Get the volume preserving part of the deformation gradient increment
-      fBar = pDefGradInc/cbrt(Jinc);
-
-      // Compute the trial elastic part of the volume preserving
-      // part of the left Cauchy-Green deformation tensor
-      bElBarTrial = fBar*bElBar[idx]*fBar.Transpose();
-      if(!d_usePlasticity){
-        double cubeRootJ      = cbrt(J);
-        double Jtothetwothirds= cubeRootJ*cubeRootJ;
-        bElBarTrial           = pDefGrad_new[idx]* pDefGrad_new[idx].Transpose()
-                                 /Jtothetwothirds;
-      }
-      IEl   = onethird*bElBarTrial.Trace();
-      muBar = IEl*shear;
-
-      // tauDevTrial is equal to the shear modulus times dev(bElBar)
-      // Compute ||tauDevTrial||
-      tauDevTrial = (bElBarTrial - Identity*IEl)*shear;
-      sTnorm      = tauDevTrial.Norm();
-
-      // Check for plastic loading
-      double alpha;
-      if(d_usePlasticity) {
-        flow = pYieldStress[idx];
-        alpha  = pPlasticStrain[idx];
-        fTrial = sTnorm - sqtwthds*(K*alpha + flow);
-      }
-      if (d_usePlasticity && (fTrial > 0.0) ) {
-        // plastic
-        // Compute increment of slip in the direction of flow
-        delgamma = (fTrial/(2.0*muBar)) / (1.0 + (K/(3.0*muBar)));
-        normal   = tauDevTrial/sTnorm;
-
-        // The actual shear stress
-        tauDev = tauDevTrial - normal*2.0*muBar*delgamma;
-
-        // Deal with history variables
-        pPlasticStrain[idx] = alpha + sqtwthds*delgamma;
-        bElBar_new[idx]     = tauDev/shear + Identity*IEl;
-      } else {
-        // The actual shear stress
-        tauDev          = tauDevTrial;
-        bElBar_new[idx] = bElBarTrial;
-      }
-
-      // get the hydrostatic part of the stress
-      p = 0.5*bulk*(J - 1.0/J);
+    // Everything after the stress update
+    auto finishParticle = [&](particleIndex idx, double J) {
+      // Assign zero internal heating by default - modify if necessary.
+      pdTdt[idx] = 0.0;
 
-      // compute the total stress (volumetric + deviatoric)
-      pStress[idx] = Identity*p + tauDev/J;
+      // Compute the deformed volume and new density
+      double rho_cur  = rho_orig/J;
 
       //__________________________________
       // Compute the strain energy for non-localized particles
       // Note this calculation is lagging by a timestep.
       if(pLocalizedOld[idx] == 0){
-        U = .5*bulk*(.5*(J*J - 1.0) - log(J));
-        W = .5*shear*(bElBar_new[idx].Trace() - 3.0);
+        double U = .5*bulk*(.5*(J*J - 1.0) - log(J));
+        double W = .5*shear*(bElBar_new[idx].Trace() - 3.0);
         double e = (U + W)*pVolume_new[idx]/J;
         se += e;
       }
 
       // Compute the local sound speed (uniaxial strain, p-wave modulus)
-      c_dil = sqrt((bulk + 4.*shear/3.)/rho_cur);
+      double c_dil = sqrt((bulk + 4.*shear/3.)/rho_cur);
 
       // Compute wave speed at each particle, store the maximum
       Vector pvel = pVelocity[idx];
@@ -755,7 +687,62 @@ void UCNH::computeStressTensor(const PatchSubset* patches,
       } else {
         p_q[idx] = 0.;
       }
-    } // end loop over particles
+    };
+
+    if (flag->d_batchStressUpdate) {
+      BatchStress::forEachBlock(pset, [&](const particleIndex* idx, int count) {
+        StressLanes s;
+        BatchStress::load(pDefGrad,     idx, count, s.F_old);
+        BatchStress::load(pDefGrad_new, idx, count, s.F_new);
+        BatchStress::load(bElBar,       idx, count, s.bElBar);
+        if(d_usePlasticity) {
+          BatchStress::load(pPlasticStrain, idx, count, s.plasticStrain);
+          BatchStress::load(pYieldStress,   idx, count, s.yieldStress);
+        }
+
+        BatchStress::determinant(s.F_new, s.J);
+        for(int l = 0; l < count; l++){
+          checkJacobian(idx[l], s.J[l]);
+        }
+
+        updateStress(s, shear, bulk, K, d_usePlasticity);
+
+        BatchStress::store(s.bElBar, idx, count, bElBar_new);
+        BatchStress::store(s.stress, idx, count, pStress);
+        if(d_usePlasticity) {
+          BatchStress::store(s.plasticStrain, idx, count, pPlasticStrain);
+        }
+
+        for(int l = 0; l < count; l++){
+          finishParticle(idx[l], s.J[l]);
+        }
+      });
+    } else {
+      ParticleSubset::iterator iter = pset->begin();
+      for(; iter != pset->end(); iter++){
+        particleIndex idx = *iter;
+
+        // Get the volumetric part of the deformation
+        double J = pDefGrad_new[idx].Determinant();
+        checkJacobian(idx, J);
+
+        double alpha = 0.0, flow = 0.0;
+        if(d_usePlasticity) {
+          alpha = pPlasticStrain[idx];
+          flow  = pYieldStress[idx];
+        }
+
+        updateStress(pDefGrad[idx], pDefGrad_new[idx], bElBar[idx], alpha, flow,
+                     J, shear, bulk, K, d_usePlasticity,
+                     bElBar_new[idx], alpha, pStress[idx]);
+
+        if(d_usePlasticity) {
+          pPlasticStrain[idx] = alpha;
+        }
+
+        finishParticle(idx, J);
+      } // end loop over particles
+    }
 
     WaveSpeed = dx/WaveSpeed;
     double delT_new = WaveSpeed.minComponent();
@@ -769,6 +756,186 @@ void UCNH::computeStressTensor(const PatchSubset* patches,
 }
 //______________________________________________________________________
 //
+void UCNH::updateStress(const Matrix3& F_old,
+                        const Matrix3& F_new,
+                        const Matrix3& bElBar_old,
+                        double plasticStrain_old,
+                        double yieldStress,
+                        double J,
+                        double shear,
+                        double bulk,
+                        double K,
+                        bool usePlasticity,
+                        Matrix3& bElBar_new,
+                        double& plasticStrain_new,
+                        Matrix3& stress)
+{
+  // Constants
+  double onethird = (1.0/3.0), sqtwthds = sqrt(2.0/3.0);
+  Matrix3 Identity; Identity.Identity();
+
+  Matrix3 pDefGradInc = F_new*F_old.Inverse();
+  double Jinc = pDefGradInc.Determinant();
+
+  // Get the volume preserving part of the deformation gradient increment
+  Matrix3 fBar = pDefGradInc/cbrt(Jinc);
+
+  // Compute the trial elastic part of the volume preserving
+  // part of the left Cauchy-Green deformation tensor
+  Matrix3 bElBarTrial = fBar*bElBar_old*fBar.Transpose();
+  if(!usePlasticity){
+    double cubeRootJ      = cbrt(J);
+    double Jtothetwothirds= cubeRootJ*cubeRootJ;
+    bElBarTrial           = F_new*F_new.Transpose()/Jtothetwothirds;
+  }
+  double IEl   = onethird*bElBarTrial.Trace();
+  double muBar = IEl*shear;
+
+  // tauDevTrial is equal to the shear modulus times dev(bElBar)
+  // Compute ||tauDevTrial||
+  Matrix3 tauDevTrial = (bElBarTrial - Identity*IEl)*shear;
+  double sTnorm       = tauDevTrial.Norm();
+
+  // Check for plastic loading
+  double alpha  = plasticStrain_old;
+  double fTrial = 0.0;
+  if(usePlasticity) {
+    fTrial = sTnorm - sqtwthds*(K*alpha + yieldStress);
+  }
+
+  Matrix3 tauDev;
+  plasticStrain_new = alpha;
+  if (usePlasticity && (fTrial > 0.0) ) {
+    // plastic
+    // Compute increment of slip in the direction of flow
+    double delgamma = (fTrial/(2.0*muBar)) / (1.0 + (K/(3.0*muBar)));
+    Matrix3 normal  = tauDevTrial/sTnorm;
+
+    // The actual shear stress
+    tauDev = tauDevTrial - normal*2.0*muBar*delgamma;
+
+    // Deal with history variables
+    plasticStrain_new = alpha + sqtwthds*delgamma;
+    bElBar_new        = tauDev/shear + Identity*IEl;
+  } else {
+    // The actual shear stress
+    tauDev     = tauDevTrial;
+    bElBar_new = bElBarTrial;
+  }
+
+  // get the hydrostatic part of the stress
+  double p = 0.5*bulk*(J - 1.0/J);
+
+  // compute the total stress (volumetric + deviatoric)
+  stress = Identity*p + tauDev/J;
+}
+
+//______________________________________________________________________
+//
+void UCNH::updateStress(StressLanes& s,
+                        double shear,
+                        double bulk,
+                        double K,
+                        bool usePlasticity)
+{
+  const int W = BatchStress::s_width;
+
+  // Constants
+  double onethird = (1.0/3.0), sqtwthds = sqrt(2.0/3.0);
+
+  // Trial elastic part of the volume preserving part of the left
+  // Cauchy-Green deformation tensor
+  BatchStress::Tensors bElBarTrial;
+  BatchStress::Tensors tmp;
+
+  if(usePlasticity){
+    BatchStress::Tensors fBar;
+    BatchStress::Scalars Jinc;
+
+    BatchStress::inverse(s.F_old, tmp);
+    BatchStress::multiply(s.F_new, tmp, fBar);
+    BatchStress::determinant(fBar, Jinc);
+    for(int l = 0; l < W; l++){
+      const double scale = 1.0/cbrt(Jinc[l]);
+      for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 3; j++){
+          fBar.m[i][j][l] *= scale;
+        }
+      }
+    }
+
+    BatchStress::multiply(fBar, s.bElBar, tmp);
+    BatchStress::multiplyTranspose(tmp, fBar, bElBarTrial);
+  } else {
+    BatchStress::multiplyTranspose(s.F_new, s.F_new, bElBarTrial);
+    for(int l = 0; l < W; l++){
+      const double cubeRootJ = cbrt(s.J[l]);
+      const double scale     = 1.0/(cubeRootJ*cubeRootJ);
+      for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 3; j++){
+          bElBarTrial.m[i][j][l] *= scale;
+        }
+      }
+    }
+  }
+
+  BatchStress::Scalars IEl;
+  BatchStress::trace(bElBarTrial, IEl);
+
+  // tauDevTrial is equal to the shear modulus times dev(bElBar)
+  BatchStress::Tensors tauDev;
+  for(int l = 0; l < W; l++){
+    IEl[l] *= onethird;
+    for(int i = 0; i < 3; i++){
+      for(int j = 0; j < 3; j++){
+        tauDev.m[i][j][l] = (bElBarTrial.m[i][j][l] - (i == j ? IEl[l] : 0.0))*shear;
+      }
+    }
+  }
+
+  if(usePlasticity){
+    BatchStress::Scalars sTnorm;
+    BatchStress::norm(tauDev, sTnorm);
+
+    // Radial return where the trial stress is outside the yield surface,
+    // elsewhere delgamma is zero and tauDev stays the trial stress
+    const double invShear = 1.0/shear;
+    for(int l = 0; l < W; l++){
+      const double muBar    = IEl[l]*shear;
+      const double fTrial   = sTnorm[l] - sqtwthds*(K*s.plasticStrain[l] + s.yieldStress[l]);
+      const bool   plastic  = fTrial > 0.0;
+      const double delgamma = plastic ? (fTrial/(2.0*muBar)) / (1.0 + (K/(3.0*muBar))) : 0.0;
+      const double invNorm  = plastic ? 1.0/sTnorm[l] : 0.0;
+
+      s.plasticStrain[l] = s.plasticStrain[l] + sqtwthds*delgamma;
+
+      for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 3; j++){
+          const double normal = tauDev.m[i][j][l]*invNorm;
+          tauDev.m[i][j][l]   = tauDev.m[i][j][l] - normal*2.0*muBar*delgamma;
+          s.bElBar.m[i][j][l] = plastic ? tauDev.m[i][j][l]*invShear + (i == j ? IEl[l] : 0.0)
+                                        : bElBarTrial.m[i][j][l];
+        }
+      }
+    }
+  } else {
+    s.bElBar = bElBarTrial;
+  }
+
+  // the total stress (volumetric + deviatoric)
+  for(int l = 0; l < W; l++){
+    const double J    = s.J[l];
+    const double p    = 0.5*bulk*(J - 1.0/J);
+    const double invJ = 1.0/J;
+    for(int i = 0; i < 3; i++){
+      for(int j = 0; j < 3; j++){
+        s.stress.m[i][j][l] = (i == j ? p : 0.0) + tauDev.m[i][j][l]*invJ;
+      }
+    }
+  }
+}
+//______________________________________________________________________
+//
 void UCNH::computeStressTensorImplicit(const PatchSubset* patches,
                                        const MPMMaterial* matl,
                                        DataWarehouse* old_dw,
@@ -51,6 +51,7 @@ namespace Uintah {
   { swapbytes(d.Alpha); }
 } // namespace Uintah
 
+#include "BatchStress.h"
 #include "ConstitutiveModel.h"
 #include "ImplicitCM.h"
 #include "PlasticityModels/MPMEquationOfState.h"
@@ -216,6 +217,42 @@ namespace Uintah {
                                              Solver* solver,
                                              const bool );
 
+    // Stress update of one particle, the elastic predictor and with
+    // plasticity the radial return, J = det(F_new).  plasticStrain_old
+    // and yieldStress are only used with plasticity.
+    static void updateStress(const Matrix3& F_old,
+                             const Matrix3& F_new,
+                             const Matrix3& bElBar_old,
+                             double plasticStrain_old,
+                             double yieldStress,
+                             double J,
+                             double shear,
+                             double bulk,
+                             double K,
+                             bool usePlasticity,
+                             Matrix3& bElBar_new,
+                             double& plasticStrain_new,
+                             Matrix3& stress);
+
+    // Particle state of the batched stress update (<batch_stress_update>)
+    struct StressLanes {
+      BatchStress::Tensors F_old;
+      BatchStress::Tensors F_new;
+      BatchStress::Tensors bElBar;         // old in, new out
+      BatchStress::Scalars plasticStrain;  // old in, new out
+      BatchStress::Scalars yieldStress;
+      BatchStress::Scalars J;
+      BatchStress::Tensors stress;         // out
+    };
+
+    // The same for BatchStress::s_width particles, the radial return
+    // is masked.
+    static void updateStress(StressLanes& s,
+                             double shear,
+                             double bulk,
+                             double K,
+                             bool usePlasticity);
+
 
     // Helper Functions //
     //////////////////////
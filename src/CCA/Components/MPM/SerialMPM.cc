@@ -25,6 +25,9 @@
 
 #include <CCA/Components/MPM/Core/MPMDiffusionLabel.h>
 #include <CCA/Components/MPM/Core/MPMBoundCond.h>
+#include <CCA/Components/MPM/Core/ParticleSlabs.h>
+#include <CCA/Components/MPM/Core/ParticleSort.h>
+#include <CCA/Components/MPM/MPMStatsEnum.h>
 #include <CCA/Components/MPM/Materials/ConstitutiveModel/ConstitutiveModel.h>
 #include <CCA/Components/MPM/Materials/ConstitutiveModel/PlasticityModels/DamageModel.h>
 #include <CCA/Components/MPM/Materials/ConstitutiveModel/PlasticityModels/ErosionModel.h>
@@ -61,6 +64,7 @@
 #include <Core/Grid/Variables/PerPatch.h>
 #include <Core/Grid/Variables/PerPatchVars.h>
 #include <Core/Grid/Variables/VarTypes.h>
+#include <Core/Parallel/MasterLock.h>
 #include <Core/Parallel/ProcessorGroup.h>
 #include <Core/ProblemSpec/ProblemSpec.h>
 #include <Core/Geometry/Vector.h>
@@ -69,6 +73,8 @@
 #include <Core/Math/Matrix3.h>
 #include <Core/Util/DebugStream.h>
 #include <Core/Util/DOUT.hpp>
+#include <Core/Util/PerfCounters.h>
+#include <Core/Util/Timers/Timers.hpp>
 
 // Diffusion includes
 #include <CCA/Components/MPM/Materials/Diffusion/DiffusionInterfaces/SDInterfaceModel.h>
@@ -105,6 +111,61 @@ static Vector face_norm(Patch::FaceType f)
   }
 }
 
+namespace {
+
+  Uintah::MasterLock g_stats_mutex{};
+
+  //______________________________________________________________________
+  // Adds the time of a particle loop task, and the last level cache
+  // misses of the calling thread and of the LoopThreadPool workers
+  // that ran its blocks if the perf counters are enabled, to the
+  // application stats when it goes out of scope.  Does nothing if the
+  // stats are not reported.
+  class ParticleLoopStats {
+
+  public:
+
+    ParticleLoopStats( ReductionInfoMapper< ApplicationInterface::ApplicationStatsEnum, double > & stats
+                     , bool enabled
+                     )
+      : m_stats( stats )
+      , m_enabled( enabled )
+    {
+      if( m_enabled ) {
+        PerfCounters::read( m_counts );
+        m_timer.start();
+      }
+    }
+
+    ~ParticleLoopStats()
+    {
+      if( !m_enabled ) {
+        return;
+      }
+
+      m_timer.stop();
+
+      uint64_t counts[PerfCounters::NumEvents];
+      PerfCounters::read( counts );
+
+      std::lock_guard<Uintah::MasterLock> lock( g_stats_mutex );
+      m_stats[ (ApplicationInterface::ApplicationStatsEnum) ParticleLoopsTime ] += m_timer().milliseconds();
+      m_stats[ (ApplicationInterface::ApplicationStatsEnum) ParticleLoopsLLCMisses ] +=
+        counts[PerfCounters::LLCMisses] - m_counts[PerfCounters::LLCMisses];
+      m_stats.incrCount( (ApplicationInterface::ApplicationStatsEnum) ParticleLoopsTime );
+      m_stats.incrCount( (ApplicationInterface::ApplicationStatsEnum) ParticleLoopsLLCMisses );
+    }
+
+  private:
+
+    ReductionInfoMapper< ApplicationInterface::ApplicationStatsEnum, double > & m_stats;
+
+    bool           m_enabled;
+    Timers::Simple m_timer;
+    uint64_t       m_counts[PerfCounters::NumEvents];
+  };
+}
+
 SerialMPM::SerialMPM( const ProcessorGroup* myworld,
                       const MaterialManagerP materialManager) :
   MPMCommon( myworld, materialManager )
@@ -127,6 +188,11 @@ SerialMPM::SerialMPM( const ProcessorGroup* myworld,
   // Diffusion related
   d_fluxBC = nullptr;
   d_sdInterfaceModel = nullptr;
+
+  // Particle loop and particle sort stats, see MPMStatsEnum.h
+  m_application_stats.insert( (ApplicationStatsEnum) ParticleLoopsTime,      std::string("MPM_ParticleLoops_Time"),      "milliseconds" );
+  m_application_stats.insert( (ApplicationStatsEnum) ParticleLoopsLLCMisses, std::string("MPM_ParticleLoops_LLCMisses"), "misses"       );
+  m_application_stats.insert( (ApplicationStatsEnum) ParticleSortTime,       std::string("MPM_ParticleSort_Time"),       "milliseconds" );
 }
 
 SerialMPM::~SerialMPM()
@@ -759,6 +825,10 @@ SerialMPM::scheduleTimeAdvance(const LevelP & level,
                                     d_particleState,
                                     lb->pParticleIDLabel, matls, 1);
 
+  if(flags->d_particleSortInterval > 0){
+    scheduleSortParticles(                    sched, patches, matls);
+  }
+
  if(flags->d_useCohesiveZones){
   sched->scheduleParticleRelocation(level, lb->pXLabel_preReloc,
                                     d_cohesiveZoneState_preReloc,
@@ -1639,6 +1709,35 @@ void SerialMPM::scheduleAddParticles(SchedulerP& sched,
   sched->addTask(t, patches, matls);
 }
 
+void SerialMPM::scheduleSortParticles(SchedulerP& sched,
+                                      const PatchSet* patches,
+                                      const MaterialSet* matls)
+{
+  if( !flags->doMPMOnLevel( getLevel(patches)->getIndex(), getLevel(patches)->getGrid()->numLevels() ) ) {
+    return;
+  }
+
+  printSchedule( patches, cout_doing, "MPM::scheduleSortParticles" );
+
+  Task * t = scinew Task("MPM::sortParticles", this, &SerialMPM::sortParticles );
+
+  t->requires(Task::OldDW, lb->timeStepLabel);
+
+  // All the relocated particle variables, per material like Relocate
+  const MaterialSubset* matlsub = matls->getUnion();
+  for(int m = 0; m < matlsub->size(); m++){
+    MaterialSubset* thismatl = scinew MaterialSubset();
+    thismatl->add(matlsub->get(m));
+
+    t->modifies(lb->pXLabel, thismatl);
+    for(unsigned int i = 0; i < d_particleState[m].size(); i++){
+      t->modifies(d_particleState[m][i], thismatl);
+    }
+  }
+
+  sched->addTask(t, patches, matls);
+}
+
 void
 SerialMPM::scheduleComputeParticleScaleFactor(       SchedulerP  & sched,
                                                const PatchSet    * patches,
@@ -2238,6 +2337,8 @@ void SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
                                            DataWarehouse* old_dw,
                                            DataWarehouse* new_dw)
 {
+  ParticleLoopStats loopStats( getApplicationStats(), getApplicationStatsEnabled() );
+
   for(int p=0;p<patches->size();p++){
     const Patch* patch = patches->get(p);
 
@@ -2245,11 +2346,15 @@ void SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
               "Doing MPM::interpolateParticlesToGrid");
 
     unsigned int numMatls = m_materialManager->getNumMatls( "MPM" );
-    ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    const bool parallel = flags->d_parallelParticleLoops;
+    vector<ParticleSlabs::Scratch> scratch =
+      ParticleSlabs::makeScratch(flags->d_interpolator, patch, parallel);
 
-    ParticleInterpolator* linear_interpolator=scinew LinearInterpolator(patch);
+    LinearInterpolator linear;
+    vector<ParticleSlabs::Scratch> linear_scratch;
+    if (flags->d_useCBDI) {
+      linear_scratch = ParticleSlabs::makeScratch(&linear, patch, parallel);
+    }
 
     string interp_type = flags->d_interpolator_type;
 
@@ -2386,18 +2491,42 @@ void SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
       // Vector from the individual mass matrix and velocity vector
       // GridMass * GridVelocity =  S^T*M_D*ParticleVelocity
 
-      Vector total_mom(0.0,0.0,0.0);
       double pSp_vol = 1./mpm_matl->getInitialDensity();
+      const constParticleVariable<Point>* pExternalForceCorners[4] =
+        { &pExternalForceCorner1, &pExternalForceCorner2,
+          &pExternalForceCorner3, &pExternalForceCorner4 };
+
       //loop over all particles in the patch:
-      for (ParticleSubset::iterator iter = pset->begin();
-           iter != pset->end();
-           iter++){
-        particleIndex idx = *iter;
+      ParticleSlabs slabs(patch, pset, px, parallel);
+      slabs.scatter([&](particleIndex idx, int slot) -> bool {
+        vector<IntVector>& ni = scratch[slot].ni;
+        vector<double>&    S  = scratch[slot].S;
         int NN =
-           interpolator->findCellAndWeights(px[idx],ni,S,psize[idx]);
+           scratch[slot].interpolator->findCellAndWeights(px[idx],ni,S,psize[idx]);
+        if (!slabs.owns(slot, ni, NN)) {
+          return false;
+        }
+
+        // CBDI spreads the external force over the particle's corners
+        const bool cbdi = flags->d_useCBDI && pLoadCurveID[idx].x()>0;
+        vector<IntVector> niCorner[4];
+        vector<double> SCorner[4];
+        if (cbdi) {
+          ParticleInterpolator* linear_interpolator =
+                                linear_scratch[slot].interpolator.get();
+          for (int c = 0; c < 4; c++) {
+            niCorner[c].resize(linear_interpolator->size());
+            SCorner[c].resize(linear_interpolator->size());
+            linear_interpolator->findCellAndWeights((*pExternalForceCorners[c])[idx],
+                                   niCorner[c],SCorner[c],psize[idx]);
+            if (!slabs.owns(slot, niCorner[c], 8)) {
+              return false;
+            }
+          }
+        }
+
         Vector pmom = pvelocity[idx]*pmass[idx];
         double ptemp_ext = pTemperature[idx];
-        total_mom += pmom;
 
         // Add each particles contribution to the local mass & velocity
         // Must use the node indices
@@ -2444,43 +2573,18 @@ void SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
             }
           }
         }
-        if (flags->d_useCBDI && pLoadCurveID[idx].x()>0) {
-          vector<IntVector> niCorner1(linear_interpolator->size());
-          vector<IntVector> niCorner2(linear_interpolator->size());
-          vector<IntVector> niCorner3(linear_interpolator->size());
-          vector<IntVector> niCorner4(linear_interpolator->size());
-          vector<double> SCorner1(linear_interpolator->size());
-          vector<double> SCorner2(linear_interpolator->size());
-          vector<double> SCorner3(linear_interpolator->size());
-          vector<double> SCorner4(linear_interpolator->size());
-          linear_interpolator->findCellAndWeights(pExternalForceCorner1[idx],
-                                 niCorner1,SCorner1,psize[idx]);
-          linear_interpolator->findCellAndWeights(pExternalForceCorner2[idx],
-                                 niCorner2,SCorner2,psize[idx]);
-          linear_interpolator->findCellAndWeights(pExternalForceCorner3[idx],
-                                 niCorner3,SCorner3,psize[idx]);
-          linear_interpolator->findCellAndWeights(pExternalForceCorner4[idx],
-                                 niCorner4,SCorner4,psize[idx]);
+        if (cbdi) {
           for(int k = 0; k < 8; k++) { // Iterates through the nodes which receive information from the current particle
-            node = niCorner1[k];
-            if(patch->containsNode(node)) {
-              gexternalforce[node] += pexternalforce[idx] * SCorner1[k];
-            }
-            node = niCorner2[k];
-            if(patch->containsNode(node)) {
-              gexternalforce[node] += pexternalforce[idx] * SCorner2[k];
-            }
-            node = niCorner3[k];
-            if(patch->containsNode(node)) {
-              gexternalforce[node] += pexternalforce[idx] * SCorner3[k];
-            }
-            node = niCorner4[k];
-            if(patch->containsNode(node)) {
-              gexternalforce[node] += pexternalforce[idx] * SCorner4[k];
+            for (int c = 0; c < 4; c++) {
+              node = niCorner[c][k];
+              if(patch->containsNode(node)) {
+                gexternalforce[node] += pexternalforce[idx] * SCorner[c][k];
+              }
             }
           }
         }
-      } // End of particle loop
+        return true;
+      }); // End of particle loop
       for(NodeIterator iter=patch->getExtraNodeIterator();
                        !iter.done();iter++){
         IntVector c = *iter;
@@ -2530,8 +2634,6 @@ void SerialMPM::interpolateParticlesToGrid(const ProcessorGroup*,
       gtempglobal[c] /= gmassglobal[c];
       gvelglobal[c] /= gmassglobal[c];
     }
-    delete interpolator;
-    delete linear_interpolator;
   }  // End loop over patches
 }
 
@@ -2931,6 +3033,8 @@ void SerialMPM::computeInternalForce(const ProcessorGroup*,
                                      DataWarehouse* old_dw,
                                      DataWarehouse* new_dw)
 {
+  ParticleLoopStats loopStats( getApplicationStats(), getApplicationStatsEnabled() );
+
   // node based forces
   Vector bndyForce[6];
   Vector bndyTraction[6];
@@ -2951,10 +3055,9 @@ void SerialMPM::computeInternalForce(const ProcessorGroup*,
     Matrix3 Id;
     Id.Identity();
 
-    ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
-    vector<Vector> d_S(interpolator->size());
+    const bool parallel = flags->d_parallelParticleLoops;
+    vector<ParticleSlabs::Scratch> scratch =
+      ParticleSlabs::makeScratch(flags->d_interpolator, patch, parallel);
     string interp_type = flags->d_interpolator_type;
 
     unsigned int numMPMMatls = m_materialManager->getNumMatls( "MPM" );
@@ -3023,22 +3126,24 @@ void SerialMPM::computeInternalForce(const ProcessorGroup*,
 
       internalforce.initialize(Vector(0,0,0));
 
-      Matrix3 stressvol;
-      Matrix3 stresspress;
+      ParticleSlabs slabs(patch, pset, px, parallel);
 
       // for the non axisymmetric case:
       if(!flags->d_axisymmetric){
-        for (ParticleSubset::iterator iter = pset->begin();
-             iter != pset->end();
-             iter++){
-          particleIndex idx = *iter;
+        slabs.scatter([&](particleIndex idx, int slot) -> bool {
+          vector<IntVector>& ni  = scratch[slot].ni;
+          vector<double>&    S   = scratch[slot].S;
+          vector<Vector>&    d_S = scratch[slot].d_S;
 
           // Get the node indices that surround the cell
           int NN =
-            interpolator->findCellAndWeightsAndShapeDerivatives(px[idx],ni,S,
-                                                     d_S,psize[idx]);
-          stressvol  = pstress[idx]*pvol[idx];
-          stresspress = pstress[idx] + Id*(p_pressure[idx] - p_q[idx]);
+            scratch[slot].interpolator->findCellAndWeightsAndShapeDerivatives(
+                                                     px[idx],ni,S,d_S,psize[idx]);
+          if (!slabs.owns(slot, ni, NN)) {
+            return false;
+          }
+          Matrix3 stressvol  = pstress[idx]*pvol[idx];
+          Matrix3 stresspress = pstress[idx] + Id*(p_pressure[idx] - p_q[idx]);
 
           for (int k = 0; k < NN; k++){
             if(patch->containsNode(ni[k])){
@@ -3048,22 +3153,26 @@ void SerialMPM::computeInternalForce(const ProcessorGroup*,
               gstress[ni[k]]       += stressvol * S[k];
             }
           }
-        }
+          return true;
+        });
       }
 
       // for the axisymmetric case
       if(flags->d_axisymmetric){
-        for (ParticleSubset::iterator iter = pset->begin();
-             iter != pset->end();
-             iter++){
-          particleIndex idx = *iter;
+        slabs.scatter([&](particleIndex idx, int slot) -> bool {
+          vector<IntVector>& ni  = scratch[slot].ni;
+          vector<double>&    S   = scratch[slot].S;
+          vector<Vector>&    d_S = scratch[slot].d_S;
 
           int NN =
-            interpolator->findCellAndWeightsAndShapeDerivatives(px[idx],ni,S,
-                                                   d_S,psize[idx]);
+            scratch[slot].interpolator->findCellAndWeightsAndShapeDerivatives(
+                                                   px[idx],ni,S,d_S,psize[idx]);
+          if (!slabs.owns(slot, ni, NN)) {
+            return false;
+          }
 
-          stressvol   = pstress[idx]*pvol[idx];
-          stresspress = pstress[idx] + Id*(p_pressure[idx] - p_q[idx]);
+          Matrix3 stressvol   = pstress[idx]*pvol[idx];
+          Matrix3 stresspress = pstress[idx] + Id*(p_pressure[idx] - p_q[idx]);
 
           // r is the x direction, z (axial) is the y direction
           double IFr=0.,IFz=0.;
@@ -3078,7 +3187,8 @@ void SerialMPM::computeInternalForce(const ProcessorGroup*,
               gstress[ni[k]]       += stressvol * S[k];
             }
           }
-        }
+          return true;
+        });
       }
 
       for(NodeIterator iter =patch->getNodeIterator();!iter.done();iter++){
@@ -3135,7 +3245,6 @@ void SerialMPM::computeInternalForce(const ProcessorGroup*,
       IntVector c = *iter;
       gstressglobal[c] /= gvolumeglobal[c];
     }
-    delete interpolator;
   }
 
   // be careful only to put the fields that we have built
@@ -3734,14 +3843,16 @@ void SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
                                                 DataWarehouse* old_dw,
                                                 DataWarehouse* new_dw)
 {
+  ParticleLoopStats loopStats( getApplicationStats(), getApplicationStatsEnabled() );
+
   for(int p=0;p<patches->size();p++){
     const Patch* patch = patches->get(p);
     printTask(patches, patch,cout_doing,
               "Doing MPM::interpolateToParticlesAndUpdate");
 
-    ParticleInterpolator* interpolator = flags->d_interpolator->clone(patch);
-    vector<IntVector> ni(interpolator->size());
-    vector<double> S(interpolator->size());
+    const bool parallel = flags->d_parallelParticleLoops;
+    vector<ParticleSlabs::Scratch> scratch =
+      ParticleSlabs::makeScratch(flags->d_interpolator, patch, parallel);
 
     // Performs the interpolation from the cell vertices of the grid
     // acceleration and velocity to the particles to update their
@@ -3758,6 +3869,30 @@ void SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
     double minPatchConc =  5e11;
     double maxPatchConc = -5e11;
 
+    // The sums of one slab of particles (ParticleSlabs), the slabs are
+    // added in order so the result does not depend on the threads.
+    struct Sums {
+      double thermal_energy;
+      double totalmass;
+      Vector CMX;
+      Vector totalMom;
+      double ke;
+      double totalConc;
+      double minPatchConc;
+      double maxPatchConc;
+
+      void add(const Sums& other) {
+        thermal_energy += other.thermal_energy;
+        totalmass      += other.totalmass;
+        CMX            += other.CMX;
+        totalMom       += other.totalMom;
+        ke             += other.ke;
+        totalConc      += other.totalConc;
+        minPatchConc    = Min(minPatchConc, other.minPatchConc);
+        maxPatchConc    = Max(maxPatchConc, other.maxPatchConc);
+      }
+    };
+
     unsigned int numMPMMatls=m_materialManager->getNumMatls( "MPM" );
     delt_vartype delT;
     old_dw->get(delT, lb->delTLabel, getLevel(patches) );
@@ -3885,14 +4020,22 @@ void SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
       }
 
 
+      // Slab 0 continues the running sums.
+      ParticleSlabs slabs(patch, pset, px, parallel);
+      vector<Sums> slab_sums(slabs.numSlabs(),
+                             Sums{0., 0., Vector(0.0), Vector(0.0), 0., 0., 5e11, -5e11});
+      slab_sums[0] = Sums{thermal_energy, totalmass, CMX, totalMom, ke,
+                          totalConc, minPatchConc, maxPatchConc};
+
       if(flags->d_XPIC2){
         // Loop over particles
-        for(ParticleSubset::iterator iter = pset->begin();
-            iter != pset->end(); iter++){
-          particleIndex idx = *iter;
+        slabs.gather([&](particleIndex idx, int slot, int slab) {
+          vector<IntVector>& ni = scratch[slot].ni;
+          vector<double>&    S  = scratch[slot].S;
+          Sums& sums = slab_sums[slab];
 
           // Get the node indices that surround the cell
-          int NN = interpolator->findCellAndWeights(px[idx], ni, S,
+          int NN = scratch[slot].interpolator->findCellAndWeights(px[idx], ni, S,
                                                     pcursize[idx]);
           Vector vel(0.0,0.0,0.0);
           Vector velSSPSSP(0.0,0.0,0.0);
@@ -3949,30 +4092,31 @@ void SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
             pConcPreviousNew[idx] = pConcentration[idx];
             if (mpm_matl->doConcReduction()) {
               if (flags->d_autoCycleUseMinMax) {
-                if (pConcentrationNew[idx] > maxPatchConc)
-                  maxPatchConc = pConcentrationNew[idx];
-                if (pConcentrationNew[idx] < minPatchConc)
-                  minPatchConc = pConcentrationNew[idx];
+                if (pConcentrationNew[idx] > sums.maxPatchConc)
+                  sums.maxPatchConc = pConcentrationNew[idx];
+                if (pConcentrationNew[idx] < sums.minPatchConc)
+                  sums.minPatchConc = pConcentrationNew[idx];
               } else {
-                totalConc += pConcentration[idx];
+                sums.totalConc += pConcentration[idx];
               }
             }
           }
 
-          thermal_energy += pTemperature[idx] * pmass[idx] * Cp;
-          ke += .5*pmass[idx]*pvelnew[idx].length2();
-          CMX         = CMX + (pxnew[idx]*pmass[idx]).asVector();
-          totalMom   += pvelnew[idx]*pmass[idx];
-          totalmass  += pmass[idx];
-        }
+          sums.thermal_energy += pTemperature[idx] * pmass[idx] * Cp;
+          sums.ke += .5*pmass[idx]*pvelnew[idx].length2();
+          sums.CMX         = sums.CMX + (pxnew[idx]*pmass[idx]).asVector();
+          sums.totalMom   += pvelnew[idx]*pmass[idx];
+          sums.totalmass  += pmass[idx];
+        });
       } else {  // Not XPIC(2)
         // Loop over particles
-        for(ParticleSubset::iterator iter = pset->begin();
-            iter != pset->end(); iter++){
-          particleIndex idx = *iter;
+        slabs.gather([&](particleIndex idx, int slot, int slab) {
+          vector<IntVector>& ni = scratch[slot].ni;
+          vector<double>&    S  = scratch[slot].S;
+          Sums& sums = slab_sums[slab];
 
           // Get the node indices that surround the cell
-          int NN = interpolator->findCellAndWeights(px[idx], ni, S,
+          int NN = scratch[slot].interpolator->findCellAndWeights(px[idx], ni, S,
                                                     pcursize[idx]);
           Vector vel(0.0,0.0,0.0);
           Vector acc(0.0,0.0,0.0);
@@ -4020,24 +4164,36 @@ void SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
             pConcPreviousNew[idx] = pConcentration[idx];
             if (mpm_matl->doConcReduction()) {
               if (flags->d_autoCycleUseMinMax) {
-                if (pConcentrationNew[idx] > maxPatchConc)
-                  maxPatchConc = pConcentrationNew[idx];
-                if (pConcentrationNew[idx] < minPatchConc)
-                  minPatchConc = pConcentrationNew[idx];
+                if (pConcentrationNew[idx] > sums.maxPatchConc)
+                  sums.maxPatchConc = pConcentrationNew[idx];
+                if (pConcentrationNew[idx] < sums.minPatchConc)
+                  sums.minPatchConc = pConcentrationNew[idx];
               } else {
-                totalConc += pConcentration[idx];
+                sums.totalConc += pConcentration[idx];
               }
             }
           }
 
-          thermal_energy += pTemperature[idx] * pmass[idx] * Cp;
-          ke += .5*pmass[idx]*pvelnew[idx].length2();
-          CMX         = CMX + (pxnew[idx]*pmass[idx]).asVector();
-          totalMom   += pvelnew[idx]*pmass[idx];
-          totalmass  += pmass[idx];
-        }
+          sums.thermal_energy += pTemperature[idx] * pmass[idx] * Cp;
+          sums.ke += .5*pmass[idx]*pvelnew[idx].length2();
+          sums.CMX         = sums.CMX + (pxnew[idx]*pmass[idx]).asVector();
+          sums.totalMom   += pvelnew[idx]*pmass[idx];
+          sums.totalmass  += pmass[idx];
+        });
       } // use XPIC(2) or not
 
+      for (int slab = 1; slab < slabs.numSlabs(); slab++) {
+        slab_sums[0].add(slab_sums[slab]);
+      }
+      thermal_energy = slab_sums[0].thermal_energy;
+      totalmass      = slab_sums[0].totalmass;
+      CMX            = slab_sums[0].CMX;
+      totalMom       = slab_sums[0].totalMom;
+      ke             = slab_sums[0].ke;
+      totalConc      = slab_sums[0].totalConc;
+      minPatchConc   = slab_sums[0].minPatchConc;
+      maxPatchConc   = slab_sums[0].maxPatchConc;
+
       // scale back huge particle velocities.
       // Default for d_max_vel is 3.e105, hence the conditional
       if(flags->d_max_vel < 1.e105){
@@ -4078,7 +4234,6 @@ void SerialMPM::interpolateToParticlesAndUpdate(const ProcessorGroup*,
     if(flags->d_reductionVars->centerOfMass){
       new_dw->put(sumvec_vartype(CMX),         lb->CenterOfMassPositionLabel);
     }
-    delete interpolator;
   }
 }
 
@@ -5157,6 +5312,56 @@ void SerialMPM::addParticles(const ProcessorGroup*,
   }    // for patches
 }
 
+void SerialMPM::sortParticles(const ProcessorGroup*,
+                              const PatchSubset* patches,
+                              const MaterialSubset* ,
+                              DataWarehouse* old_dw,
+                              DataWarehouse* new_dw)
+{
+  timeStep_vartype timeStep;
+  old_dw->get(timeStep, lb->timeStepLabel);
+
+  if( timeStep % flags->d_particleSortInterval != 0 ) {
+    return;
+  }
+
+  const ParticleSort::Curve curve = ParticleSort::getCurve( flags->d_particleSortCurve );
+
+  for(int p=0;p<patches->size();p++){
+    const Patch* patch = patches->get(p);
+    printTask(patches, patch,cout_doing, "Doing MPM::sortParticles");
+
+    Timers::Simple timer;
+    timer.start();
+
+    unsigned int numMatls = m_materialManager->getNumMatls( "MPM" );
+    for(unsigned int m = 0; m < numMatls; m++){
+      MPMMaterial* mpm_matl = (MPMMaterial*) m_materialManager->getMaterial( "MPM", m );
+      int dwi = mpm_matl->getDWIndex();
+      ParticleSubset* pset = new_dw->getParticleSubset(dwi, patch);
+
+      constParticleVariable<Point> px;
+      new_dw->get(px, lb->pXLabel, pset);
+
+      vector<ParticleVariableBase*> vars;
+      vars.push_back(new_dw->getParticleVariable(lb->pXLabel, pset));
+      for(unsigned int i = 0; i < d_particleState[m].size(); i++){
+        vars.push_back(new_dw->getParticleVariable(d_particleState[m][i], pset));
+      }
+
+      ParticleSort::sortParticles(curve, patch, pset, px, vars);
+    }
+
+    timer.stop();
+
+    if( getApplicationStatsEnabled() ) {
+      std::lock_guard<Uintah::MasterLock> lock( g_stats_mutex );
+      getApplicationStats()[ (ApplicationInterface::ApplicationStatsEnum) ParticleSortTime ] += timer().milliseconds();
+      getApplicationStats().incrCount( (ApplicationInterface::ApplicationStatsEnum) ParticleSortTime );
+    }
+  }
+}
+
 void SerialMPM::computeParticleScaleFactor(const ProcessorGroup*,
                                            const PatchSubset* patches,
                                            const MaterialSubset* ,
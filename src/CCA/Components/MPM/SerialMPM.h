@@ -407,6 +407,14 @@ protected:
                             DataWarehouse* old_dw,
                             DataWarehouse* new_dw);
 
+  // Reorders the particles of every patch by cell along a space-filling
+  // curve (ParticleSort), every d_particleSortInterval timesteps.
+  virtual void sortParticles(const ProcessorGroup*,
+                             const PatchSubset* patches,
+                             const MaterialSubset* matls,
+                             DataWarehouse* old_dw,
+                             DataWarehouse* new_dw);
+
 
   // Used to compute the particles initial physical size
   // for use in deformed particle visualization
@@ -533,6 +541,10 @@ protected:
                                     const PatchSet*,
                                     const MaterialSet*);
 
+  virtual void scheduleSortParticles(SchedulerP&,
+                                     const PatchSet*,
+                                     const MaterialSet*);
+
   virtual void scheduleComputeParticleScaleFactor(SchedulerP&, 
                                                   const PatchSet*,
                                                   const MaterialSet*);
@@ -28,7 +28,6 @@
 
 #include <Core/Grid/DbgOutput.h>
 #include <Core/Grid/Variables/PerPatch.h>
-#include <Core/Math/MersenneTwister.h>
 #include <Core/Util/DOUT.hpp>
 #include <fstream>
 
@@ -100,6 +99,7 @@ RMCRTCommon::RMCRTCommon( TypeDescription::Type FLT_DBL )
 
   d_boundFluxLabel     = VarLabel::create( "RMCRTboundFlux",   CCVariable<Stencil7>::getTypeDescription() );
   d_radiationVolqLabel = VarLabel::create( "radiationVolq",    CCVariable<double>::getTypeDescription() );
+  d_timeStepLabel      = VarLabel::create( timeStep_name,      timeStep_vartype::getTypeDescription() );
 
   d_gac          = Ghost::AroundCells;
   d_gn           = Ghost::None;
@@ -120,6 +120,7 @@ RMCRTCommon::~RMCRTCommon()
   VarLabel::destroy( d_sigmaT4Label );
   VarLabel::destroy( d_boundFluxLabel );
   VarLabel::destroy( d_radiationVolqLabel );
+  VarLabel::destroy( d_timeStepLabel );
 
   if (RMCRTCommon::d_FLT_DBL == TypeDescription::float_type){
     VarLabel::destroy( d_abskgLabel );
@@ -379,18 +380,12 @@ RMCRTCommon::raySignStep(double sign[],
 //  Compute the ray direction
 //______________________________________________________________________
 Vector
-RMCRTCommon::findRayDirection(MTRand& mTwister,
-                             const IntVector& origin,
-                             const int iRay )
+RMCRTCommon::findRayDirection( Philox& rng )
 {
-  if( d_isSeedRandom == false ){
-    mTwister.seed((origin.x() + origin.y() + origin.z()) * iRay +1);
-  }
-
   // Random Points On Sphere
-  double plusMinus_one = 2.0 * mTwister.randDblExc() - 1.0 + DBL_EPSILON;  // add fuzz to avoid inf in 1/dirVector
+  double plusMinus_one = 2.0 * rng.randDblExc() - 1.0 + DBL_EPSILON;  // add fuzz to avoid inf in 1/dirVector
   double r = sqrt(1.0 - plusMinus_one * plusMinus_one);     // Radius of circle at z
-  double theta = 2.0 * M_PI * mTwister.randDblExc();        // Uniform betwen 0-2Pi
+  double theta = 2.0 * M_PI * rng.randDblExc();             // Uniform betwen 0-2Pi
 
   Vector direction_vector;
   direction_vector[0] = r*cos(theta);                       // Convert to cartesian
@@ -424,7 +419,7 @@ RMCRTCommon::findRayDirection(MTRand& mTwister,
 //  Compute the physical location of a ray's origin
 //______________________________________________________________________
 void
-RMCRTCommon::ray_Origin( MTRand& mTwister,
+RMCRTCommon::ray_Origin( Philox& rng,
                          const Point  CC_pos,
                          const Vector dx,
                          const bool   useCCRays,
@@ -432,9 +427,9 @@ RMCRTCommon::ray_Origin( MTRand& mTwister,
 {
   if( useCCRays == false ){
     
-    double x = mTwister.rand() * dx.x();
-    double y = mTwister.rand() * dx.y();
-    double z = mTwister.rand() * dx.z();
+    double x = rng.rand() * dx.x();
+    double y = rng.rand() * dx.y();
+    double z = rng.rand() * dx.z();
     
     Vector offset(x,y,z);  // Note you HAVE to compute the components separately to ensure that the 
                            //  random numbers called in the x,y,z order -Todd
@@ -442,7 +437,7 @@ RMCRTCommon::ray_Origin( MTRand& mTwister,
     if ( offset.x() > dx.x() || 
          offset.y() > dx.y() ||
          offset.z() > dx.z() ) {
-      std::cout << "  Warning:ray_Origin  The Mersenne twister random number generator has returned garbage (" << offset
+      std::cout << "  Warning:ray_Origin  The random number generator has returned garbage (" << offset
                 << ") Now forcing the ray origin to be located at the cell-center\n" ;
       offset = Vector( 0.5*dx.x(), 0.5*dx.y(), 0.5*dx.z() );
     }
@@ -498,7 +493,7 @@ RMCRTCommon::updateSumI (const Level* level,
                          constCCVariable<int>& celltype,
                          unsigned long int& nRaySteps,
                          double& sumI,
-                         MTRand& mTwister)
+                         Philox& rng)
 
 {
   IntVector cur = origin;
@@ -554,7 +549,7 @@ RMCRTCommon::updateSumI (const Level* level,
 
   // Determine the length at which scattering will occur
   // See CCA/Components/Arches/RMCRT/PaulasAttic/MCRT/ArchesRMCRT/ray.cc
-  double scatLength = -log(mTwister.randDblExc() ) / scatCoeff; 
+  double scatLength = -log(rng.randDblExc() ) / scatCoeff; 
 #endif
 
   //______________________________________________________________________
@@ -673,9 +668,9 @@ RMCRTCommon::updateSumI (const Level* level,
       if (rayLength_scatter > scatLength && in_domain ){
             
         // get new scatLength for each scattering event
-        scatLength = -log(mTwister.randDblExc() ) / scatCoeff;
+        scatLength = -log(rng.randDblExc() ) / scatCoeff;
 
-        ray_direction     =  findRayDirection( mTwister, cur );
+        ray_direction     =  findRayDirection( rng );
 
         inv_ray_direction = Vector(1.0)/ray_direction;
 
@@ -896,8 +891,7 @@ RMCRTCommon::isDbgCell( const IntVector me)
 //______________________________________________________________________
 void
 RMCRTCommon::randVector( std::vector <int> &int_array,
-                         MTRand& mTwister,
-                         const IntVector& cell )
+                         Philox& rng )
 {
   int max= int_array.size();
 
@@ -905,16 +899,12 @@ RMCRTCommon::randVector( std::vector <int> &int_array,
     int_array[i] = i;
   }
 
-  if( d_isSeedRandom == false ){
-    mTwister.seed((cell.x() + cell.y() + cell.z()));
-  }
-
   for (int i=max-1; i>0; i--){  // fisher-yates shuffle starting with max-1
 
 #ifdef FIXED_RANDOM_NUM
     int rand_int =  0.3*i;  
 #else
-    int rand_int =  mTwister.randInt(i);
+    int rand_int =  rng.randInt(i);
 #endif 
     int swap = int_array[i];
     int_array[i] = int_array[rand_int];
@@ -922,6 +912,47 @@ RMCRTCommon::randVector( std::vector <int> &int_array,
   }
 }
 
+//______________________________________________________________________
+//  Each ray draws from its own counter based stream.  The key is the
+//  timestep (0 if the seed is not random, i.e. the same rays every
+//  timestep) and the level index (upper 8 bits) with the z index of the
+//  cell (lower 24 bits), the counter the stream type, the ray index and
+//  the x and y indices.  A ray therefore gets the same random numbers no
+//  matter which thread traces it, in which order and on which patch,
+//  and the cells of different levels do not share streams.
+//______________________________________________________________________
+Philox
+RMCRTCommon::rayStream( const IntVector& cell,
+                        const int L,
+                        const int timeStep,
+                        const int which,
+                        const int iRay )
+{
+  const uint32_t seed = d_isSeedRandom ? timeStep : 0;
+  const uint32_t plane = ( uint32_t( L ) << 24 ) | ( uint32_t( cell.z() ) & 0xFFFFFF );
+  const uint32_t ray   = ( uint32_t( which ) << 28 ) | uint32_t( iRay );
+
+  return Philox( seed, plane, ray, cell.x(), cell.y() );
+}
+
+//______________________________________________________________________
+//
+int
+RMCRTCommon::getTimeStep( DataWarehouse* old_dw,
+                          DataWarehouse* new_dw )
+{
+  timeStep_vartype timeStepVar(0);
+
+  if( old_dw && old_dw->exists( d_timeStepLabel ) ){
+    old_dw->get( timeStepVar, d_timeStepLabel );
+  }
+  else if( new_dw && new_dw->exists( d_timeStepLabel ) ){
+    new_dw->get( timeStepVar, d_timeStepLabel );
+  }
+
+  return timeStepVar;
+}
+
 //______________________________________________________________________
 // For RMCRT algorithms the absorption coefficient can be required from either the old_dw or
 // new_dw depending on if RMCRT:float is specified.  On coarse levels abskg _always_ resides
@@ -1003,8 +1034,8 @@ RMCRTCommon::get_abskg_whichDW ( const int L,
 // Explicit template instantiations:
 
 template void
-  RMCRTCommon::updateSumI ( const Level*, Vector&, Vector&, const IntVector&, const Vector&, constCCVariable< double >&, constCCVariable<double>&, constCCVariable<int>&, unsigned long int&, double&, MTRand&);
+  RMCRTCommon::updateSumI ( const Level*, Vector&, Vector&, const IntVector&, const Vector&, constCCVariable< double >&, constCCVariable<double>&, constCCVariable<int>&, unsigned long int&, double&, Philox&);
 
 template void
-  RMCRTCommon::updateSumI ( const Level*, Vector&, Vector&, const IntVector&, const Vector&, constCCVariable< float >&, constCCVariable<float>&, constCCVariable<int>&, unsigned long int&, double&, MTRand&);
+  RMCRTCommon::updateSumI ( const Level*, Vector&, Vector&, const IntVector&, const Vector&, constCCVariable< float >&, constCCVariable<float>&, constCCVariable<int>&, unsigned long int&, double&, Philox&);
 
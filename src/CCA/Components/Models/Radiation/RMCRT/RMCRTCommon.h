@@ -31,6 +31,7 @@
 #include <Core/Grid/Variables/CCVariable.h>
 #include <Core/Math/Expon.h>
 #include <Core/Disclosure/TypeDescription.h>
+#include <Core/Math/Philox.h>
 
 #include <sci_defs/uintah_defs.h>
 
@@ -51,7 +52,6 @@
  #        This allows for a significant savings in memory and communication costs
  *
  */
-class MTRand;
 
 namespace Uintah{
 
@@ -85,7 +85,7 @@ namespace Uintah{
                          constCCVariable<int>& celltype,
                          unsigned long int& size,
                          double& sumI,
-                         MTRand& mTwister);
+                         Philox& rng);
 
       //__________________________________
       /** @brief Schedule compute of blackbody intensity */
@@ -139,7 +139,7 @@ namespace Uintah{
 
       //__________________________________
       //
-      void ray_Origin( MTRand& mTwister,
+      void ray_Origin( Philox& rng,
                        const Point  CC_position,
                        const Vector Dx,
                        const bool useCCRays,
@@ -147,15 +147,25 @@ namespace Uintah{
 
       //__________________________________
       //
-      Vector findRayDirection( MTRand& mTwister,
-                               const IntVector& = IntVector(-9,-9,-9),
-                               const int iRay = -9);
+      Vector findRayDirection( Philox& rng );
 
       //__________________________________
       /** @brief populates a vector of integers with a stochastic array without replacement from 0 to n-1 */
       void randVector( std::vector <int> &int_array,
-                       MTRand& mTwister,
-                       const IntVector& cell);
+                       Philox& rng );
+
+      //__________________________________
+      /** @brief The random number stream of ray iRay from cell on level L, see RAY_STREAM */
+      Philox rayStream( const IntVector& cell,
+                        const int L,
+                        const int timeStep,
+                        const int which,
+                        const int iRay );
+
+      //__________________________________
+      /** @brief The timestep from the old_dw, or the new_dw, 0 if neither has it */
+      int getTimeStep( DataWarehouse* old_dw,
+                       DataWarehouse* new_dw );
 
 
       //______________________________________________________________________
@@ -233,6 +243,18 @@ namespace Uintah{
         , NUM_GRAPHS
       };
 
+      // What a random number stream is drawn for.  The rays of a cell draw
+      // from streams that only depend on the cell, its level, the ray index
+      // and the timestep, so the results do not depend on the order in which the
+      // cells and rays are traced.
+      enum RAY_STREAM {
+          DIVQ_RAY         = 0              // divQ rays
+        , FLUX_RAY         = 1              // boundary flux rays, iRay = face * nFluxRays + ray
+        , RADIOMETER_RAY   = 2              // radiometer rays
+        , DIVQ_LHC         = 3              // Latin-Hyper-Cube permutation of a cell, iRay = 0
+        , FLUX_LHC         = 4              // Latin-Hyper-Cube permutation of a face, iRay = face
+      };
+
       enum Algorithm{ dataOnion,            
                       coarseLevel, 
                       singleLevel, 
@@ -277,6 +299,8 @@ namespace Uintah{
       static const VarLabel* d_compAbskgLabel;      //  Absorption Coefficient
       static const VarLabel* d_cellTypeLabel;       //  cell type marker
 
+      const VarLabel* d_timeStepLabel{nullptr};
+
       fastApproxExponent d_fastExp;
 
 
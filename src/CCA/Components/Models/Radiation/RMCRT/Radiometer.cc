@@ -31,7 +31,6 @@
 #include <Core/Geometry/BBox.h>
 #include <Core/Grid/DbgOutput.h>
 #include <Core/Grid/Variables/PerPatch.h>
-#include <Core/Math/MersenneTwister.h>
 #include <Core/Util/DOUT.hpp>
 
 #include <fstream>
@@ -315,6 +314,9 @@ Radiometer::sched_radiometer( const LevelP& level,
   tsk->requires(sigma_dw,    d_sigmaT4Label,  gac, SHRT_MAX);
   tsk->requires(celltype_dw, d_cellTypeLabel, gac, SHRT_MAX);
 
+  // the timestep keys the random number streams
+  tsk->requires(Task::OldDW, d_timeStepLabel);
+
   tsk->modifies(d_VRFluxLabel);
   tsk->modifies(d_VRIntensityLabel);
 
@@ -343,7 +345,7 @@ Radiometer::radiometer( const ProcessorGroup* pg,
 
   //__________________________________
   //
-  MTRand mTwister;
+  const int timeStep = getTimeStep( old_dw, new_dw );
 
   DataWarehouse* abskg_dw    = new_dw->getOtherDataWarehouse(which_abskg_dw);
   DataWarehouse* sigmaT4_dw  = new_dw->getOtherDataWarehouse(whichd_sigmaT4_dw);
@@ -364,7 +366,7 @@ Radiometer::radiometer( const ProcessorGroup* pg,
     const Patch* patch = patches->get(p);
 
     bool modifiesFlux= true;
-    radiometerFlux < T > ( patch, level, new_dw, mTwister, sigmaT4OverPi, abskg, celltype, modifiesFlux );
+    radiometerFlux < T > ( patch, level, new_dw, timeStep, sigmaT4OverPi, abskg, celltype, modifiesFlux );
 
   }  // end patch loop
 }  // end radiometer
@@ -377,7 +379,7 @@ void
 Radiometer::radiometerFlux( const Patch* patch,
                             const Level* level,
                             DataWarehouse* new_dw,
-                            MTRand& mTwister,
+                            const int timeStep,
                             constCCVariable< T > sigmaT4OverPi,
                             constCCVariable< T > abskg,
                             constCCVariable<int> celltype,
@@ -424,17 +426,19 @@ Radiometer::radiometerFlux( const Patch* patch,
       // ray loop
       for (int iRay=0; iRay < d_VR_nRays; iRay++){
 
+        Philox rng = rayStream( c, level->getIndex(), timeStep, RADIOMETER_RAY, iRay );
+
         Vector rayOrigin;
         bool useCCRays = true;
-        ray_Origin( mTwister, CC_pos, Dx, useCCRays, rayOrigin);
+        ray_Origin( rng, CC_pos, Dx, useCCRays, rayOrigin);
 
 
         double cosVRTheta;
         Vector direction_vector;
-        rayDirection_VR( mTwister, c, iRay, d_VR, direction_vector, cosVRTheta);
+        rayDirection_VR( rng, d_VR, direction_vector, cosVRTheta);
 
         // get the intensity for this ray
-        updateSumI< T >(level, direction_vector, rayOrigin, c, Dx, sigmaT4OverPi, abskg, celltype, size, sumI, mTwister);
+        updateSumI< T >(level, direction_vector, rayOrigin, c, Dx, sigmaT4OverPi, abskg, celltype, size, sumI, rng);
 
         sumProjI += cosVRTheta * (sumI - sumI_prev); // must subtract sumI_prev, since sumI accumulates intensity
                                                      // from all the rays up to that point
@@ -454,17 +458,11 @@ Radiometer::radiometerFlux( const Patch* patch,
 //    Compute the Ray direction for Virtual Radiometer
 //______________________________________________________________________
 void
-Radiometer::rayDirection_VR( MTRand& mTwister,
-                             const IntVector& origin,
-                             const int iRay,
+Radiometer::rayDirection_VR( Philox& rng,
                              VR_variables& VR,
                              Vector& direction_vector,
                              double& cosVRTheta)
 {
-  if( d_isSeedRandom == false ){
-    mTwister.seed((origin.x() + origin.y() + origin.z()) * iRay +1);
-  }
-
   // to help code readability
   double thetaRot   = VR.thetaRot;
   double deltaTheta = VR.deltaTheta;
@@ -474,10 +472,10 @@ Radiometer::rayDirection_VR( MTRand& mTwister,
 
   // Generate two uniformly-distributed-over-the-solid-angle random numbers
   // Used in determining the ray direction
-  double phi = 2 * M_PI * mTwister.randDblExc(); //azimuthal angle. Range of 0 to 2pi
+  double phi = 2 * M_PI * rng.randDblExc(); //azimuthal angle. Range of 0 to 2pi
 
   // This guarantees that the polar angle of the ray is within the delta_theta
-  double VRTheta = acos( cos(deltaTheta) + range * mTwister.randDblExc());
+  double VRTheta = acos( cos(deltaTheta) + range * rng.randDblExc());
   cosVRTheta = cos(VRTheta);
 
   // Convert to Cartesian x,y, and z represent the pre-rotated direction vector of a ray
@@ -562,10 +560,10 @@ Radiometer::getPatchSet( SchedulerP& sched,
 // Explicit template instantiations:
 
 template void
-Radiometer::radiometerFlux( const Patch*, const Level*, DataWarehouse*, MTRand&,
+Radiometer::radiometerFlux( const Patch*, const Level*, DataWarehouse*, const int,
                             constCCVariable< double >, constCCVariable<double>, constCCVariable<int>,
                             const bool );
 template void
-Radiometer::radiometerFlux( const Patch*, const Level*, DataWarehouse*, MTRand&,
+Radiometer::radiometerFlux( const Patch*, const Level*, DataWarehouse*, const int,
                             constCCVariable< float >, constCCVariable< float >, constCCVariable<int>,
                             const bool );
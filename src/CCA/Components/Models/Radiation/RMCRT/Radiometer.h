@@ -36,8 +36,6 @@
  *
  */
 
-class MTRand;
-
 namespace Uintah{
 
   class Radiometer : public RMCRTCommon {
@@ -78,7 +76,7 @@ namespace Uintah{
       void radiometerFlux( const Patch* patch,
                            const Level* level,
                            DataWarehouse* new_dw,
-                           MTRand& mTwister,
+                           const int timeStep,
                            constCCVariable< T > sigmaT4OverPi,
                            constCCVariable< T > abskg,
                            constCCVariable<int> celltype,
@@ -128,9 +126,7 @@ namespace Uintah{
 
       //__________________________________
       //
-      void rayDirection_VR( MTRand& mTwister,
-                            const IntVector& origin,
-                            const int iRay,
+      void rayDirection_VR( Philox& rng,
                             VR_variables& VR,
                             Vector& directionVector,
                             double& cosVRTheta );
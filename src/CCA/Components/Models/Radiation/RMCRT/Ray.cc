@@ -35,7 +35,7 @@
 #include <Core/Grid/BoundaryConditions/BCUtils.h>
 #include <Core/Grid/DbgOutput.h>
 #include <Core/Grid/Variables/PerPatchVars.h>
-#include <Core/Math/MersenneTwister.h>
+#include <Core/Parallel/LoopThreadPool.h>
 #include <Core/Util/DOUT.hpp>
 #include <Core/Util/Timers/Timers.hpp>
 
@@ -48,7 +48,7 @@
 #include <string>
 #include <iostream>
 
-// TURN ON debug flag in src/Core/Math/MersenneTwister.h to compare with Ray:CPU
+// TURN ON debug flag in src/Core/Math/Philox.h to compare with Ray:CPU
 #define DEBUG -9      // 1: divQ, 2: boundFlux, 3: scattering
 #define CUDA_PRINTF   // increase the printf buffer
 
@@ -84,9 +84,6 @@ Ray::Ray( const TypeDescription::Type FLT_DBL ) : RMCRTCommon( FLT_DBL)
 //  d_boundFluxFiltLabel   = VarLabel::create( "boundFluxFilt",    CCVariable<Stencil7>::getTypeDescription() );
 //  d_divQFiltLabel        = VarLabel::create( "divQFilt",         CCVariable<double>::getTypeDescription() );
 
-  // Time Step
-  m_timeStepLabel = VarLabel::create(timeStep_name, timeStep_vartype::getTypeDescription() );
-
   // internal variables for RMCRT
   d_flaggedCellsLabel    = VarLabel::create( "flaggedCells",     CCVariable<int>::getTypeDescription() );
   d_ROI_LoCellLabel      = VarLabel::create( "ROI_loCell",       minvec_vartype::getTypeDescription() );
@@ -130,8 +127,6 @@ Ray::Ray( const TypeDescription::Type FLT_DBL ) : RMCRTCommon( FLT_DBL)
 //---------------------------------------------------------------------------
 Ray::~Ray()
 {
-  VarLabel::destroy( m_timeStepLabel );
-
   VarLabel::destroy( d_mag_grad_abskgLabel );
   VarLabel::destroy( d_mag_grad_sigmaT4Label );
   VarLabel::destroy( d_flaggedCellsLabel );
@@ -421,19 +416,7 @@ Ray::sched_rayTrace( const LevelP& level,
     // numbers that are in a sense repeatable.  But the same could be
     // accomplished with repeatable random numbers passed in.
 
-    timeStep_vartype timeStepVar(0);
-    
-    DataWarehouse* old_dw = sched->get_dw(0);
-    DataWarehouse* new_dw = sched->get_dw(1);
-    
-    if( old_dw && old_dw->exists( m_timeStepLabel ) ){
-      old_dw->get( timeStepVar, m_timeStepLabel );
-    }
-    else if( new_dw && new_dw->exists( m_timeStepLabel ) ){
-      new_dw->get( timeStepVar, m_timeStepLabel );
-    }
-    
-    int timeStep = timeStepVar;
+    int timeStep = getTimeStep( sched->get_dw(0), sched->get_dw(1) );
     
     if ( RMCRTCommon::d_FLT_DBL == TypeDescription::double_type ) {
       tsk = scinew Task( taskname, this, &Ray::rayTraceGPU< double >, modifies_divQ, timeStep, abskg_dw, sigma_dw, celltype_dw );
@@ -486,6 +469,11 @@ Ray::sched_rayTrace( const LevelP& level,
   tsk->requires( abskg_dw ,    d_abskgLabel  ,   gac, n_ghostCells );
   tsk->requires( sigma_dw ,    d_sigmaT4Label,   gac, n_ghostCells );
   tsk->requires( celltype_dw , d_cellTypeLabel , gac, n_ghostCells );
+
+  // the timestep keys the random number streams (the GPU task gets it above)
+  if ( !Parallel::usingDevice() ) {
+    tsk->requires( Task::OldDW, d_timeStepLabel );
+  }
   
 
   if( modifies_divQ ) {
@@ -543,7 +531,8 @@ Ray::rayTrace( const ProcessorGroup* pg,
 
   //__________________________________
   //
-  MTRand mTwister;
+  const int timeStep = getTimeStep( old_dw, new_dw );
+  const int L        = level->getIndex();
 
   DataWarehouse* abskg_dw    = new_dw->getOtherDataWarehouse(which_abskg_dw);
   DataWarehouse* sigmaT4_dw  = new_dw->getOtherDataWarehouse(which_sigmaT4_dw);
@@ -567,11 +556,6 @@ Ray::rayTrace( const ProcessorGroup* pg,
 
     const Patch* patch = patches->get(p);
     printTask(patches,patch,g_ray_dbg,"Doing Ray::rayTrace");
-    
-    
-//    if ( d_isSeedRandom == false ){     Disable until the code compares with nightly GS -Todd
-//      mTwister.seed(patch->getID());
-//    }
 
     CCVariable<double> divQ;
     CCVariable<Stencil7> boundFlux;
@@ -639,12 +623,30 @@ Ray::rayTrace( const ProcessorGroup* pg,
     unsigned long int size = 0;                   // current size of PathIndex
     Vector Dx = patch->dCell();                   // cell spacing
 
+    //__________________________________
+    //  The cells are traced in rows along x, which are spread over the
+    //  LoopThreadPool threads.  Every ray draws from its own random number
+    //  stream (rayStream), so divQ and boundFlux do not depend on the
+    //  number of threads.
+    const IntVector lo = patch->getCellLowIndex();
+    const IntVector hi = patch->getCellHighIndex();
+    const int nRows_y  = hi.y() - lo.y();
+    const int nRows    = nRows_y * ( hi.z() - lo.z() );
+
+    auto rowIterator = [&]( int row ) {
+      const int y = lo.y() + row % nRows_y;
+      const int z = lo.z() + row / nRows_y;
+      return CellIterator( IntVector( lo.x(), y, z ), IntVector( hi.x(), y + 1, z + 1 ) );
+    };
+
+    vector<unsigned long int> slotSize( LoopThreadPool::getNumThreads(), 0 );
+
     //______________________________________________________________________
     //           R A D I O M E T E R
     //______________________________________________________________________
 
     if (d_radiometer) {
-      d_radiometer->radiometerFlux< T >( patch, level, new_dw, mTwister, sigmaT4OverPi, abskg, celltype, modifies_divQ );
+      d_radiometer->radiometerFlux< T >( patch, level, new_dw, timeStep, sigmaT4OverPi, abskg, celltype, modifies_divQ );
     }
 
     //______________________________________________________________________
@@ -652,89 +654,96 @@ Ray::rayTrace( const ProcessorGroup* pg,
     //______________________________________________________________________
     if( d_solveBoundaryFlux ) {
 
-      //__________________________________
-      //
-      vector <int> rand_i( d_rayDirSampleAlgo == LATIN_HYPER_CUBE ? d_nFluxRays : 0);  // only needed for LHC scheme
+      LoopThreadPool::run( nRows, [&]( int row, int slot ) {
 
-      for (CellIterator iter = patch->getCellIterator(); !iter.done(); iter++){
-        IntVector origin = *iter;
+        vector <int> rand_i( d_rayDirSampleAlgo == LATIN_HYPER_CUBE ? d_nFluxRays : 0);  // only needed for LHC scheme
+        unsigned long int rowSize = 0;
 
-        if (celltype[origin] != d_flowCell) {
-          continue;
-        }
+        for (CellIterator iter = rowIterator( row ); !iter.done(); iter++){
+          IntVector origin = *iter;
+
+          if (celltype[origin] != d_flowCell) {
+            continue;
+          }
  
-        // A given flow cell may have 0,1,2,3,4,5, or 6 faces that are adjacent to a wall.
-        // boundaryFaces is the vector that contains the list of which faces are adjacent to a wall
-        vector<int> boundaryFaces;
-        boundaryFaces.clear();
+          // A given flow cell may have 0,1,2,3,4,5, or 6 faces that are adjacent to a wall.
+          // boundaryFaces is the vector that contains the list of which faces are adjacent to a wall
+          vector<int> boundaryFaces;
+          boundaryFaces.clear();
 
-        // determine if origin has one or more boundary faces, and if so, populate boundaryFaces vector
-        boundFlux[origin].p = has_a_boundary(origin, celltype, boundaryFaces);
+          // determine if origin has one or more boundary faces, and if so, populate boundaryFaces vector
+          boundFlux[origin].p = has_a_boundary(origin, celltype, boundaryFaces);
 
-        Point CC_pos = level->getCellPosition(origin);
-        //__________________________________
-        // Loop over boundary faces of the cell and compute incident radiative flux
-        for (vector<int>::iterator it=boundaryFaces.begin() ; it < boundaryFaces.end(); it++ ){
+          Point CC_pos = level->getCellPosition(origin);
+          //__________________________________
+          // Loop over boundary faces of the cell and compute incident radiative flux
+          for (vector<int>::iterator it=boundaryFaces.begin() ; it < boundaryFaces.end(); it++ ){
 
-          int RayFace = *it;
-          int UintahFace[6] = {WEST,EAST,SOUTH,NORTH,BOT,TOP};
+            int RayFace = *it;
+            int UintahFace[6] = {WEST,EAST,SOUTH,NORTH,BOT,TOP};
 
-          double sumI         = 0;
-          double sumProjI     = 0;
-          double sumI_prev    = 0;
-          double sumCosTheta  = 0;    // used to force sumCosTheta/nRays == 0.5 or  sum (d_Omega * cosTheta) == pi
+            double sumI         = 0;
+            double sumProjI     = 0;
+            double sumI_prev    = 0;
+            double sumCosTheta  = 0;    // used to force sumCosTheta/nRays == 0.5 or  sum (d_Omega * cosTheta) == pi
 
-          if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){
-            randVector(rand_i, mTwister, origin);
-          }
+            if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){
+              Philox rng = rayStream( origin, L, timeStep, FLUX_LHC, RayFace );
+              randVector(rand_i, rng);
+            }
 
 
-          //__________________________________
-          // Flux ray loop
-          for (int iRay=0; iRay < d_nFluxRays; iRay++){
+            //__________________________________
+            // Flux ray loop
+            for (int iRay=0; iRay < d_nFluxRays; iRay++){
 
-            Vector direction_vector;
-            Vector rayOrigin;
-            double cosTheta;
+              Philox rng = rayStream( origin, L, timeStep, FLUX_RAY, RayFace * d_nFluxRays + iRay );
 
-            if ( d_rayDirSampleAlgo == LATIN_HYPER_CUBE ){        // Latin-Hyper-Cube sampling
-              rayDirectionHyperCube_cellFace( mTwister, origin, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace], iRay,
-                                              direction_vector, cosTheta, rand_i[iRay],iRay);
-            } else{                                               // Naive Monte-Carlo sampling
-              rayDirection_cellFace( mTwister, origin, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace], iRay,
-                                     direction_vector, cosTheta );
-            }
+              Vector direction_vector;
+              Vector rayOrigin;
+              double cosTheta;
 
-            rayLocation_cellFace( mTwister, RayFace, Dx, CC_pos, rayOrigin);
+              if ( d_rayDirSampleAlgo == LATIN_HYPER_CUBE ){        // Latin-Hyper-Cube sampling
+                rayDirectionHyperCube_cellFace( rng, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace],
+                                                direction_vector, cosTheta, rand_i[iRay],iRay);
+              } else{                                               // Naive Monte-Carlo sampling
+                rayDirection_cellFace( rng, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace],
+                                       direction_vector, cosTheta );
+              }
 
-            updateSumI<T>( level, direction_vector, rayOrigin, origin, Dx, sigmaT4OverPi, abskg, celltype, size, sumI, mTwister);
+              rayLocation_cellFace( rng, RayFace, Dx, CC_pos, rayOrigin);
 
-            sumProjI    += cosTheta * (sumI - sumI_prev);              // must subtract sumI_prev, since sumI accumulates intensity
+              updateSumI<T>( level, direction_vector, rayOrigin, origin, Dx, sigmaT4OverPi, abskg, celltype, rowSize, sumI, rng);
 
-            sumCosTheta += cosTheta;
+              sumProjI    += cosTheta * (sumI - sumI_prev);              // must subtract sumI_prev, since sumI accumulates intensity
 
-            sumI_prev    = sumI;
+              sumCosTheta += cosTheta;
 
-          } // end of flux ray loop
+              sumI_prev    = sumI;
 
-          sumProjI = sumProjI * (double) d_nFluxRays/sumCosTheta/2.0; // This operation corrects for error in the first moment over a half range of the solid angle (Modest Radiative Heat Transfer page 545 1rst edition)
+            } // end of flux ray loop
 
-          //__________________________________
-          //  Compute Net Flux to the boundary
-          int face = UintahFace[RayFace];
-          boundFlux[origin][ face ] = sumProjI * 2 *M_PI/ (double) d_nFluxRays;
+            sumProjI = sumProjI * (double) d_nFluxRays/sumCosTheta/2.0; // This operation corrects for error in the first moment over a half range of the solid angle (Modest Radiative Heat Transfer page 545 1rst edition)
+
+            //__________________________________
+            //  Compute Net Flux to the boundary
+            int face = UintahFace[RayFace];
+            boundFlux[origin][ face ] = sumProjI * 2 *M_PI/ (double) d_nFluxRays;
 
 /*`==========TESTING==========*/
 #if (DEBUG == 2)
-          if( isDbgCell(origin) ) {
-            printf( "\n      [%d, %d, %d]  face: %d sumProjI:  %g BoundaryFlux: %g\n",
-                  origin.x(), origin.y(), origin.z(), face, sumProjI, boundFlux[origin][ face ]);
-          }
+            if( isDbgCell(origin) ) {
+              printf( "\n      [%d, %d, %d]  face: %d sumProjI:  %g BoundaryFlux: %g\n",
+                    origin.x(), origin.y(), origin.z(), face, sumProjI, boundFlux[origin][ face ]);
+            }
 #endif
 /*===========TESTING==========`*/
 
-        } // boundary faces loop
-      }  // end cell iterator
+          } // boundary faces loop
+        }  // end cell iterator
+
+        slotSize[slot] += rowSize;
+      });  // end row loop
     }   // end if d_solveBoundaryFlux
 
 
@@ -743,58 +752,69 @@ Ray::rayTrace( const ProcessorGroup* pg,
     //______________________________________________________________________
     if( d_solveDivQ){
 
-    //__________________________________
-    //
-      vector <int> rand_i( d_rayDirSampleAlgo == LATIN_HYPER_CUBE ? d_nDivQRays : 0);  // only needed for LHC scheme
+      LoopThreadPool::run( nRows, [&]( int row, int slot ) {
 
-      for (CellIterator iter = patch->getCellIterator(); !iter.done(); iter++){
-        IntVector origin = *iter;
-        
-        // don't compute in intrusions and walls
-        if( celltype[origin] != d_flowCell ){
-          continue;
-        }
+        vector <int> rand_i( d_rayDirSampleAlgo == LATIN_HYPER_CUBE ? d_nDivQRays : 0);  // only needed for LHC scheme
+        unsigned long int rowSize = 0;
+
+        for (CellIterator iter = rowIterator( row ); !iter.done(); iter++){
+          IntVector origin = *iter;
         
-        if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){
-          randVector(rand_i, mTwister, origin);
-        }
-        double sumI = 0;
-        Point CC_pos = level->getCellPosition(origin);
+          // don't compute in intrusions and walls
+          if( celltype[origin] != d_flowCell ){
+            continue;
+          }
         
-        // ray loop
-        for (int iRay=0; iRay < d_nDivQRays; iRay++){
-          
-          Vector direction_vector;
-          if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){        // Latin-Hyper-Cube sampling
-            direction_vector =findRayDirectionHyperCube(mTwister, origin, iRay, rand_i[iRay],iRay );
-          }else{                                              // Naive Monte-Carlo sampling
-            direction_vector =findRayDirection(mTwister, origin, iRay );
+          if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){
+            Philox rng = rayStream( origin, L, timeStep, DIVQ_LHC, 0 );
+            randVector(rand_i, rng);
           }
+          double sumI = 0;
+          Point CC_pos = level->getCellPosition(origin);
+        
+          // ray loop
+          for (int iRay=0; iRay < d_nDivQRays; iRay++){
+
+            Philox rng = rayStream( origin, L, timeStep, DIVQ_RAY, iRay );
+
+            Vector direction_vector;
+            if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){        // Latin-Hyper-Cube sampling
+              direction_vector =findRayDirectionHyperCube(rng, rand_i[iRay],iRay );
+            }else{                                              // Naive Monte-Carlo sampling
+              direction_vector =findRayDirection( rng );
+            }
           
-          Vector rayOrigin;
-          ray_Origin( mTwister, CC_pos, Dx, d_CCRays, rayOrigin);
+            Vector rayOrigin;
+            ray_Origin( rng, CC_pos, Dx, d_CCRays, rayOrigin);
           
-          updateSumI< T >( level, direction_vector, rayOrigin, origin, Dx,  sigmaT4OverPi, abskg, celltype, size, sumI, mTwister);
+            updateSumI< T >( level, direction_vector, rayOrigin, origin, Dx,  sigmaT4OverPi, abskg, celltype, rowSize, sumI, rng);
           
-        }  // Ray loop
+          }  // Ray loop
         
-        //__________________________________
-        //  Compute divQ
-        divQ[origin] = -4.0 * M_PI * abskg[origin] * ( sigmaT4OverPi[origin] - (sumI/d_nDivQRays) );
+          //__________________________________
+          //  Compute divQ
+          divQ[origin] = -4.0 * M_PI * abskg[origin] * ( sigmaT4OverPi[origin] - (sumI/d_nDivQRays) );
         
-        // radiationVolq is the incident energy per cell (W/m^3) and is necessary when particle heat transfer models (i.e. Shaddix) are used
-        radiationVolq[origin] = 4.0 * M_PI * (sumI/d_nDivQRays) ;
+          // radiationVolq is the incident energy per cell (W/m^3) and is necessary when particle heat transfer models (i.e. Shaddix) are used
+          radiationVolq[origin] = 4.0 * M_PI * (sumI/d_nDivQRays) ;
         /*`==========TESTING==========*/
 #if DEBUG == 1
-        if( isDbgCell(origin) ) {
-          printf( "\n      [%d, %d, %d]  sumI: %g  divQ: %g radiationVolq: %g  abskg: %g,    sigmaT4: %g \n",
-                  origin.x(), origin.y(), origin.z(), sumI,divQ[origin], radiationVolq[origin],abskg[origin], sigmaT4OverPi[origin]);
-        }
+          if( isDbgCell(origin) ) {
+            printf( "\n      [%d, %d, %d]  sumI: %g  divQ: %g radiationVolq: %g  abskg: %g,    sigmaT4: %g \n",
+                    origin.x(), origin.y(), origin.z(), sumI,divQ[origin], radiationVolq[origin],abskg[origin], sigmaT4OverPi[origin]);
+          }
 #endif
 /*===========TESTING==========`*/
-      }  // end cell iterator
+        }  // end cell iterator
+
+        slotSize[slot] += rowSize;
+      });  // end row loop
     }  // end of if(_solveDivQ)
     
+    for( unsigned long int n : slotSize ){
+      size += n;
+    }
+
     timer.stop();
     
 #ifdef ADD_PERFORMANCE_STATS
@@ -856,19 +876,7 @@ Ray::sched_rayTrace_dataOnion( const LevelP& level,
   if (Parallel::usingDevice()) {          // G P U
     taskname = "Ray::rayTraceDataOnionGPU";
 
-    timeStep_vartype timeStepVar(0);
-    
-    DataWarehouse* old_dw = sched->get_dw(0);
-    DataWarehouse* new_dw = sched->get_dw(1);
-    
-    if( old_dw && old_dw->exists( m_timeStepLabel ) ){
-      old_dw->get( timeStepVar, m_timeStepLabel );
-    }
-    else if( new_dw && new_dw->exists( m_timeStepLabel ) ){
-      new_dw->get( timeStepVar, m_timeStepLabel );
-    }
-    
-    int timeStep = timeStepVar;
+    int timeStep = getTimeStep( sched->get_dw(0), sched->get_dw(1) );
     
     
     if (RMCRTCommon::d_FLT_DBL == TypeDescription::double_type) {
@@ -927,6 +935,9 @@ Ray::sched_rayTrace_dataOnion( const LevelP& level,
     tsk->requires( Task::OldDW, d_divQLabel,          d_gn, 0 );
     tsk->requires( Task::OldDW, d_boundFluxLabel,     d_gn, 0);
     tsk->requires( Task::OldDW, d_radiationVolqLabel, d_gn, 0 );
+
+    // the timestep keys the random number streams
+    tsk->requires( Task::OldDW, d_timeStepLabel );
   }
 
 
@@ -1005,7 +1016,8 @@ Ray::rayTrace_dataOnion( const ProcessorGroup* pg,
   int maxLevels    = fineLevel->getGrid()->numLevels();
   int levelPatchID = fineLevel->getPatch(0)->getID();
   LevelP level_0 = new_dw->getGrid()->getLevel(0);
-  MTRand mTwister;
+  const int timeStep = getTimeStep( old_dw, new_dw );
+  const int L_indx   = fineLevel->getIndex();
 
   //__________________________________
   // retrieve the coarse level data
@@ -1073,9 +1085,7 @@ Ray::rayTrace_dataOnion( const ProcessorGroup* pg,
 
     const Patch* finePatch = finePatches->get(p);
     printTask(finePatches, finePatch,g_ray_dbg,"Doing Ray::rayTrace_dataOnion");
-    if ( d_isSeedRandom == false ){
-      mTwister.seed(finePatch->getID());
-    }
+
      //__________________________________
     //  retrieve fine level data ( patch_based )
     if ( d_ROI_algo == patch_based ) {
@@ -1155,30 +1165,33 @@ Ray::rayTrace_dataOnion( const ProcessorGroup* pg,
           double sumCosTheta  = 0;    // used to force sumCosTheta/nRays == 0.5 or  sum (d_Omega * cosTheta) == pi
 
           if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){
-            randVector(rand_i, mTwister, origin);
+            Philox rng = rayStream( origin, L_indx, timeStep, FLUX_LHC, RayFace );
+            randVector(rand_i, rng);
           }
 
           //__________________________________
           // Flux ray loop
           for (int iRay=0; iRay < d_nFluxRays; iRay++){
 
+            Philox rng = rayStream( origin, L_indx, timeStep, FLUX_RAY, RayFace * d_nFluxRays + iRay );
+
             Vector direction_vector;
             Vector rayOrigin;
             double cosTheta;
 
             if ( d_rayDirSampleAlgo == LATIN_HYPER_CUBE ){        // Latin-Hyper-Cube sampling
-              rayDirectionHyperCube_cellFace( mTwister, origin, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace], iRay,
+              rayDirectionHyperCube_cellFace( rng, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace],
                                               direction_vector, cosTheta, rand_i[iRay],iRay);
             } else{                                               // Naive Monte-Carlo sampling
-              rayDirection_cellFace( mTwister, origin, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace], iRay,
+              rayDirection_cellFace( rng, d_dirIndexOrder[RayFace], d_dirSignSwap[RayFace],
                                      direction_vector, cosTheta );
             }
 
-            rayLocation_cellFace( mTwister, RayFace, Dx[my_L], CC_pos, rayOrigin);
+            rayLocation_cellFace( rng, RayFace, Dx[my_L], CC_pos, rayOrigin);
 
             updateSumI_ML< T >( direction_vector, rayOrigin, origin, Dx, domain_BB, maxLevels, fineLevel,
                          fineLevel_ROI_Lo, fineLevel_ROI_Hi, regionLo, regionHi, sigmaT4OverPi, abskg, cellType,
-                         nFluxRaySteps, sumI, mTwister );
+                         nFluxRaySteps, sumI, rng );
 
             sumProjI    += cosTheta * (sumI - sumI_prev);              // must subtract sumI_prev, since sumI accumulates intensity
 
@@ -1229,7 +1242,8 @@ Ray::rayTrace_dataOnion( const ProcessorGroup* pg,
         Point CC_pos = fineLevel->getCellPosition(origin);
 
         if (d_rayDirSampleAlgo == LATIN_HYPER_CUBE){
-          randVector(rand_i, mTwister, origin);
+          Philox rng = rayStream( origin, L_indx, timeStep, DIVQ_LHC, 0 );
+          randVector(rand_i, rng);
         }
 
         double sumI = 0;
@@ -1238,20 +1252,22 @@ Ray::rayTrace_dataOnion( const ProcessorGroup* pg,
         //  ray loop
         for (int iRay=0; iRay < d_nDivQRays; iRay++){
 
+          Philox rng = rayStream( origin, L_indx, timeStep, DIVQ_RAY, iRay );
+
           Vector direction_vector;
           if (d_rayDirSampleAlgo== LATIN_HYPER_CUBE){       // Latin-Hyper-Cube sampling
-            direction_vector =findRayDirectionHyperCube( mTwister, origin, iRay,rand_i[iRay],iRay );
+            direction_vector =findRayDirectionHyperCube( rng, rand_i[iRay],iRay );
           }else{                                            // Naive Monte-Carlo sampling
-            direction_vector =findRayDirection( mTwister, origin, iRay );
+            direction_vector =findRayDirection( rng );
           }
 
           Vector rayOrigin;
           int my_L = maxLevels - 1;
-          ray_Origin( mTwister, CC_pos, Dx[my_L], d_CCRays, rayOrigin );
+          ray_Origin( rng, CC_pos, Dx[my_L], d_CCRays, rayOrigin );
 
           updateSumI_ML< T >( direction_vector, rayOrigin, origin, Dx, domain_BB, maxLevels, fineLevel,
                          fineLevel_ROI_Lo, fineLevel_ROI_Hi, regionLo, regionHi, sigmaT4OverPi, abskg, cellType,
-                         nRaySteps, sumI, mTwister );
+                         nRaySteps, sumI, rng );
 
 
         }  // Ray loop
@@ -1394,22 +1410,15 @@ Ray::computeExtents(LevelP level_0,
 
 //______________________________________________________________________
 // Compute the Ray direction from a cell face
-void Ray::rayDirection_cellFace( MTRand& mTwister,
-                                 const IntVector& origin,
+void Ray::rayDirection_cellFace( Philox& rng,
                                  const IntVector& indexOrder,
                                  const IntVector& signOrder,
-                                 const int iRay,
                                  Vector& directionVector,
                                  double& cosTheta)
 {
-
-  if( d_isSeedRandom == false ){                 // !! This could use a compiler directive for speed-up
-    mTwister.seed((origin.x() + origin.y() + origin.z()) * iRay +1);
-  }
-
   // Surface Way to generate a ray direction from the positive z face
-  double phi   = 2 * M_PI * mTwister.rand(); // azimuthal angle.  Range of 0 to 2pi
-  double theta = acos(mTwister.rand());      // polar angle for the hemisphere
+  double phi   = 2 * M_PI * rng.rand(); // azimuthal angle.  Range of 0 to 2pi
+  double theta = acos(rng.rand());      // polar angle for the hemisphere
   cosTheta = cos(theta);
 
   //Convert to Cartesian
@@ -1431,25 +1440,19 @@ void Ray::rayDirection_cellFace( MTRand& mTwister,
 //  and as hence does not include the cosine in the sample.
 //______________________________________________________________________
 void
-Ray::rayDirectionHyperCube_cellFace(MTRand& mTwister,
-                                 const IntVector& origin,
+Ray::rayDirectionHyperCube_cellFace(Philox& rng,
                                  const IntVector& indexOrder,
                                  const IntVector& signOrder,
-                                 const int iRay,
                                  Vector& directionVector,
                                  double& cosTheta,
                                  const int bin_i,
                                  const int bin_j)
 {
-  if( d_isSeedRandom == false ){                 // !! This could use a compiler directive for speed-up
-    mTwister.seed((origin.x() + origin.y() + origin.z()) * iRay +1);
-  }
-
  // randomly sample within each randomly selected region (may not be needed, alternatively choose center of subregion)
-  cosTheta = (mTwister.randDblExc() + (double) bin_i)/d_nFluxRays;
+  cosTheta = (rng.randDblExc() + (double) bin_i)/d_nFluxRays;
 
   double theta = acos(cosTheta);      // polar angle for the hemisphere
-  double phi = 2.0 * M_PI * (mTwister.randDblExc() + (double) bin_j)/d_nFluxRays;        // Uniform betwen 0-2Pi
+  double phi = 2.0 * M_PI * (rng.randDblExc() + (double) bin_j)/d_nFluxRays;        // Uniform betwen 0-2Pi
 
   cosTheta = cos(theta);
 
@@ -1471,20 +1474,14 @@ Ray::rayDirectionHyperCube_cellFace(MTRand& mTwister,
 //  generate the Monte-Carlo directions.  Samples uniformly on a sphere.
 //______________________________________________________________________
 Vector
-Ray::findRayDirectionHyperCube(MTRand& mTwister,
-                               const IntVector& origin,
-                               const int iRay,
+Ray::findRayDirectionHyperCube(Philox& rng,
                                const int bin_i,
                                const int bin_j)
 {
-  if( d_isSeedRandom == false ){
-    mTwister.seed((origin.x() + origin.y() + origin.z()) * iRay +1);
-  }
-
   // Random Points On Sphere
-  double plusMinus_one = 2.0 *(mTwister.randDblExc() + (double) bin_i)/d_nDivQRays - 1.0;  // add fuzz to avoid inf in 1/dirVector
+  double plusMinus_one = 2.0 *(rng.randDblExc() + (double) bin_i)/d_nDivQRays - 1.0;  // add fuzz to avoid inf in 1/dirVector
   double r = sqrt(1.0 - plusMinus_one * plusMinus_one);     // Radius of circle at z
-  double phi = 2.0 * M_PI * (mTwister.randDblExc() + (double) bin_j)/d_nDivQRays;        // Uniform betwen 0-2Pi
+  double phi = 2.0 * M_PI * (rng.randDblExc() + (double) bin_j)/d_nDivQRays;        // Uniform betwen 0-2Pi
 
   Vector direction_vector;
   direction_vector[0] = r*cos(phi);                       // Convert to cartesian
@@ -1497,7 +1494,7 @@ Ray::findRayDirectionHyperCube(MTRand& mTwister,
 //______________________________________________________________________
 //
 //  Compute the Ray location on a cell face
-void Ray::rayLocation_cellFace( MTRand& mTwister,
+void Ray::rayLocation_cellFace( Philox& rng,
                                  const int face,
                                  const Vector Dx,
                                  const Point CC_pos,
@@ -1513,32 +1510,32 @@ void Ray::rayLocation_cellFace( MTRand& mTwister,
   {
     case WEST:
       rayOrigin[X] = cellOrigin[X];
-      rayOrigin[Y] = cellOrigin[Y] + mTwister.rand() * Dx[Y];
-      rayOrigin[Z] = cellOrigin[Z] + mTwister.rand() * Dx[Z];
+      rayOrigin[Y] = cellOrigin[Y] + rng.rand() * Dx[Y];
+      rayOrigin[Z] = cellOrigin[Z] + rng.rand() * Dx[Z];
       break;
     case EAST:
       rayOrigin[X] = cellOrigin[X] +  Dx[X];
-      rayOrigin[Y] = cellOrigin[Y] + mTwister.rand() * Dx[Y];
-      rayOrigin[Z] = cellOrigin[Z] + mTwister.rand() * Dx[Z];
+      rayOrigin[Y] = cellOrigin[Y] + rng.rand() * Dx[Y];
+      rayOrigin[Z] = cellOrigin[Z] + rng.rand() * Dx[Z];
       break;
     case SOUTH:
-      rayOrigin[X] = cellOrigin[X] + mTwister.rand() * Dx[X];
+      rayOrigin[X] = cellOrigin[X] + rng.rand() * Dx[X];
       rayOrigin[Y] = cellOrigin[Y];
-      rayOrigin[Z] = cellOrigin[Z] + mTwister.rand() * Dx[Z];
+      rayOrigin[Z] = cellOrigin[Z] + rng.rand() * Dx[Z];
       break;
     case NORTH:
-      rayOrigin[X] = cellOrigin[X] + mTwister.rand() * Dx[X];
+      rayOrigin[X] = cellOrigin[X] + rng.rand() * Dx[X];
       rayOrigin[Y] = cellOrigin[Y] + Dx[Y];
-      rayOrigin[Z] = cellOrigin[Z] + mTwister.rand() * Dx[Z];
+      rayOrigin[Z] = cellOrigin[Z] + rng.rand() * Dx[Z];
       break;
     case BOT:
-      rayOrigin[X] = cellOrigin[X] + mTwister.rand() * Dx[X];;
-      rayOrigin[Y] = cellOrigin[Y] + mTwister.rand() * Dx[Y];;
+      rayOrigin[X] = cellOrigin[X] + rng.rand() * Dx[X];;
+      rayOrigin[Y] = cellOrigin[Y] + rng.rand() * Dx[Y];;
       rayOrigin[Z] = cellOrigin[Z];
       break;
     case TOP:
-      rayOrigin[X] = cellOrigin[X] + mTwister.rand() * Dx[X];;
-      rayOrigin[Y] = cellOrigin[Y] + mTwister.rand() * Dx[Y];;
+      rayOrigin[X] = cellOrigin[X] + rng.rand() * Dx[X];;
+      rayOrigin[Y] = cellOrigin[Y] + rng.rand() * Dx[Y];;
       rayOrigin[Z] = cellOrigin[Z] + Dx[Z];
       break;
     default:
@@ -2402,7 +2399,7 @@ void Ray::computeCellType( const ProcessorGroup*,
                            std::vector< constCCVariable< int > >& cellType,
                            unsigned long int& nRaySteps,
                            double& sumI,
-                           MTRand& mTwister)
+                           Philox& rng)
 {
   int L       = maxLevels -1;  // finest level
   int prevLev = L;
@@ -2783,7 +2780,7 @@ template void  Ray::updateSumI_ML< double> ( Vector&,
                                              std::vector< constCCVariable< int > >& cellType,
                                              unsigned long int& ,
                                              double& ,
-                                             MTRand&);
+                                             Philox&);
 
 template void  Ray::updateSumI_ML< float> ( Vector&,
                                             Vector&,
@@ -2801,4 +2798,4 @@ template void  Ray::updateSumI_ML< float> ( Vector&,
                                             std::vector< constCCVariable< int > >& cellType,
                                             unsigned long int& ,
                                             double& ,
-                                            MTRand&);
+                                            Philox&);
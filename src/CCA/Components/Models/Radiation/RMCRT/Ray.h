@@ -61,7 +61,6 @@
  *
  *
  */
-class MTRand; // forward declaration for use in updateSumI
 
 class ApplicationInterface;
 
@@ -211,8 +210,6 @@ namespace Uintah{
       std::map <int,IntVector> d_dirIndexOrder;
       std::map <int,IntVector> d_dirSignSwap;
 
-      const VarLabel* m_timeStepLabel {nullptr};
-      
       const VarLabel* d_mag_grad_abskgLabel;
       const VarLabel* d_mag_grad_sigmaT4Label;
       const VarLabel* d_flaggedCellsLabel;
@@ -304,7 +301,7 @@ namespace Uintah{
                            std::vector< constCCVariable< int > >& cellType,
                            unsigned long int& size,
                            double& sumI,
-                           MTRand& mTwister);
+                           Philox& rng);
 
      //__________________________________
      void computeExtents( LevelP level_0,
@@ -335,7 +332,7 @@ namespace Uintah{
 
       //__________________________________
       /** @brief Adjust the location of a ray origin depending on the cell face */
-      void rayLocation_cellFace( MTRand& mTwister,
+      void rayLocation_cellFace( Philox& rng,
                                  const int face,
                                  const Vector Dx,
                                  const Point CC_pos,
@@ -343,30 +340,24 @@ namespace Uintah{
 
       //__________________________________
       /** @brief Adjust the direction of a ray depending on the cell face */
-      void rayDirection_cellFace( MTRand& mTwister,
-                                  const IntVector& origin,
+      void rayDirection_cellFace( Philox& rng,
                                   const IntVector& indexOrder,
                                   const IntVector& signOrder,
-                                  const int iRay,
                                   Vector& directionVector,
                                   double& cosTheta );
 
       //__________________________________
       /** @brief Sample Rays for directional flux using LHC sampling */
-      void rayDirectionHyperCube_cellFace( MTRand& mTwister,
-                                           const IntVector& origin,
+      void rayDirectionHyperCube_cellFace( Philox& rng,
                                            const IntVector& indexOrder,
                                            const IntVector& signOrder,
-                                           const int iRay,
                                            Vector& directionVector,
                                            double& cosTheta,
                                            const int ibin,
                                            const int jbin);
       //__________________________________
       /** @brief Sample Rays for flux divergence using LHC sampling */
-      Vector findRayDirectionHyperCube( MTRand& mTwister,
-                                        const IntVector& = IntVector(-9,-9,-9),
-                                        const int iRay = -9,
+      Vector findRayDirectionHyperCube( Philox& rng,
                                         const int bin_i = 0,
                                         const int bin_j = 0);
 
@@ -42,7 +42,7 @@
 #undef __CUDA_INTERNAL_COMPILATION__
 
 #define DEBUG -9                  // 1: divQ, 2: boundFlux, 3: scattering
-//#define FIXED_RANDOM_NUM        // also edit in src/Core/Math/MersenneTwister.h to compare with Ray:CPU
+//#define FIXED_RANDOM_NUM        // also edit in src/Core/Math/Philox.h to compare with Ray:CPU
 
 #define FIXED_RAY_DIR -9          // Sets ray direction.  1: (0.7071,0.7071, 0), 2: (0.7071, 0, 0.7071), 3: (0, 0.7071, 0.7071)
                                   //                      4: (0.7071, 0.7071, 7071), 5: (1,0,0)  6: (0, 1, 0),   7: (0,0,1)
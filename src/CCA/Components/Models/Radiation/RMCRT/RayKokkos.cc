@@ -48,7 +48,7 @@
 #include <vector>
 
 //__________________________________
-// To enable comparisons with Ray:CPU, define FIXED_RANDOM_NUM both here and in src/Core/Math/MersenneTwister.h
+// To enable comparisons with Ray:CPU, define FIXED_RANDOM_NUM both here and in src/Core/Math/Philox.h
 // To enable comparisons with Ray:GPU, define FIXED_RANDOM_NUM both here and in src/CCA/Components/Models/Radiation/RMCRT/RayGPUKernel.cu
 
 #define DEBUG -9          // 1: divQ, 2: boundFlux, 3: scattering
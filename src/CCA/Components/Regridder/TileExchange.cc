@@ -0,0 +1,283 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include <CCA/Components/Regridder/TileExchange.h>
+
+#include <algorithm>
+
+using namespace Uintah;
+
+namespace {
+
+  // A run of 'length' tiles starting at (x, y, z) along x.
+  struct TileRun {
+    unsigned int x : 10;
+    unsigned int y : 10;
+    unsigned int z : 10;
+    unsigned int length;
+  };
+
+  //______________________________________________________________________
+  // Appends the runs of the sorted, unique 'tiles'.
+  void
+  encode( const std::vector<IntVector> & tiles
+        ,       std::vector<TileRun>   & runs
+        )
+  {
+    for (size_t i = 0; i < tiles.size(); ) {
+      TileRun run;
+      run.x      = tiles[i].x();
+      run.y      = tiles[i].y();
+      run.z      = tiles[i].z();
+      run.length = 1;
+
+      // IntVector::operator< sorts z, then y, then x
+      for (++i; i < tiles.size(); ++i) {
+        const IntVector & t = tiles[i];
+        if (t.x() != static_cast<int>(run.x + run.length) || t.y() != static_cast<int>(run.y) || t.z() != static_cast<int>(run.z)) {
+          break;
+        }
+        ++run.length;
+      }
+      runs.push_back(run);
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  decode( const TileRun                * runs
+        ,       size_t                   count
+        ,       std::vector<IntVector> & tiles
+        )
+  {
+    for (size_t i = 0; i < count; ++i) {
+      for (unsigned int n = 0; n < runs[i].length; ++n) {
+        tiles.push_back(IntVector(runs[i].x + n, runs[i].y, runs[i].z));
+      }
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+void
+TileExchange::makeUnique( std::vector<IntVector> & tiles )
+{
+  std::sort(tiles.begin(), tiles.end());
+  tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+}
+
+//______________________________________________________________________
+//
+void
+TileExchange::allgather( std::vector<IntVector> & tiles
+                       , MPI_Comm                 comm
+                       )
+{
+  std::vector<std::vector<IntVector> > levels(1);
+  levels[0].swap(tiles);
+  allgather(levels, comm);
+  tiles.swap(levels[0]);
+}
+
+//______________________________________________________________________
+//
+void
+TileExchange::allgather( std::vector<std::vector<IntVector> > & tiles
+                       , MPI_Comm                                comm
+                       )
+{
+  const int num_levels = tiles.size();
+
+  int num_ranks;
+  Uintah::MPI::Comm_size(comm, &num_ranks);
+
+  std::vector<TileRun>  runs;
+  std::vector<unsigned> counts(num_levels);
+  for (int l = 0; l < num_levels; ++l) {
+    makeUnique(tiles[l]);
+
+    const size_t before = runs.size();
+    encode(tiles[l], runs);
+    counts[l] = runs.size() - before;
+  }
+
+  if (num_ranks == 1) {
+    return;
+  }
+
+  // the number of runs on each level of each rank
+  std::vector<unsigned> all_counts(num_levels * num_ranks);
+  Uintah::MPI::Allgather(counts.data(), num_levels, MPI_UNSIGNED, all_counts.data(), num_levels, MPI_UNSIGNED, comm);
+
+  std::vector<int> recvcounts(num_ranks);
+  std::vector<int> displs(num_ranks);
+  int pos = 0;
+  for (int p = 0; p < num_ranks; ++p) {
+    int rank_runs = 0;
+    for (int l = 0; l < num_levels; ++l) {
+      rank_runs += all_counts[p * num_levels + l];
+    }
+    displs[p]     = pos;
+    recvcounts[p] = rank_runs * sizeof(TileRun);
+    pos          += recvcounts[p];
+  }
+
+  std::vector<TileRun> all_runs(pos / sizeof(TileRun));
+
+  int myrank;
+  Uintah::MPI::Comm_rank(comm, &myrank);
+  Uintah::MPI::Allgatherv(runs.data(), recvcounts[myrank], MPI_BYTE, all_runs.data(), recvcounts.data(), displs.data(), MPI_BYTE, comm);
+
+  for (int l = 0; l < num_levels; ++l) {
+    tiles[l].clear();
+  }
+
+  const TileRun* run = all_runs.data();
+  for (int p = 0; p < num_ranks; ++p) {
+    for (int l = 0; l < num_levels; ++l) {
+      const unsigned count = all_counts[p * num_levels + l];
+      decode(run, count, tiles[l]);
+      run += count;
+    }
+  }
+
+  // tiles on the boundaries of the ranks' patches may come from several ranks
+  for (int l = 0; l < num_levels; ++l) {
+    makeUnique(tiles[l]);
+  }
+}
+
+//______________________________________________________________________
+//
+void
+TileExchange::exchange( const std::map<int, std::vector<IntVector> > & sends
+                      ,       std::vector<IntVector>                 & received
+                      ,       MPI_Comm                                 comm
+                      ,       int                                      tag
+                      )
+{
+  int myrank;
+  Uintah::MPI::Comm_rank(comm, &myrank);
+
+  received.clear();
+
+  std::vector<std::vector<TileRun> > send_runs;
+  std::vector<int>                   send_ranks;
+  send_runs.reserve(sends.size());
+
+  for (auto iter = sends.begin(); iter != sends.end(); ++iter) {
+    if (iter->second.empty()) {
+      continue;
+    }
+    if (iter->first == myrank) {
+      received.insert(received.end(), iter->second.begin(), iter->second.end());
+      continue;
+    }
+
+    std::vector<IntVector> tiles = iter->second;
+    makeUnique(tiles);
+
+    send_runs.push_back(std::vector<TileRun>());
+    encode(tiles, send_runs.back());
+    send_ranks.push_back(iter->first);
+  }
+
+  std::vector<MPI_Request> send_requests(send_runs.size());
+  std::vector<TileRun>     recv_runs;
+
+  auto receive = [&]( const MPI_Status & status ) {
+    int bytes;
+    Uintah::MPI::Get_count(&status, MPI_BYTE, &bytes);
+    recv_runs.resize(bytes / sizeof(TileRun));
+    Uintah::MPI::Recv(recv_runs.data(), bytes, MPI_BYTE, status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE);
+    decode(recv_runs.data(), recv_runs.size(), received);
+  };
+
+#if UINTAH_ENABLE_MPI3
+  for (size_t i = 0; i < send_runs.size(); ++i) {
+    Uintah::MPI::Issend(send_runs[i].data(), send_runs[i].size() * sizeof(TileRun), MPI_BYTE, send_ranks[i], tag, comm, &send_requests[i]);
+  }
+
+  // Receive until every rank has had all of its sends matched, which
+  // the barrier tells once the last rank has entered it.
+  MPI_Request barrier        = MPI_REQUEST_NULL;
+  bool        barrier_active = false;
+
+  while (true) {
+    int        arrived;
+    MPI_Status status;
+    Uintah::MPI::Iprobe(MPI_ANY_SOURCE, tag, comm, &arrived, &status);
+    if (arrived) {
+      receive(status);
+    }
+
+    if (barrier_active) {
+      int done;
+      Uintah::MPI::Test(&barrier, &done, MPI_STATUS_IGNORE);
+      if (done) {
+        break;
+      }
+    }
+    else {
+      int sent;
+      Uintah::MPI::Testall(send_requests.size(), send_requests.data(), &sent, MPI_STATUSES_IGNORE);
+      if (sent) {
+        Uintah::MPI::Ibarrier(comm, &barrier);
+        barrier_active = true;
+      }
+    }
+  }
+#else
+  for (size_t i = 0; i < send_runs.size(); ++i) {
+    Uintah::MPI::Isend(send_runs[i].data(), send_runs[i].size() * sizeof(TileRun), MPI_BYTE, send_ranks[i], tag, comm, &send_requests[i]);
+  }
+
+  // Without the non-blocking barrier the number of messages to receive
+  // is found by summing one flag per rank.
+  int num_ranks;
+  Uintah::MPI::Comm_size(comm, &num_ranks);
+
+  std::vector<int> messages(num_ranks, 0);
+  std::vector<int> ones(num_ranks, 1);
+  for (size_t i = 0; i < send_ranks.size(); ++i) {
+    messages[send_ranks[i]] = 1;
+  }
+
+  int incoming;
+  Uintah::MPI::Reduce_scatter(messages.data(), &incoming, ones.data(), MPI_INT, MPI_SUM, comm);
+
+  for (int i = 0; i < incoming; ++i) {
+    MPI_Status status;
+    Uintah::MPI::Probe(MPI_ANY_SOURCE, tag, comm, &status);
+    receive(status);
+  }
+
+  Uintah::MPI::Waitall(send_requests.size(), send_requests.data(), MPI_STATUSES_IGNORE);
+#endif
+
+  makeUnique(received);
+}
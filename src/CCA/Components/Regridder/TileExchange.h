@@ -0,0 +1,103 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef CCA_COMPONENTS_REGRIDDER_TILEEXCHANGE_H
+#define CCA_COMPONENTS_REGRIDDER_TILEEXCHANGE_H
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Parallel/UintahMPI.h>
+
+#include <map>
+#include <vector>
+
+namespace Uintah {
+
+/**************************************
+
+CLASS
+   TileExchange
+
+GENERAL INFORMATION
+
+   TileExchange.h
+
+KEYWORDS
+   TiledRegridder
+
+DESCRIPTION
+   Moves the tiles (tile indices of a level) flagged by the
+   TiledRegridder between ranks.
+
+   allgather() gives every rank the tiles of all ranks, which is what
+   building the new grid needs.  It takes one MPI_Allgather of the
+   counts and one MPI_Allgatherv of the tiles for any number of levels.
+
+   exchange() is a sparse exchange: every rank sends tiles to the
+   ranks it names and receives the tiles sent to it, without knowing
+   in advance who sends.  With MPI-3 the synchronous sends are
+   completed by a non-blocking barrier, so the cost depends on the
+   number of neighbors and not on the number of ranks.  Otherwise
+   the number of incoming messages comes from a reduce-scatter of
+   one int per rank.
+
+   Tiles are sent as runs of consecutive tiles along x.  The indices
+   must fit in 10 bits, as checked by TiledRegridder::problemSetup.
+
+WARNING
+
+****************************************/
+
+class TileExchange {
+
+public:
+
+  // On return every level of 'tiles' holds the tiles of all ranks,
+  // sorted and without duplicates.
+  static void allgather( std::vector<std::vector<IntVector> > & tiles
+                       , MPI_Comm                                comm
+                       );
+
+  static void allgather( std::vector<IntVector> & tiles
+                       , MPI_Comm                 comm
+                       );
+
+  // Sends sends[rank] to each rank.  On return 'received' holds the
+  // tiles sent to this rank (including its own entry), sorted and
+  // without duplicates.  Consecutive exchanges must use different
+  // tags.
+  static void exchange( const std::map<int, std::vector<IntVector> > & sends
+                      ,       std::vector<IntVector>                 & received
+                      ,       MPI_Comm                                 comm
+                      ,       int                                      tag
+                      );
+
+  // Sorts 'tiles' and removes the duplicates.
+  static void makeUnique( std::vector<IntVector> & tiles );
+
+};
+
+} // End namespace Uintah
+
+#endif // CCA_COMPONENTS_REGRIDDER_TILEEXCHANGE_H
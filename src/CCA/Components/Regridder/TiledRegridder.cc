@@ -23,6 +23,7 @@
  */
 
 #include <CCA/Components/Regridder/TiledRegridder.h>
+#include <CCA/Components/Regridder/TileExchange.h>
 #include <CCA/Ports/ApplicationInterface.h>
 #include <CCA/Ports/LoadBalancer.h>
 #include <CCA/Ports/Scheduler.h>
@@ -46,6 +47,9 @@ static DebugStream rgtimes("RGTimes", "Regridder", "Tiled regridder times debug
 
 extern DebugStream regrider_dbg;
 
+//tags of the sparse tile exchange, one per level
+static const int TILE_EXCHANGE_TAG = 0x7117;
+
 int
 Product( const IntVector &i )
 {
@@ -184,7 +188,6 @@ Grid* TiledRegridder::regrid(Grid* oldGrid, const int timeStep)
     const LevelP level=oldGrid->getLevel(l);
 
     vector<IntVector> mytiles;
-    vector<IntVector> myoldtiles;
 
     rtimes[0] += timer().seconds();
     timer.reset( true );
@@ -194,16 +197,27 @@ Grid* TiledRegridder::regrid(Grid* oldGrid, const int timeStep)
     rtimes[1] += timer().seconds();
     timer.reset( true );
 
-    GatherTiles(mytiles,tiles[l+1]);
-
     if(l>0) {
+      //only the ranks owning the coarse patches under the tiles need them, so each rank
+      //receives the tiles over its own patches and the ones reaching them from its neighbors
+      vector<IntVector> neighborTiles;
+      ExchangeNeighborTiles(oldGrid,l,mytiles,neighborTiles);
+
       //add flags to the coarser level to ensure that boundary layers exist and that fine patches have a coarse patches above them.
-      CoarsenFlags(oldGrid,l,tiles[l+1]);
+      CoarsenFlags(oldGrid,l,neighborTiles);
     }
+
+    //each rank keeps only its own tiles until the new grid is built
+    tiles[l+1].swap(mytiles);
     rtimes[6] += timer().seconds();
     timer.reset( true );
   }
 
+  //every rank builds the whole grid, so it needs the tiles of all levels
+  TileExchange::allgather(tiles,d_myworld->getComm());
+  rtimes[2] += timer().seconds();
+  timer.reset( true );
+
   //level 0 does not change so just copy the patches over.
   for (Level::const_patch_iterator p = oldGrid->getLevel(0)->patchesBegin(); p != oldGrid->getLevel(0)->patchesEnd(); p++) {
     tiles[0].push_back(computeTileIndex((*p)->getCellLowIndex(),d_tileSize[0]));
@@ -516,26 +530,8 @@ void TiledRegridder::CoarsenFlags(GridP oldGrid, int l, vector<IntVector> tiles)
   {
     //cout << d_myworld->myRank() << "    fine tile: low:" << tiles[t] << " high:" << tiles[t]+d_tileSize[l+1] << endl;
 
-    //add a boundary and convert coordinates to a coarse level by dividing by the refinement ratios.  
-    IntVector low = (computeCellLowIndex(tiles[t],d_numCells[l+1],d_tileSize[l+1]) - d_minBoundaryCells)/d_cellRefinementRatio[l]/d_cellRefinementRatio[l-1]; 
-    
-    IntVector high = Ceil( (computeCellHighIndex(tiles[t],d_numCells[l+1],d_tileSize[l+1]) + d_minBoundaryCells).asVector()
-                            / d_cellRefinementRatio[l].asVector() / d_cellRefinementRatio[l-1].asVector()
-                         ); 
-    //cout << "level " << l << " coarsening flags for tile: " << tiles[t] << " low:" << computeCellLowIndex(tiles[t],d_numCells[l+1],d_tileSize[l+1]) << " high: " << computeCellHighIndex(tiles[t],d_numCells[l+1],d_tileSize[l+1]) << endl;
-    //cout << "     coarseLow: " << low << " coarseHigh: " << high << endl;
-    //clamp low and high points to domain boundaries 
-    for(int d=0;d<3;d++)
-    {
-      if(low[d]<0)
-      {
-         low[d]=0;
-      }
-      if(high[d]>d_cellNum[l-1][d])
-      {
-          high[d]=d_cellNum[l-1][d];
-      }
-    }
+    IntVector low, high;
+    computeCoarsenedTileExtents(tiles[t],l,low,high);
     //cout << d_myworld->myRank() << "    coarse tile low:" << low << " high:" << high << endl;
 
     Level::selectType intersecting_patches;
@@ -570,6 +566,62 @@ void TiledRegridder::CoarsenFlags(GridP oldGrid, int l, vector<IntVector> tiles)
 }
 //______________________________________________________________________
 //
+void TiledRegridder::computeCoarsenedTileExtents(const IntVector& tile, int l, IntVector& low, IntVector& high)
+{
+  //add a boundary and convert coordinates to a coarse level by dividing by the refinement ratios.  
+  low = (computeCellLowIndex(tile,d_numCells[l+1],d_tileSize[l+1]) - d_minBoundaryCells)/d_cellRefinementRatio[l]/d_cellRefinementRatio[l-1]; 
+  
+  high = Ceil( (computeCellHighIndex(tile,d_numCells[l+1],d_tileSize[l+1]) + d_minBoundaryCells).asVector()
+                / d_cellRefinementRatio[l].asVector() / d_cellRefinementRatio[l-1].asVector()
+             ); 
+  //cout << "level " << l << " coarsening flags for tile: " << tile << " low:" << computeCellLowIndex(tile,d_numCells[l+1],d_tileSize[l+1]) << " high: " << computeCellHighIndex(tile,d_numCells[l+1],d_tileSize[l+1]) << endl;
+  //cout << "     coarseLow: " << low << " coarseHigh: " << high << endl;
+  //clamp low and high points to domain boundaries 
+  for(int d=0;d<3;d++)
+  {
+    if(low[d]<0)
+    {
+       low[d]=0;
+    }
+    if(high[d]>d_cellNum[l-1][d])
+    {
+        high[d]=d_cellNum[l-1][d];
+    }
+  }
+}
+//______________________________________________________________________
+//Send each tile on level l+1 to the ranks owning the patches on level l-1
+//that CoarsenFlags will flag for it, and receive the tiles sent to this rank.
+void TiledRegridder::ExchangeNeighborTiles(GridP oldGrid, int l, const vector<IntVector>& mytiles, vector<IntVector>& neighborTiles)
+{
+  ASSERT(l-1>=0);
+
+  LevelP level=oldGrid->getLevel(l-1);
+  map<int, vector<IntVector> > sends;
+
+  for(unsigned t=0;t<mytiles.size();t++)
+  {
+    IntVector low, high;
+    computeCoarsenedTileExtents(mytiles[t],l,low,high);
+
+    Level::selectType patches;
+    level->selectPatches(low, high, patches);
+
+    for(unsigned int i=0;i<patches.size();i++)
+    {
+      int owner=m_loadBalancer->getPatchwiseProcessorAssignment(patches[i]->getRealPatch());
+      vector<IntVector> &ownerTiles=sends[owner];
+      if(ownerTiles.empty() || ownerTiles.back()!=mytiles[t]) {
+        ownerTiles.push_back(mytiles[t]);
+      }
+    }
+  }
+
+  //a tag per level, as a rank may start on the next level while others still receive
+  TileExchange::exchange(sends,neighborTiles,d_myworld->getComm(),TILE_EXCHANGE_TAG+l);
+}
+//______________________________________________________________________
+//
 bool TiledRegridder::verifyGrid(Grid *grid)
 {
   //if we are running in serial there is no reason to verify that each processor has the same grid.
@@ -668,85 +720,3 @@ IntVector TiledRegridder::computeCellHighIndex(const IntVector& tileIndex, const
 {
   return computeCellLowIndex(tileIndex+IntVector(1,1,1),numCells,tileSize);
 }
-//______________________________________________________________________
-//
-struct CompressedIntVector
-{
-  unsigned int x : 10;
-  unsigned int y : 10;
-  unsigned int z : 10;
-  int operator[](int index)
-  {
-    switch (index)
-    {
-      case 0:
-        return x;
-      case 1:
-        return y;
-      case 2:
-        return z;
-      default:
-        throw InternalError("CompressedIntVector invalid index",__FILE__,__LINE__);
-    }
-  }
-};
-//______________________________________________________________________
-//
-void TiledRegridder::GatherTiles(vector<IntVector>& mytiles, vector<IntVector> &gatheredTiles )
-{
-  set<IntVector> settiles;
-  if(d_myworld->nRanks()>1)
-  {
-    unsigned int mycount=mytiles.size();
-    vector<unsigned int> counts(d_myworld->nRanks());
-
-    vector<CompressedIntVector> tiles(mytiles.size()), gtiles;
-
-    //copy tiles into compressed data structure
-    for(size_t i=0; i<tiles.size();i++)
-    {
-      tiles[i].x=mytiles[i].x();
-      tiles[i].y=mytiles[i].y();
-      tiles[i].z=mytiles[i].z();
-    }
-   
-    //gather the number of tiles on each processor
-    Uintah::MPI::Allgather(&mycount,1,MPI_UNSIGNED,&counts[0],1,MPI_UNSIGNED,d_myworld->getComm());
-
-    //compute the displacements and recieve counts for a gatherv
-    vector<int> displs(d_myworld->nRanks());
-    vector<int> recvcounts(d_myworld->nRanks());
-
-    int pos=0;
-    for(int p=0;p<d_myworld->nRanks();p++)
-    {
-      displs[p]=pos;
-      recvcounts[p]=counts[p]*sizeof(CompressedIntVector);
-      //cout << d_myworld->myRank() << " displs: " << displs[p] << " recvs: " << recvcounts[p] << endl;
-      pos+=recvcounts[p];
-    }
-
-    gtiles.resize(pos/sizeof(CompressedIntVector));
-
-    //gatherv tiles
-    Uintah::MPI::Allgatherv(&tiles[0],recvcounts[d_myworld->myRank()], MPI_BYTE, &gtiles[0], &recvcounts[0],
-                   &displs[0], MPI_BYTE, d_myworld->getComm());
-    
-    //tiles might not be unique so add them to a set to make them unique
-    //copy compressed tiles into the tile set
-    for(size_t i=0;i<gtiles.size();i++)
-      settiles.insert(IntVector(gtiles[i].x,gtiles[i].y,gtiles[i].z));
-
-    gtiles.clear();
-  }
-  else
-  {
-    //tiles might not be unique so add them to a set to make them unique
-    for(size_t i=0;i<mytiles.size();i++)
-      settiles.insert(mytiles[i]);
-  }
-    
-  //reassign set to a vector
-  gatheredTiles.assign(settiles.begin(),settiles.end());
-
-}
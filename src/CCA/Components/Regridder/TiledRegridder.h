@@ -84,7 +84,10 @@ WARNING
     void CoarsenFlags(GridP oldGrid, int l, std::vector<IntVector> tiles); 
     void OutputGridStats(Grid* newGrid);
     void ComputeTiles(std::vector<IntVector> &tiles, const LevelP level, IntVector tile_size, IntVector cellRefinementRatio);
-    void GatherTiles(std::vector<IntVector>& mytiles, std::vector<IntVector> &gatheredTiles );
+    void ExchangeNeighborTiles(GridP oldGrid, int l, const std::vector<IntVector>& mytiles, std::vector<IntVector>& neighborTiles);
+
+    //computes the cells on level l-1 flagged for a tile on level l+1 (with the boundary layer)
+    void computeCoarsenedTileExtents(const IntVector& tile, int l, IntVector& low, IntVector& high);
     
     //maps a cell index to a tile index
     IntVector computeTileIndex(const IntVector& cellIndex, 
@@ -34,6 +34,7 @@ SRCDIR   := CCA/Components/Regridder
 SRCS     += $(SRCDIR)/RegridderCommon.cc \
             $(SRCDIR)/RegridderFactory.cc \
             $(SRCDIR)/TiledRegridder.cc\
+            $(SRCDIR)/TileExchange.cc \
             $(SRCDIR)/SingleLevelRegridder.cc
 
 PSELIBS := \
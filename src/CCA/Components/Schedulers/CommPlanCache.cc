@@ -0,0 +1,133 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <CCA/Components/Schedulers/CommPlanCache.h>
+
+#include <Core/Parallel/PackBufferInfo.h>
+
+using namespace Uintah;
+
+//______________________________________________________________________
+//
+CommPlanCache::~CommPlanCache()
+{
+  clear();
+}
+
+//______________________________________________________________________
+//
+void
+CommPlanCache::clear()
+{
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  for( auto & plan : m_sends ) {
+    plan.second.free();
+  }
+  for( auto & plan : m_recvs ) {
+    plan.second.free();
+  }
+  m_sends.clear();
+  m_recvs.clear();
+
+  ++m_generation;
+}
+
+//______________________________________________________________________
+//
+CommPlanCache::Message *
+CommPlanCache::plan(       Plans           & plans
+                   , const DependencyBatch * batch
+                   ,       bool              send
+                   )
+{
+  if( !m_enabled ) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  Message & message = plans[batch];
+  message.m_send = send;
+
+  return &message;
+}
+
+//______________________________________________________________________
+//
+void
+CommPlanCache::Message::start(       PackedBuffer * buf
+                             ,       int            count
+                             ,       int            peer
+                             ,       int            tag
+                             ,       MPI_Comm       comm
+                             ,       MPI_Request  * request
+                             )
+{
+  // A receive can take any message that fits into the buffer.
+  if( !m_send ) {
+    count = buf->getBufSize();
+  }
+
+  if( buf != m_buffer || count != m_count ) {
+    free();
+
+    m_buffer = buf;
+    m_buffer->addReference();
+    m_count = count;
+
+    if( m_send ) {
+      Uintah::MPI::Send_init( m_buffer->getBuffer(), m_count, MPI_PACKED, peer, tag, comm, &m_request );
+    }
+    else {
+      Uintah::MPI::Recv_init( m_buffer->getBuffer(), m_count, MPI_PACKED, peer, tag, comm, &m_request );
+    }
+  }
+
+  // The pool's copy of the handle refers to the same persistent
+  // request, completing it leaves the request inactive but valid.
+  *request = m_request;
+  Uintah::MPI::Start( request );
+}
+
+//______________________________________________________________________
+//
+void
+CommPlanCache::Message::free()
+{
+  if( m_request != MPI_REQUEST_NULL ) {
+    int finalized;
+    Uintah::MPI::Finalized( &finalized );
+    if( !finalized ) {
+      Uintah::MPI::Request_free( &m_request );
+    }
+    m_request = MPI_REQUEST_NULL;
+  }
+
+  if( m_buffer && m_buffer->removeReference() ) {
+    delete m_buffer;
+  }
+  m_buffer = nullptr;
+  m_count  = 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CCA_COMPONENTS_SCHEDULERS_COMMPLANCACHE_H
+#define CCA_COMPONENTS_SCHEDULERS_COMMPLANCACHE_H
+
+#include <Core/Parallel/UintahMPI.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Uintah {
+
+class DependencyBatch;
+class PackedBuffer;
+
+/**************************************
+
+  CLASS
+    CommPlanCache
+
+  GENERAL INFORMATION
+    CommPlanCache.h
+
+  DESCRIPTION
+    The messages of the MPIScheduler are the DependencyBatches of the
+    compiled task graphs, which are the same every timestep until the
+    graphs are recompiled (after a regrid or a new load balance).
+
+    For every batch sent or received, the cache keeps the pack buffer
+    and a persistent request (MPI_Send_init/MPI_Recv_init) on it, so
+    that after the first timestep a message is posted with MPI_Start
+    without allocating a buffer or creating a request.  A send request
+    is recreated when the packed size changes (e.g. the number of
+    particles), a receive request is set up for the whole buffer and
+    only recreated when the buffer has to grow.
+
+    The scheduler must have completed all requests of the previous
+    execute() before a batch is posted again, and must clear() the
+    cache whenever the task graphs are recompiled.
+
+****************************************/
+
+class CommPlanCache {
+
+public:
+
+  CommPlanCache() = default;
+
+  ~CommPlanCache();
+
+  void setEnabled( bool enabled ) { m_enabled = enabled; }
+  bool isEnabled() const          { return m_enabled; }
+
+  // Frees all buffers and requests.
+  void clear();
+
+  // Number of clear() calls, i.e. which compiled task graphs the
+  // plans belong to.
+  unsigned int generation() const { return m_generation; }
+
+  class Message {
+
+  public:
+
+    // The pack buffer of the previous timestep, if any.
+    PackedBuffer * buffer() const { return m_buffer; }
+
+    // Posts the message in 'buf' (which must be the buffer packed by
+    // the PackBufferInfo) into 'request'.
+    void start(       PackedBuffer * buf
+              ,       int            count
+              ,       int            peer
+              ,       int            tag
+              ,       MPI_Comm       comm
+              ,       MPI_Request  * request
+              );
+
+  private:
+
+    friend class CommPlanCache;
+
+    void free();
+
+    bool           m_send{true};
+    PackedBuffer * m_buffer{nullptr};
+    MPI_Request    m_request{MPI_REQUEST_NULL};
+    int            m_count{0};
+  };
+
+  // The plans of 'batch', created on first use.  nullptr when disabled.
+  Message * sendPlan( const DependencyBatch * batch ) { return plan( m_sends, batch, true ); }
+  Message * recvPlan( const DependencyBatch * batch ) { return plan( m_recvs, batch, false ); }
+
+private:
+
+  using Plans = std::unordered_map<const DependencyBatch*, Message>;
+
+  Message * plan( Plans & plans, const DependencyBatch * batch, bool send );
+
+  bool         m_enabled{true};
+  unsigned int m_generation{0};
+
+  std::mutex   m_mutex;  // guards the maps, not the messages
+  Plans        m_sends;
+  Plans        m_recvs;
+
+  // eliminate copy, assignment and move
+  CommPlanCache( const CommPlanCache & )            = delete;
+  CommPlanCache& operator=( const CommPlanCache & ) = delete;
+  CommPlanCache( CommPlanCache && )                 = delete;
+  CommPlanCache& operator=( CommPlanCache && )      = delete;
+};
+
+} // End namespace Uintah
+
+#endif // CCA_COMPONENTS_SCHEDULERS_COMMPLANCACHE_H
@@ -0,0 +1,677 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <CCA/Components/Schedulers/CompileCache.h>
+#include <CCA/Components/Schedulers/DetailedTasks.h>
+#include <CCA/Ports/LoadBalancer.h>
+
+#include <Core/Grid/Grid.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/ComputeSet.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+
+using namespace Uintah;
+
+namespace {
+
+  // lexicographic order of two IntVectors
+  int compare( const IntVector & a, const IntVector & b )
+  {
+    for (int i = 0; i < 3; ++i) {
+      if (a[i] != b[i]) {
+        return (a[i] < b[i]) ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+  bool less( const CompileCache::Record & a, const CompileCache::Record & b )
+  {
+    if (a.m_from != b.m_from) {
+      return a.m_from < b.m_from;
+    }
+    const auto a_deps = std::make_tuple(a.m_comp.m_task, a.m_comp.m_list, a.m_comp.m_index, a.m_req.m_task, a.m_req.m_list, a.m_req.m_index, a.m_matl, a.m_cond);
+    const auto b_deps = std::make_tuple(b.m_comp.m_task, b.m_comp.m_list, b.m_comp.m_index, b.m_req.m_task, b.m_req.m_list, b.m_req.m_index, b.m_matl, b.m_cond);
+    if (a_deps != b_deps) {
+      return a_deps < b_deps;
+    }
+    if (!(a.m_from_patch == b.m_from_patch)) {
+      return a.m_from_patch < b.m_from_patch;
+    }
+    if (!(a.m_to_patch == b.m_to_patch)) {
+      return a.m_to_patch < b.m_to_patch;
+    }
+    const int low = compare(a.m_low, b.m_low);
+    return (low != 0) ? (low < 0) : (compare(a.m_high, b.m_high) < 0);
+  }
+
+}
+
+//______________________________________________________________________
+//
+bool
+CompileCache::PatchRef::operator==( const PatchRef & rhs ) const
+{
+  return m_grid == rhs.m_grid && m_level == rhs.m_level && m_low == rhs.m_low && m_high == rhs.m_high;
+}
+
+//______________________________________________________________________
+//
+bool
+CompileCache::PatchRef::operator<( const PatchRef & rhs ) const
+{
+  if (m_grid != rhs.m_grid) {
+    return m_grid < rhs.m_grid;
+  }
+  if (m_level != rhs.m_level) {
+    return m_level < rhs.m_level;
+  }
+  const int low = compare(m_low, rhs.m_low);
+  return (low != 0) ? (low < 0) : (compare(m_high, rhs.m_high) < 0);
+}
+
+//______________________________________________________________________
+//
+bool
+CompileCache::Record::operator==( const Record & rhs ) const
+{
+  return m_from == rhs.m_from && m_comp == rhs.m_comp && m_from_patch == rhs.m_from_patch && m_req == rhs.m_req &&
+         m_to_patch == rhs.m_to_patch && m_matl == rhs.m_matl && m_low == rhs.m_low && m_high == rhs.m_high && m_cond == rhs.m_cond;
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::clear()
+{
+  m_signature.clear();
+  m_logs.clear();
+  m_state[0].clear();
+  m_state[1].clear();
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::beginCompile( const std::string                         & context
+                          , const std::vector<std::shared_ptr<Task> > & tasks
+                          ,       DetailedTasks                       * dts
+                          , const Grid                                * grid
+                          , const Grid                                * oldGrid
+                          ,       LoadBalancer                        * lb
+                          )
+{
+  m_num_replayed   = 0;
+  m_num_recomputed = 0;
+
+  m_new_logs.clear();
+  m_dirty.clear();
+  m_all_dirty.clear();
+  m_task_keys.clear();
+  m_tasks_by_key.clear();
+  m_task_index.clear();
+  m_dep_refs.clear();
+  m_deps.clear();
+  m_patches.clear();
+
+  // The tasks and their dependencies by position, and the signature of the graph:
+  // the logs of another graph (or of the same graph with other dependencies) are not
+  // replayed.
+  std::ostringstream signature;
+  signature << context << '\n';
+
+  const int num_tasks = static_cast<int>(tasks.size());
+  m_deps.resize(num_tasks);
+  for (int t = 0; t < num_tasks; ++t) {
+    Task* task = tasks[t].get();
+    m_task_index[task] = t;
+
+    signature << task->getName() << ' ' << static_cast<int>(task->getType()) << ' ' << task->usesMPI() << ' ' << task->getHasSubScheduler();
+    for (const auto & kv : task->m_max_ghost_cells) {
+      signature << " g" << kv.first << ':' << kv.second;
+    }
+    const MaterialSet* ms = task->getMaterialSet();
+    if (ms) {
+      for (int m = 0; m < ms->size(); ++m) {
+        const MaterialSubset* mss = ms->getSubset(m);
+        signature << " m";
+        for (int i = 0; i < mss->size(); ++i) {
+          signature << mss->get(i) << ',';
+        }
+      }
+    }
+    signature << '\n';
+
+    Task::Dependency* lists[3] = { task->getRequires(), task->getModifies(), task->getComputes() };
+    m_deps[t].resize(3);
+    for (int list = 0; list < 3; ++list) {
+      for (Task::Dependency* dep = lists[list]; dep != nullptr; dep = dep->m_next) {
+        m_dep_refs[dep] = DepRef{t, list, static_cast<int>(m_deps[t][list].size())};
+        m_deps[t][list].push_back(dep);
+
+        signature << "  " << list << ' ' << dep->m_var->getName() << ' ' << dep->m_dep_type << ' ' << dep->m_look_in_old_tg << ' '
+                  << dep->m_patches_dom << ' ' << dep->m_matls_dom << ' ' << dep->m_gtype << ' ' << dep->m_num_ghost_cells << ' '
+                  << dep->m_level_offset << ' ' << dep->m_whichdw << ' ' << dep->mapDataWarehouse() << ' '
+                  << (dep->m_patches != nullptr) << ' ' << (dep->m_reduction_level ? dep->m_reduction_level->getIndex() : -1) << " m";
+        if (dep->m_matls) {
+          for (int i = 0; i < dep->m_matls->size(); ++i) {
+            signature << dep->m_matls->get(i) << ',';
+          }
+        }
+        signature << '\n';
+      }
+    }
+  }
+
+  for (int which = 0; which < 2; ++which) {
+    const Grid* g = (which == 0) ? grid : oldGrid;
+    signature << "grid " << which << ' ' << (g ? g->numLevels() : -1) << '\n';
+    snapshot(g, which, lb);
+  }
+
+  // The DetailedTasks by key.  A key that is not unique is not replayed.
+  const int num_dtasks = dts->numTasks();
+  for (int i = 0; i < num_dtasks; ++i) {
+    DetailedTask* dtask = dts->getTask(i);
+    const std::string key = taskKey(dtask);
+    m_task_keys[dtask] = key;
+    auto inserted = m_tasks_by_key.emplace(key, dtask);
+    if (!inserted.second) {
+      inserted.first->second = nullptr;
+    }
+  }
+
+  m_replay = m_enabled && !m_logs.empty() && (signature.str() == m_signature);
+  if (m_replay) {
+    findDirtyBoxes();
+  }
+  else {
+    m_logs.clear();
+  }
+
+  m_signature = signature.str();
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::snapshot( const Grid         * grid
+                      ,       int            which
+                      ,       LoadBalancer * lb
+                      )
+{
+  std::vector<LevelState>& levels = m_new_state[which];
+  levels.clear();
+  if (grid == nullptr) {
+    return;
+  }
+
+  const int num_levels = grid->numLevels();
+  levels.resize(num_levels);
+  for (int l = 0; l < num_levels; ++l) {
+    const LevelP& level = grid->getLevel(l);
+    LevelState& state   = levels[l];
+
+    IntVector low, high;
+    level->findCellIndexRange(low, high);
+
+    std::ostringstream signature;
+    signature << std::setprecision(17) << low << high << level->getExtraCells() << level->getPeriodicBoundaries()
+              << level->getRefinementRatio() << level->dCell() << level->getAnchor();
+    state.m_signature = signature.str();
+    state.m_periodic  = (level->getPeriodicBoundaries() != IntVector(0, 0, 0));
+
+    for (Level::const_patch_iterator iter = level->patchesBegin(); iter != level->patchesEnd(); ++iter) {
+      const Patch* patch = *iter;
+      const PatchRef ref = patchRef(patch, which);
+
+      PatchState& patch_state = state.m_patches[ref];
+      patch_state.m_owner     = lb->getPatchwiseProcessorAssignment(patch);
+      patch_state.m_old_owner = lb->getOldProcessorAssignment(patch);
+      patch_state.m_local     = lb->inNeighborhood(patch, false);
+      patch_state.m_distal    = lb->inNeighborhood(patch, true);
+
+      m_patches[ref] = patch;
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::findDirtyBoxes()
+{
+  // The patches that were added, removed, or whose assignment or neighborhood changed.
+  for (int which = 0; which < 2; ++which) {
+    const std::vector<LevelState>& before = m_state[which];
+    const std::vector<LevelState>& after  = m_new_state[which];
+
+    for (size_t l = 0; l < after.size(); ++l) {
+      const std::pair<int, int> id(which, static_cast<int>(l));
+      if (l >= before.size() || before[l].m_signature != after[l].m_signature) {
+        m_all_dirty[id] = true;
+        continue;
+      }
+
+      std::vector<Box>& dirty = m_dirty[id];
+      auto add = [&](const PatchRef & ref) {
+        dirty.push_back(Box{which, static_cast<int>(l), ref.m_low, ref.m_high});
+      };
+
+      auto b = before[l].m_patches.begin();
+      auto a = after[l].m_patches.begin();
+      while (b != before[l].m_patches.end() || a != after[l].m_patches.end()) {
+        if (a == after[l].m_patches.end() || (b != before[l].m_patches.end() && b->first < a->first)) {
+          add((b++)->first);
+        }
+        else if (b == before[l].m_patches.end() || a->first < b->first) {
+          add((a++)->first);
+        }
+        else {
+          if (!(a->second == b->second)) {
+            add(a->first);
+          }
+          ++a;
+          ++b;
+        }
+      }
+
+      // the ghost regions of a periodic level wrap around
+      if (!dirty.empty() && after[l].m_periodic) {
+        m_all_dirty[id] = true;
+      }
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+bool
+CompileCache::isDirty( const Box & box ) const
+{
+  const std::pair<int, int> id(box.m_grid, box.m_level);
+
+  auto all = m_all_dirty.find(id);
+  if (all != m_all_dirty.end() && all->second) {
+    return true;
+  }
+
+  auto dirty = m_dirty.find(id);
+  if (dirty == m_dirty.end()) {
+    return false;
+  }
+
+  // patches touching the box count, they change its boundary faces
+  const IntVector one(1, 1, 1);
+  const IntVector low  = box.m_low - one;
+  const IntVector high = box.m_high + one;
+  for (const Box & d : dirty->second) {
+    if (d.m_low.x() < high.x() && low.x() < d.m_high.x() &&
+        d.m_low.y() < high.y() && low.y() < d.m_high.y() &&
+        d.m_low.z() < high.z() && low.z() < d.m_high.z()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//______________________________________________________________________
+//
+std::string
+CompileCache::taskKey( const DetailedTask * dtask ) const
+{
+  auto known = m_task_keys.find(dtask);
+  if (known != m_task_keys.end()) {
+    return known->second;
+  }
+
+  std::ostringstream key;
+  auto index = m_task_index.find(dtask->getTask());
+  if (index == m_task_index.end()) {
+    // the send-old-data task of a rank
+    key << "old@" << dtask->getAssignedResourceIndex();
+    return key.str();
+  }
+
+  key << index->second << '@' << dtask->getAssignedResourceIndex();
+
+  const PatchSubset* patches = dtask->getPatches();
+  if (patches) {
+    for (int p = 0; p < patches->size(); ++p) {
+      const Patch* patch = patches->get(p);
+      key << '|' << patch->getLevel()->getIndex() << patch->getCellLowIndex() << patch->getCellHighIndex();
+    }
+  }
+
+  const MaterialSubset* matls = dtask->getMaterials();
+  key << '#';
+  if (matls) {
+    for (int m = 0; m < matls->size(); ++m) {
+      key << matls->get(m) << ',';
+    }
+  }
+  return key.str();
+}
+
+//______________________________________________________________________
+//
+CompileCache::PatchRef
+CompileCache::patchRef( const Patch * patch
+                      ,       int     grid
+                      ) const
+{
+  PatchRef ref;
+  if (patch) {
+    ref.m_grid  = grid;
+    ref.m_level = patch->getLevel()->getIndex();
+    ref.m_low   = patch->getCellLowIndex();
+    ref.m_high  = patch->getCellHighIndex();
+  }
+  return ref;
+}
+
+//______________________________________________________________________
+//
+CompileCache::DepRef
+CompileCache::depRef( const Task::Dependency * dep ) const
+{
+  if (dep == nullptr) {
+    return DepRef{};
+  }
+  auto ref = m_dep_refs.find(dep);
+  return (ref != m_dep_refs.end()) ? ref->second : DepRef{-2, -2, -2};
+}
+
+//______________________________________________________________________
+//
+const CompileCache::Log *
+CompileCache::findLog( const DetailedTask * dtask ) const
+{
+  // tasks without patches (reductions, global output, sending old data) are always analyzed
+  if (!m_replay || dtask->getPatches() == nullptr) {
+    return nullptr;
+  }
+
+  auto key = m_task_keys.find(dtask);
+  if (key == m_task_keys.end() || m_tasks_by_key.at(key->second) != dtask) {
+    return nullptr;
+  }
+
+  auto log = m_logs.find(key->second);
+  if (log == m_logs.end() || !log->second.m_replayable) {
+    return nullptr;
+  }
+
+  for (const Box & box : log->second.m_footprint) {
+    if (isDirty(box)) {
+      return nullptr;
+    }
+  }
+  return &log->second;
+}
+
+//______________________________________________________________________
+//
+bool
+CompileCache::resolve( const Log                     & log
+                     ,       std::vector<Dependency> & deps
+                     )
+{
+  auto task = [&](const std::string & key) -> DetailedTask* {
+    auto found = m_tasks_by_key.find(key);
+    return (found != m_tasks_by_key.end()) ? found->second : nullptr;
+  };
+
+  bool resolved = true;
+  auto dep = [&](const DepRef & ref) -> Task::Dependency* {
+    if (ref.m_task == -1) {
+      return nullptr;
+    }
+    if (ref.m_task < 0 || ref.m_task >= static_cast<int>(m_deps.size()) || ref.m_index >= static_cast<int>(m_deps[ref.m_task][ref.m_list].size())) {
+      resolved = false;
+      return nullptr;
+    }
+    return m_deps[ref.m_task][ref.m_list][ref.m_index];
+  };
+
+  auto patch = [&](const PatchRef & ref) -> const Patch* {
+    if (ref.m_grid == -1) {
+      return nullptr;
+    }
+    auto found = m_patches.find(ref);
+    if (found == m_patches.end()) {
+      resolved = false;
+      return nullptr;
+    }
+    return found->second;
+  };
+
+  // the tasks that require a variable before this task modifies it
+  for (const RequiringTasks & requiring : log.m_requiring) {
+    DetailedTask* creator  = task(requiring.m_creator);
+    Task::Dependency* req = dep(requiring.m_req);
+    if (creator == nullptr || req == nullptr || !resolved) {
+      return false;
+    }
+
+    std::list<DetailedTask*> tasks;
+    creator->findRequiringTasks(req->m_var, tasks);
+
+    std::vector<std::string> keys;
+    for (const DetailedTask* t : tasks) {
+      keys.push_back(taskKey(t));
+    }
+    std::sort(keys.begin(), keys.end());
+    if (keys != requiring.m_tasks) {
+      return false;
+    }
+  }
+
+  deps.resize(log.m_records.size());
+  for (size_t i = 0; i < log.m_records.size(); ++i) {
+    const Record& record = log.m_records[i];
+    Dependency& d = deps[i];
+
+    d.m_from       = task(record.m_from);
+    d.m_comp       = dep(record.m_comp);
+    d.m_from_patch = patch(record.m_from_patch);
+    d.m_req        = dep(record.m_req);
+    d.m_to_patch   = patch(record.m_to_patch);
+    d.m_record     = &record;
+
+    if (d.m_from == nullptr || d.m_req == nullptr || !resolved) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::keepLog( const DetailedTask * dtask
+                     , const Log          & log
+                     )
+{
+  m_new_logs[taskKey(dtask)] = log;
+}
+
+//______________________________________________________________________
+//
+CompileCache::Log *
+CompileCache::newLog( const DetailedTask * dtask )
+{
+  auto key = m_task_keys.find(dtask);
+  if (dtask->getPatches() == nullptr || key == m_task_keys.end() || m_tasks_by_key[key->second] != dtask) {
+    return nullptr;
+  }
+
+  Log& log = m_new_logs[key->second];
+  log = Log();
+
+  const PatchSubset* patches = dtask->getPatches();
+  for (int p = 0; p < patches->size(); ++p) {
+    const Patch* patch = patches->get(p);
+    recordFootprint(log, patch->getLevel(), false, patch->getExtraCellLowIndex(), patch->getExtraCellHighIndex());
+  }
+  return &log;
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::recordDependency(       Log              & log
+                              ,       DetailedTask     * from
+                              ,       Task::Dependency * comp
+                              , const Patch            * fromPatch
+                              ,       bool               fromOldGrid
+                              ,       Task::Dependency * req
+                              , const Patch            * toPatch
+                              ,       int                matl
+                              , const IntVector        & low
+                              , const IntVector        & high
+                              ,       int                cond
+                              )
+{
+  if ((fromPatch && fromPatch->isVirtual()) || (toPatch && toPatch->isVirtual()) || from == nullptr) {
+    log.m_replayable = false;
+    return;
+  }
+
+  Record record;
+  record.m_from       = taskKey(from);
+  record.m_comp       = depRef(comp);
+  record.m_from_patch = patchRef(fromPatch, fromOldGrid ? 1 : 0);
+  record.m_req        = depRef(req);
+  record.m_to_patch   = patchRef(toPatch, 0);
+  record.m_matl       = matl;
+  record.m_low        = low;
+  record.m_high       = high;
+  record.m_cond       = cond;
+
+  if (record.m_comp.m_task == -2 || record.m_req.m_task < 0) {
+    log.m_replayable = false;
+  }
+
+  if (fromPatch) {
+    recordFootprint(log, fromPatch->getLevel(), fromOldGrid, fromPatch->getExtraCellLowIndex(), fromPatch->getExtraCellHighIndex());
+  }
+  if (toPatch) {
+    recordFootprint(log, toPatch->getLevel(), false, toPatch->getExtraCellLowIndex(), toPatch->getExtraCellHighIndex());
+  }
+
+  log.m_records.push_back(record);
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::recordRequiringTasks(       Log                      & log
+                                  ,       DetailedTask             * creator
+                                  ,       Task::Dependency         * req
+                                  , const std::list<DetailedTask*> & tasks
+                                  )
+{
+  RequiringTasks requiring;
+  requiring.m_creator = taskKey(creator);
+  requiring.m_req     = depRef(req);
+  for (const DetailedTask* task : tasks) {
+    requiring.m_tasks.push_back(taskKey(task));
+  }
+  std::sort(requiring.m_tasks.begin(), requiring.m_tasks.end());
+
+  if (requiring.m_req.m_task < 0) {
+    log.m_replayable = false;
+  }
+  log.m_requiring.push_back(requiring);
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::recordFootprint(       Log       & log
+                             , const Level     * level
+                             ,       bool        oldGrid
+                             , const IntVector & low
+                             , const IntVector & high
+                             )
+{
+  const int grid = oldGrid ? 1 : 0;
+  for (Box & box : log.m_footprint) {
+    if (box.m_grid == grid && box.m_level == level->getIndex()) {
+      box.m_low  = Min(box.m_low, low);
+      box.m_high = Max(box.m_high, high);
+      return;
+    }
+  }
+  log.m_footprint.push_back(Box{grid, level->getIndex(), low, high});
+}
+
+//______________________________________________________________________
+//
+bool
+CompileCache::sameDependencies( const Log & a
+                              , const Log & b
+                              )
+{
+  // the order of the requiring tasks (and so of some records) depends on addresses
+  if (a.m_records.size() != b.m_records.size()) {
+    return false;
+  }
+
+  std::vector<Record> a_records = a.m_records;
+  std::vector<Record> b_records = b.m_records;
+  std::sort(a_records.begin(), a_records.end(), less);
+  std::sort(b_records.begin(), b_records.end(), less);
+
+  return a_records == b_records;
+}
+
+//______________________________________________________________________
+//
+void
+CompileCache::endCompile()
+{
+  m_logs.swap(m_new_logs);
+  m_new_logs.clear();
+
+  m_state[0].swap(m_new_state[0]);
+  m_state[1].swap(m_new_state[1]);
+
+  m_task_keys.clear();
+  m_tasks_by_key.clear();
+  m_task_index.clear();
+  m_dep_refs.clear();
+  m_deps.clear();
+  m_patches.clear();
+  m_dirty.clear();
+  m_all_dirty.clear();
+  m_replay = false;
+}
@@ -0,0 +1,307 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CCA_COMPONENTS_SCHEDULERS_COMPILECACHE_H
+#define CCA_COMPONENTS_SCHEDULERS_COMPILECACHE_H
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Grid/Task.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Uintah {
+
+class DetailedTask;
+class DetailedTasks;
+class Grid;
+class Level;
+class LoadBalancer;
+class Patch;
+
+/**************************************
+
+  CLASS
+    CompileCache
+
+  GENERAL INFORMATION
+    CompileCache.h
+
+  DESCRIPTION
+    Reuses the dependency analysis of TaskGraph::createDetailedDependencies
+    across recompiles of the same task graph.
+
+    While a DetailedTask's requires and modifies are analyzed, every call
+    to DetailedTasks::possiblyCreateDependency is recorded in a log, with
+    the tasks, dependencies and patches it involves stored as keys that
+    survive a recompile: a task by its index in the graph, its patches
+    and materials and its rank, a dependency by its position in its task,
+    and a patch by its level and cell extents.  The log also keeps the
+    boxes of the grid the analysis looked at (its footprint).
+
+    On the next compile with the same task graph, a DetailedTask whose
+    footprint holds no patch that was added, removed, reassigned, or that
+    moved in or out of this rank's neighborhood replays its log instead of
+    analyzing its dependencies again.  Only the tasks near a change of the
+    grid or of the load balance are analyzed.  The DetailedTasks,
+    DetailedDeps and DependencyBatches are rebuilt from the replayed logs:
+    they point at the Tasks and Patches of the graph being compiled, which
+    are new objects after every recompile (and after a regrid).
+
+    Requires of reduction variables are always analyzed, they depend on
+    every task computing the variable on this rank.
+
+    With the TaskGraphCompileVerify debug stream, replayed tasks are also
+    analyzed and the compile fails if the two differ.
+
+****************************************/
+
+class CompileCache {
+
+public:
+
+  // A patch of the grid (or of the grid of the old DW) by its extents.
+  struct PatchRef {
+    int       m_grid{-1};   // -1 none, 0 the current grid, 1 the old DW grid
+    int       m_level{-1};
+    IntVector m_low{0, 0, 0};
+    IntVector m_high{0, 0, 0};
+
+    bool operator==( const PatchRef & rhs ) const;
+    bool operator< ( const PatchRef & rhs ) const;
+  };
+
+  // A requires, modifies or computes of a task by its position.
+  struct DepRef {
+    DepRef() = default;
+    DepRef( int task, int list, int index ) : m_task(task), m_list(list), m_index(index) {}
+
+    int m_task{-1};
+    int m_list{-1};
+    int m_index{-1};
+
+    bool operator==( const DepRef & rhs ) const
+    {
+      return m_task == rhs.m_task && m_list == rhs.m_list && m_index == rhs.m_index;
+    }
+  };
+
+  // One call of DetailedTasks::possiblyCreateDependency, the to-task is
+  // the task the log belongs to.
+  struct Record {
+    std::string m_from{};
+    DepRef      m_comp{};
+    PatchRef    m_from_patch{};
+    DepRef      m_req{};
+    PatchRef    m_to_patch{};
+    int         m_matl{0};
+    IntVector   m_low{0, 0, 0};
+    IntVector   m_high{0, 0, 0};
+    int         m_cond{0};
+
+    bool operator==( const Record & rhs ) const;
+  };
+
+  // The tasks that required a variable from its creator before the
+  // task modified it, these depend on the tasks analyzed earlier.
+  struct RequiringTasks {
+    std::string              m_creator{};
+    DepRef                   m_req{};
+    std::vector<std::string> m_tasks{};
+  };
+
+  struct Box {
+    Box() = default;
+    Box( int grid, int level, const IntVector & low, const IntVector & high ) : m_grid(grid), m_level(level), m_low(low), m_high(high) {}
+
+    int       m_grid{0};
+    int       m_level{0};
+    IntVector m_low{0, 0, 0};
+    IntVector m_high{0, 0, 0};
+  };
+
+  struct Log {
+    std::vector<Record>         m_records{};
+    std::vector<RequiringTasks> m_requiring{};
+    std::vector<Box>            m_footprint{};   // one bounding box per grid and level
+    bool                        m_replayable{true};
+  };
+
+  CompileCache() = default;
+
+  ~CompileCache() = default;
+
+  void setEnabled( bool enabled ) { m_enabled = enabled; }
+  bool isEnabled() const          { return m_enabled; }
+
+  // Forgets all logs.
+  void clear();
+
+  // Starts the dependency analysis of a compile of 'tasks' into 'dts'.
+  // 'context' must describe everything else the dependencies depend on
+  // besides the grids and the patch assignment (e.g. the number of ranks).
+  void beginCompile( const std::string                         & context
+                   , const std::vector<std::shared_ptr<Task> > & tasks
+                   ,       DetailedTasks                       * dts
+                   , const Grid                                * grid
+                   , const Grid                                * oldGrid
+                   ,       LoadBalancer                        * lb
+                   );
+
+  // The log of 'dtask' from the last compile if its footprint is unchanged,
+  // otherwise nullptr.
+  const Log * findLog( const DetailedTask * dtask ) const;
+
+  // A recorded call resolved against the graph being compiled.
+  struct Dependency {
+    DetailedTask     * m_from{nullptr};
+    Task::Dependency * m_comp{nullptr};
+    const Patch      * m_from_patch{nullptr};
+    Task::Dependency * m_req{nullptr};
+    const Patch      * m_to_patch{nullptr};
+    const Record     * m_record{nullptr};
+  };
+
+  // Resolves the records of 'log'.  False if a task, dependency or patch
+  // no longer exists or the requiring tasks changed.
+  bool resolve( const Log                     & log
+              ,       std::vector<Dependency> & deps
+              );
+
+  // Keeps the replayed 'log' for the next compile.
+  void keepLog( const DetailedTask * dtask, const Log & log );
+
+  // A new, empty log for 'dtask' (nullptr if it can't be replayed later).
+  Log * newLog( const DetailedTask * dtask );
+
+  void recordDependency(       Log              & log
+                       ,       DetailedTask     * from
+                       ,       Task::Dependency * comp
+                       , const Patch            * fromPatch
+                       ,       bool               fromOldGrid
+                       ,       Task::Dependency * req
+                       , const Patch            * toPatch
+                       ,       int                matl
+                       , const IntVector        & low
+                       , const IntVector        & high
+                       ,       int                cond
+                       );
+
+  void recordRequiringTasks(       Log                       & log
+                           ,       DetailedTask              * creator
+                           ,       Task::Dependency          * req
+                           , const std::list<DetailedTask*>  & tasks
+                           );
+
+  // Adds [low, high) of 'level' to the footprint of 'log'.
+  void recordFootprint(       Log       & log
+                      , const Level     * level
+                      ,       bool        oldGrid
+                      , const IntVector & low
+                      , const IntVector & high
+                      );
+
+  // Whether the dependencies of two logs are the same.
+  static bool sameDependencies( const Log & a, const Log & b );
+
+  // Ends the compile, the logs recorded or kept replace the previous ones.
+  void endCompile();
+
+  int numReplayed() const   { return m_num_replayed; }
+  int numRecomputed() const { return m_num_recomputed; }
+
+  void countReplayed()   { ++m_num_replayed; }
+  void countRecomputed() { ++m_num_recomputed; }
+
+private:
+
+  // What the dependencies of the tasks on a patch depend on.
+  struct PatchState {
+    int  m_owner{-1};
+    int  m_old_owner{-1};
+    bool m_local{false};
+    bool m_distal{false};
+
+    bool operator==( const PatchState & rhs ) const
+    {
+      return m_owner == rhs.m_owner && m_old_owner == rhs.m_old_owner && m_local == rhs.m_local && m_distal == rhs.m_distal;
+    }
+  };
+
+  struct LevelState {
+    std::string                     m_signature{};
+    bool                            m_periodic{false};
+    std::map<PatchRef, PatchState>  m_patches{};
+  };
+
+  void snapshot( const Grid * grid, int which, LoadBalancer * lb );
+
+  void findDirtyBoxes();
+
+  bool isDirty( const Box & box ) const;
+
+  std::string taskKey( const DetailedTask * dtask ) const;
+
+  PatchRef patchRef( const Patch * patch, int grid ) const;
+
+  DepRef depRef( const Task::Dependency * dep ) const;
+
+  bool m_enabled{false};
+
+  // of the last compile
+  std::string                           m_signature{};
+  std::unordered_map<std::string, Log>  m_logs{};
+  std::vector<LevelState>               m_state[2]{};      // the current and the old DW grid
+
+  // of the compile in progress
+  bool                                  m_replay{false};
+  std::unordered_map<std::string, Log>  m_new_logs{};
+  std::vector<LevelState>               m_new_state[2]{};
+  std::map<std::pair<int, int>, std::vector<Box> > m_dirty{};      // by grid and level
+  std::map<std::pair<int, int>, bool>              m_all_dirty{};  // by grid and level
+
+  std::unordered_map<const DetailedTask*, std::string>      m_task_keys{};
+  std::unordered_map<std::string, DetailedTask*>            m_tasks_by_key{};
+  std::unordered_map<const Task*, int>                      m_task_index{};
+  std::unordered_map<const Task::Dependency*, DepRef>       m_dep_refs{};
+  std::vector<std::vector<std::vector<Task::Dependency*> > > m_deps{};
+  std::map<PatchRef, const Patch*>                          m_patches{};
+
+  int m_num_replayed{0};
+  int m_num_recomputed{0};
+
+  // eliminate copy, assignment and move
+  CompileCache( const CompileCache & )            = delete;
+  CompileCache& operator=( const CompileCache & ) = delete;
+  CompileCache( CompileCache && )                 = delete;
+  CompileCache& operator=( CompileCache && )      = delete;
+};
+
+} // End namespace Uintah
+
+#endif // CCA_COMPONENTS_SCHEDULERS_COMPILECACHE_H
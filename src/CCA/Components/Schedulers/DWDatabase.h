@@ -40,10 +40,15 @@
 #include <Core/Parallel/Parallel.h>
 #include <Core/Util/FancyAssert.h>
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
-#include <unordered_map>
+#include <thread>
 #include <vector>
 
 
@@ -67,21 +72,56 @@
     DWDatabase
 
   DESCRIPTION
-
+    Per-DataWarehouse storage of variables, indexed through a KeyDatabase.
+    There is no global lock: key lookups are lock-free and variable slots
+    are updated with atomic exchanges (see KeyDatabase and DWDatabase::Slot).
+    A DataItem taken out of a slot is only deleted once no reader is inside
+    that slot (see DWDatabase::SlotReader and DWDatabase::retire).
 
 ****************************************/
 
 
-namespace {
+//______________________________________________________________________
+//
+// Custom hash function for VarLabelMatl
+//
+// Specialize std::hash structure and inject into the std namespace so that
+// VarLabelMatl<DomainType> can be used as a key in std::unordered_map and in KeyDatabase
+//
+// NOTE: this is legit, and likely the easiest way to get this done due to templates (APH - 10/25/18).
+//
+// It is allowed to add template specializations for any standard library class template to the std namespace
+// only if the declaration depends on at least one program-defined type and the specialization satisfies all
+// requirements for the original template (https://en.cppreference.com/w/cpp/language/extending_std).
+//
+namespace std {
 
-Uintah::MasterLock g_keyDB_lock{};
-Uintah::MasterLock g_mvars_lock{};
+using Uintah::VarLabelMatl;
 
-}
+template<class DomainType>
+struct hash<VarLabelMatl<DomainType> > {
+  size_t operator()( const VarLabelMatl<DomainType>& v ) const {
+    // VarLabels are unique, so the label pointer identifies the name - no need to hash the string
+    return ((((size_t)v.m_label) << (sizeof(size_t) / 2) ^ ((size_t)v.m_label) >> (sizeof(size_t) / 2)) ^ (size_t)v.m_domain ^ (size_t)v.m_matl_index);
+  }
+};
 
-namespace Uintah {
+}  // end namespace std
 
 
+namespace Uintah {
+
+//______________________________________________________________________
+//
+// KeyDatabase maps (VarLabel, matl, domain) to a dense index into the DWDatabase slot table.
+//
+// Keys are split across KEY_SHARDS independent hash tables, selected by the (VarLabel, domain)
+// hash, so that concurrent inserts (copy timesteps, reductions) only contend per shard. Keys are
+// never removed between clear() calls, which allows an RCU-style read path: buckets hold
+// immutable nodes that are published with release stores, and a shard that outgrows its bucket
+// array builds a new table and publishes it atomically. Superseded tables are retired, not freed,
+// until clear(), so lookup() never takes a lock, whether or not the key database is still growing.
+//
 template<class DomainType>
 class KeyDatabase {
 
@@ -91,7 +131,7 @@ public:
 
   KeyDatabase() {};
 
-  ~KeyDatabase() {};
+  ~KeyDatabase();
 
   void clear();
 
@@ -103,19 +143,94 @@ public:
   int lookup( const VarLabel   * label
             ,       int          matlIndex
             , const DomainType * dom
-            );
+            ) const;
 
   void merge( const KeyDatabase<DomainType>& newDB );
 
   void print( std::ostream & out, int rank ) const;
 
+  int size() const { return m_key_count.load(std::memory_order_acquire); }
+
+  // calls f( const VarLabelMatl<DomainType> & key, int index ) for every key, in no particular order
+  template<typename Functor>
+  void forEach( Functor f ) const;
+
 private:
 
-  using keyDBtype = std::unordered_map<VarLabelMatl<DomainType>, int>;
-  keyDBtype m_keys;
+  using Key = VarLabelMatl<DomainType>;
+
+  static constexpr int    KEY_SHARDS      = 64;
+  static constexpr size_t INITIAL_BUCKETS = 16;
+
+  struct Node {
+    Node( const Key & key, int index, Node * next ) : m_key{key}, m_index{index}, m_next{next} {}
+
+    const Key         m_key;
+    const int         m_index;
+          Node* const m_next;
+  };
+
+  struct Table {
+    explicit Table( size_t num_buckets )
+      : m_num_buckets{num_buckets}
+      , m_buckets{new std::atomic<Node*>[num_buckets]}
+    {
+      for (size_t i = 0; i < m_num_buckets; ++i) {
+        m_buckets[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    ~Table()
+    {
+      for (size_t i = 0; i < m_num_buckets; ++i) {
+        Node* node = m_buckets[i].load(std::memory_order_relaxed);
+        while (node) {
+          Node* next = node->m_next;
+          delete node;
+          node = next;
+        }
+      }
+      delete [] m_buckets;
+    }
+
+    const size_t               m_num_buckets;
+          std::atomic<Node*> * m_buckets;
+          Table              * m_retired_next{nullptr};
+  };
+
+  struct alignas(64) Shard {
+    std::atomic<Table*> m_table{nullptr};
+    Table             * m_retired{nullptr};  // superseded tables, kept alive for in-flight readers
+    size_t              m_size{0};
+    Uintah::MasterLock  m_insert_lock{};     // serializes writers on this shard only
+  };
+
+  static size_t hashKey( const Key & key )
+  {
+    // finalizer from MurmurHash3 - spreads the pointer-heavy std::hash value over all bits
+    uint64_t h = std::hash<Key>()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+  }
+
+  static int shardOf( size_t hash ) { return static_cast<int>((hash >> 48) % KEY_SHARDS); }
 
-  int m_key_count { 0 };
+  void insertKey( const Key & key );
 
+  int lookupKey( const Key & key ) const;
+
+  Shard            m_shards[KEY_SHARDS];
+  std::atomic<int> m_key_count{0};
+
+  // eliminate copy, assignment and move
+  KeyDatabase( const KeyDatabase & )            = delete;
+  KeyDatabase& operator=( const KeyDatabase & ) = delete;
+  KeyDatabase( KeyDatabase && )                 = delete;
+  KeyDatabase& operator=( KeyDatabase && )      = delete;
 };
 
 
@@ -234,6 +349,9 @@ class DWDatabase {
 
     void getVarLabelMatlTriples(std::vector<VarLabelMatl<DomainType> >& vars) const;
 
+    // Adds the bytes of every variable to its domain's entry.
+    void getDataSizes(std::map<const DomainType*, size_t>& sizes) const;
+
 
   private:
 
@@ -253,18 +371,77 @@ class DWDatabase {
         struct DataItem * m_next { nullptr };
     };
 
-    DataItem* getDataItem( const VarLabel   * label
-                         ,       int          matlindex
-                         , const DomainType * dom
-                         ) const;
+    // One slot per key index. Slots live in fixed-size chunks that are never moved, so a
+    // thread may read a slot while another thread reserves room for newly inserted keys.
+    // Ownership of a DataItem is transferred with atomic exchanges; whoever takes it out of
+    // the slot deletes it through retire(), which first waits for the slot's readers to leave.
+    struct Slot {
+      std::atomic<DataItem*> m_item    {nullptr};
+      std::atomic<int>       m_scrub   {0};
+      std::atomic<int>       m_readers {0};
+    };
 
-    KeyDatabase<DomainType>* m_keyDB { nullptr };
+    // Pins a slot for the lifetime of the reader: announce the reader, then load the item.
+    // Both steps are sequentially consistent, as are the exchanges that remove items, so a
+    // remover either sees this reader in retire() or this reader already sees the new item.
+    class SlotReader {
+      public:
+        explicit SlotReader( Slot * slot ) : m_slot{slot}
+        {
+          if (m_slot) {
+            m_slot->m_readers.fetch_add(1, std::memory_order_seq_cst);
+          }
+        }
+
+        ~SlotReader()
+        {
+          if (m_slot) {
+            m_slot->m_readers.fetch_sub(1, std::memory_order_release);
+          }
+        }
+
+        DataItem* item() const { return m_slot ? m_slot->m_item.load(std::memory_order_seq_cst) : nullptr; }
+
+      private:
+        Slot * m_slot;
+
+        SlotReader( const SlotReader & )            = delete;
+        SlotReader& operator=( const SlotReader & ) = delete;
+    };
+
+    // deletes an item that has already been exchanged out of slot, once no reader can still hold it
+    static void retire( Slot * slot, DataItem * item )
+    {
+      if (item) {
+        while (slot->m_readers.load(std::memory_order_seq_cst) != 0) {
+          std::this_thread::yield();
+        }
+        delete item;
+      }
+    }
+
+    static constexpr int SLOT_CHUNK_BITS = 10;
+    static constexpr int SLOT_CHUNK_SIZE = 1 << SLOT_CHUNK_BITS;
+    static constexpr int MAX_SLOT_CHUNKS = 4096;
+
+    // returns nullptr if no slot has been reserved for idx yet
+    Slot* getSlot( int idx ) const
+    {
+      Slot* chunk = m_slot_chunks[idx >> SLOT_CHUNK_BITS].load(std::memory_order_acquire);
+      return chunk ? &chunk[idx & (SLOT_CHUNK_SIZE - 1)] : nullptr;
+    }
 
-    using varDBtype = std::vector<DataItem*>;
-    varDBtype m_vars {};
+    Slot* reserveSlot( int idx );
+
+    Slot* getDataSlot( const VarLabel   * label
+                     ,       int          matlindex
+                     , const DomainType * dom
+                     ) const;
+
+    KeyDatabase<DomainType>* m_keyDB { nullptr };
 
-    using scrubDBtype = std::vector<int>;
-    scrubDBtype m_scrubs {};
+    std::atomic<Slot*> m_slot_chunks[MAX_SLOT_CHUNKS] {};
+    Uintah::MasterLock m_reserve_lock {};
 
     // eliminate copy, assignment and move
     DWDatabase( const DWDatabase & )            = delete;
@@ -286,13 +463,38 @@ DWDatabase<DomainType>::~DWDatabase()
 template<class DomainType>
 void DWDatabase<DomainType>::clear()
 {
-  for (auto iter = m_vars.begin(); iter != m_vars.end(); ++iter) {
-    if (*iter) {
-      delete *iter;
+  for (int c = 0; c < MAX_SLOT_CHUNKS; ++c) {
+    Slot* chunk = m_slot_chunks[c].exchange(nullptr, std::memory_order_acq_rel);
+    if (chunk) {
+      for (int i = 0; i < SLOT_CHUNK_SIZE; ++i) {
+        delete chunk[i].m_item.load(std::memory_order_relaxed);
+      }
+      delete [] chunk;
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+template<class DomainType>
+typename DWDatabase<DomainType>::Slot*
+DWDatabase<DomainType>::reserveSlot( int idx )
+{
+  const int c = idx >> SLOT_CHUNK_BITS;
+  if (c >= MAX_SLOT_CHUNKS) {
+    SCI_THROW(InternalError("DWDatabase: key index exceeds slot table capacity", __FILE__, __LINE__));
+  }
+
+  Slot* chunk = m_slot_chunks[c].load(std::memory_order_acquire);
+  if (!chunk) {
+    std::lock_guard<Uintah::MasterLock> reserve_lock(m_reserve_lock);
+    chunk = m_slot_chunks[c].load(std::memory_order_acquire);
+    if (!chunk) {
+      chunk = new Slot[SLOT_CHUNK_SIZE];
+      m_slot_chunks[c].store(chunk, std::memory_order_release);
     }
-    *iter = nullptr;
   }
-  m_vars.clear();
+  return &chunk[idx & (SLOT_CHUNK_SIZE - 1)];
 }
 
 //______________________________________________________________________
@@ -301,11 +503,23 @@ template<class DomainType>
 void
 DWDatabase<DomainType>::cleanForeign()
 {
-  for (auto iter = m_vars.begin(); iter != m_vars.end(); ++iter) {
-    if (*iter && (*iter)->m_var->isForeign()) {
-      if ( dynamic_cast<SubProblemsVariableBase*>( (*iter)->m_var ) ) continue;
-      delete (*iter);
-      (*iter) = nullptr;
+  for (int c = 0; c < MAX_SLOT_CHUNKS; ++c) {
+    Slot* chunk = m_slot_chunks[c].load(std::memory_order_acquire);
+    if (!chunk) {
+      continue;
+    }
+    for (int i = 0; i < SLOT_CHUNK_SIZE; ++i) {
+      DataItem* item = nullptr;
+      {
+        SlotReader reader(&chunk[i]);
+        item = reader.item();
+        if (!item || !item->m_var->isForeign() || dynamic_cast<SubProblemsVariableBase*>(item->m_var)) {
+          continue;
+        }
+      }
+      if (chunk[i].m_item.compare_exchange_strong(item, nullptr, std::memory_order_seq_cst)) {
+        retire(&chunk[i], item);
+      }
     }
   }
 }
@@ -327,20 +541,18 @@ DWDatabase<DomainType>::decrementScrubCount( const VarLabel   * label
 
   ASSERT(matlIndex >= -1);
 
-  std::lock_guard<Uintah::MasterLock> decrement_scrub_count_lock(g_keyDB_lock);
-
   int idx = m_keyDB->lookup(label, matlIndex, dom);
   if (idx == -1) {
     return 0;
   }
-  if (!m_vars[idx]) {
+  Slot* slot = getSlot(idx);
+  if (!slot || !slot->m_item.load(std::memory_order_acquire)) {
     return 0;
   }
 
-  int rt = __sync_sub_and_fetch(&(m_scrubs[idx]), 1);
+  int rt = slot->m_scrub.fetch_sub(1, std::memory_order_acq_rel) - 1;
   if (rt == 0) {
-    delete m_vars[idx];
-    m_vars[idx] = nullptr;
+    retire(slot, slot->m_item.exchange(nullptr, std::memory_order_seq_cst));
   }
 
   return rt;
@@ -356,13 +568,11 @@ DWDatabase<DomainType>::setScrubCount( const VarLabel   * label
                                      ,       int          count
                                      )
 {
-  std::lock_guard<Uintah::MasterLock> set_scrub_count_lock(g_keyDB_lock);
-
   int idx = m_keyDB->lookup(label, matlIndex, dom);
   if (idx == -1) {
     SCI_THROW(UnknownVariable(label->getName(), -99, dom, matlIndex, "DWDatabase::setScrubCount", __FILE__, __LINE__));
   }
-  m_scrubs[idx] = count;
+  reserveSlot(idx)->m_scrub.store(count, std::memory_order_release);
 }
 
 //______________________________________________________________________
@@ -376,12 +586,13 @@ DWDatabase<DomainType>::scrub( const VarLabel   * label
 {
   ASSERT(matlIndex >= -1);
 
-  std::lock_guard<Uintah::MasterLock> scrub_lock(g_keyDB_lock);
-
   int idx = m_keyDB->lookup(label, matlIndex, dom);
-  if (idx != -1 && m_vars[idx]) {
-    delete m_vars[idx];
-    m_vars[idx] = nullptr;
+  if (idx == -1) {
+    return;
+  }
+  Slot* slot = getSlot(idx);
+  if (slot) {
+    retire(slot, slot->m_item.exchange(nullptr, std::memory_order_seq_cst));
   }
 }
 
@@ -396,34 +607,104 @@ DWDatabase<DomainType>::initializeScrubs(       int                        dwid
 {
   // loop over each variable, probing the scrubcount map. Set the scrubcount appropriately.
   // If the variable has no entry in the scrubcount map, delete it
-  for (auto keyiter = m_keyDB->m_keys.begin(); keyiter != m_keyDB->m_keys.end();) {
-    if (m_vars[keyiter->second]) {
-      VarLabelMatl<DomainType> vlm = keyiter->first;
-      // See if it is in the scrubcounts map.
-      ScrubItem key(vlm.m_label, vlm.m_matl_index, vlm.m_domain, dwid);
-      ScrubItem* result = scrubcounts->lookup(&key);
-      if (!result && !add) {
-        delete m_vars[keyiter->second];
-        m_vars[keyiter->second] = nullptr;
+  m_keyDB->forEach([&](const VarLabelMatl<DomainType> & vlm, int idx) {
+    Slot* slot = getSlot(idx);
+    if (!slot || !slot->m_item.load(std::memory_order_acquire)) {
+      return;
+    }
+    // See if it is in the scrubcounts map.
+    ScrubItem key(vlm.m_label, vlm.m_matl_index, vlm.m_domain, dwid);
+    ScrubItem* result = scrubcounts->lookup(&key);
+    if (!result && !add) {
+      retire(slot, slot->m_item.exchange(nullptr, std::memory_order_seq_cst));
+    }
+    else if (result) {
+      if (add) {
+        slot->m_scrub.fetch_add(result->m_count, std::memory_order_acq_rel);
       }
       else {
-        if (result) {
-          if (add) {
-            __sync_add_and_fetch(&(m_scrubs[keyiter->second]), result->m_count);
-          }
-          else {
-            if (!__sync_bool_compare_and_swap(&(m_scrubs[keyiter->second]), 0, result->m_count)) {
-              SCI_THROW(InternalError("initializing non-zero scrub counter", __FILE__, __LINE__));
-            }
-          }
+        int expected = 0;
+        if (!slot->m_scrub.compare_exchange_strong(expected, result->m_count, std::memory_order_acq_rel)) {
+          SCI_THROW(InternalError("initializing non-zero scrub counter", __FILE__, __LINE__));
         }
-        ++keyiter;
       }
     }
-    else {
-      ++keyiter;
+  });
+}
+
+//______________________________________________________________________
+//
+template<class DomainType>
+KeyDatabase<DomainType>::~KeyDatabase()
+{
+  clear();
+}
+
+//______________________________________________________________________
+//
+template<class DomainType>
+int
+KeyDatabase<DomainType>::lookupKey( const Key & key ) const
+{
+  const size_t h     = hashKey(key);
+  const Shard& shard = m_shards[shardOf(h)];
+
+  const Table* table = shard.m_table.load(std::memory_order_acquire);
+  if (!table) {
+    return -1;
+  }
+  for (const Node* node = table->m_buckets[h % table->m_num_buckets].load(std::memory_order_acquire); node != nullptr; node = node->m_next) {
+    if (node->m_key == key) {
+      return node->m_index;
     }
   }
+  return -1;
+}
+
+//______________________________________________________________________
+//
+template<class DomainType>
+void
+KeyDatabase<DomainType>::insertKey( const Key & key )
+{
+  const size_t h     = hashKey(key);
+        Shard& shard = m_shards[shardOf(h)];
+
+  std::lock_guard<Uintah::MasterLock> insert_lock(shard.m_insert_lock);
+
+  Table* table = shard.m_table.load(std::memory_order_relaxed);
+  if (!table) {
+    table = new Table(INITIAL_BUCKETS);
+    shard.m_table.store(table, std::memory_order_release);
+  }
+
+  std::atomic<Node*>* bucket = &table->m_buckets[h % table->m_num_buckets];
+  for (const Node* node = bucket->load(std::memory_order_relaxed); node != nullptr; node = node->m_next) {
+    if (node->m_key == key) {
+      return;
+    }
+  }
+
+  // grow: readers still walking the old table see a consistent (if slightly stale) snapshot
+  if (shard.m_size + 1 > 2 * table->m_num_buckets) {
+    Table* grown = new Table(4 * table->m_num_buckets);
+    for (size_t b = 0; b < table->m_num_buckets; ++b) {
+      for (const Node* node = table->m_buckets[b].load(std::memory_order_relaxed); node != nullptr; node = node->m_next) {
+        std::atomic<Node*>& dest = grown->m_buckets[hashKey(node->m_key) % grown->m_num_buckets];
+        dest.store(new Node(node->m_key, node->m_index, dest.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+      }
+    }
+    table->m_retired_next = shard.m_retired;
+    shard.m_retired       = table;
+    shard.m_table.store(grown, std::memory_order_release);
+
+    table  = grown;
+    bucket = &table->m_buckets[h % table->m_num_buckets];
+  }
+
+  const int index = m_key_count.fetch_add(1, std::memory_order_acq_rel);
+  bucket->store(new Node(key, index, bucket->load(std::memory_order_relaxed)), std::memory_order_release);
+  ++shard.m_size;
 }
 
 //______________________________________________________________________
@@ -433,32 +714,42 @@ int
 KeyDatabase<DomainType>::lookup( const VarLabel   * label
                                ,       int          matlIndex
                                , const DomainType * dom
-                               )
+                               ) const
 {
-  VarLabelMatl<DomainType> v(label, matlIndex, getRealDomain(dom));
-  typename keyDBtype::const_iterator const_iter = m_keys.find(v);
-  if (const_iter == m_keys.end()) {
-    return -1;
-  }
-  else {
-    return const_iter->second;
-  }
+  return lookupKey(Key(label, matlIndex, getRealDomain(dom)));
 }
 
 //______________________________________________________________________
 //
 template<class DomainType>
+template<typename Functor>
 void
-KeyDatabase<DomainType>::merge( const KeyDatabase<DomainType> & newDB )
+KeyDatabase<DomainType>::forEach( Functor f ) const
 {
-  for (typename keyDBtype::const_iterator const_keyiter = newDB.m_keys.cbegin(); const_keyiter != newDB.m_keys.cend(); ++const_keyiter) {
-    typename keyDBtype::const_iterator const_db_iter = m_keys.find(const_keyiter->first);
-    if (const_db_iter == m_keys.end()) {
-      m_keys.insert(std::pair<VarLabelMatl<DomainType>, int>(const_keyiter->first, m_key_count++));
+  for (int s = 0; s < KEY_SHARDS; ++s) {
+    const Table* table = m_shards[s].m_table.load(std::memory_order_acquire);
+    if (!table) {
+      continue;
+    }
+    for (size_t b = 0; b < table->m_num_buckets; ++b) {
+      for (const Node* node = table->m_buckets[b].load(std::memory_order_acquire); node != nullptr; node = node->m_next) {
+        f(node->m_key, node->m_index);
+      }
     }
   }
 }
 
+//______________________________________________________________________
+//
+template<class DomainType>
+void
+KeyDatabase<DomainType>::merge( const KeyDatabase<DomainType> & newDB )
+{
+  newDB.forEach([this](const Key & key, int) {
+    insertKey(key);
+  });
+}
+
 //______________________________________________________________________
 //
 template<class DomainType>
@@ -468,10 +759,9 @@ KeyDatabase<DomainType>::insert( const VarLabel   * label
                                , const DomainType * dom
                                )
 {
-  VarLabelMatl<DomainType> v(label, matlIndex, getRealDomain(dom));
-  typename keyDBtype::const_iterator const_iter = m_keys.find(v);
-  if (const_iter == m_keys.end()) {
-    m_keys.insert(std::pair<VarLabelMatl<DomainType>, int>(v, m_key_count++));
+  Key v(label, matlIndex, getRealDomain(dom));
+  if (lookupKey(v) == -1) {
+    insertKey(v);
   }
 }
 
@@ -481,8 +771,17 @@ template<class DomainType>
 void
 KeyDatabase<DomainType>::clear()
 {
-  m_keys.clear();
-  m_key_count = 0;
+  for (int s = 0; s < KEY_SHARDS; ++s) {
+    Shard& shard = m_shards[s];
+    delete shard.m_table.exchange(nullptr, std::memory_order_acq_rel);
+    while (shard.m_retired) {
+      Table* next = shard.m_retired->m_retired_next;
+      delete shard.m_retired;
+      shard.m_retired = next;
+    }
+    shard.m_size = 0;
+  }
+  m_key_count.store(0, std::memory_order_release);
 }
 
 //______________________________________________________________________
@@ -491,8 +790,7 @@ template<class DomainType>
 void
 KeyDatabase<DomainType>::print( std::ostream & out, int rank ) const
 {
-  for (auto keyiter = m_keys.begin(); keyiter != m_keys.end(); ++keyiter) {
-    const VarLabelMatl<DomainType>& vlm = keyiter->first;
+  forEach([&](const Key & vlm, int) {
     const DomainType* dom = vlm.m_domain;
     if (dom) {
       out << rank << " Name: " << vlm.m_label->getName() << "  domain: " << *dom << "  matl:" << vlm.m_matl_index << '\n';
@@ -500,7 +798,7 @@ KeyDatabase<DomainType>::print( std::ostream & out, int rank ) const
     else {
       out << rank << " Name: " << vlm.m_label->getName() << "  domain: N/A  matl: " << vlm.m_matl_index << '\n';
     }
-  }
+  });
 }
 
 //______________________________________________________________________
@@ -510,8 +808,11 @@ void
 DWDatabase<DomainType>::doReserve( KeyDatabase<DomainType> * keydb )
 {
   m_keyDB = keydb;
-  m_vars.resize(m_keyDB->m_key_count + 1, (DataItem*)nullptr);
-  m_scrubs.resize(m_keyDB->m_key_count + 1, 0);
+  const int num_keys = m_keyDB->size();
+  for (int idx = 0; idx <= num_keys; idx += SLOT_CHUNK_SIZE) {
+    reserveSlot(idx);
+  }
+  reserveSlot(num_keys);
 }
 
 //______________________________________________________________________
@@ -523,16 +824,12 @@ DWDatabase<DomainType>::exists( const VarLabel   * label
                               , const DomainType * dom
                               ) const
 {
-  std::lock_guard<Uintah::MasterLock> exists_lock(g_keyDB_lock);
-
   int idx = m_keyDB->lookup(label, matlIndex, dom);
   if (idx == -1) {
     return false;
   }
-  if (m_vars[idx] == nullptr) {
-    return false;
-  }
-  return true;
+  Slot* slot = getSlot(idx);
+  return (slot && slot->m_item.load(std::memory_order_acquire) != nullptr);
 }
 
 //______________________________________________________________________
@@ -549,11 +846,8 @@ DWDatabase<DomainType>::put( const VarLabel   * label
 {
   ASSERT(matlIndex >= -1);
 
-  std::lock_guard<Uintah::MasterLock> put_lock(g_keyDB_lock);
-
   if (init) {
     m_keyDB->insert(label, matlIndex, dom);
-    this->doReserve(m_keyDB);
   }
 
   int idx = m_keyDB->lookup(label, matlIndex, dom);
@@ -561,20 +855,25 @@ DWDatabase<DomainType>::put( const VarLabel   * label
     SCI_THROW(UnknownVariable(label->getName(), -1, dom, matlIndex, "DWDatabase::put", __FILE__, __LINE__));
   }
 
-  if (m_vars[idx]) {
-    if (m_vars[idx]->m_next) {
-      SCI_THROW(InternalError("More than one vars on this label", __FILE__, __LINE__));
-    }
-    if (!replace) {
-      SCI_THROW(InternalError("Put replacing old vars", __FILE__, __LINE__));
+  Slot* slot = reserveSlot(idx);
+
+  {
+    SlotReader reader(slot);
+    const DataItem* olddi = reader.item();
+    if (olddi) {
+      if (olddi->m_next) {
+        SCI_THROW(InternalError("More than one vars on this label", __FILE__, __LINE__));
+      }
+      if (!replace) {
+        SCI_THROW(InternalError("Put replacing old vars", __FILE__, __LINE__));
+      }
+      ASSERT(olddi->m_var != var);
     }
-    ASSERT(m_vars[idx]->m_var != var);
-    delete m_vars[idx];
   }
 
   DataItem* newdi = new DataItem();
   newdi->m_var = var;
-  m_vars[idx] = newdi;
+  retire(slot, slot->m_item.exchange(newdi, std::memory_order_seq_cst));
 }
 
 //______________________________________________________________________
@@ -590,11 +889,8 @@ DWDatabase<DomainType>::putReduce( const VarLabel              * label
 {
   ASSERT(matlIndex >= -1);
 
-  std::lock_guard<Uintah::MasterLock> put_reduce_lock(g_keyDB_lock);
-
   if (init) {
     m_keyDB->insert(label, matlIndex, dom);
-    this->doReserve(m_keyDB);
   }
 
   int idx = m_keyDB->lookup(label, matlIndex, dom);
@@ -602,22 +898,40 @@ DWDatabase<DomainType>::putReduce( const VarLabel              * label
     SCI_THROW(UnknownVariable(label->getName(), -1, dom, matlIndex, "DWDatabase::putReduce", __FILE__, __LINE__));
   }
 
+  Slot* slot = reserveSlot(idx);
+
   DataItem* newdi = new DataItem();
   newdi->m_var = var;
-  do {
-    DataItem* olddi = __sync_lock_test_and_set(&m_vars[idx], 0);
-    if (olddi == nullptr) {
-      olddi = newdi;
+
+  // The slot always holds a complete value: the reduced value is built in a fresh item and
+  // swapped in place of the old one, so a concurrent reader never finds the slot empty.
+  while (true) {
+    DataItem* olddi     = nullptr;
+    DataItem* reduceddi = newdi;
+    {
+      SlotReader reader(slot);
+      olddi = reader.item();
+      if (olddi) {
+        ReductionVariableBase* reduced = dynamic_cast<ReductionVariableBase*>(olddi->m_var)->clone();
+        reduced->reduce(*var);
+        reduceddi = new DataItem();
+        reduceddi->m_var = reduced;
+      }
     }
-    else {
-      ReductionVariableBase* oldvar = dynamic_cast<ReductionVariableBase*>(olddi->m_var);
-      ReductionVariableBase* newvar = dynamic_cast<ReductionVariableBase*>(newdi->m_var);
-      oldvar->reduce(*newvar);
-      delete newdi;
+
+    if (slot->m_item.compare_exchange_strong(olddi, reduceddi, std::memory_order_seq_cst)) {
+      if (reduceddi != newdi) {
+        delete newdi;
+        retire(slot, olddi);
+      }
+      return;
+    }
+
+    // another reduction got there first, retry against its result
+    if (reduceddi != newdi) {
+      delete reduceddi;
     }
-    newdi = __sync_lock_test_and_set(&m_vars[idx], olddi);
   }
-  while (newdi != nullptr);
 }
 
 //______________________________________________________________________
@@ -633,11 +947,8 @@ DWDatabase<DomainType>::putForeign( const VarLabel   * label
 {
   ASSERT(matlIndex >= -1);
 
-  std::lock_guard<Uintah::MasterLock> put_foreign_lock(g_keyDB_lock);
-
   if (init) {
     m_keyDB->insert(label, matlIndex, dom);
-    this->doReserve(m_keyDB);
   }
 
   int idx = m_keyDB->lookup(label, matlIndex, dom);
@@ -645,19 +956,21 @@ DWDatabase<DomainType>::putForeign( const VarLabel   * label
     SCI_THROW(UnknownVariable(label->getName(), -1, dom, matlIndex, "DWDatabase::putForeign", __FILE__, __LINE__));
   }
 
+  Slot* slot = reserveSlot(idx);
+
   DataItem* newdi = new DataItem();
   newdi->m_var = var;
-  do {
-    newdi->m_next = m_vars[idx];
+  newdi->m_next = slot->m_item.load(std::memory_order_acquire);
+  while (!slot->m_item.compare_exchange_weak(newdi->m_next, newdi, std::memory_order_acq_rel)) {
+    // m_next now holds the current head, retry
   }
-  while (!__sync_bool_compare_and_swap(&m_vars[idx], newdi->m_next, newdi));  // vars[iter->second] = newdi;
 }
 
 //______________________________________________________________________
 //
 template<class DomainType>
-typename DWDatabase<DomainType>::DataItem*
-DWDatabase<DomainType>::getDataItem( const VarLabel   * label
+typename DWDatabase<DomainType>::Slot*
+DWDatabase<DomainType>::getDataSlot( const VarLabel   * label
                                    ,       int          matlIndex
                                    , const DomainType * dom
                                    ) const
@@ -666,9 +979,9 @@ DWDatabase<DomainType>::getDataItem( const VarLabel   * label
 
   int idx = m_keyDB->lookup(label, matlIndex, dom);
   if (idx == -1) {
-    SCI_THROW(UnknownVariable(label->getName(), -99, dom, matlIndex, "DWDatabase::getDataItem", __FILE__, __LINE__));
+    SCI_THROW(UnknownVariable(label->getName(), -99, dom, matlIndex, "DWDatabase::getDataSlot", __FILE__, __LINE__));
   }
-  return m_vars[idx];
+  return getSlot(idx);
 }
 
 //______________________________________________________________________
@@ -681,9 +994,8 @@ DWDatabase<DomainType>::get( const VarLabel   * label
                            , const DomainType * dom
                            ) const
 {
-  std::lock_guard<Uintah::MasterLock> get_lock(g_keyDB_lock);
-
-  const DataItem* dataItem = getDataItem(label, matlIndex, dom);
+  SlotReader reader(getDataSlot(label, matlIndex, dom));
+  const DataItem* dataItem = reader.item();
   ASSERT(dataItem != nullptr);          // should have thrown an exception before
   ASSERT(dataItem->m_next == nullptr);  // should call getlist()
   return dataItem->m_var;
@@ -699,8 +1011,12 @@ DWDatabase<DomainType>::get( const VarLabel   * label
                            ,       Variable   & var
                            ) const
 {
-  Variable* tmp = get(label, matlIndex, dom);
-  var.copyPointer(*tmp);
+  // stay inside the slot until copyPointer has taken its own reference to the data
+  SlotReader reader(getDataSlot(label, matlIndex, dom));
+  const DataItem* dataItem = reader.item();
+  ASSERT(dataItem != nullptr);          // should have thrown an exception before
+  ASSERT(dataItem->m_next == nullptr);  // should call getlist()
+  var.copyPointer(*dataItem->m_var);
 }
 
 //______________________________________________________________________
@@ -713,9 +1029,8 @@ DWDatabase<DomainType>::getlist( const VarLabel               * label
                                ,       std::vector<Variable*> & varlist
                                ) const
 {
-  std::lock_guard<Uintah::MasterLock> get_list_lock(g_keyDB_lock);
-
-  for (DataItem* dataItem = getDataItem(label, matlIndex, dom); dataItem != nullptr; dataItem = dataItem->m_next) {
+  SlotReader reader(getDataSlot(label, matlIndex, dom));
+  for (const DataItem* dataItem = reader.item(); dataItem != nullptr; dataItem = dataItem->m_next) {
     varlist.push_back(dataItem->m_var);
   }
 }
@@ -730,11 +1045,9 @@ DWDatabase<DomainType>::getforeignlist( const VarLabel                       * l
                                       ,       std::vector<const Variable*>   & varlist
                                       ) const
 {
-  std::lock_guard<Uintah::MasterLock> get_list_lock(g_keyDB_lock);
-
-  for (auto keyiter = m_keyDB->m_keys.begin(); keyiter != m_keyDB->m_keys.end(); ++keyiter) {
-    const auto & key = keyiter->first;
-    const auto & val = m_vars[keyiter->second];
+  m_keyDB->forEach([&](const VarLabelMatl<DomainType> & key, int idx) {
+    SlotReader reader(getSlot(idx));
+    const DataItem* val = reader.item();
     if (val) {
       const VarLabel* iterLabel = key.m_label;
       const Variable* iterVariable = val->m_var;
@@ -744,7 +1057,7 @@ DWDatabase<DomainType>::getforeignlist( const VarLabel                       * l
         varlist.push_back(iterVariable);
       }
     }
-  }
+  });
 }
 
 //______________________________________________________________________
@@ -753,9 +1066,9 @@ template<class DomainType>
 void
 DWDatabase<DomainType>::print( std::ostream & out, int rank ) const
 {
-  for (auto keyiter = m_keyDB->m_keys.begin(); keyiter != m_keyDB->m_keys.end(); ++keyiter) {
-    if (m_vars[keyiter->second]) {
-      const VarLabelMatl<DomainType>& vlm = keyiter->first;
+  m_keyDB->forEach([&](const VarLabelMatl<DomainType> & vlm, int idx) {
+    Slot* slot = getSlot(idx);
+    if (slot && slot->m_item.load(std::memory_order_acquire)) {
       const DomainType* dom = vlm.m_domain;
       if (dom) {
         out << rank << " Name: " << vlm.m_label->getName() << "  domain: " << *dom << "  matl:" << vlm.m_matl_index << '\n';
@@ -764,7 +1077,7 @@ DWDatabase<DomainType>::print( std::ostream & out, int rank ) const
         out << rank << " Name: " << vlm.m_label->getName() << "  domain: N/A  matl: " << vlm.m_matl_index << '\n';
       }
     }
-  }
+  });
 }
 
 //______________________________________________________________________
@@ -777,10 +1090,11 @@ DWDatabase<DomainType>::logMemoryUse(       std::ostream  & out
                                     ,       int             dwid
                                     )
 {
-  for (auto keyiter = m_keyDB->m_keys.begin(); keyiter != m_keyDB->m_keys.end(); ++keyiter) {
-    if (m_vars[keyiter->second]) {
-      Variable* var = m_vars[keyiter->second]->m_var;
-      VarLabelMatl<DomainType> vlm = keyiter->first;
+  m_keyDB->forEach([&](const VarLabelMatl<DomainType> & vlm, int idx) {
+    SlotReader reader(getSlot(idx));
+    const DataItem* item = reader.item();
+    if (item) {
+      Variable* var = item->m_var;
       const VarLabel* label = vlm.m_label;
       std::string elems;
       unsigned long totsize;
@@ -791,7 +1105,7 @@ DWDatabase<DomainType>::logMemoryUse(       std::ostream  & out
       logMemory(out, total, tag, label->getName(), (td ? td->getName() : "-"), vlm.m_domain,
                 vlm.m_matl_index, elems, totsize, ptr, dwid);
     }
-  }
+  });
 }
 
 //______________________________________________________________________
@@ -800,49 +1114,30 @@ template<class DomainType>
 void
 DWDatabase<DomainType>::getVarLabelMatlTriples( std::vector<VarLabelMatl<DomainType> > & v) const
 {
-  std::lock_guard<Uintah::MasterLock> get_var_label_mat_triples_lock(g_keyDB_lock);
-
-  for (auto keyiter = m_keyDB->m_keys.begin(); keyiter != m_keyDB->m_keys.end(); ++keyiter) {
-    const VarLabelMatl<DomainType>& vlm = keyiter->first;
-    if (m_vars[keyiter->second]) {
+  m_keyDB->forEach([&](const VarLabelMatl<DomainType> & vlm, int idx) {
+    Slot* slot = getSlot(idx);
+    if (slot && slot->m_item.load(std::memory_order_acquire)) {
       v.push_back(vlm);
     }
-  }
+  });
 }
 
-} // namespace Uintah
-
-
 //______________________________________________________________________
 //
-// Custom hash function for VarLabelMatl
-//
-// Specialize std::hash structure and inject into the std namespace so that
-// VarLabelMatl<DomainType> can be used as a key in std::unordered_map
-//
-// NOTE: this is legit, and likely the easiest way to get this done due to templates (APH - 10/25/18).
-//
-// It is allowed to add template specializations for any standard library class template to the std namespace
-// only if the declaration depends on at least one program-defined type and the specialization satisfies all
-// requirements for the original template (https://en.cppreference.com/w/cpp/language/extending_std).
-//
-namespace std {
-
-using Uintah::VarLabelMatl;
-
 template<class DomainType>
-struct hash<VarLabelMatl<DomainType> > {
-  size_t operator()( const VarLabelMatl<DomainType>& v ) const {
-    size_t h = 0u;
-    char* str = const_cast<char*>(v.m_label->getName().data());
-    while (int c = *str++) {
-      h = h * 7 + c;
+void
+DWDatabase<DomainType>::getDataSizes( std::map<const DomainType*, size_t> & sizes ) const
+{
+  m_keyDB->forEach([&](const VarLabelMatl<DomainType> & vlm, int idx) {
+    SlotReader reader(getSlot(idx));
+    const DataItem* item = reader.item();
+    if (item) {
+      sizes[vlm.m_domain] += item->m_var->getDataSize();
     }
-    return ((((size_t)v.m_label) << (sizeof(size_t) / 2) ^ ((size_t)v.m_label) >> (sizeof(size_t) / 2)) ^ (size_t)v.m_domain ^ (size_t)v.m_matl_index);
-  }
-};
+  });
+}
 
-}  // end namespace std
+} // namespace Uintah
 
 
 #endif // CCA_COMPONENTS_SCHEDULERS_DWDATABASE_H
@@ -93,6 +93,7 @@ DependencyBatch::received( const ProcessorGroup * pg )
   std::lock_guard<Uintah::MasterLock> dep_batch_lock(g_dep_batch_mutex);
 
   m_received = true;
+  m_received_time = DetailedTask::clockTime();
 
   // set all the toVars to valid, meaning the MPI has been completed
   for (auto iter = m_to_vars.begin(); iter != m_to_vars.end(); ++iter) {
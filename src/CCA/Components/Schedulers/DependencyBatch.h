@@ -69,6 +69,7 @@ public:
   std::list<DetailedTask*>   m_to_tasks{};
   int                        m_message_tag{-1};
   int                        m_to_rank{-1};
+  int64_t                    m_received_time{0};   // DetailedTask::clockTime() of the last received()
 
 
 private:
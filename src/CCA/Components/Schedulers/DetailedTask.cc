@@ -37,6 +37,7 @@
 #include <Core/Parallel/Parallel.h>
 #include <Core/Parallel/ProcessorGroup.h>
 #include <Core/Util/DOUT.hpp>
+#include <Core/Util/Tracer.h>
 
 #include <sci_defs/config_defs.h>
 #include <sci_defs/cuda_defs.h>
@@ -117,6 +118,10 @@ DetailedTask::doit( const ProcessorGroup                      * pg
 
   // start timing the execution duration
   m_exec_timer.start();
+  markExecStart();
+
+  uint64_t perf_start[PerfCounters::NumEvents];
+  PerfCounters::read(perf_start);
 
   if ( g_internal_deps_dbg ) {
     std::ostringstream message;
@@ -166,8 +171,19 @@ DetailedTask::doit( const ProcessorGroup                      * pg
   }
   else
 #endif
+  {
+    Tracer::Scope trace( Tracer::Task, &m_task->getName() );
+    trace.setArgs( (m_patches && m_patches->size() > 0) ? m_patches->get(0)->getID() : -1
+                 , (m_matls && m_matls->size() > 0) ? m_matls->get(0) : -1 );
 
     m_task->doit( this, event, pg, m_patches, m_matls, dws, nullptr, nullptr, nullptr, -1 );
+  }
+
+  uint64_t perf_end[PerfCounters::NumEvents];
+  PerfCounters::read(perf_end);
+  for (int i = 0; i < PerfCounters::NumEvents; ++i) {
+    m_perf_counts[i] = perf_end[i] - perf_start[i];
+  }
 
   for (size_t i = 0u; i < dws.size(); ++i) {
     if ( oddws[i] != nullptr ) {
@@ -186,6 +202,9 @@ DetailedTask::scrub( std::vector<OnDemandDataWarehouseP> & dws )
 
   const Task* task = getTask();
 
+  Tracer::Scope trace(Tracer::Scrub, &task->getName());
+  trace.setArgs((m_patches && m_patches->size() > 0) ? m_patches->get(0)->getID() : -1);
+
   const std::set<const VarLabel*, VarLabel::Compare> & initialRequires = m_task_group->getSchedulerCommon()->getInitialRequiredVars();
   const std::set<std::string>                        &   unscrubbables = m_task_group->getSchedulerCommon()->getNoScrubVars();
 
@@ -410,7 +429,12 @@ DetailedTask::addInternalRequires( DependencyBatch * req )
 void
 DetailedTask::checkExternalDepCount()
 {
-  std::lock_guard<Uintah::MasterLock> external_ready_guard(g_external_ready_mutex);
+  // with work-stealing queues, the handoff is the m_externally_ready exchange below and the
+  // task goes to the calling thread's own queue, so the shared external-ready lock is not needed
+  std::unique_lock<Uintah::MasterLock> external_ready_guard(g_external_ready_mutex, std::defer_lock);
+  if (!m_task_group->usingWorkStealing()) {
+    external_ready_guard.lock();
+  }
 
   DOUT(g_external_deps_dbg, "Rank-" << Parallel::getMPIRank() << " Task " << this->getTask()->getName() << " external deps: "
                                     << m_external_dependency_count.load(std::memory_order_acquire)
@@ -422,10 +446,9 @@ DetailedTask::checkExternalDepCount()
     DOUT(g_external_deps_dbg, "Rank-" << Parallel::getMPIRank() << " Task " << this->getTask()->getName()
                                       << " MPI requirements satisfied, placing into external ready queue");
 
-    if (m_externally_ready.load(std::memory_order_acquire) == false) {
-      m_task_group->m_mpi_completed_tasks.push(this);
-      m_task_group->m_atomic_mpi_completed_tasks_size.fetch_add(1);
-      m_externally_ready.store(true, std::memory_order_release);
+    // exactly one caller wins the exchange and queues the task
+    if (m_externally_ready.exchange(true, std::memory_order_acq_rel) == false) {
+      m_task_group->addExternalReadyTask(this);
     }
   }
 }
@@ -490,6 +513,7 @@ DetailedTask::done( std::vector<OnDemandDataWarehouseP> & dws )
   }
 
   m_exec_timer.stop();
+  m_exec_end = clockTime();
 }
 
 //_____________________________________________________________________________
@@ -35,10 +35,12 @@
 #endif
 
 #include <Core/Grid/Task.h>
+#include <Core/Util/PerfCounters.h>
 
 #include <sci_defs/cuda_defs.h>
 
 #include <atomic>
+#include <chrono>
 #include <list>
 #include <map>
 #include <queue>
@@ -191,6 +193,38 @@ public:
   double task_wait_time() const { return m_wait_timer().seconds(); }
   double task_exec_time() const { return m_exec_timer().seconds(); }
 
+  // Clock (ns) of the executed task graph records, see SchedulerCommon::startGraphRecord().
+  static int64_t clockTime()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( Timers::Simple::clock_type::now().time_since_epoch() ).count();
+  }
+
+  // Start of the last execution (doit()) and its end (done()).
+  void    markExecStart() { m_exec_start = clockTime(); }
+  int64_t getExecStart() const { return m_exec_start; }
+  int64_t getExecEnd()   const { return m_exec_end; }
+
+  const std::list<InternalDependency>& getInternalDependencies() const { return m_internal_dependencies; }
+
+  // Hardware events counted during the last execution of the task's callback,
+  // zeros unless PerfCounters are enabled.
+  const uint64_t* getPerfCounts() const { return m_perf_counts; }
+
+  // Execution time predicted by the load balancer's cost model, used by the
+  // PredictedCost QueueAlg.
+  double getPredictedCost() const { return m_predicted_cost; }
+  void   setPredictedCost( double cost ) { m_predicted_cost = cost; }
+
+  // Longest path (seconds) from the start of this task to the end of the task graph,
+  // used by the CriticalPath QueueAlg.
+  double getBottomLevel() const { return m_bottom_level; }
+  void   setBottomLevel( double level ) { m_bottom_level = level; }
+
+  // Whether this task or one of the local tasks depending on it sends an MPI message,
+  // used by the CriticalPath QueueAlg.
+  bool feedsRemoteSend() const { return m_feeds_remote_send; }
+  void setFeedsRemoteSend( bool feeds ) { m_feeds_remote_send = feeds; }
+
 //-----------------------------------------------------------------------------
 #ifdef HAVE_CUDA
 
@@ -299,6 +333,13 @@ private:
   RuntimeStats::TaskExecTimer m_exec_timer{this};
   RuntimeStats::TaskWaitTimer m_wait_timer{this};
 
+  uint64_t m_perf_counts[PerfCounters::NumEvents] {};
+  int64_t  m_exec_start { 0 };
+  int64_t  m_exec_end   { 0 };
+  double   m_predicted_cost { 0 };
+  double   m_bottom_level { 0 };
+  bool     m_feeds_remote_send { false };
+
   bool operator<(const DetailedTask & other);
 
 
@@ -28,6 +28,7 @@
 #include <CCA/Components/Schedulers/OnDemandDataWarehouse.h>
 #include <CCA/Components/Schedulers/SchedulerCommon.h>
 #include <CCA/Components/Schedulers/TaskGraph.h>
+#include <CCA/Ports/LoadBalancer.h>
 
 #include <Core/Grid/Grid.h>
 #include <Core/Grid/Variables/PSPatchMatlGhostRange.h>
@@ -44,9 +45,12 @@
 
 #include <sci_defs/cuda_defs.h>
 
+#include <algorithm>
 #include <atomic>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 using namespace Uintah;
 
@@ -66,6 +70,8 @@ namespace Uintah {
 namespace {
 
   Uintah::MasterLock g_internal_ready_mutex{}; // synchronizes access to the internal-ready task queue
+
+  thread_local int t_worker_queue_id = 0;      // this thread's queue in work-stealing mode
   
   Dout g_detailed_dw_dbg(    "DetailedDWDBG", "DetailedTasks", "report when var is saved in varDB", false);
   Dout g_detailed_tasks_dbg( "DetailedTasks", "DetailedTasks", "general bdg info for DetailedTasks", false);
@@ -853,17 +859,139 @@ DetailedTasks::getOldDWSendTask( int proc )
 void
 DetailedTasks::internalDependenciesSatisfied( DetailedTask * dtask )
 {
+  if (usingWorkStealing()) {
+    WorkerQueues& queues = *m_worker_queues[t_worker_queue_id % m_worker_queues.size()];
+    std::lock_guard<Uintah::MasterLock> worker_queue_guard(queues.m_lock);
+    queues.m_internal_ready.push(dtask);
+    m_atomic_initial_ready_tasks_size.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
   std::lock_guard<Uintah::MasterLock> internal_deps_satisfied_guard(g_internal_ready_mutex);
 
   m_ready_tasks.push(dtask);
   m_atomic_initial_ready_tasks_size.fetch_add(1, std::memory_order_relaxed);
 }
 
+//_____________________________________________________________________________
+//
+void
+DetailedTasks::addExternalReadyTask( DetailedTask * dtask )
+{
+  if (usingWorkStealing()) {
+    WorkerQueues& queues = *m_worker_queues[t_worker_queue_id % m_worker_queues.size()];
+    std::lock_guard<Uintah::MasterLock> worker_queue_guard(queues.m_lock);
+    queues.m_external_ready.push(dtask);
+  }
+  else {
+    m_mpi_completed_tasks.push(dtask);
+  }
+  m_atomic_mpi_completed_tasks_size.fetch_add(1, std::memory_order_release);
+}
+
+//_____________________________________________________________________________
+//
+void
+DetailedTasks::setNumWorkerQueues( int num_queues )
+{
+  if (num_queues == static_cast<int>(m_worker_queues.size())) {
+    return;
+  }
+
+  m_worker_queues.clear();
+  for (int i = 0; i < num_queues; ++i) {
+    m_worker_queues.emplace_back(new WorkerQueues());
+  }
+}
+
+//_____________________________________________________________________________
+//
+void
+DetailedTasks::setWorkerQueueID( int id )
+{
+  t_worker_queue_id = id;
+}
+
+//_____________________________________________________________________________
+//
+unsigned long
+DetailedTasks::getNumSteals( int queue ) const
+{
+  return m_worker_queues[queue]->m_num_steals;
+}
+
+//_____________________________________________________________________________
+//
+unsigned long
+DetailedTasks::getNumFailedSteals( int queue ) const
+{
+  return m_worker_queues[queue]->m_num_failed_steals;
+}
+
+//_____________________________________________________________________________
+//
+DetailedTask*
+DetailedTasks::popWorkerQueues( bool external )
+{
+  std::atomic<int>& num_ready = external ? m_atomic_mpi_completed_tasks_size : m_atomic_initial_ready_tasks_size;
+  if (num_ready.load(std::memory_order_acquire) <= 0) {
+    return nullptr;
+  }
+
+  auto pop = [external](WorkerQueues & queues)->DetailedTask* {
+    DetailedTask* dtask = nullptr;
+    if (external && !queues.m_external_ready.empty()) {
+      dtask = queues.m_external_ready.top();
+      queues.m_external_ready.pop();
+    }
+    else if (!external && !queues.m_internal_ready.empty()) {
+      dtask = queues.m_internal_ready.front();
+      queues.m_internal_ready.pop();
+    }
+    return dtask;
+  };
+
+  const int num_queues = static_cast<int>(m_worker_queues.size());
+  const int me         = t_worker_queue_id % num_queues;
+  WorkerQueues& mine   = *m_worker_queues[me];
+
+  DetailedTask* dtask = nullptr;
+  {
+    std::lock_guard<Uintah::MasterLock> worker_queue_guard(mine.m_lock);
+    dtask = pop(mine);
+  }
+
+  // own queue is empty, try to steal - skip victims that are busy rather than convoy on their locks
+  for (int i = 1; dtask == nullptr && i < num_queues; ++i) {
+    WorkerQueues& victim = *m_worker_queues[(me + i) % num_queues];
+    if (victim.m_lock.try_lock()) {
+      dtask = pop(victim);
+      victim.m_lock.unlock();
+      if (dtask) {
+        ++mine.m_num_steals;
+      }
+    }
+  }
+
+  if (dtask) {
+    num_ready.fetch_sub(1, std::memory_order_acq_rel);
+  }
+  else {
+    ++mine.m_num_failed_steals;
+  }
+
+  return dtask;
+}
+
 //_____________________________________________________________________________
 //
 DetailedTask*
 DetailedTasks::getNextInternalReadyTask()
 {
+  if (usingWorkStealing()) {
+    return popWorkerQueues(false);
+  }
+
   std::lock_guard<Uintah::MasterLock> internal_ready_guard(g_internal_ready_mutex);
 
   DetailedTask* nextTask = nullptr;
@@ -891,6 +1019,10 @@ DetailedTasks::numInternalReadyTasks()
 DetailedTask*
 DetailedTasks::getNextExternalReadyTask()
 {
+  if (usingWorkStealing()) {
+    return popWorkerQueues(true);
+  }
+
   std::lock_guard<Uintah::MasterLock> external_ready_guard(g_external_ready_mutex);
 
   DetailedTask* nextTask = nullptr;
@@ -918,7 +1050,22 @@ DetailedTasks::numExternalReadyTasks()
 void
 DetailedTasks::initTimestep()
 {
-  m_ready_tasks = m_initial_ready_tasks;
+  if (usingWorkStealing()) {
+    // deal the initially ready tasks out round-robin so every thread starts with local work
+    TaskQueue initial_ready_tasks = m_initial_ready_tasks;
+    for (size_t i = 0; !initial_ready_tasks.empty(); ++i) {
+      WorkerQueues& queues = *m_worker_queues[i % m_worker_queues.size()];
+      queues.m_internal_ready.push(initial_ready_tasks.front());
+      initial_ready_tasks.pop();
+    }
+    for (auto & queues : m_worker_queues) {
+      queues->m_num_steals        = 0;
+      queues->m_num_failed_steals = 0;
+    }
+  }
+  else {
+    m_ready_tasks = m_initial_ready_tasks;
+  }
   m_atomic_initial_ready_tasks_size.store(m_initial_ready_tasks.size(), std::memory_order_release);
   incrementDependencyGeneration();
   initializeBatches();
@@ -983,6 +1130,89 @@ DetailedTasks::emitEdges( ProblemSpecP edgesElement, int rank )
   }
 }
 
+//_____________________________________________________________________________
+//
+void
+DetailedTasks::setPredictedCosts()
+{
+  LoadBalancer* lb = m_sched_common->getLoadBalancer();
+  for (DetailedTask* task : m_local_tasks) {
+    task->setPredictedCost(lb->predictContribution(task));
+  }
+}
+
+//_____________________________________________________________________________
+//
+void
+DetailedTasks::setBottomLevels()
+{
+  LoadBalancer* lb = m_sched_common->getLoadBalancer();
+
+  const int num_tasks = m_local_tasks.size();
+  std::unordered_map<const DetailedTask*, int> index;
+  for (int i = 0; i < num_tasks; i++) {
+    index[m_local_tasks[i]] = i;
+  }
+
+  // The internal dependencies only list a task's prerequisites, collect the dependents.
+  std::vector<std::vector<int> > prerequisites(num_tasks);
+  std::vector<int>               num_dependents(num_tasks, 0);
+  for (int i = 0; i < num_tasks; i++) {
+    for (const InternalDependency& dep : m_local_tasks[i]->getInternalDependencies()) {
+      auto iter = index.find(dep.m_prerequisite_task);
+      if (iter != index.end()) {
+        prerequisites[i].push_back(iter->second);
+        num_dependents[iter->second]++;
+      }
+    }
+  }
+
+  // The weight of a task is its execution time in the previous execution of this graph.
+  // Before the first execution the load balancer's prediction is used, or a microsecond
+  // (the number of tasks on the path) if there is none.
+  std::vector<int> order;
+  for (int i = 0; i < num_tasks; i++) {
+    m_local_tasks[i]->setBottomLevel(0);
+    m_local_tasks[i]->setFeedsRemoteSend(false);
+    if (num_dependents[i] == 0) {
+      order.push_back(i);
+    }
+  }
+
+  for (size_t n = 0; n < order.size(); n++) {
+    DetailedTask* task = m_local_tasks[order[n]];
+
+    double weight = 0;
+    if (task->getExecStart() > 0 && task->getExecEnd() > task->getExecStart()) {
+      weight = (task->getExecEnd() - task->getExecStart()) * 1.e-9;
+    }
+    else {
+      weight = lb->predictContribution(task);
+    }
+    if (weight <= 0) {
+      weight = 1.e-6;
+    }
+
+    // the dependents' bottom levels are final
+    const double level = task->getBottomLevel() + weight;
+    task->setBottomLevel(level);
+
+    // so is whether one of them sends
+    const bool feeds_send = task->feedsRemoteSend() || (task->getComputes() != nullptr);
+    task->setFeedsRemoteSend(feeds_send);
+
+    for (int pre : prerequisites[order[n]]) {
+      DetailedTask* pre_task = m_local_tasks[pre];
+      pre_task->setBottomLevel(std::max(pre_task->getBottomLevel(), level));
+      pre_task->setFeedsRemoteSend(pre_task->feedsRemoteSend() || feeds_send);
+      if (--num_dependents[pre] == 0) {
+        order.push_back(pre);
+      }
+    }
+  }
+  ASSERTEQ(static_cast<int>(order.size()), num_tasks);
+}
+
 //_____________________________________________________________________________
 //
 // comparing the priority of two detailed tasks - true means give rtask priority
@@ -1085,6 +1315,19 @@ DetailedTaskPriorityComparison::operator()( DetailedTask *& ltask
     }
   }
 
+  else if (alg == PredictedCost) {  // longest predicted execution time first
+    return ltask->getPredictedCost() < rtask->getPredictedCost();
+  }
+
+  else if (alg == CriticalPath) {  // tasks on a path to a remote send first, then longest bottom level
+    const bool lsends = ltask->feedsRemoteSend();
+    const bool rsends = rtask->feedsRemoteSend();
+    if (lsends != rsends) {
+      return rsends;
+    }
+    return ltask->getBottomLevel() < rtask->getBottomLevel();
+  }
+
   else if (alg == PatchOrderRandom) {  // smaller level, larger size, smaller patchID, smaller tasksortID
     const PatchSubset* lpatches = ltask->getPatches();
     const PatchSubset* rpatches = rtask->getPatches();
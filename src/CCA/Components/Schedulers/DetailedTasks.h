@@ -39,6 +39,7 @@
 #include <Core/Grid/Variables/ScrubItem.h>
 
 #include <Core/Lockfree/Lockfree_Pool.hpp>
+#include <Core/Parallel/MasterLock.h>
 
 
 #ifdef HAVE_CUDA
@@ -49,6 +50,7 @@
 #include <sci_defs/cuda_defs.h>
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <vector>
@@ -85,6 +87,8 @@ enum QueueAlg {
   , LeastL2Children
   , PatchOrder
   , PatchOrderRandom
+  , PredictedCost
+  , CriticalPath
 };
 
 
@@ -181,6 +185,25 @@ public:
 
   int numExternalReadyTasks();
 
+  // Work-stealing ready queues: with num_queues > 0, every task execution thread owns a local
+  // internal- and external-ready queue instead of sharing the two global ones. Threads push and
+  // pop locally and steal from other threads' queues when their own run dry. The QueueAlg still
+  // orders each external-ready queue. num_queues == 0 restores the shared queues.
+  void setNumWorkerQueues( int num_queues );
+
+  bool usingWorkStealing() const
+  {
+    return !m_worker_queues.empty();
+  }
+
+  // identifies the calling thread's queue, called once by each task execution thread
+  static void setWorkerQueueID( int id );
+
+  // steal statistics for the given worker queue since the last initTimestep()
+  unsigned long getNumSteals( int queue ) const;
+
+  unsigned long getNumFailedSteals( int queue ) const;
+
   void createScrubCounts();
 
   bool mustConsiderInternalDependencies()
@@ -223,9 +246,18 @@ public:
     return m_particle_recvs;
   }
 
+  // Called by the schedulers before each execution; for PredictedCost this also
+  // refreshes the local tasks' predicted costs from the load balancer, for
+  // CriticalPath their bottom levels.
   void setTaskPriorityAlg( QueueAlg alg )
   {
     m_task_priority_alg = alg;
+    if (alg == PredictedCost) {
+      setPredictedCosts();
+    }
+    else if (alg == CriticalPath) {
+      setBottomLevels();
+    }
   }
 
   QueueAlg getTaskPriorityAlg()
@@ -233,6 +265,15 @@ public:
     return m_task_priority_alg;
   }
 
+  // Asks the load balancer's cost model for the execution time of each local task.
+  void setPredictedCosts();
+
+  // Sets the bottom level of each local task: the longest path through the internal
+  // dependencies from the start of the task to the end of the graph, weighted by the
+  // tasks' execution times of the previous execution.  Also marks the tasks that a
+  // task sending MPI messages depends on.
+  void setBottomLevels();
+
 #ifdef HAVE_CUDA
 
   void addDeviceValidateRequiresCopies( DetailedTask * dtask );
@@ -303,6 +344,9 @@ protected:
 
   void internalDependenciesSatisfied( DetailedTask * dtask );
 
+  // called from DetailedTask::checkExternalDepCount(), with g_external_ready_mutex held unless work stealing
+  void addExternalReadyTask( DetailedTask * dtask );
+
   SchedulerCommon* getSchedulerCommon()
   {
     return m_sched_common;
@@ -374,6 +418,19 @@ private:
   std::atomic<int> m_atomic_initial_ready_tasks_size { 0 };
   std::atomic<int> m_atomic_mpi_completed_tasks_size { 0 };
 
+  // per-thread queues for work-stealing mode, see setNumWorkerQueues()
+  struct alignas(64) WorkerQueues {
+    Uintah::MasterLock m_lock{};
+    TaskQueue          m_internal_ready{};
+    TaskPQueue         m_external_ready{};
+    unsigned long      m_num_steals{0};         // only written by the owning thread
+    unsigned long      m_num_failed_steals{0};  // only written by the owning thread
+  };
+
+  DetailedTask* popWorkerQueues( bool external );
+
+  std::vector<std::unique_ptr<WorkerQueues> > m_worker_queues{};
+
   // This "generation" number is to keep track of which InternalDependency
   // links have been satisfied in the current timestep and avoids the
   // need to traverse all InternalDependency links to reset values.
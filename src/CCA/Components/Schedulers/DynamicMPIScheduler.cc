@@ -31,6 +31,7 @@
 
 #include <Core/Exceptions/ProblemSetupException.h>
 #include <Core/Util/DOUT.hpp>
+#include <Core/Util/Tracer.h>
 
 #include <iomanip>
 #include <sstream>
@@ -121,6 +122,12 @@ DynamicMPIScheduler::problemSetup( const ProblemSpecP&     prob_spec
     else if (taskQueueAlg == "PatchOrderRandom") {
       m_task_queue_alg = PatchOrderRandom;
     }
+    else if (taskQueueAlg == "PredictedCost") {
+      m_task_queue_alg = PredictedCost;
+    }
+    else if (taskQueueAlg == "CriticalPath") {
+      m_task_queue_alg = CriticalPath;
+    }
     else {
       throw ProblemSetupException("Unknown task ready queue algorithm", __FILE__, __LINE__);
     }
@@ -139,6 +146,8 @@ DynamicMPIScheduler::createSubScheduler()
   DynamicMPIScheduler * newsched = scinew DynamicMPIScheduler( d_myworld, this );
   newsched->setComponents( this );
   newsched->m_materialManager = m_materialManager;
+  newsched->m_cache_comm_plans = m_cache_comm_plans;
+  newsched->m_incremental_compile = m_incremental_compile;
   return newsched;
 }
 
@@ -154,6 +163,9 @@ DynamicMPIScheduler::execute( int tgnum     /*=0*/
     return;
   }
 
+  Tracer::Scope trace(Tracer::Execute);
+  trace.setArgs(tgnum, iteration);
+
   // track total scheduler execution time across timesteps
   m_exec_timer.reset(true);
 
@@ -191,6 +203,9 @@ DynamicMPIScheduler::execute( int tgnum     /*=0*/
   // This only happens if "-emit_taskgraphs" is passed to sus
   makeTaskGraphDoc(dts, me);
 
+  // This only happens for the <ExecutedTaskGraph> timesteps
+  startGraphRecord();
+
   mpi_info_.reset( 0 );
 
   if( m_reloc_new_pos_label && m_dws[m_dwmap[Task::OldDW]] != nullptr ) {
@@ -401,6 +416,8 @@ DynamicMPIScheduler::execute( int tgnum     /*=0*/
   ASSERT(m_sends.size() == 0u);
   ASSERT(m_recvs.size() == 0u);
 
+  finishGraphRecord(dts);
+
   finalizeTimestep();
   
   m_exec_timer.stop();
@@ -38,6 +38,7 @@
 #include <Core/Parallel/MasterLock.h>
 #include <Core/Util/DOUT.hpp>
 #include <Core/Util/Timers/Timers.hpp>
+#include <Core/Util/Tracer.h>
 
 #include <sci_defs/kokkos_defs.h>
 
@@ -144,6 +145,12 @@ KokkosOpenMPScheduler::problemSetup( const ProblemSpecP     & prob_spec
     else if (taskQueueAlg == "PatchOrderRandom") {
       m_task_queue_alg = PatchOrderRandom;
     }
+    else if (taskQueueAlg == "PredictedCost") {
+      m_task_queue_alg = PredictedCost;
+    }
+    else if (taskQueueAlg == "CriticalPath") {
+      m_task_queue_alg = CriticalPath;
+    }
     else {
       throw ProblemSetupException("Unknown task ready queue algorithm", __FILE__, __LINE__);
     }
@@ -182,6 +189,9 @@ KokkosOpenMPScheduler::execute( int tgnum       /* = 0 */
     return;
   }
 
+  Tracer::Scope trace(Tracer::Execute);
+  trace.setArgs(tgnum, iteration);
+
   // track total scheduler execution time across timesteps
   m_exec_timer.reset(true);
 
@@ -218,6 +228,9 @@ KokkosOpenMPScheduler::execute( int tgnum       /* = 0 */
   // This only happens if "-emit_taskgraphs" is passed to sus
   makeTaskGraphDoc(m_detailed_tasks, my_rank);
 
+  // This only happens for the <ExecutedTaskGraph> timesteps
+  startGraphRecord();
+
   mpi_info_.reset( 0 );
 
   g_num_tasks_done = 0;
@@ -328,6 +341,8 @@ KokkosOpenMPScheduler::execute( int tgnum       /* = 0 */
     proc0cout << "average queue length:" << allqueuelength / d_myworld->nRanks() << std::endl;
   }
 
+  finishGraphRecord(m_detailed_tasks);
+
   finalizeTimestep();
 
   m_exec_timer.stop();
@@ -44,6 +44,7 @@
 #include <Core/Util/DOUT.hpp>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/Timers/Timers.hpp>
+#include <Core/Util/Tracer.h>
 
 #include <sci_defs/kokkos_defs.h>
 
@@ -90,6 +91,7 @@ namespace {
   Uintah::MasterLock g_send_time_mutex{};         // for reporting thread-safe MPI send times
   Uintah::MasterLock g_recv_time_mutex{};         // for reporting thread-safe MPI recv times
   Uintah::MasterLock g_wait_time_mutex{};         // for reporting thread-safe MPI wait times
+  Uintah::MasterLock g_setup_time_mutex{};        // for reporting thread-safe MPI message setup times
   
   Dout g_dbg(          "MPIScheduler_DBG"       , "MPIScheduler", "general dbg info for MPIScheduler", false );
   Dout g_send_stats(   "MPISendStats"           , "MPIScheduler", "MPI send statistics, num_sends, send volume", false );
@@ -130,6 +132,7 @@ MPIScheduler::MPIScheduler( const ProcessorGroup * myworld
   mpi_info_.insert( TotalWait  , std::string("TotalWait")  ,    timeStr );
   mpi_info_.insert( TotalReduce, std::string("TotalReduce"),    timeStr );
   mpi_info_.insert( TotalTask  , std::string("TotalTask")  ,    timeStr );
+  mpi_info_.insert( TotalCommSetup, std::string("TotalCommSetup"), timeStr );
 }
 
 //______________________________________________________________________
@@ -166,6 +169,8 @@ MPIScheduler::createSubScheduler()
 
   newsched->setComponents( this );
   newsched->m_materialManager = m_materialManager;
+  newsched->m_cache_comm_plans = m_cache_comm_plans;
+  newsched->m_incremental_compile = m_incremental_compile;
   return newsched;
 }
 
@@ -245,7 +250,10 @@ MPIScheduler::initiateReduction( DetailedTask* dtask )
   Timers::Simple timer;
 
   timer.start();
-  runReductionTask(dtask);
+  {
+    Tracer::Scope trace(Tracer::Reduction, &dtask->getTask()->getName());
+    runReductionTask(dtask);
+  }
   timer.stop();
 
   mpi_info_[TotalReduce] += timer().seconds();
@@ -328,6 +336,8 @@ MPIScheduler::runTask( DetailedTask * dtask
 void
 MPIScheduler::runReductionTask( DetailedTask* dtask )
 {
+  dtask->markExecStart();
+
   const Task::Dependency* mod = dtask->getTask()->getModifies();
   ASSERT(!mod->m_next);
 
@@ -355,6 +365,11 @@ MPIScheduler::postMPISends( DetailedTask * dtask
   // Send data to dependents
   for (DependencyBatch* batch = dtask->getComputes(); batch != nullptr; batch = batch->m_comp_next) {
 
+    Timers::Simple setup_timer;
+    setup_timer.start();
+
+    Tracer::Scope trace(Tracer::Send);
+
     // Prepare to send a message
 #ifdef USE_PACKING
     PackBufferInfo mpibuff;
@@ -441,11 +456,22 @@ MPIScheduler::postMPISends( DetailedTask * dtask
       MPI_Datatype datatype;
 
 #ifdef USE_PACKING
-      mpibuff.get_type(buf, count, datatype, my_comm);
+      CommPlanCache::Message* plan = m_comm_plans.sendPlan(batch);
+
+      mpibuff.get_type(buf, count, datatype, my_comm, plan ? plan->buffer() : nullptr);
+      setup_timer.stop();
       mpibuff.pack(my_comm, count);
 #else
+      CommPlanCache::Message* plan = nullptr;
+
       mpibuff.get_type(buf, count, datatype);
+      setup_timer.stop();
 #endif
+      {
+        std::lock_guard<Uintah::MasterLock> setup_time_lock(g_setup_time_mutex);
+        mpi_info_[TotalCommSetup] += setup_timer().seconds();
+      }
+
       if (!buf) {
         printf("postMPISends() - ERROR, the send MPI buffer is nullptr\n");
         SCI_THROW( InternalError("The send MPI buffer is null", __FILE__, __LINE__) );
@@ -457,6 +483,7 @@ MPIScheduler::postMPISends( DetailedTask * dtask
       int typeSize;
 
       Uintah::MPI::Type_size(datatype, &typeSize);
+      trace.setArgs(to, batch->m_message_tag, count * typeSize);
 
       {
         std::lock_guard<Uintah::MasterLock> msg_vol_lock(g_msg_vol_mutex);
@@ -467,7 +494,15 @@ MPIScheduler::postMPISends( DetailedTask * dtask
       // New way of managing single MPI requests - avoids MPI_Waitsome & MPI_Donesome - APH 07/20/16
       //---------------------------------------------------------------------------
       CommRequestPool::iterator comm_sends_iter = m_sends.emplace(new SendHandle(mpibuff.takeSendlist()));
-      Uintah::MPI::Isend(buf, count, datatype, to, batch->m_message_tag, my_comm, comm_sends_iter->request());
+#ifdef USE_PACKING
+      if (plan) {
+        plan->start(mpibuff.getPackedBuffer(), count, to, batch->m_message_tag, my_comm, comm_sends_iter->request());
+      }
+      else
+#endif
+      {
+        Uintah::MPI::Isend(buf, count, datatype, to, batch->m_message_tag, my_comm, comm_sends_iter->request());
+      }
       comm_sends_iter.clear();
       //---------------------------------------------------------------------------
 
@@ -556,6 +591,9 @@ void MPIScheduler::postMPIRecvs( DetailedTask * dtask
         }
       }
 
+      Timers::Simple setup_timer;
+      setup_timer.start();
+
       // Prepare to receive a message
       BatchReceiveHandler* pBatchRecvHandler = scinew BatchReceiveHandler(batch);
       PackBufferInfo* p_mpibuff = nullptr;
@@ -638,16 +676,26 @@ void MPIScheduler::postMPIRecvs( DetailedTask * dtask
       // Post the receive
       if ( mpibuff.count() > 0 ) {
 
+        Tracer::Scope trace(Tracer::Recv);
+
         ASSERT(batch->m_message_tag > 0);
         void* buf = nullptr;
         int count;
         MPI_Datatype datatype;
 
 #ifdef USE_PACKING
-        mpibuff.get_type(buf, count, datatype, my_comm);
+        CommPlanCache::Message* plan = m_comm_plans.recvPlan(batch);
+
+        mpibuff.get_type(buf, count, datatype, my_comm, plan ? plan->buffer() : nullptr);
 #else
         mpibuff.get_type(buf, count, datatype);
 #endif
+        setup_timer.stop();
+        {
+          std::lock_guard<Uintah::MasterLock> setup_time_lock(g_setup_time_mutex);
+          mpi_info_[TotalCommSetup] += setup_timer().seconds();
+        }
+
         if (!buf) {
           printf("postMPIRecvs() - ERROR, the receive MPI buffer is nullptr\n");
           SCI_THROW( InternalError("The receive MPI buffer is nullptr", __FILE__, __LINE__) );
@@ -656,6 +704,12 @@ void MPIScheduler::postMPIRecvs( DetailedTask * dtask
         int from = batch->m_from_task->getAssignedResourceIndex();
         ASSERTRANGE(from, 0, d_myworld->nRanks());
 
+        if (Tracer::isEnabled()) {
+          int typeSize;
+          Uintah::MPI::Type_size(datatype, &typeSize);
+          trace.setArgs(from, batch->m_message_tag, count * typeSize);
+        }
+
         DOUT(g_mpi_dbg, "Rank-" << my_rank << " Posting recv for message number "
                                 << batch->m_message_tag << " from rank-" << from
                                 << ", length: " << count << " (bytes)");
@@ -664,7 +718,15 @@ void MPIScheduler::postMPIRecvs( DetailedTask * dtask
         // New way of managing single MPI requests - avoids MPI_Waitsome & MPI_Donesome - APH 07/20/16
         //---------------------------------------------------------------------------
         CommRequestPool::iterator comm_recvs_iter = m_recvs.emplace(new RecvHandle(p_mpibuff, pBatchRecvHandler));
-        Uintah::MPI::Irecv(buf, count, datatype, from, batch->m_message_tag, my_comm, comm_recvs_iter->request());
+#ifdef USE_PACKING
+        if (plan) {
+          plan->start(mpibuff.getPackedBuffer(), count, from, batch->m_message_tag, my_comm, comm_recvs_iter->request());
+        }
+        else
+#endif
+        {
+          Uintah::MPI::Irecv(buf, count, datatype, from, batch->m_message_tag, my_comm, comm_recvs_iter->request());
+        }
         comm_recvs_iter.clear();
         //---------------------------------------------------------------------------
 
@@ -720,6 +782,7 @@ void MPIScheduler::processMPIRecvs( int test_type )
       RuntimeStats::TestTimer mpi_test_timer;
       comm_iter = m_recvs.find_any(test_request);
       if (comm_iter) {
+        Tracer::Scope trace(Tracer::Unpack);
         MPI_Status status;
         comm_iter->finishedCommunication(d_myworld, status);
         m_recvs.erase(comm_iter);
@@ -730,8 +793,12 @@ void MPIScheduler::processMPIRecvs( int test_type )
     case WAIT_ONCE :
     {
       RuntimeStats::WaitTimer mpi_wait_timer;
-      comm_iter = m_recvs.find_any(wait_request);
+      {
+        Tracer::Scope trace(Tracer::Wait);
+        comm_iter = m_recvs.find_any(wait_request);
+      }
       if (comm_iter) {
+        Tracer::Scope trace(Tracer::Unpack);
         MPI_Status status;
         comm_iter->finishedCommunication(d_myworld, status);
         m_recvs.erase(comm_iter);
@@ -743,8 +810,12 @@ void MPIScheduler::processMPIRecvs( int test_type )
     {
       RuntimeStats::WaitTimer mpi_wait_timer;
       while (m_recvs.size() != 0u) {
-        comm_iter = m_recvs.find_any(wait_request);
+        {
+          Tracer::Scope trace(Tracer::Wait);
+          comm_iter = m_recvs.find_any(wait_request);
+        }
         if (comm_iter) {
+          Tracer::Scope trace(Tracer::Unpack);
           MPI_Status status;
           comm_iter->finishedCommunication(d_myworld, status);
           m_recvs.erase(comm_iter);
@@ -771,6 +842,9 @@ MPIScheduler::execute( int tgnum     /* = 0 */
                      , int iteration /* = 0 */
                      )
 {
+  Tracer::Scope trace(Tracer::Execute);
+  trace.setArgs(tgnum, iteration);
+
   // track total scheduler execution time across timesteps
   m_exec_timer.reset(true);
 
@@ -810,6 +884,9 @@ MPIScheduler::execute( int tgnum     /* = 0 */
   // This only happens if "-emit_taskgraphs" is passed to sus
   makeTaskGraphDoc( dts, my_rank );
 
+  // This only happens for the <ExecutedTaskGraph> timesteps
+  startGraphRecord();
+
   mpi_info_.reset( 0 );
 
   DOUT(g_dbg, "Rank-" << my_rank << ", MPI Scheduler executing taskgraph: " << tgnum << ", timestep: " << m_application->getTimeStep()
@@ -887,14 +964,17 @@ MPIScheduler::execute( int tgnum     /* = 0 */
   // wait on all pending requests
   auto ready_request = [](CommRequest const& r)->bool { return r.wait(); };
   CommRequestPool::handle find_handle;
-  while ( m_sends.size() != 0u ) {
-    CommRequestPool::iterator comm_sends_iter;
-    if ((comm_sends_iter = m_sends.find_any(find_handle, ready_request))) {
-      find_handle = comm_sends_iter;
-      m_sends.erase(comm_sends_iter);
-    }
-    else {
-      // TODO - make this a sleep? APH 07/20/16
+  if ( m_sends.size() != 0u ) {
+    Tracer::Scope wait_trace(Tracer::Wait);
+    while ( m_sends.size() != 0u ) {
+      CommRequestPool::iterator comm_sends_iter;
+      if ((comm_sends_iter = m_sends.find_any(find_handle, ready_request))) {
+        find_handle = comm_sends_iter;
+        m_sends.erase(comm_sends_iter);
+      }
+      else {
+        // TODO - make this a sleep? APH 07/20/16
+      }
     }
   }
   //---------------------------------------------------------------------------
@@ -902,6 +982,8 @@ MPIScheduler::execute( int tgnum     /* = 0 */
   ASSERT(m_sends.size() == 0u);
   ASSERT(m_recvs.size() == 0u);
 
+  finishGraphRecord( dts );
+
   finalizeTimestep();
 
   m_exec_timer.stop();
@@ -1010,6 +1092,7 @@ MPIScheduler::outputTimingStats( const char* label )
     emitTime("Total wait time"  , mpi_info_[TotalWait]);
     emitTime("Total reduce time", mpi_info_[TotalReduce]);
     emitTime("Total task time"  , mpi_info_[TotalTask]);
+    emitTime("Total comm setup time", mpi_info_[TotalCommSetup]);
     emitTime("Total comm time"  , mpi_info_[TotalSend] + mpi_info_[TotalRecv] + mpi_info_[TotalTest] + mpi_info_[TotalWait] + mpi_info_[TotalReduce]);
 
     emitTime("Total execution time"   , totalexec );
@@ -1125,6 +1208,7 @@ void MPIScheduler::computeNetRuntimeStats()
     // don't count output time
     (*m_runtimeStats)[TaskExecTime      ] += mpi_info_[TotalTask] - (*m_runtimeStats)[TotalIOTime];
     (*m_runtimeStats)[TaskLocalCommTime ] += mpi_info_[TotalRecv] + mpi_info_[TotalSend];
+    (*m_runtimeStats)[TaskCommSetupTime ] += mpi_info_[TotalCommSetup];
     (*m_runtimeStats)[TaskWaitCommTime  ] += mpi_info_[TotalWait];
     (*m_runtimeStats)[TaskReduceCommTime] += mpi_info_[TotalReduce];
   }
@@ -26,6 +26,7 @@
 #define CCA_COMPONENTS_SCHEDULERS_MPISCHEDULER_H
 
 #include <CCA/Components/Schedulers/SchedulerCommon.h>
+#include <CCA/Components/Schedulers/CommPlanCache.h>
 #include <CCA/Components/Schedulers/DetailedTask.h>
 #include <CCA/Components/Schedulers/OnDemandDataWarehouseP.h>
 #include <CCA/Ports/DataWarehouseP.h>
@@ -91,6 +92,11 @@ class MPIScheduler : public SchedulerCommon {
     void compile() {
       m_num_messages   = 0;
       m_message_volume = 0;
+
+      // The batches of the old graphs are about to be destroyed.
+      m_comm_plans.clear();
+      m_comm_plans.setEnabled( m_cache_comm_plans );
+
       SchedulerCommon::compile();
     }
 
@@ -107,6 +113,7 @@ class MPIScheduler : public SchedulerCommon {
       , TotalWait
       , TotalReduce
       , TotalTask
+      , TotalCommSetup  // building the messages, part of TotalSend and TotalRecv
     };
     
     enum {
@@ -133,6 +140,8 @@ class MPIScheduler : public SchedulerCommon {
     CommRequestPool             m_sends{};
     CommRequestPool             m_recvs{};
 
+    CommPlanCache               m_comm_plans;
+
     std::vector<const char*>    m_labels;
     std::vector<double>         m_times;
 
@@ -1658,11 +1658,32 @@ OnDemandDataWarehouse::get(       constParticleVariableBase & constVar
   }
   else {
     checkGetAccess( label, matlIndex, patch );
-    ParticleVariableBase* var = constVar.cloneType();
 
     const std::vector<const Patch*>& neighborPatches = pset->getNeighbors();
     const std::vector<ParticleSubset*>& neighbor_subsets = pset->getNeighborSubsets();
 
+    // If only the patch itself contributes, all of its particles, and
+    // both subsets are the identity, the gather would just copy the
+    // patch's variable - use it directly.
+    int contributing = -1;
+    for (size_t i = 0u; i < neighborPatches.size(); i++) {
+      if (neighbor_subsets[i]->numParticles() > 0) {
+        contributing = (contributing == -1) ? (int)i : -2;
+      }
+    }
+    if (contributing >= 0 && neighborPatches[contributing] == patch && m_var_DB.exists(label, matlIndex, patch)) {
+      ParticleSubset* subset = neighbor_subsets[contributing];
+      ParticleVariableBase* patchvar = dynamic_cast<ParticleVariableBase*>( m_var_DB.get( label, matlIndex, patch ) );
+
+      if (subset->numParticles() == patchvar->getParticleSubset()->numParticles() &&
+          subset->isContiguous() && pset->isContiguous()) {
+        constVar = *patchvar;
+        return;
+      }
+    }
+
+    ParticleVariableBase* var = constVar.cloneType();
+
     std::vector<ParticleVariableBase*> neighborvars( neighborPatches.size() );
 
     for (size_t i = 0u; i < neighborPatches.size(); i++) {
@@ -4063,6 +4084,14 @@ OnDemandDataWarehouse::getVarLabelMatlLevelTriples( std::vector<VarLabelMatl<Lev
   m_level_DB.getVarLabelMatlTriples( vars );
 }
 
+//______________________________________________________________________
+//
+void
+OnDemandDataWarehouse::getPatchDataSizes( std::map<const Patch*, size_t> & sizes ) const
+{
+  m_var_DB.getDataSizes( sizes );
+}
+
 //______________________________________________________________________
 //
 void
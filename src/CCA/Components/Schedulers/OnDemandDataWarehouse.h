@@ -629,6 +629,9 @@ public:
   // The following is for support of regridding
   virtual void getVarLabelMatlLevelTriples( std::vector<VarLabelMatl<Level> > & vars ) const;
 
+  // Bytes of the patch variables on each patch
+  virtual void getPatchDataSizes( std::map<const Patch*, size_t> & sizes ) const;
+
   static bool s_combine_memory;
 
   friend class SchedulerCommon;
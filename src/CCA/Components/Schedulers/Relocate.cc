@@ -1135,8 +1135,11 @@ Relocate::relocateParticlesModifies( const ProcessorGroup* pg,
         ParticleSubset* orig_pset = old_dw->getParticleSubset(matl, toPatch);
         
         //__________________________________
-        // Particles haven't moved, carry the old data forward
-        if(recvs == 0 && subsets.size() == 1 && keep_pset == orig_pset && !adding_new_particles){
+        // Particles haven't moved, carry the old data forward.  A
+        // fragmented subset (e.g. after sort()) is compacted by the
+        // gather below instead, so the new data is dense again.
+        if(recvs == 0 && subsets.size() == 1 && keep_pset == orig_pset && !adding_new_particles &&
+           orig_pset->isContiguous()){
           // carry forward old data
           new_dw->saveParticleSubset(orig_pset, matl, toPatch);
           
@@ -1559,9 +1562,11 @@ Relocate::relocateParticles(const ProcessorGroup* pg,
         ParticleSubset* orig_pset = old_dw->getParticleSubset(matl, toPatch);
 
         //__________________________________
-        // Particles haven't moved, carry the old data forward
+        // Particles haven't moved, carry the old data forward (unless
+        // the subset is fragmented, see above)
         if(recvs == 0 && subsets.size() == 1 && 
-           keep_pset == orig_pset && !adding_new_particles){
+           keep_pset == orig_pset && !adding_new_particles &&
+           orig_pset->isContiguous()){
           // carry forward old data
           new_dw->saveParticleSubset(orig_pset, matl, toPatch);
           
@@ -57,6 +57,15 @@ namespace Uintah {
     , RegriddingCompilationTime
     , RegriddingCopyDataTime
     , LoadBalancerTime
+
+    // Bytes of patch data sent away by the load balancer's new assignments
+    , LoadBalancerMigration
+
+    // Task graph compilation phases, part of CompilationTime and RegriddingCompilationTime
+    , CompileSetupTime
+    , CompileDetailedTasksTime
+    , CompileDependenciesTime
+    , CompileFinalizeTime
     
     // These five enumerators are used in SimulationController::ReportStats to determine task and comm overhead.
     , TaskExecTime
@@ -65,6 +74,13 @@ namespace Uintah {
     , TaskReduceCommTime
     , TaskWaitThreadTime
 
+    // Building the MPI messages, part of TaskLocalCommTime
+    , TaskCommSetupTime
+
+    // Work-stealing task queues (UnifiedScheduler <workStealing>)
+    , NumTaskSteals
+    , NumFailedTaskSteals
+
     , XMLIOTime
     , OutputIOTime
     , OutputGlobalIOTime
@@ -84,6 +100,10 @@ namespace Uintah {
     , MemoryUsed
     , MemoryResident
 
+    // Grid and particle variable memory pool (<variablePoolMB>)
+    , VariablePoolHitRate
+    , VariablePoolRetained
+
     , NumTasks
     , NumPatches
     , NumCells
@@ -24,7 +24,9 @@
 
 #include <CCA/Components/Schedulers/SchedulerCommon.h>
 
+#include <CCA/Components/Schedulers/DependencyBatch.h>
 #include <CCA/Components/Schedulers/DetailedTasks.h>
+#include <CCA/Components/Schedulers/MemoryLog.h>
 #include <CCA/Components/Schedulers/OnDemandDataWarehouse.h>
 #include <CCA/Components/Schedulers/OnDemandDataWarehouseP.h>
 #include <CCA/Components/Schedulers/TaskGraph.h>
@@ -39,6 +41,8 @@
 #include <Core/Exceptions/ProblemSetupException.h>
 #include <Core/Grid/Patch.h>
 #include <Core/Grid/Task.h>
+#include <Core/Grid/Variables/Array3Data.h>
+#include <Core/Grid/Variables/VariableMemoryPool.h>
 #include <Core/Grid/Variables/LocallyComputedPatchVarMap.h>
 #include <Core/Grid/Variables/PerPatch.h>
 #include <Core/Grid/Variables/CellIterator.h>
@@ -48,15 +52,22 @@
 #include <Core/Grid/Variables/SFCYVariable.h>
 #include <Core/Grid/Variables/SFCZVariable.h>
 #include <Core/Malloc/Allocator.h>
+#include <Core/Parallel/LoopThreadPool.h>
+#include <Core/Parallel/PackBufferInfo.h>
 #include <Core/Parallel/ProcessorGroup.h>
+#include <Core/Parallel/UintahMPI.h>
 #include <Core/ProblemSpec/ProblemSpec.h>
 #include <Core/OS/ProcessInfo.h>
 #include <Core/Util/DOUT.hpp>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/Timers/Timers.hpp>
+#include <Core/Util/Tracer.h>
 
+#include <sci_defs/cuda_defs.h>
+#include <sci_defs/kokkos_defs.h>
 #include <sci_defs/visit_defs.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdlib>
 #include <fstream>
@@ -102,6 +113,14 @@ SchedulerCommon::SchedulerCommon( const ProcessorGroup * myworld )
 //
 SchedulerCommon::~SchedulerCommon()
 {
+  if (m_trace) {
+    size_t dropped = Tracer::dump(d_myworld->myRank());
+    if (dropped > 0) {
+      std::cout << "Rank-" << d_myworld->myRank() << " WARNING: the trace dropped " << dropped
+                << " events, increase <Trace><maxEventsPerThread>\n";
+    }
+  }
+
   if (m_mem_logfile) {
     delete m_mem_logfile;
   }
@@ -283,13 +302,100 @@ SchedulerCommon::makeTaskGraphDoc( const DetailedTasks * /* dt*/
   }
 }
 
+//______________________________________________________________________
+//
+void
+SchedulerCommon::startGraphRecord()
+{
+  if (m_record_timesteps.empty()) {
+    return;
+  }
+
+  const int timestep = m_application->getTimeStep();
+  if (std::find(m_record_timesteps.begin(), m_record_timesteps.end(), timestep) == m_record_timesteps.end()) {
+    return;
+  }
+
+  if (timestep != m_record_timestep) {
+    m_record_timestep = timestep;
+    m_record_count    = 0;
+  }
+
+  // a common time origin for all ranks
+  Uintah::MPI::Barrier(d_myworld->getComm());
+  m_record_origin = DetailedTask::clockTime();
+  m_recording     = true;
+}
+
+//______________________________________________________________________
+//
+void
+SchedulerCommon::finishGraphRecord( DetailedTasks * dts )
+{
+  if (!m_recording) {
+    return;
+  }
+  m_recording = false;
+
+  const int rank = d_myworld->myRank();
+
+  std::ostringstream fname;
+  fname << m_record_filename << "." << m_record_timestep << "." << m_record_count++ << "." << rank << ".txt";
+
+  std::ofstream out(fname.str().c_str());
+  if (!out) {
+    std::cerr << "Rank-" << rank << " WARNING: could not open " << fname.str() << "\n";
+    return;
+  }
+
+  // times in microseconds since startGraphRecord(), -1 if not in this execution
+  auto time = [this](int64_t t) { return (t >= m_record_origin) ? (t - m_record_origin) * 1.e-3 : -1.0; };
+
+  const int num_tasks = dts->numLocalTasks();
+
+  std::map<const DetailedTask*, int> ids;
+  for (int i = 0; i < num_tasks; i++) {
+    ids[dts->localTask(i)] = i;
+  }
+
+  out << "# Uintah executed task graph\n";
+  out << "rank " << rank << " ranks " << d_myworld->nRanks() << " timestep " << m_record_timestep << "\n";
+  out << std::fixed << std::setprecision(3);
+
+  for (int i = 0; i < num_tasks; i++) {
+    DetailedTask* dtask = dts->localTask(i);
+    out << "task " << i << " " << time(dtask->getExecStart()) << " " << time(dtask->getExecEnd()) << " " << dtask->getName() << "\n";
+  }
+
+  for (int i = 0; i < num_tasks; i++) {
+    DetailedTask* dtask = dts->localTask(i);
+
+    for (const InternalDependency& dep : dtask->getInternalDependencies()) {
+      auto iter = ids.find(dep.m_prerequisite_task);
+      if (iter != ids.end()) {
+        out << "dep " << iter->second << " " << i << "\n";
+      }
+    }
+
+    for (DependencyBatch* batch = dtask->getComputes(); batch != nullptr; batch = batch->m_comp_next) {
+      out << "send " << i << " " << batch->m_to_rank << " " << batch->m_message_tag << "\n";
+    }
+
+    for (auto& req : dtask->getRequires()) {
+      DependencyBatch* batch = req.first;
+      out << "recv " << i << " " << batch->m_from_task->getAssignedResourceIndex() << " " << batch->m_message_tag
+          << " " << time(batch->m_received_time) << "\n";
+    }
+  }
+}
+
 //______________________________________________________________________
 //
 bool
 SchedulerCommon::useInternalDeps()
 {
-  // Keep track of internal dependencies only if it will emit the taskgraphs (by default).
-  return m_emit_task_graph;
+  // Keep track of internal dependencies only if it will emit or record the taskgraphs (by default).
+  return m_emit_task_graph || !m_record_timesteps.empty();
 }
 
 //______________________________________________________________________
@@ -366,6 +472,96 @@ SchedulerCommon::problemSetup( const ProblemSpecP     & prob_spec
       proc0cout << "Using large, combined MPI messages\n";
     }
 
+    // Memory layout of the grid variables.
+    int alignment = Array3DataLayout::getAlignment();
+    params->getWithDefault("gridVariableAlignment", alignment, alignment);
+    if (alignment < 64 || (alignment & (alignment - 1)) != 0) {
+      std::ostringstream msg;
+      msg << "<gridVariableAlignment> (" << alignment << ") must be a power of two of at least 64 bytes";
+      SCI_THROW(ProblemSetupException(msg.str(), __FILE__, __LINE__));
+    }
+    Array3DataLayout::setAlignment(alignment);
+
+    bool padRows = false;
+    params->getWithDefault("padGridVariableRows", padRows, false);
+#if defined(HAVE_CUDA) || defined(UINTAH_ENABLE_KOKKOS)
+    if (padRows) {
+      SCI_THROW(ProblemSetupException("<padGridVariableRows> is not available with CUDA or Kokkos, the device copies and views assume unpadded rows", __FILE__, __LINE__));
+    }
+#endif
+#if defined(HAVE_VISIT)
+    if (padRows) {
+      SCI_THROW(ProblemSetupException("<padGridVariableRows> is not available with VisIt, the VisIt readers assume unpadded rows", __FILE__, __LINE__));
+    }
+#endif
+    Array3DataLayout::setPadRows(padRows);
+
+    if (padRows) {
+      proc0cout << "Grid variable rows padded to " << alignment << " bytes\n";
+    }
+
+    // Recycling of the grid and particle variable memory.
+    double poolMB = 0;
+    params->getWithDefault("variablePoolMB", poolMB, 0.0);
+    if (poolMB < 0) {
+      SCI_THROW(ProblemSetupException("<variablePoolMB> must not be negative", __FILE__, __LINE__));
+    }
+    VariableMemoryPool::setBudget((size_t)(poolMB * 1024 * 1024));
+
+    if (poolMB > 0) {
+      proc0cout << "Recycling up to " << poolMB << " MB of variable memory per rank\n";
+    }
+
+    // Caching of the MPI message buffers and persistent requests.
+    params->getWithDefault("cacheCommPlans", m_cache_comm_plans, true);
+
+    // Replay the dependency analysis of the last compile where nothing changed.
+    params->getWithDefault("incrementalCompile", m_incremental_compile, false);
+
+    // Copy the grid variable windows into the MPI messages ourselves.
+    bool explicitPacking = false;
+    params->getWithDefault("explicitPacking", explicitPacking, false);
+    PackBufferInfo::setExplicitPacking(explicitPacking);
+
+    // Order in which the loop threads combine the partial results of reductions.
+    bool deterministicReductions = LoopThreadPool::getDeterministicReductions();
+    params->getWithDefault("deterministicLoopReductions", deterministicReductions, deterministicReductions);
+    LoopThreadPool::setDeterministicReductions(deterministicReductions);
+
+    if (!deterministicReductions) {
+      proc0cout << "Loop reductions combine one partial result per thread (not reproducible)\n";
+    }
+
+    // Timeline of the tasks and the communication.
+    ProblemSpecP trace = params->findBlock("Trace");
+    if (trace) {
+      std::string filename = "trace";
+      std::string format   = "json";
+      int         maxEvents = 1000000;
+      trace->getWithDefault("filename", filename, filename);
+      trace->getWithDefault("format", format, format);
+      trace->getWithDefault("maxEventsPerThread", maxEvents, maxEvents);
+
+      if (format != "json" && format != "binary") {
+        SCI_THROW(ProblemSetupException("<Trace><format> must be 'json' or 'binary'", __FILE__, __LINE__));
+      }
+
+      // a common time origin for all ranks
+      Uintah::MPI::Barrier(d_myworld->getComm());
+      Tracer::enable(filename, (format == "json") ? Tracer::JSON : Tracer::Binary, std::max(maxEvents, 0));
+      Tracer::setThreadName("main");
+      m_trace = true;
+
+      proc0cout << "Tracing tasks and communication to " << filename << ".<rank>." << (format == "json" ? "json" : "bin") << "\n";
+    }
+
+    // Executed task graphs for the critical path analysis.
+    ProblemSpecP record = params->findBlock("ExecutedTaskGraph");
+    if (record) {
+      record->require("timesteps", m_record_timesteps);
+      record->getWithDefault("filename", m_record_filename, m_record_filename);
+    }
+
     ProblemSpecP track = params->findBlock("VarTracker");
     if (track) {
       track->require("start_time", m_tracking_start_time);
@@ -1322,6 +1518,13 @@ SchedulerCommon::logMemoryUse()
     }
   }
 
+  if (VariableMemoryPool::getBudget() > 0) {
+    VariableMemoryPool::Stats pool = VariableMemoryPool::getStats();
+    std::ostringstream hits;
+    hits << pool.m_hits << "/" << pool.m_hits + pool.m_misses;
+    logMemory(*m_mem_logfile, total, "VariablePool", "retained", "-", nullptr, -1, hits.str(), pool.m_retainedBytes, nullptr);
+  }
+
   *m_mem_logfile << "Total: " << total << '\n';
   m_mem_logfile->flush();
 }
@@ -1378,15 +1581,47 @@ SchedulerCommon::compile()
       // check if this TG has any tasks with halo requirements > MAX_HALO_DEPTH (determined in public SchedulerCommon::addTask())
       const bool has_distal_reqs = m_task_graphs[i]->getDistalRequires();
 
+      bool is_init = m_is_init_timestep || m_is_restart_init_timestep;
+
+      // the graphs of the initialization and copy data timesteps are compiled once, leave
+      // the cache to the graph compiled before and after them
+      CompileCache* compile_cache = nullptr;
+      if (m_incremental_compile && !is_init && !m_is_copy_data_timestep) {
+        if (m_compile_caches.size() < num_task_graphs) {
+          m_compile_caches.resize(num_task_graphs);
+        }
+        if (!m_compile_caches[i]) {
+          m_compile_caches[i].reset(scinew CompileCache());
+          m_compile_caches[i]->setEnabled(true);
+        }
+        compile_cache = m_compile_caches[i].get();
+      }
+
       // NOTE: this single call is where all the TG compilation complexity arises (dependency analysis for auto MPI mesgs)
-      m_task_graphs[i]->createDetailedTasks( useInternalDeps(), grid, oldGrid, has_distal_reqs );
+      m_task_graphs[i]->createDetailedTasks( useInternalDeps(), grid, oldGrid, has_distal_reqs, compile_cache );
 
       double compile_time = tg_compile_timer().seconds();
 
-      bool is_init = m_is_init_timestep || m_is_restart_init_timestep;
+      const TaskGraph* tg = m_task_graphs[i];
+      const double setup_time        = tg->getCompilePhaseTime(TaskGraph::SetupPhase);
+      const double detailed_time     = tg->getCompilePhaseTime(TaskGraph::DetailedTasksPhase);
+      const double dependencies_time = tg->getCompilePhaseTime(TaskGraph::DependenciesPhase);
+      const double finalize_time     = tg->getCompilePhaseTime(TaskGraph::FinalizePhase);
 
       DOUT(g_task_graph_compile, "Rank-" << std::left << std::setw(5) << d_myworld->myRank() << " time to compile TG-" << std::setw(4)
-                                         << (is_init ? "init-tg" : std::to_string(m_task_graphs[i]->getIndex())) << ": " << compile_time << " (sec)");
+                                         << (is_init ? "init-tg" : std::to_string(m_task_graphs[i]->getIndex())) << ": " << compile_time << " (sec)"
+                                         << "  setup: " << setup_time << "  detailed tasks: " << detailed_time
+                                         << "  dependencies: " << dependencies_time << "  finalize: " << finalize_time
+                                         << (compile_cache ? "  replayed tasks: " + std::to_string(compile_cache->numReplayed()) + " of "
+                                                             + std::to_string(compile_cache->numReplayed() + compile_cache->numRecomputed())
+                                                           : std::string()));
+
+      if (m_runtimeStats) {
+        (*m_runtimeStats)[CompileSetupTime]         += setup_time;
+        (*m_runtimeStats)[CompileDetailedTasksTime] += detailed_time;
+        (*m_runtimeStats)[CompileDependenciesTime]  += dependencies_time;
+        (*m_runtimeStats)[CompileFinalizeTime]      += finalize_time;
+      }
     }
 
     // check scheduler at runtime, that all ranks are executing the same size TG (excluding spatial tasks)
@@ -1761,6 +1996,7 @@ SchedulerCommon::scheduleAndDoDataCopy( const GridP & grid )
   double wait_time   = (*m_runtimeStats)[TaskWaitCommTime];
   double reduce_time = (*m_runtimeStats)[TaskReduceCommTime];
   double thread_time = (*m_runtimeStats)[TaskWaitThreadTime];
+  double setup_time  = (*m_runtimeStats)[TaskCommSetupTime];
 
   timer.reset( true );
   this->execute();
@@ -1830,6 +2066,7 @@ SchedulerCommon::scheduleAndDoDataCopy( const GridP & grid )
   (*m_runtimeStats)[TaskWaitCommTime]   = wait_time;
   (*m_runtimeStats)[TaskReduceCommTime] = reduce_time;
   (*m_runtimeStats)[TaskWaitThreadTime] = thread_time;
+  (*m_runtimeStats)[TaskCommSetupTime]  = setup_time;
 
   m_is_copy_data_timestep = false;
 }
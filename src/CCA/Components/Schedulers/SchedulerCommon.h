@@ -26,6 +26,7 @@
 #ifndef UINTAH_HOMEBREW_SCHEDULERCOMMON_H
 #define UINTAH_HOMEBREW_SCHEDULERCOMMON_H
 
+#include <CCA/Components/Schedulers/CompileCache.h>
 #include <CCA/Components/Schedulers/OnDemandDataWarehouseP.h>
 #include <CCA/Components/Schedulers/Relocate.h>
 #include <CCA/Ports/Scheduler.h>
@@ -40,6 +41,7 @@
 
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -316,6 +318,13 @@ class SchedulerCommon : public Scheduler, public UintahParallelComponent {
 
     void finalizeNodes( int process=0 );
 
+    // Record the executed task graph (tasks with their start and end
+    // times, internal and MPI dependencies) of the <ExecutedTaskGraph>
+    // timesteps, for StandAlone/tools/critical_path.  Called at the
+    // start and the end of execute().
+    void startGraphRecord();
+    void finishGraphRecord( DetailedTasks * dts );
+
     template< class T >
     void    printTrackedValues(       GridVariable<T> * var
                               , const IntVector       & start
@@ -342,6 +351,25 @@ class SchedulerCommon : public Scheduler, public UintahParallelComponent {
     int                                 m_generation{0};
     int                                 m_dwmap[Task::TotalDWs];
 
+    // Reuse the MPI message buffers and requests between timesteps (<cacheCommPlans>).
+    bool                                m_cache_comm_plans{true};
+
+    // Replay the dependency analysis where the grid and the load balance did not
+    // change (<incrementalCompile>), one cache per task graph.
+    bool                                m_incremental_compile{false};
+    std::vector<std::unique_ptr<CompileCache> > m_compile_caches{};
+
+    // Record a timeline of the tasks and the communication (<Trace>), dumped in the destructor.
+    bool                                m_trace{false};
+
+    // Executed task graph records (<ExecutedTaskGraph>)
+    std::vector<int>                    m_record_timesteps{};
+    std::string                         m_record_filename{"executed_graph"};
+    bool                                m_recording{false};
+    int64_t                             m_record_origin{0};
+    int                                 m_record_timestep{-1};
+    int                                 m_record_count{0};     // graphs recorded in m_record_timestep
+
     ApplicationInterface * m_application  {nullptr};
     LoadBalancer         * m_loadBalancer {nullptr};
     Output               * m_output       {nullptr};
@@ -42,6 +42,7 @@
 #include <Core/Util/DOUT.hpp>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/ProgressiveWarning.h>
+#include <Core/Util/Timers/Timers.hpp>
 
 #include <iostream>
 #include <map>
@@ -61,6 +62,7 @@ namespace {
   Dout g_detailed_task_dbg(     "TaskGraphDetailedTasks" , "TaskGraph", "high-level info on creation of DetailedTasks"        , false);
   Dout g_detailed_deps_dbg(     "TaskGraphDetailedDeps"  , "TaskGraph", "detailed dep info for each DetailedTask"             , false);
   Dout g_topological_deps_dbg(  "TopologicalDetailedDeps", "TaskGraph", "topologiocal sort detailed dependnecy info"          , false);
+  Dout g_compile_verify_dbg(    "TaskGraphCompileVerify" , "TaskGraph", "check replayed dependencies against a fresh analysis" , false);
 
 }
 
@@ -199,12 +201,16 @@ TaskGraph::createDetailedTask(       Task           * task
 //
 
 DetailedTasks*
-TaskGraph::createDetailedTasks(       bool    useInternalDeps
-                              , const GridP & grid
-                              , const GridP & oldGrid
-                              , const bool    hasDistalReqs /* = false */
+TaskGraph::createDetailedTasks(       bool           useInternalDeps
+                              , const GridP        & grid
+                              , const GridP        & oldGrid
+                              , const bool           hasDistalReqs /* = false */
+                              ,       CompileCache * compileCache  /* = nullptr */
                               )
 {
+  Timers::Simple phase_timer;
+  phase_timer.start();
+
   std::vector<Task*> sorted_tasks;
 
   nullSort(sorted_tasks);
@@ -241,6 +247,9 @@ TaskGraph::createDetailedTasks(       bool    useInternalDeps
   const std::unordered_set<int> distal_procs = m_load_balancer->getDistalNeighborhoodProcessors();
 
   m_detailed_tasks = scinew DetailedTasks(m_scheduler, m_proc_group, this, (hasDistalReqs ? distal_procs : local_procs), useInternalDeps );
+
+  m_compile_phase_times[SetupPhase] = phase_timer().seconds();
+  phase_timer.reset( true );
  
   // Go through every task, find the max ghost cell associated with each varlabel/matl, and remember that.
   //
@@ -620,9 +629,30 @@ TaskGraph::createDetailedTasks(       bool    useInternalDeps
 
   m_load_balancer->assignResources(*m_detailed_tasks);
 
+  m_compile_phase_times[DetailedTasksPhase] = phase_timer().seconds();
+  phase_timer.reset( true );
+
+  // the dependencies depend on these besides the task graph, the grids and the patch assignment
+  m_compile_cache = (compileCache && compileCache->isEnabled()) ? compileCache : nullptr;
+  if (m_compile_cache) {
+    std::ostringstream context;
+    context << m_type << ' ' << m_index << ' ' << m_proc_group->myRank() << ' ' << m_proc_group->nRanks() << ' '
+            << useInternalDeps << ' ' << hasDistalReqs << ' ' << m_load_balancer->getNthRank() << ' '
+            << m_scheduler->getMaxGhost() << ' ' << m_scheduler->getMaxDistalGhost() << ' ' << m_scheduler->getMaxLevelOffset();
+    m_compile_cache->beginCompile(context.str(), m_tasks, m_detailed_tasks, grid.get_rep(), oldGrid.get_rep(), m_load_balancer);
+  }
+
   // scrub counts are created via addScrubCount() through this call ( via possiblyCreateDependency() )
   createDetailedDependencies();
 
+  if (m_compile_cache) {
+    m_compile_cache->endCompile();
+    m_compile_cache = nullptr;
+  }
+
+  m_compile_phase_times[DependenciesPhase] = phase_timer().seconds();
+  phase_timer.reset( true );
+
   if (m_detailed_tasks->getExtraCommunication() > 0 && m_proc_group->myRank() == 0) {
     std::cout << m_proc_group->myRank() << "  Warning: Extra communication.  This taskgraph on this rank overcommunicates about "
               << m_detailed_tasks->getExtraCommunication() << " cells\n";
@@ -635,6 +665,8 @@ TaskGraph::createDetailedTasks(       bool    useInternalDeps
   m_detailed_tasks->computeLocalTasks();
   m_detailed_tasks->makeDWKeyDatabase();
 
+  m_compile_phase_times[FinalizePhase] = phase_timer().seconds();
+
   return m_detailed_tasks;
 
 } // end TaskGraph::createDetailedTasks
@@ -698,9 +730,50 @@ TaskGraph::createDetailedDependencies()
   m_num_task_phases = currphase + 1;
 
   // Go through the modifies/requires and create data dependencies as appropriate
+  std::vector<CompileCache::Dependency> replayed_deps;
   for (int i = 0; i < m_detailed_tasks->numTasks(); i++) {
     DetailedTask* dtask = m_detailed_tasks->getTask(i);
 
+    // Replay the dependencies of the last compile if nothing they depend on changed.
+    // Same calls in the same task order, so the batches come out the same.
+    const CompileCache::Log* log = m_compile_cache ? m_compile_cache->findLog(dtask) : nullptr;
+    if (log && m_compile_cache->resolve(*log, replayed_deps)) {
+
+      if (g_compile_verify_dbg) {
+        CompileCache::Log fresh;
+        m_compile_log        = &fresh;
+        m_apply_dependencies = false;
+        createDetailedDependencies(dtask, dtask->m_task->getRequires(), ct, false, PatchDependencies);
+        createDetailedDependencies(dtask, dtask->m_task->getModifies(), ct, true, PatchDependencies);
+        m_compile_log        = nullptr;
+        m_apply_dependencies = true;
+
+        if (!CompileCache::sameDependencies(fresh, *log)) {
+          std::ostringstream message;
+          message << "Rank-" << my_rank << " the replayed dependencies of " << *dtask << " (" << log->m_records.size()
+                  << ") differ from a fresh analysis (" << fresh.m_records.size() << ")";
+          SCI_THROW(InternalError(message.str(), __FILE__, __LINE__));
+        }
+      }
+
+      for (const CompileCache::Dependency& dep : replayed_deps) {
+        const CompileCache::Record& record = *dep.m_record;
+        m_detailed_tasks->possiblyCreateDependency(dep.m_from, dep.m_comp, dep.m_from_patch, dtask, dep.m_req, dep.m_to_patch,
+                                                   record.m_matl, record.m_low, record.m_high, static_cast<DetailedDep::CommCondition>(record.m_cond));
+      }
+      createDetailedDependencies(dtask, dtask->m_task->getRequires(), ct, false, ReductionDependencies);
+      createDetailedDependencies(dtask, dtask->m_task->getModifies(), ct, true, ReductionDependencies);
+
+      m_compile_cache->keepLog(dtask, *log);
+      m_compile_cache->countReplayed();
+      continue;
+    }
+
+    if (m_compile_cache) {
+      m_compile_log = m_compile_cache->newLog(dtask);
+      m_compile_cache->countRecomputed();
+    }
+
     // debug
     if (g_detailed_deps_dbg && (dtask->m_task->getRequires() != nullptr)) {
       DOUT(true, "Rank-" << my_rank << " Looking at requires of detailed task: " << *dtask);
@@ -714,6 +787,8 @@ TaskGraph::createDetailedDependencies()
     }
 
     createDetailedDependencies(dtask, dtask->m_task->getModifies(), ct, true);
+
+    m_compile_log = nullptr;
   }
 
   DOUT(g_detailed_task_dbg, "Rank-" << my_rank << " Done creating detailed tasks");
@@ -827,12 +902,21 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
                                      , Task::Dependency * req
                                      , CompTable        & ct
                                      , bool               modifies
+                                     , DependencyPass     pass /* = AllDependencies */
                                      )
 {
   int my_rank = m_proc_group->myRank();
 
   for (; req != nullptr; req = req->m_next) {
 
+    // only the tasks with patches are replayed, on those the reduction variables are the requires without patches
+    if (pass == ReductionDependencies) {
+      TypeDescription::Type vartype = req->m_var->typeDescription()->getType();
+      if (vartype != TypeDescription::ReductionVariable && vartype != TypeDescription::SoleVariable) {
+        continue;
+      }
+    }
+
 
     // ARS reduction vars seem be handled below with type checks. I
     // would say it is not not needed.
@@ -906,6 +990,12 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
 
         otherLevelLow = origLevel->mapCellToCoarser(otherLevelLow, req->m_level_offset);
         otherLevelHigh = origLevel->mapCellToCoarser(otherLevelHigh, req->m_level_offset) + ratio - IntVector(1, 1, 1);
+
+        if (m_compile_log) {
+          // the coarse patches under the patch, see Task::Dependency::getOtherLevelPatchSubset
+          IntVector pad(req->m_num_ghost_cells + 1, req->m_num_ghost_cells + 1, req->m_num_ghost_cells + 1);
+          recordFootprint(nextLevel->getCoarserLevel().get_rep(), false, otherLevelLow - pad, otherLevelHigh + pad);
+        }
       }
       else {  //This covers when req->m_patches_dom == Task::ThisLevel (single level problems)
               //or when req->m_patches_dom == Task::OtherGridDomain. (AMR problems)
@@ -922,6 +1012,14 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
         }
         otherLevelLow = origLevel->mapCellToFiner(otherLevelLow);
         otherLevelHigh = origLevel->mapCellToFiner(otherLevelHigh);
+
+        if (m_compile_log) {
+          // the fine patches over the patch, see Task::Dependency::getOtherLevelPatchSubset
+          const LevelP& fineLevel = origLevel->getFinerLevel();
+          const IntVector ratio   = fineLevel->getRefinementRatio();
+          const int ngc = (req->m_num_ghost_cells + 1) * Max(Max(ratio.x(), ratio.y()), ratio.z());
+          recordFootprint(fineLevel.get_rep(), false, otherLevelLow - IntVector(ngc, ngc, ngc), otherLevelHigh + IntVector(ngc, ngc, ngc));
+        }
       }
     }
 
@@ -958,6 +1056,10 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
                                                          low, high);
         }
 
+        if (m_compile_log) {
+          recordFootprint(patch->getLevel(), false, low, high);
+        }
+
         if (req->m_patches_dom == Task::CoarseLevel || req->m_patches_dom == Task::FineLevel) {
           // make sure the bounds of the dep are limited to the original patch's (see above)
           // also limit to current patch, as patches already loops over all patches
@@ -983,7 +1085,10 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
         else {
           origPatch = patch;
           if (req->m_num_ghost_cells > 0) {
-            patch->getLevel()->selectPatches(low, high, neighbors);
+            // Cached on the level: many requires share the same extents, and
+            // recompiles on an unchanged grid (e.g. after load balancing) find
+            // the neighbors of every patch there.
+            patch->getLevel()->selectPatches(low, high, neighbors, false, true);
           }
           else {
             neighbors.push_back(patch);
@@ -1053,6 +1158,9 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
             fromLevel->selectPatches(Max(neighbor->getExtraLowIndex(basis, req->m_var->getBoundaryLayer()) , l),
                                      Min(neighbor->getExtraHighIndex(basis, req->m_var->getBoundaryLayer()), h),
                                      fromNeighbors);
+            if (m_compile_log) {
+              recordFootprint(fromLevel.get_rep(), true, l, h);
+            }
           }
           else {
             fromNeighbors.push_back(neighbor);
@@ -1170,6 +1278,9 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
                 // before this task, which modifies the data computed by the same task
                 std::list<DetailedTask*> requireBeforeModifiedTasks;
                 creator->findRequiringTasks(req->m_var, requireBeforeModifiedTasks);
+                if (m_compile_log) {
+                  m_compile_cache->recordRequiringTasks(*m_compile_log, creator, req, requireBeforeModifiedTasks);
+                }
 
                 std::list<DetailedTask*>::iterator reqTaskIter;
                 for (reqTaskIter = requireBeforeModifiedTasks.begin(); reqTaskIter != requireBeforeModifiedTasks.end(); ++reqTaskIter) {
@@ -1212,6 +1323,9 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
                         req_patch->computeVariableExtents(req->m_var->typeDescription()->getType(), req->m_var->getBoundaryLayer(), Ghost::AroundCells, 2, low, high);
 
                         req_patch->getLevel()->selectPatches(low, high, n);
+                        if (m_compile_log) {
+                          recordFootprint(req_patch->getLevel(), false, low, high);
+                        }
                         bool found = false;
                         for (unsigned int i = 0; i < n.size(); i++) {
                           if (n[i]->getID() == p->getID()) {
@@ -1224,7 +1338,7 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
                         }
                       }
                     }
-                    m_detailed_tasks->possiblyCreateDependency(prevReqTask, nullptr, nullptr, dtask, req, nullptr, matl, from_l, from_h, DetailedDep::Always);
+                    addDetailedDependency(prevReqTask, nullptr, nullptr, dtask, req, nullptr, matl, from_l, from_h, DetailedDep::Always);
                   }
                 }
               }
@@ -1236,12 +1350,12 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
                 if (subsequentProc != proc) {
                   cond = DetailedDep::FirstIteration;  // change outer cond from always to first-only
                   DetailedTask* subsequentCreator = m_detailed_tasks->getOldDWSendTask(subsequentProc);
-                  m_detailed_tasks->possiblyCreateDependency(subsequentCreator, comp, fromNeighbor, dtask, req, patch, matl, from_l,
-                                                             from_h, DetailedDep::SubsequentIterations);
+                  addDetailedDependency(subsequentCreator, comp, fromNeighbor, dtask, req, patch, matl, from_l, from_h,
+                                        DetailedDep::SubsequentIterations);
                   DOUT(g_detailed_deps_dbg, "Rank-" << my_rank << "   Adding condition reqs for " << *req->m_var << " task : " << *creator << "  to " << *dtask);
                 }
               }
-              m_detailed_tasks->possiblyCreateDependency(creator, comp, fromNeighbor, dtask, req, patch, matl, from_l, from_h, cond);
+              addDetailedDependency(creator, comp, fromNeighbor, dtask, req, patch, matl, from_l, from_h, cond);
 
             } // forall materials
 
@@ -1254,6 +1368,10 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
     }  // if we have a valid patch AND material set
 
     else if (!patches && matls && !matls->empty()) {
+      if (pass == PatchDependencies) {
+        continue;
+      }
+
       // requiring reduction variables
       for (int m = 0; m < matls->size(); m++) {
         int matl = matls->get(m);
@@ -1333,6 +1451,43 @@ TaskGraph::createDetailedDependencies( DetailedTask     * dtask
   }
 }
 
+//______________________________________________________________________
+//
+void
+TaskGraph::addDetailedDependency(       DetailedTask              * from
+                                ,       Task::Dependency          * comp
+                                , const Patch                     * fromPatch
+                                ,       DetailedTask              * to
+                                ,       Task::Dependency          * req
+                                , const Patch                     * toPatch
+                                ,       int                         matl
+                                , const IntVector                 & low
+                                , const IntVector                 & high
+                                ,       DetailedDep::CommCondition  cond
+                                )
+{
+  if (m_compile_log) {
+    const bool fromOldGrid = (req->m_patches_dom == Task::OtherGridDomain);
+    m_compile_cache->recordDependency(*m_compile_log, from, comp, fromPatch, fromOldGrid, req, toPatch, matl, low, high, cond);
+  }
+
+  if (m_apply_dependencies) {
+    m_detailed_tasks->possiblyCreateDependency(from, comp, fromPatch, to, req, toPatch, matl, low, high, cond);
+  }
+}
+
+//______________________________________________________________________
+//
+void
+TaskGraph::recordFootprint( const Level     * level
+                          ,       bool        oldGrid
+                          , const IntVector & low
+                          , const IntVector & high
+                          )
+{
+  m_compile_cache->recordFootprint(*m_compile_log, level, oldGrid, low, high);
+}
+
 //______________________________________________________________________
 //
 int
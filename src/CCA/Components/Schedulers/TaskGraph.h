@@ -25,6 +25,8 @@
 #ifndef CCA_COMPONENTS_SCHEDULERS_TASKGRAPH_H
 #define CCA_COMPONENTS_SCHEDULERS_TASKGRAPH_H
 
+#include <CCA/Components/Schedulers/CompileCache.h>
+#include <CCA/Components/Schedulers/DetailedDependency.h>
 #include <CCA/Ports/Scheduler.h>
 
 #include <Core/Containers/FastHashTable.h>
@@ -207,11 +209,14 @@ class TaskGraph {
     /// and loads them into a new DetailedTasks object. (There is one
     /// DetailedTask for each PatchSubset and MaterialSubset in a Task,
     /// where a Task may have many PatchSubsets and MaterialSubsets.).
-    /// Sorts using nullSort.
-    DetailedTasks* createDetailedTasks(       bool    useInternalDeps
-                                      , const GridP & grid
-                                      , const GridP & oldGrid
-                                      , const bool    hasDistalReqs = false
+    /// Sorts using nullSort.  With a compileCache, the dependency analysis
+    /// of the last compile of this graph is replayed where the grid and
+    /// the load balance did not change (see CompileCache).
+    DetailedTasks* createDetailedTasks(       bool           useInternalDeps
+                                      , const GridP        & grid
+                                      , const GridP        & oldGrid
+                                      , const bool           hasDistalReqs = false
+                                      ,       CompileCache * compileCache  = nullptr
                                       );
 
     inline DetailedTasks* getDetailedTasks()
@@ -277,6 +282,25 @@ class TaskGraph {
       return m_has_distal_requires;
     }
 
+    /// The phases of createDetailedTasks, timed separately:
+    ///   SetupPhase         - sorting the tasks and creating the neighborhoods
+    ///   DetailedTasksPhase - creating the DetailedTasks and assigning resources
+    ///   DependenciesPhase  - createDetailedDependencies
+    ///   FinalizePhase      - message tags, local tasks and the DW key database
+    enum CompilePhase {
+        SetupPhase = 0
+      , DetailedTasksPhase
+      , DependenciesPhase
+      , FinalizePhase
+      , NumCompilePhases
+    };
+
+    /// Seconds spent in a phase by the last createDetailedTasks call.
+    inline double getCompilePhaseTime( CompilePhase phase ) const
+    {
+      return m_compile_phase_times[phase];
+    }
+
     /// Makes and returns a map that associates VarLabel names with
     /// the materials the variable is computed for.
     using VarLabelMaterialMap = std::map<std::string, std::list<int> >;
@@ -303,12 +327,43 @@ class TaskGraph {
     /// what addDependencyEdges (removed) did for setupTaskConnections.
     /// This will set up the data dependencies that need to be communicated
     /// between processors.
+    /// Which dependencies of a task the private createDetailedDependencies creates:
+    /// those of the requires of reduction variables are never replayed from the
+    /// CompileCache.
+    enum DependencyPass {
+        AllDependencies
+      , PatchDependencies
+      , ReductionDependencies
+    };
+
     void createDetailedDependencies( DetailedTask     * dtask
                                    , Task::Dependency * req
                                    , CompTable        & ct
                                    , bool               modifies
+                                   , DependencyPass     pass = AllDependencies
                                    );
 
+    /// Creates (and records into m_compile_log) a dependency, see
+    /// DetailedTasks::possiblyCreateDependency.
+    void addDetailedDependency(       DetailedTask              * from
+                              ,       Task::Dependency          * comp
+                              , const Patch                     * fromPatch
+                              ,       DetailedTask              * to
+                              ,       Task::Dependency          * req
+                              , const Patch                     * toPatch
+                              ,       int                         matl
+                              , const IntVector                 & low
+                              , const IntVector                 & high
+                              ,       DetailedDep::CommCondition  cond
+                              );
+
+    /// Adds the cells the dependency analysis looked at to m_compile_log.
+    void recordFootprint( const Level     * level
+                        ,       bool        oldGrid
+                        , const IntVector & low
+                        , const IntVector & high
+                        );
+
     /// Makes a DetailedTask from task with given PatchSubset and MaterialSubset.
     void createDetailedTask(       Task           * task
                            , const PatchSubset    * patches
@@ -364,6 +419,16 @@ class TaskGraph {
     // does this TG contain requires with halo > MAX_HALO_DEPTH
     bool m_has_distal_requires{false};
 
+    // seconds per CompilePhase of the last compile
+    double m_compile_phase_times[NumCompilePhases]{};
+
+    // the cache of the compile in progress, the log of the DetailedTask
+    // being analyzed, and whether its dependencies are created or only
+    // recorded (to verify a replayed log)
+    CompileCache      * m_compile_cache{nullptr};
+    CompileCache::Log * m_compile_log{nullptr};
+    bool                m_apply_dependencies{true};
+
     std::vector<std::shared_ptr<Task> > m_tasks{};
 
 
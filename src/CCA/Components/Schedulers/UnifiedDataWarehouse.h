@@ -265,6 +265,8 @@ public:
   // this is so we can get reduction information for regridding
   virtual void getVarLabelMatlLevelTriples(std::vector<VarLabelMatl<Level> >& vars ) const = 0;
 
+  virtual void getPatchDataSizes(std::map<const Patch*, size_t>& sizes) const = 0;
+
   // Remove particles that are no longer relevant
   virtual void deleteParticles(ParticleSubset* delset) = 0;
 
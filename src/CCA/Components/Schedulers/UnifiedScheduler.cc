@@ -38,6 +38,7 @@
 #include <Core/Parallel/MasterLock.h>
 #include <Core/Util/DOUT.hpp>
 #include <Core/Util/Timers/Timers.hpp>
+#include <Core/Util/Tracer.h>
 
 #include <sci_defs/cuda_defs.h>
 
@@ -150,10 +151,15 @@ void thread_driver( const int tid )
 {
   // t_tid is a thread_local variable, unique to each std::thread spawned below
   t_tid = tid;
+  DetailedTasks::setWorkerQueueID(tid);
 
   // set each TaskWorker thread's affinity
   set_affinity( g_cpu_affinities[tid] );
 
+  if (Tracer::isEnabled()) {
+    Tracer::setThreadName("worker " + std::to_string(tid));
+  }
+
   try {
     // wait until main thread sets function and changes states
     g_thread_states[tid] = ThreadState::Inactive;
@@ -216,6 +222,7 @@ void init_threads( UnifiedScheduler * sched, int num_threads )
   // set main thread's affinity (core-0) and tid
   set_affinity(g_cpu_affinities[0]);
   t_tid = 0;
+  DetailedTasks::setWorkerQueueID(0);
 
   // TaskRunner threads start at g_runners[1]
   for (int i = 1; i < g_num_threads; ++i) {
@@ -371,13 +378,25 @@ UnifiedScheduler::problemSetup( const ProblemSpecP     & prob_spec
     else if (taskQueueAlg == "PatchOrderRandom") {
       m_task_queue_alg = PatchOrderRandom;
     }
+    else if (taskQueueAlg == "PredictedCost") {
+      m_task_queue_alg = PredictedCost;
+    }
+    else if (taskQueueAlg == "CriticalPath") {
+      m_task_queue_alg = CriticalPath;
+    }
     else {
       throw ProblemSetupException("Unknown task ready queue algorithm", __FILE__, __LINE__);
     }
+
+    params->getWithDefault("workStealing", m_work_stealing, false);
   }
 
   proc0cout << "Using \"" << taskQueueAlg << "\" task queue priority algorithm" << std::endl;
 
+  if (m_work_stealing) {
+    proc0cout << "Using per-thread work-stealing task ready queues" << std::endl;
+  }
+
   int num_threads = Uintah::Parallel::getNumThreads() - 1;
 
   if ( (num_threads < 1) &&  Uintah::Parallel::usingDevice() ) {
@@ -485,6 +504,11 @@ UnifiedScheduler::problemSetup( const ProblemSpecP     & prob_spec
     m_thread_info.insert( WaitTime  , std::string("WaitTime")  , "seconds" );
     m_thread_info.insert( NumTasks  , std::string("NumTasks")  , "tasks"   );
     m_thread_info.insert( NumPatches, std::string("NumPatches"), "patches" );
+
+    if (m_work_stealing) {
+      m_thread_info.insert( NumSteals      , std::string("NumSteals")      , "tasks"    );
+      m_thread_info.insert( NumFailedSteals, std::string("NumFailedSteals"), "attempts" );
+    }
     
     m_thread_info.calculateMinimum(true);
     m_thread_info.calculateStdDev (true);
@@ -666,6 +690,9 @@ UnifiedScheduler::execute( int tgnum       /* = 0 */
     return;
   }
 
+  Tracer::Scope trace(Tracer::Execute);
+  trace.setArgs(tgnum, iteration);
+
   // track total scheduler execution time across timesteps
   m_exec_timer.reset(true);
 
@@ -690,6 +717,7 @@ UnifiedScheduler::execute( int tgnum       /* = 0 */
   }
 
   m_detailed_tasks->initializeScrubs(m_dws, m_dwmap);
+  m_detailed_tasks->setNumWorkerQueues(m_work_stealing ? Impl::g_num_threads : 0);
   m_detailed_tasks->initTimestep();
 
   m_num_tasks = m_detailed_tasks->numLocalTasks();
@@ -706,6 +734,9 @@ UnifiedScheduler::execute( int tgnum       /* = 0 */
   // This only happens if "-emit_taskgraphs" is passed to sus
   makeTaskGraphDoc(m_detailed_tasks, my_rank);
 
+  // This only happens for the <ExecutedTaskGraph> timesteps
+  startGraphRecord();
+
   mpi_info_.reset( 0 );
   m_thread_info.reset( 0 );
 
@@ -812,6 +843,8 @@ UnifiedScheduler::execute( int tgnum       /* = 0 */
     proc0cout << "average queue length:" << allqueuelength / d_myworld->nRanks() << std::endl;
   }
 
+  finishGraphRecord(m_detailed_tasks);
+
   finalizeTimestep();
 
   m_exec_timer.stop();
@@ -827,6 +860,19 @@ UnifiedScheduler::execute( int tgnum       /* = 0 */
         m_thread_info[i][WaitTime] = Impl::g_runners[i]->getWaitTime();
     }
 
+    // Work-stealing stats - the main thread (queue 0) also executes tasks
+    if (m_detailed_tasks->usingWorkStealing()) {
+      for (int i = 0; i < Impl::g_num_threads; ++i) {
+        (*m_runtimeStats)[NumTaskSteals]       += m_detailed_tasks->getNumSteals(i);
+        (*m_runtimeStats)[NumFailedTaskSteals] += m_detailed_tasks->getNumFailedSteals(i);
+
+        if( i > 0 && (g_thread_stats || g_thread_indv_stats) ) {
+          m_thread_info[i][NumSteals]       = m_detailed_tasks->getNumSteals(i);
+          m_thread_info[i][NumFailedSteals] = m_detailed_tasks->getNumFailedSteals(i);
+        }
+      }
+    }
+
     MPIScheduler::computeNetRuntimeStats();
   }
 
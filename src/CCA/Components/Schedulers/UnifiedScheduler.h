@@ -115,6 +115,8 @@ class UnifiedScheduler : public MPIScheduler  {
         WaitTime
       , NumTasks
       , NumPatches
+      , NumSteals
+      , NumFailedSteals
     };
     
     VectorInfoMapper< ThreadStatsEnum, double > m_thread_info;
@@ -143,6 +145,7 @@ class UnifiedScheduler : public MPIScheduler  {
     DetailedTasks              * m_detailed_tasks{nullptr};
 
     QueueAlg m_task_queue_alg{MostMessages};
+    bool     m_work_stealing{false};   // per-thread ready queues, see DetailedTasks::setNumWorkerQueues()
     int      m_curr_iteration{0};
     int      m_num_tasks_done{0};
     int      m_num_tasks{0};
@@ -29,6 +29,8 @@ include $(SCIRUN_SCRIPTS)/smallso_prologue.mk
 SRCDIR := CCA/Components/Schedulers
 
 SRCS += \
+        $(SRCDIR)/CommPlanCache.cc            \
+        $(SRCDIR)/CompileCache.cc             \
         $(SRCDIR)/DependencyBatch.cc          \
         $(SRCDIR)/DependencyException.cc      \
         $(SRCDIR)/DetailedDependency.cc       \
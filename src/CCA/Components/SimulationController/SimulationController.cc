@@ -29,6 +29,7 @@
 #include <Core/Grid/Grid.h>
 #include <Core/Grid/MaterialManager.h>
 #include <Core/Grid/Variables/VarTypes.h>
+#include <Core/Grid/Variables/VariableMemoryPool.h>
 #include <Core/OS/Dir.h>
 #include <Core/OS/ProcessInfo.h>
 #include <Core/Parallel/Parallel.h>
@@ -125,12 +126,22 @@ SimulationController::SimulationController( const ProcessorGroup * myworld
   m_runtime_stats.insert( RegriddingCompilationTime, std::string("RegriddingCompilation"), timeStr );
   m_runtime_stats.insert( RegriddingCopyDataTime,    std::string("RegriddingCopyData"),    timeStr );
   m_runtime_stats.insert( LoadBalancerTime,          std::string("LoadBalancer"),          timeStr );
+  m_runtime_stats.insert( LoadBalancerMigration,     std::string("LoadBalancerMigration"), bytesStr );
+
+  m_runtime_stats.insert( CompileSetupTime,          std::string("CompileSetup"),          timeStr );
+  m_runtime_stats.insert( CompileDetailedTasksTime,  std::string("CompileDetailedTasks"),  timeStr );
+  m_runtime_stats.insert( CompileDependenciesTime,   std::string("CompileDependencies"),   timeStr );
+  m_runtime_stats.insert( CompileFinalizeTime,       std::string("CompileFinalize"),       timeStr );
 
   m_runtime_stats.insert( TaskExecTime,              std::string("TaskExec"),              timeStr );
   m_runtime_stats.insert( TaskLocalCommTime,         std::string("TaskLocalComm"),         timeStr );
   m_runtime_stats.insert( TaskWaitCommTime,          std::string("TaskWaitCommTime"),      timeStr );
   m_runtime_stats.insert( TaskReduceCommTime,        std::string("TaskReduceCommTime"),    timeStr );
   m_runtime_stats.insert( TaskWaitThreadTime,        std::string("TaskWaitThread"),        timeStr );
+  m_runtime_stats.insert( TaskCommSetupTime,         std::string("TaskCommSetup"),         timeStr );
+
+  m_runtime_stats.insert( NumTaskSteals,             std::string("NumberOfTaskSteals"),       "tasks" );
+  m_runtime_stats.insert( NumFailedTaskSteals,       std::string("NumberOfFailedTaskSteals"), "attempts" );
 
   m_runtime_stats.insert( XMLIOTime,                 std::string("XMLIO"),                 timeStr );
   m_runtime_stats.insert( OutputIOTime,              std::string("OutputIO"),              timeStr );
@@ -155,6 +166,9 @@ SimulationController::SimulationController( const ProcessorGroup * myworld
   m_runtime_stats.insert( MemoryUsed,                std::string("MemoryUsed"),            bytesStr );
   m_runtime_stats.insert( MemoryResident,            std::string("MemoryResident"),        bytesStr );
 
+  m_runtime_stats.insert( VariablePoolHitRate,       std::string("VariablePoolHitRate"),   "%" );
+  m_runtime_stats.insert( VariablePoolRetained,      std::string("VariablePoolRetained"),  bytesStr );
+
   m_runtime_stats.calculateRankMinimum(true);
   m_runtime_stats.calculateRankStdDev (true);
 
@@ -561,6 +575,15 @@ void SimulationController::ResetStats( void )
 {
   m_runtime_stats.reset( 0 );
   m_application->resetApplicationStats( 0 );
+
+#ifdef HAVE_VISIT
+  bool reduce = getVisIt();
+#else
+  bool reduce = false;
+#endif
+
+  // Stats that are not reported need not be collected.
+  m_application->setApplicationStatsEnabled( g_app_stats || g_app_node_stats || reduce );
 }
 
 //______________________________________________________________________
@@ -881,6 +904,14 @@ SimulationController::getMemoryStats( bool create /* = false */ )
     m_runtime_stats[MemoryResident] = ProcessInfo::getMemoryResident();
   }
 
+  if (VariableMemoryPool::getBudget() > 0) {
+    VariableMemoryPool::Stats pool = VariableMemoryPool::getStats();
+    const unsigned long requests = pool.m_hits + pool.m_misses;
+
+    m_runtime_stats[VariablePoolHitRate]  = requests ? 100.0 * pool.m_hits / requests : 0.0;
+    m_runtime_stats[VariablePoolRetained] = pool.m_retainedBytes;
+  }
+
   // Get memory stats for each proc if MALLOC_PERPROC is in the environment.
   if (getenv("MALLOC_PERPROC")) {
     std::ostream* mallocPerProcStream = nullptr;
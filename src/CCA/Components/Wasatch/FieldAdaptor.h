@@ -339,7 +339,8 @@ namespace WasatchCore{
 
     const Uintah::IntVector lowIx       = uintahVar.getLowIndex();
     const Uintah::IntVector highIx      = uintahVar.getHighIndex();
-    const Uintah::IntVector fieldSize   = uintahVar.getWindow()->getData()->size();
+    // the allocated size, so that padded x-rows are laid out correctly
+    const Uintah::IntVector fieldSize   = uintahVar.getWindow()->getData()->allocatedSize();
     const Uintah::IntVector fieldOffset = uintahVar.getWindow()->getOffset();
     const Uintah::IntVector fieldExtent = highIx - lowIx;
     
@@ -317,6 +317,10 @@ WARNING
       
     virtual void reduceApplicationStats( bool allReduce, const ProcessorGroup* myWorld ) = 0;
 
+    // True if the application stats are reported this time step.
+    virtual void setApplicationStatsEnabled( bool val ) = 0;
+    virtual bool getApplicationStatsEnabled() const = 0;
+
     virtual void   setDelTOverrideRestart( double val ) = 0;
     virtual double getDelTOverrideRestart() const = 0;
 
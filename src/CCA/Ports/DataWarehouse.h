@@ -48,6 +48,7 @@
 #endif
 
 #include <iosfwd>
+#include <map>
 
 
 namespace Uintah {
@@ -247,6 +248,10 @@ public:
   // this is so we can get reduction information for regridding
   virtual void getVarLabelMatlLevelTriples(std::vector<VarLabelMatl<Level> >& vars ) const = 0;
 
+  // Bytes of the patch variables on each patch, for estimating how much data a new load
+  // balance would move.
+  virtual void getPatchDataSizes(std::map<const Patch*, size_t>& sizes) const = 0;
+
   // Remove particles that are no longer relevant
   virtual void deleteParticles(ParticleSubset* delset) = 0;
 
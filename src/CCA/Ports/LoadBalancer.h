@@ -173,6 +173,9 @@ public:
   // Update the contribution for this patch.
   virtual void addContribution( DetailedTask *task, double cost ) = 0;
 
+  // Predicted execution time of the task (in seconds), 0 if there is no model for it.
+  virtual double predictContribution( DetailedTask *task ) = 0;
+
   // Finalize the contributions (updates the weight, should be called once per timestep).
   virtual void finalizeContributions( const GridP & currentgrid ) = 0;
 
@@ -27,6 +27,8 @@
 
 #include <Core/ProblemSpec/ProblemSpec.h>
 
+#include <string>
+
 namespace Uintah {
    /**************************************
      
@@ -62,6 +64,15 @@ namespace Uintah {
 	: fd(fd), filename(filename), cur(cur), varnode(varnode), outputDoubleAsFloat(outputDoubleAsFloat)
       {
       }
+
+      // Staging context used by the asynchronous output: the variable
+      // is serialized into 'staging' and neither compressed nor
+      // written.  The requested compression mode is left in
+      // 'compressionMode' for whoever writes the buffer out.
+      OutputContext(std::string* staging, const char* filename, ProblemSpecP varnode, bool outputDoubleAsFloat = false)
+	: fd(-1), filename(filename), cur(0), varnode(varnode), outputDoubleAsFloat(outputDoubleAsFloat), staging(staging)
+      {
+      }
       ~OutputContext() {}
 
       int fd;
@@ -69,6 +80,13 @@ namespace Uintah {
       long cur;
       ProblemSpecP varnode;
       bool outputDoubleAsFloat;
+
+      std::string* staging{nullptr};
+      std::string  compressionMode;
+
+      // Set by Variable::emit when it compresses the data.
+      size_t uncompressedSize{0};
+      double compressionSeconds{0};
    private:
       OutputContext(const OutputContext&);
       OutputContext& operator=(const OutputContext&);
@@ -2092,6 +2092,16 @@ DataArchive::TimeData::init()
         if( level >= d_xmlFilenames.size() ) {
           d_xmlFilenames.resize( level +1 );
           d_xmlParsed.resize(    level + 1 );
+          d_rankXmlIndex.resize( level + 1 );
+        }
+
+        // Aggregated output lists the ranks whose data the file holds.
+        string ranks = attributes[ "ranks" ];
+        if( ranks != "" ) {
+          ConsecutiveRangeSet rankSet( ranks );
+          for( ConsecutiveRangeSet::iterator iter = rankSet.begin(); iter != rankSet.end(); ++iter ) {
+            d_rankXmlIndex[ level ][ *iter ] = d_xmlFilenames[ level ].size();
+          }
         }
 
         string filename = d_ts_directory + datafile;
@@ -2125,6 +2135,7 @@ DataArchive::TimeData::purgeCache()
   d_varInfo.clear();
   d_xmlFilenames.clear();
   d_xmlParsed.clear();
+  d_rankXmlIndex.clear();
   d_initialized = false;
 }
 
@@ -2280,7 +2291,17 @@ DataArchive::TimeData::parsePatch( const Patch * patch )
 
   // If this is a newer uda, the patch info in the grid will store the
   // processor where the data is.
-  if( patchinfo.proc != -1 ) {
+  if( patchinfo.proc != -1 && levelIndex < (int) d_rankXmlIndex.size() &&
+      d_rankXmlIndex[ levelIndex ].count( patchinfo.proc ) ) {
+    // Aggregated output - the file holds the patches of many ranks,
+    // only parse it once.
+    int index = d_rankXmlIndex[ levelIndex ][ patchinfo.proc ];
+    if( !d_xmlParsed[ levelIndex ][ index ] ) {
+      parseFile( d_xmlFilenames[ levelIndex ][ index ], levelIndex, levelBasePatchID );
+      d_xmlParsed[ levelIndex ][ index ] = true;
+    }
+  }
+  else if( patchinfo.proc != -1 ) {
     ostringstream file;
     file << d_ts_directory << "l" << (int) real_patch->getLevel()->getIndex() << "/p" << setw(5) << setfill('0') << (int) patchinfo.proc << ".xml";
     parseFile( file.str(), levelIndex, levelBasePatchID );
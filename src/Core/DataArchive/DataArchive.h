@@ -50,6 +50,7 @@
 #endif
 
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -414,6 +415,10 @@ private:
     std::vector< std::vector<std::string> > d_xmlFilenames;
     std::vector< std::vector<bool> >        d_xmlParsed;
 
+    // For aggregated output (one axxxxx.xml file holds the data of a
+    // group of ranks): rank -> index into d_xmlFilenames, per level.
+    std::vector< std::map<int, int> >      d_rankXmlIndex;
+
     std::string   d_globaldata;
 
     ConsecutiveRangeSet d_matls;  // materials available this timestep
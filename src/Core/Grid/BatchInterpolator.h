@@ -0,0 +1,987 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CORE_GRID_BATCHINTERPOLATOR_H
+#define CORE_GRID_BATCHINTERPOLATOR_H
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Geometry/Point.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/ParticleInterpolator.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Math/MiscMath.h>
+#include <Core/Util/Assert.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    BatchInterpolator
+
+  GENERAL INFORMATION
+    BatchInterpolator.h
+
+  DESCRIPTION
+    Computes the node indices, weights and (optionally) shape function
+    derivatives of a block of up to BLOCK particles at once, into the
+    fixed size structure of arrays of an InterpolationBlock, usually on
+    the stack.
+
+    The shape functions are selected at compile time by the kernel:
+
+      LinearKernel  - same nodes and weights as LinearInterpolator
+      GIMPKernel    - same nodes and weights as GIMPInterpolator
+      cpdiKernel    - same nodes and weights as cpdiInterpolator
+      TOBSplineKernel - same nodes and weights as TOBSplineInterpolator
+      BSplineKernel - same weights as BSplineInterpolator, the nodes
+                      left out next to the domain boundary are given
+                      zero weights instead
+      VirtualKernel - any ParticleInterpolator through its virtual
+                      interface (axisymmetric, cpti, ...)
+
+    The specialized kernels are inlined into the loop over the block,
+    their node count is a compile time constant and there are no
+    per particle virtual calls or std::vector accesses.  They evaluate
+    the same expressions in the same order as the ParticleInterpolator
+    they replace, so the results agree up to the compiler's freedom
+    (e.g. fused multiply-adds).  As with the ParticleInterpolators the
+    derivatives are with respect to the cell index space, i.e. they
+    still have to be multiplied by 1/dx.
+
+    One BatchInterpolator per thread, like the ParticleInterpolators.
+
+****************************************/
+
+  //______________________________________________________________________
+  // Entry [n][p] is node n of particle p of the block.
+  template<int NODES, int BLOCK>
+  struct InterpolationBlock {
+
+    static const int maxNodes  = NODES;
+    static const int blockSize = BLOCK;
+
+    int    count;                 // particles in the block
+
+    int    ni_x[NODES][BLOCK];
+    int    ni_y[NODES][BLOCK];
+    int    ni_z[NODES][BLOCK];
+
+    double S[NODES][BLOCK];
+
+    double dS_x[NODES][BLOCK];    // only set if gradients were requested
+    double dS_y[NODES][BLOCK];
+    double dS_z[NODES][BLOCK];
+
+    IntVector node( int n, int p ) const
+    {
+      return IntVector( ni_x[n][p], ni_y[n][p], ni_z[n][p] );
+    }
+
+    Vector gradient( int n, int p ) const
+    {
+      return Vector( dS_x[n][p], dS_y[n][p], dS_z[n][p] );
+    }
+  };
+
+  //______________________________________________________________________
+  //  The kernels.  compute<GRADIENTS>() fills nodes [0, size()) of the
+  //  n particles of the block from the positions in cell index space
+  //  (cx, cy, cz), the physical positions and the particle sizes.
+  //  The inputs are padded to the full block, so the specialized
+  //  kernels always compute whole blocks: the per particle work first,
+  //  into arrays over the block, then the nodes in fixed length loops
+  //  over the block's particles the compiler can vectorize.
+
+  //______________________________________________________________________
+  //
+  struct LinearKernel {
+
+    static const int nodes = 8;
+
+    int size() const { return nodes; }
+
+    template<bool GRADIENTS, class Block>
+    void compute( const double  * cx
+                , const double  * cy
+                , const double  * cz
+                , const Point   * const * /* pos */
+                , const Matrix3 * const * /* size */
+                , int             /* n */
+                , Block         & b
+                )
+    {
+      const int B = Block::blockSize;
+
+      int    ix[B], iy[B], iz[B];
+      double wx[2][B], wy[2][B], wz[2][B];
+
+      for( int p = 0; p < B; p++ ) {
+        ix[p] = Floor( cx[p] );
+        iy[p] = Floor( cy[p] );
+        iz[p] = Floor( cz[p] );
+
+        const double fx = cx[p] - ix[p];
+        const double fy = cy[p] - iy[p];
+        const double fz = cz[p] - iz[p];
+
+        wx[0][p] = 1 - fx;  wx[1][p] = fx;
+        wy[0][p] = 1 - fy;  wy[1][p] = fy;
+        wz[0][p] = 1 - fz;  wz[1][p] = fz;
+      }
+
+      // z varies fastest, as in LinearInterpolator
+      for( int i = 0; i < 2; i++ ) {
+        for( int j = 0; j < 2; j++ ) {
+          for( int k = 0; k < 2; k++ ) {
+            const int m = 4*i + 2*j + k;
+
+            for( int p = 0; p < B; p++ ) {
+              b.ni_x[m][p] = ix[p] + i;
+              b.ni_y[m][p] = iy[p] + j;
+              b.ni_z[m][p] = iz[p] + k;
+              b.S[m][p]    = wx[i][p] * wy[j][p] * wz[k][p];
+            }
+
+            if( GRADIENTS ) {
+              const double dx = i ? 1. : -1.;
+              const double dy = j ? 1. : -1.;
+              const double dz = k ? 1. : -1.;
+              for( int p = 0; p < B; p++ ) {
+                b.dS_x[m][p] = dx       * wy[j][p] * wz[k][p];
+                b.dS_y[m][p] = wx[i][p] * dy       * wz[k][p];
+                b.dS_z[m][p] = wx[i][p] * wy[j][p] * dz;
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  //______________________________________________________________________
+  //
+  struct GIMPKernel {
+
+    static const int nodes = 27;
+
+    int size() const { return nodes; }
+
+    // The 1D weights and derivatives of the nodes i, i+1 and i+nn for
+    // a particle at c with half width l, see GIMPInterpolator.
+    static inline void axis( double c, double l, int ni[3], double f[3], double df[3] )
+    {
+      const int i  = Floor( c );
+      const int nn = ( c - i <= .5 ) ? -1 : 2;
+
+      ni[0] = i;
+      ni[1] = i + 1;
+      ni[2] = i + nn;
+
+      // (x_p - x_v)/L
+      const double p0 = c - ( i );
+      const double p1 = c - ( i + 1 );
+      const double p2 = c - ( i + nn );
+
+      if( p0 <= l ) {
+        f[0]  = 1. - ( p0*p0 + l*l )/( 2.*l );
+        f[1]  = ( 1. + l + p1 )*( 1. + l + p1 )/( 4.*l );
+        f[2]  = ( 1. + l - p2 )*( 1. + l - p2 )/( 4.*l );
+        df[0] = -p0/l;
+        df[1] =  ( 1. + l + p1 )/( 2.*l );
+        df[2] = -( 1. + l - p2 )/( 2.*l );
+      }
+      else if( p0 <= ( 1. - l ) ) {
+        f[0]  = 1. - p0;
+        f[1]  = 1. + p1;
+        f[2]  = 0.;
+        df[0] = -1.;
+        df[1] =  1.;
+        df[2] =  0.;
+      }
+      else {
+        f[0]  = ( 1. + l - p0 )*( 1. + l - p0 )/( 4.*l );
+        f[1]  = 1. - ( p1*p1 + l*l )/( 2.*l );
+        f[2]  = ( 1. + l + p2 )*( 1. + l + p2 )/( 4.*l );
+        df[0] = -( 1. + l - p0 )/( 2.*l );
+        df[1] = -p1/l;
+        df[2] = ( 1. + l + p2 )/( 2.*l );
+      }
+    }
+
+    template<bool GRADIENTS, class Block>
+    void compute( const double  * cx
+                , const double  * cy
+                , const double  * cz
+                , const Point   * const * /* pos */
+                , const Matrix3 * const * size
+                , int             /* n */
+                , Block         & b
+                )
+    {
+      const int B = Block::blockSize;
+
+      int    nx[3][B], ny[3][B], nz[3][B];
+      double fx[3][B], fy[3][B], fz[3][B];
+      double dfx[3][B], dfy[3][B], dfz[3][B];
+
+      for( int p = 0; p < B; p++ ) {
+        int    ni[3];
+        double f[3];
+        double df[3];
+
+        axis( cx[p], (*size[p])( 0, 0 )/2., ni, f, df );
+        for( int i = 0; i < 3; i++ ) {
+          nx[i][p] = ni[i];  fx[i][p] = f[i];  dfx[i][p] = df[i];
+        }
+        axis( cy[p], (*size[p])( 1, 1 )/2., ni, f, df );
+        for( int i = 0; i < 3; i++ ) {
+          ny[i][p] = ni[i];  fy[i][p] = f[i];  dfy[i][p] = df[i];
+        }
+        axis( cz[p], (*size[p])( 2, 2 )/2., ni, f, df );
+        for( int i = 0; i < 3; i++ ) {
+          nz[i][p] = ni[i];  fz[i][p] = f[i];  dfz[i][p] = df[i];
+        }
+      }
+
+      // x varies fastest, as in GIMPInterpolator
+      for( int k = 0; k < 3; k++ ) {
+        for( int j = 0; j < 3; j++ ) {
+          for( int i = 0; i < 3; i++ ) {
+            const int m = 9*k + 3*j + i;
+
+            for( int p = 0; p < B; p++ ) {
+              b.ni_x[m][p] = nx[i][p];
+              b.ni_y[m][p] = ny[j][p];
+              b.ni_z[m][p] = nz[k][p];
+              b.S[m][p]    = fx[i][p] * fy[j][p] * fz[k][p];
+            }
+
+            if( GRADIENTS ) {
+              for( int p = 0; p < B; p++ ) {
+                b.dS_x[m][p] = dfx[i][p] * fy[j][p]  * fz[k][p];
+                b.dS_y[m][p] = fx[i][p]  * dfy[j][p] * fz[k][p];
+                b.dS_z[m][p] = fx[i][p]  * fy[j][p]  * dfz[k][p];
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  //______________________________________________________________________
+  //
+  struct cpdiKernel {
+
+    static const int nodes = 64;
+
+    explicit cpdiKernel( double lcrit = 1.e10 ) : m_lcrit( lcrit ) {}
+
+    int size() const { return nodes; }
+
+    // Position of corner c of the particle domain relative to its center
+    static inline Vector corner( const Matrix3 & d, int c )
+    {
+      const double s1 = ( c == 1 || c == 2 || c == 5 || c == 6 ) ? 1. : -1.;
+      const double s2 = ( c == 2 || c == 3 || c == 6 || c == 7 ) ? 1. : -1.;
+      const double s3 = ( c >= 4 ) ? 1. : -1.;
+      return Vector( s1*d( 0, 0 ) + s2*d( 0, 1 ) + s3*d( 0, 2 ),
+                     s1*d( 1, 0 ) + s2*d( 1, 1 ) + s3*d( 1, 2 ),
+                     s1*d( 2, 0 ) + s2*d( 2, 1 ) + s3*d( 2, 2 ) )*0.5;
+    }
+
+    // The gradient coefficients of the corners, see cpdiInterpolator.
+    static inline void gradientCoefficients( const Matrix3 & dsize, Vector alpha[8] )
+    {
+      const Vector r1( dsize( 0, 0 ), dsize( 1, 0 ), dsize( 2, 0 ) );
+      const Vector r2( dsize( 0, 1 ), dsize( 1, 1 ), dsize( 2, 1 ) );
+      const Vector r3( dsize( 0, 2 ), dsize( 1, 2 ), dsize( 2, 2 ) );
+
+      const double one_over_4V = 1.0/( 4.0*dsize.Determinant() );
+
+      alpha[0][0] = one_over_4V*(-r2[1]*r3[2]+r2[2]*r3[1]+r1[1]*r3[2]-r1[2]*r3[1]-r1[1]*r2[2]+r1[2]*r2[1]);
+      alpha[0][1] = one_over_4V*( r2[0]*r3[2]-r2[2]*r3[0]-r1[0]*r3[2]+r1[2]*r3[0]+r1[0]*r2[2]-r1[2]*r2[0]);
+      alpha[0][2] = one_over_4V*(-r2[0]*r3[1]+r2[1]*r3[0]+r1[0]*r3[1]-r1[1]*r3[0]-r1[0]*r2[1]+r1[1]*r2[0]);
+
+      alpha[1][0] = one_over_4V*( r2[1]*r3[2]-r2[2]*r3[1]+r1[1]*r3[2]-r1[2]*r3[1]-r1[1]*r2[2]+r1[2]*r2[1]);
+      alpha[1][1] = one_over_4V*(-r2[0]*r3[2]+r2[2]*r3[0]-r1[0]*r3[2]+r1[2]*r3[0]+r1[0]*r2[2]-r1[2]*r2[0]);
+      alpha[1][2] = one_over_4V*( r2[0]*r3[1]-r2[1]*r3[0]+r1[0]*r3[1]-r1[1]*r3[0]-r1[0]*r2[1]+r1[1]*r2[0]);
+
+      alpha[2][0] = one_over_4V*( r2[1]*r3[2]-r2[2]*r3[1]-r1[1]*r3[2]+r1[2]*r3[1]-r1[1]*r2[2]+r1[2]*r2[1]);
+      alpha[2][1] = one_over_4V*(-r2[0]*r3[2]+r2[2]*r3[0]+r1[0]*r3[2]-r1[2]*r3[0]+r1[0]*r2[2]-r1[2]*r2[0]);
+      alpha[2][2] = one_over_4V*( r2[0]*r3[1]-r2[1]*r3[0]-r1[0]*r3[1]+r1[1]*r3[0]-r1[0]*r2[1]+r1[1]*r2[0]);
+
+      alpha[3][0] = one_over_4V*(-r2[1]*r3[2]+r2[2]*r3[1]-r1[1]*r3[2]+r1[2]*r3[1]-r1[1]*r2[2]+r1[2]*r2[1]);
+      alpha[3][1] = one_over_4V*( r2[0]*r3[2]-r2[2]*r3[0]+r1[0]*r3[2]-r1[2]*r3[0]+r1[0]*r2[2]-r1[2]*r2[0]);
+      alpha[3][2] = one_over_4V*(-r2[0]*r3[1]+r2[1]*r3[0]-r1[0]*r3[1]+r1[1]*r3[0]-r1[0]*r2[1]+r1[1]*r2[0]);
+
+      alpha[4][0] = one_over_4V*(-r2[1]*r3[2]+r2[2]*r3[1]+r1[1]*r3[2]-r1[2]*r3[1]+r1[1]*r2[2]-r1[2]*r2[1]);
+      alpha[4][1] = one_over_4V*( r2[0]*r3[2]-r2[2]*r3[0]-r1[0]*r3[2]+r1[2]*r3[0]-r1[0]*r2[2]+r1[2]*r2[0]);
+      alpha[4][2] = one_over_4V*(-r2[0]*r3[1]+r2[1]*r3[0]+r1[0]*r3[1]-r1[1]*r3[0]+r1[0]*r2[1]-r1[1]*r2[0]);
+
+      alpha[5][0] = one_over_4V*( r2[1]*r3[2]-r2[2]*r3[1]+r1[1]*r3[2]-r1[2]*r3[1]+r1[1]*r2[2]-r1[2]*r2[1]);
+      alpha[5][1] = one_over_4V*(-r2[0]*r3[2]+r2[2]*r3[0]-r1[0]*r3[2]+r1[2]*r3[0]-r1[0]*r2[2]+r1[2]*r2[0]);
+      alpha[5][2] = one_over_4V*( r2[0]*r3[1]-r2[1]*r3[0]+r1[0]*r3[1]-r1[1]*r3[0]+r1[0]*r2[1]-r1[1]*r2[0]);
+
+      alpha[6][0] = one_over_4V*( r2[1]*r3[2]-r2[2]*r3[1]-r1[1]*r3[2]+r1[2]*r3[1]+r1[1]*r2[2]-r1[2]*r2[1]);
+      alpha[6][1] = one_over_4V*(-r2[0]*r3[2]+r2[2]*r3[0]+r1[0]*r3[2]-r1[2]*r3[0]-r1[0]*r2[2]+r1[2]*r2[0]);
+      alpha[6][2] = one_over_4V*( r2[0]*r3[1]-r2[1]*r3[0]-r1[0]*r3[1]+r1[1]*r3[0]+r1[0]*r2[1]-r1[1]*r2[0]);
+
+      alpha[7][0] = one_over_4V*(-r2[1]*r3[2]+r2[2]*r3[1]-r1[1]*r3[2]+r1[2]*r3[1]+r1[1]*r2[2]-r1[2]*r2[1]);
+      alpha[7][1] = one_over_4V*( r2[0]*r3[2]-r2[2]*r3[0]+r1[0]*r3[2]-r1[2]*r3[0]-r1[0]*r2[2]+r1[2]*r2[0]);
+      alpha[7][2] = one_over_4V*(-r2[0]*r3[1]+r2[1]*r3[0]-r1[0]*r3[1]+r1[1]*r3[0]+r1[0]*r2[1]-r1[1]*r2[0]);
+    }
+
+    template<bool GRADIENTS, class Block>
+    void compute( const double  * cx
+                , const double  * cy
+                , const double  * cz
+                , const Point   * const * /* pos */
+                , const Matrix3 * const * size
+                , int             /* n */
+                , Block         & b
+                )
+    {
+      const int B = Block::blockSize;
+
+      // corner positions in cell index space and gradient coefficients
+      double x[8][B], y[8][B], z[8][B];
+      double ax[8][B], ay[8][B], az[8][B];
+
+      const double lcritsq = m_lcrit*m_lcrit;
+
+      for( int p = 0; p < B; p++ ) {
+        Matrix3 dsize = *size[p];
+
+        // Scale the domain so that no corner is further than lcrit
+        // from the center, see cpdiInterpolator.
+        Vector la = corner( dsize, 6 );
+        Vector lb = corner( dsize, 5 );
+        Vector lc = corner( dsize, 7 );
+        Vector ld = corner( dsize, 4 );
+
+        bool scaled = false;
+        if( la.length2() > lcritsq ) { la = la*( m_lcrit/la.length() ); scaled = true; }
+        if( lb.length2() > lcritsq ) { lb = lb*( m_lcrit/lb.length() ); scaled = true; }
+        if( lc.length2() > lcritsq ) { lc = lc*( m_lcrit/lc.length() ); scaled = true; }
+        if( ld.length2() > lcritsq ) { ld = ld*( m_lcrit/ld.length() ); scaled = true; }
+
+        if( scaled ) {
+          dsize( 0, 0 ) = .5*( la.x() + lb.x() - lc.x() - ld.x() );
+          dsize( 1, 0 ) = .5*( la.y() + lb.y() - lc.y() - ld.y() );
+          dsize( 2, 0 ) = .5*( la.z() + lb.z() - lc.z() - ld.z() );
+
+          dsize( 0, 1 ) = .5*( la.x() - lb.x() + lc.x() - ld.x() );
+          dsize( 1, 1 ) = .5*( la.y() - lb.y() + lc.y() - ld.y() );
+          dsize( 2, 1 ) = .5*( la.z() - lb.z() + lc.z() - ld.z() );
+
+          dsize( 0, 2 ) = .5*( la.x() + lb.x() + lc.x() + ld.x() );
+          dsize( 1, 2 ) = .5*( la.y() + lb.y() + lc.y() + ld.y() );
+          dsize( 2, 2 ) = .5*( la.z() + lb.z() + lc.z() + ld.z() );
+        }
+
+        for( int c = 0; c < 8; c++ ) {
+          const Vector r = corner( dsize, c );
+          x[c][p] = cx[p] + r.x();
+          y[c][p] = cy[p] + r.y();
+          z[c][p] = cz[p] + r.z();
+        }
+
+        if( GRADIENTS ) {
+          Vector alpha[8];
+          gradientCoefficients( dsize, alpha );
+          for( int c = 0; c < 8; c++ ) {
+            ax[c][p] = alpha[c][0];
+            ay[c][p] = alpha[c][1];
+            az[c][p] = alpha[c][2];
+          }
+        }
+      }
+
+      // Node c*8 + m is node m (in cpdiInterpolator order) of the linear
+      // interpolation at corner c, weighted by 1/8.
+      static const int ox[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
+      static const int oy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
+      static const int oz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+
+      for( int c = 0; c < 8; c++ ) {
+        int    ix[B], iy[B], iz[B];
+        double wx[2][B], wy[2][B], wz[2][B];
+
+        for( int p = 0; p < B; p++ ) {
+          ix[p] = Floor( x[c][p] );
+          iy[p] = Floor( y[c][p] );
+          iz[p] = Floor( z[c][p] );
+
+          const double fx = x[c][p] - ix[p];
+          const double fy = y[c][p] - iy[p];
+          const double fz = z[c][p] - iz[p];
+
+          wx[0][p] = 1 - fx;  wx[1][p] = fx;
+          wy[0][p] = 1 - fy;  wy[1][p] = fy;
+          wz[0][p] = 1 - fz;  wz[1][p] = fz;
+        }
+
+        for( int m = 0; m < 8; m++ ) {
+          const int k = 8*c + m;
+          const int i = ox[m];
+          const int j = oy[m];
+          const int l = oz[m];
+
+          for( int p = 0; p < B; p++ ) {
+            const double phi = wx[i][p] * wy[j][p] * wz[l][p];
+            b.ni_x[k][p] = ix[p] + i;
+            b.ni_y[k][p] = iy[p] + j;
+            b.ni_z[k][p] = iz[p] + l;
+            b.S[k][p]    = .125*phi;
+            if( GRADIENTS ) {
+              b.dS_x[k][p] = ax[c][p]*phi;
+              b.dS_y[k][p] = ay[c][p]*phi;
+              b.dS_z[k][p] = az[c][p]*phi;
+            }
+          }
+        }
+      }
+    }
+
+    double m_lcrit;
+  };
+
+  //______________________________________________________________________
+  //  Third order B-splines, the 1D weights of the nodes i, i+1 and i-1
+  //  or i+2, see TOBSplineInterpolator.
+  struct TOBSplineKernel {
+
+    static const int nodes = 27;
+
+    int size() const { return nodes; }
+
+    static inline double eval( double dx )
+    {
+      if( dx < -1.5 ) {
+        return -10.0;
+      }
+      else if( dx < -.5 ) {
+        return ( dx + 1.5 ) * ( dx + 1.5 ) * .5;
+      }
+      else if( dx < .5 ) {
+        return ( -dx * dx + .75 );
+      }
+      else if( dx < 1.5 ) {
+        return .5 * ( 1.5 - dx ) * ( 1.5 - dx );
+      }
+      return 10.0;
+    }
+
+    static inline double evalGrad( double dx )
+    {
+      if( dx < -1.5 ) {
+        return 11.0;
+      }
+      else if( dx < -.5 ) {
+        return dx + 1.5;
+      }
+      else if( dx < .5 ) {
+        return - 2. * dx;
+      }
+      else if( dx < 1.5 ) {
+        return dx - 1.5;
+      }
+      return -11.0;
+    }
+
+    static inline void axis( double c, int ni[3], double f[3], double df[3] )
+    {
+      const int i = Floor( c );
+
+      ni[0] = i;
+      ni[1] = i + 1;
+      ni[2] = ( c - i < 0.5 ) ? i - 1 : i + 2;
+
+      for( int n = 0; n < 3; n++ ) {
+        f[n]  = eval( c - ni[n] );
+        df[n] = evalGrad( c - ni[n] );
+      }
+    }
+
+    template<bool GRADIENTS, class Block>
+    void compute( const double  * cx
+                , const double  * cy
+                , const double  * cz
+                , const Point   * const * /* pos */
+                , const Matrix3 * const * /* size */
+                , int             /* n */
+                , Block         & b
+                )
+    {
+      const int B = Block::blockSize;
+
+      int    nx[3][B], ny[3][B], nz[3][B];
+      double fx[3][B], fy[3][B], fz[3][B];
+      double dfx[3][B], dfy[3][B], dfz[3][B];
+
+      for( int p = 0; p < B; p++ ) {
+        int    ni[3];
+        double f[3];
+        double df[3];
+
+        axis( cx[p], ni, f, df );
+        for( int i = 0; i < 3; i++ ) {
+          nx[i][p] = ni[i];  fx[i][p] = f[i];  dfx[i][p] = df[i];
+        }
+        axis( cy[p], ni, f, df );
+        for( int i = 0; i < 3; i++ ) {
+          ny[i][p] = ni[i];  fy[i][p] = f[i];  dfy[i][p] = df[i];
+        }
+        axis( cz[p], ni, f, df );
+        for( int i = 0; i < 3; i++ ) {
+          nz[i][p] = ni[i];  fz[i][p] = f[i];  dfz[i][p] = df[i];
+        }
+      }
+
+      // z varies fastest, as in TOBSplineInterpolator
+      for( int i = 0; i < 3; i++ ) {
+        for( int j = 0; j < 3; j++ ) {
+          for( int k = 0; k < 3; k++ ) {
+            const int m = 9*i + 3*j + k;
+
+            for( int p = 0; p < B; p++ ) {
+              b.ni_x[m][p] = nx[i][p];
+              b.ni_y[m][p] = ny[j][p];
+              b.ni_z[m][p] = nz[k][p];
+              b.S[m][p]    = fx[i][p] * fy[j][p] * fz[k][p];
+            }
+
+            if( GRADIENTS ) {
+              for( int p = 0; p < B; p++ ) {
+                b.dS_x[m][p] = dfx[i][p] * fy[j][p]  * fz[k][p];
+                b.dS_y[m][p] = fx[i][p]  * dfy[j][p] * fz[k][p];
+                b.dS_z[m][p] = fx[i][p]  * fy[j][p]  * dfz[k][p];
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  //______________________________________________________________________
+  //  Fourth order B-splines, see BSplineInterpolator.  The 1D nodes are
+  //  i, i+1, i-1 and i+2, and the basis of each node depends on its
+  //  distance to the interior node range [low, hi) of the level.
+  //  BSplineInterpolator leaves out i-1 and i+2 where they are outside
+  //  of the range and packs the remaining nodes; here they stay in
+  //  their slots as node i with a zero weight, so the node count stays
+  //  fixed.  The weights summed per node are the same.
+  struct BSplineKernel {
+
+    static const int nodes = 64;
+
+    explicit BSplineKernel( const Patch * patch )
+    {
+      patch->getLevel()->findInteriorNodeIndexRange( m_low, m_hi );
+    }
+
+    int size() const { return nodes; }
+
+    // internal nodes
+    static inline double evalType1( double dx )
+    {
+      if( dx < -2. ) {
+        return -10.0;
+      }
+      else if( dx < -1. ) {
+        return ( ( 1./6. * dx + 1. ) * dx + 2. ) * dx + 4./3.;
+      }
+      else if( dx < 0. ) {
+        return ( -.5 * dx - 1. ) * dx * dx + 2./3.;
+      }
+      else if( dx < 1. ) {
+        return ( .5 * dx - 1. ) * dx * dx + 2./3.;
+      }
+      else if( dx < 2. ) {
+        return ( ( -1./6. * dx + 1. ) * dx - 2. ) * dx + 4./3.;
+      }
+      return 10.0;
+    }
+
+    // nodes 1 away from the boundary
+    static inline double evalType2( double dx )
+    {
+      if( dx < -1. ) {
+        return -20.0;
+      }
+      else if( dx < 0. ) {
+        return ( ( -11./12. * dx - 1.25 ) * dx + .25 ) * dx + 7./12.;
+      }
+      else if( dx < 1. ) {
+        return ( ( 7./12. * dx - 1.25 ) * dx + .25 ) * dx + 7./12.;
+      }
+      else if( dx < 2. ) {
+        return ( ( -1./6. * dx + 1. ) * dx - 2. ) * dx + 4./3.;
+      }
+      return 20.0;
+    }
+
+    // boundary nodes
+    static inline double evalType3( double dx )
+    {
+      if( dx < 0. ) {
+        return -30.0;
+      }
+      else if( dx < 1.0 ) {
+        return ( .75 * dx - 1.5 ) * dx * dx + 1.;
+      }
+      else if( dx < 2.0 ) {
+        return ( ( -.25 * dx + 1.5 ) * dx - 3. ) * dx + 2.;
+      }
+      return 30.0;
+    }
+
+    static inline double evalType1Grad( double dx )
+    {
+      if( dx < -2. ) {
+        return 11.0;
+      }
+      else if( dx < -1. ) {
+        return ( .5 * dx + 2. ) * dx + 2.;
+      }
+      else if( dx < 0. ) {
+        return ( -1.5 * dx - 2. ) * dx;
+      }
+      else if( dx < 1. ) {
+        return ( 1.5 * dx - 2. ) * dx;
+      }
+      else if( dx < 2. ) {
+        return ( -.5 * dx + 2. ) * dx - 2.;
+      }
+      return -11.0;
+    }
+
+    static inline double evalType2Grad( double dx )
+    {
+      if( dx < -1. ) {
+        return 22.0;
+      }
+      else if( dx < 0. ) {
+        return ( -11./4. * dx - 2.5 ) * dx + .25;
+      }
+      else if( dx < 1. ) {
+        return ( 7./4. * dx - 2.5 ) * dx + .25;
+      }
+      else if( dx < 2. ) {
+        return ( -.5 * dx + 2. ) * dx - 2.;
+      }
+      return -22.0;
+    }
+
+    static inline double evalType3Grad( double dx )
+    {
+      if( dx < 0. ) {
+        return 33.0;
+      }
+      else if( dx < 1.0 ) {
+        return ( 2.25 * dx - 3. ) * dx;
+      }
+      else if( dx < 2.0 ) {
+        return ( -.75 * dx + 3. ) * dx - 3.;
+      }
+      return -33.0;
+    }
+
+    // The weight and derivative of node xn for a particle at c; the
+    // nodes next to the upper boundary use the mirrored basis.
+    static inline void basis( double c, int xn, int low, int hi, double & f, double & df )
+    {
+      if( xn == low ) {
+        f  = evalType3( c - xn );
+        df = evalType3Grad( c - xn );
+      }
+      else if( xn == hi - 1 ) {
+        f  = evalType3( xn - c );
+        df = -evalType3Grad( xn - c );
+      }
+      else if( xn == low + 1 ) {
+        f  = evalType2( c - xn );
+        df = evalType2Grad( c - xn );
+      }
+      else if( xn == hi - 2 ) {
+        f  = evalType2( xn - c );
+        df = -evalType2Grad( xn - c );
+      }
+      else {
+        f  = evalType1( c - xn );
+        df = evalType1Grad( c - xn );
+      }
+    }
+
+    static inline void axis( double c, int low, int hi, int ni[4], double f[4], double df[4] )
+    {
+      const int i = Floor( c );
+
+      ni[0] = i;
+      ni[1] = i + 1;
+      ni[2] = i - 1;
+      ni[3] = i + 2;
+
+      for( int n = 0; n < 4; n++ ) {
+        basis( c, ni[n], low, hi, f[n], df[n] );
+      }
+
+      // outside of the domain
+      if( i <= low ) {
+        ni[2] = i;  f[2] = 0.;  df[2] = 0.;
+      }
+      if( i + 1 >= hi ) {
+        ni[3] = i;  f[3] = 0.;  df[3] = 0.;
+      }
+    }
+
+    template<bool GRADIENTS, class Block>
+    void compute( const double  * cx
+                , const double  * cy
+                , const double  * cz
+                , const Point   * const * /* pos */
+                , const Matrix3 * const * /* size */
+                , int             /* n */
+                , Block         & b
+                )
+    {
+      const int B = Block::blockSize;
+
+      int    nx[4][B], ny[4][B], nz[4][B];
+      double fx[4][B], fy[4][B], fz[4][B];
+      double dfx[4][B], dfy[4][B], dfz[4][B];
+
+      for( int p = 0; p < B; p++ ) {
+        int    ni[4];
+        double f[4];
+        double df[4];
+
+        axis( cx[p], m_low.x(), m_hi.x(), ni, f, df );
+        for( int i = 0; i < 4; i++ ) {
+          nx[i][p] = ni[i];  fx[i][p] = f[i];  dfx[i][p] = df[i];
+        }
+        axis( cy[p], m_low.y(), m_hi.y(), ni, f, df );
+        for( int i = 0; i < 4; i++ ) {
+          ny[i][p] = ni[i];  fy[i][p] = f[i];  dfy[i][p] = df[i];
+        }
+        axis( cz[p], m_low.z(), m_hi.z(), ni, f, df );
+        for( int i = 0; i < 4; i++ ) {
+          nz[i][p] = ni[i];  fz[i][p] = f[i];  dfz[i][p] = df[i];
+        }
+      }
+
+      // z varies fastest, as in BSplineInterpolator
+      for( int i = 0; i < 4; i++ ) {
+        for( int j = 0; j < 4; j++ ) {
+          for( int k = 0; k < 4; k++ ) {
+            const int m = 16*i + 4*j + k;
+
+            for( int p = 0; p < B; p++ ) {
+              b.ni_x[m][p] = nx[i][p];
+              b.ni_y[m][p] = ny[j][p];
+              b.ni_z[m][p] = nz[k][p];
+              b.S[m][p]    = fx[i][p] * fy[j][p] * fz[k][p];
+            }
+
+            if( GRADIENTS ) {
+              for( int p = 0; p < B; p++ ) {
+                b.dS_x[m][p] = dfx[i][p] * fy[j][p]  * fz[k][p];
+                b.dS_y[m][p] = fx[i][p]  * dfy[j][p] * fz[k][p];
+                b.dS_z[m][p] = fx[i][p]  * fy[j][p]  * dfz[k][p];
+              }
+            }
+          }
+        }
+      }
+    }
+
+    IntVector m_low;
+    IntVector m_hi;
+  };
+
+  //______________________________________________________________________
+  //  Any ParticleInterpolator with at most NODES nodes, through the
+  //  virtual per particle calls.  'interpolator' is not owned.
+  template<int NODES>
+  struct VirtualKernel {
+
+    static const int nodes = NODES;
+
+    explicit VirtualKernel( ParticleInterpolator * interpolator )
+      : m_interpolator( interpolator )
+      , m_size( interpolator->size() )
+      , m_ni( m_size )
+      , m_S( m_size )
+      , m_d_S( m_size )
+    {
+      ASSERT( m_size <= NODES );
+    }
+
+    int size() const { return m_size; }
+
+    template<bool GRADIENTS, class Block>
+    void compute( const double  * /* cx */
+                , const double  * /* cy */
+                , const double  * /* cz */
+                , const Point   * const * pos
+                , const Matrix3 * const * size
+                , int             n
+                , Block         & b
+                )
+    {
+      for( int p = 0; p < n; p++ ) {
+        if( GRADIENTS ) {
+          m_interpolator->findCellAndWeightsAndShapeDerivatives( *pos[p], m_ni, m_S, m_d_S, *size[p] );
+        }
+        else {
+          m_interpolator->findCellAndWeights( *pos[p], m_ni, m_S, *size[p] );
+        }
+
+        for( int k = 0; k < m_size; k++ ) {
+          b.ni_x[k][p] = m_ni[k].x();
+          b.ni_y[k][p] = m_ni[k].y();
+          b.ni_z[k][p] = m_ni[k].z();
+          b.S[k][p]    = m_S[k];
+          if( GRADIENTS ) {
+            b.dS_x[k][p] = m_d_S[k].x();
+            b.dS_y[k][p] = m_d_S[k].y();
+            b.dS_z[k][p] = m_d_S[k].z();
+          }
+        }
+      }
+    }
+
+    ParticleInterpolator   * m_interpolator;
+    int                      m_size;
+    std::vector<IntVector>   m_ni;
+    std::vector<double>      m_S;
+    std::vector<Vector>      m_d_S;
+  };
+
+  //______________________________________________________________________
+  //
+  template<class Kernel, int BLOCK = 16>
+  class BatchInterpolator {
+
+  public:
+
+    typedef InterpolationBlock<Kernel::nodes, BLOCK> Block;
+
+    static const int blockSize = BLOCK;
+
+    BatchInterpolator( const Patch * patch, const Kernel & kernel = Kernel() )
+      : m_kernel( kernel )
+      , m_anchor( patch->getLevel()->getAnchor() )
+      , m_dcell( patch->getLevel()->dCell() )
+    {}
+
+    // Number of nodes per particle
+    int size() const { return m_kernel.size(); }
+
+    // Fills 'b' for the 0 < n <= BLOCK particles idx[0, n).  'px' and
+    // 'psize' are (const)ParticleVariables or anything else indexed
+    // by particleIndex.
+    template<class PX, class PSIZE>
+    void findCellAndWeights( const PX            & px
+                           , const PSIZE         & psize
+                           , const particleIndex * idx
+                           ,       int             n
+                           ,       bool            gradients
+                           ,       Block         & b
+                           )
+    {
+      double          cx[BLOCK];
+      double          cy[BLOCK];
+      double          cz[BLOCK];
+      const Point   * pos[BLOCK];
+      const Matrix3 * size[BLOCK];
+
+      for( int p = 0; p < n; p++ ) {
+        pos[p]  = &px[idx[p]];
+        size[p] = &psize[idx[p]];
+
+        // Level::positionToIndex
+        cx[p] = ( pos[p]->x() - m_anchor.x() )/m_dcell.x();
+        cy[p] = ( pos[p]->y() - m_anchor.y() )/m_dcell.y();
+        cz[p] = ( pos[p]->z() - m_anchor.z() )/m_dcell.z();
+      }
+
+      // The rest of a partial block repeats the last particle.
+      for( int p = n; p < BLOCK; p++ ) {
+        pos[p]  = pos[n - 1];
+        size[p] = size[n - 1];
+        cx[p]   = cx[n - 1];
+        cy[p]   = cy[n - 1];
+        cz[p]   = cz[n - 1];
+      }
+
+      b.count = n;
+      if( gradients ) {
+        m_kernel.template compute<true>( cx, cy, cz, pos, size, n, b );
+      }
+      else {
+        m_kernel.template compute<false>( cx, cy, cz, pos, size, n, b );
+      }
+    }
+
+    // Calls body(b, idx) for consecutive blocks of the particles of
+    // 'pset', idx[0, b.count) being the indices of the block's particles.
+    template<class PX, class PSIZE, class Body>
+    void forEachBlock( ParticleSubset * pset
+                     , const PX       & px
+                     , const PSIZE    & psize
+                     ,       bool       gradients
+                     ,       Body       body
+                     )
+    {
+      Block b;
+      const particleIndex * indices = pset->getPointer();
+      const int             n       = pset->numParticles();
+
+      for( int first = 0; first < n; first += BLOCK ) {
+        const int count = std::min( BLOCK, n - first );
+        findCellAndWeights( px, psize, indices + first, count, gradients, b );
+        body( static_cast<const Block &>( b ), indices + first );
+      }
+    }
+
+  private:
+
+    Kernel m_kernel;
+    Point  m_anchor;
+    Vector m_dcell;
+  };
+
+} // End namespace Uintah
+
+#endif // CORE_GRID_BATCHINTERPOLATOR_H
@@ -153,6 +153,22 @@ public:
     else
       return IntVector(0,0,0);
   }
+
+  // Elements between consecutive x-rows of the underlying data.
+  int rowPitch() const {
+    if (d_window && d_window->getData())
+      return d_window->getData()->rowPitch();
+    else
+      return size().x();
+  }
+
+  // size() including the row padding of the underlying data.
+  IntVector allocatedSize() const {
+    if (d_window && d_window->getData())
+      return d_window->getData()->allocatedSize();
+    else
+      return size();
+  }
   void initialize(const T& value) {
     d_window->initialize(value);
   }
@@ -0,0 +1,60 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Core/Grid/Variables/Array3Data.h>
+
+#include <Core/Exceptions/InternalError.h>
+
+#include <sstream>
+
+using namespace Uintah;
+
+size_t Array3DataLayout::s_alignment = 64;
+bool   Array3DataLayout::s_pad_rows  = false;
+
+//______________________________________________________________________
+//
+void
+Array3DataLayout::setAlignment( size_t bytes )
+{
+  if( bytes < 64 || ( bytes & ( bytes - 1 ) ) != 0 ) {
+    std::ostringstream msg;
+    msg << "Array3DataLayout: the alignment (" << bytes << ") must be a power of two of at least 64 bytes";
+    SCI_THROW( InternalError( msg.str(), __FILE__, __LINE__ ) );
+  }
+  s_alignment = bytes;
+}
+
+//______________________________________________________________________
+//
+int
+Array3DataLayout::rowPitch( int nx, size_t elemSize )
+{
+  if( !s_pad_rows || nx <= 0 || elemSize == 0 || s_alignment % elemSize != 0 ) {
+    return nx;
+  }
+  const int multiple = s_alignment / elemSize;
+
+  return ( ( nx + multiple - 1 ) / multiple ) * multiple;
+}
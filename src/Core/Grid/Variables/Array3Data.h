@@ -27,12 +27,19 @@
 
 #include <Core/Util/RefCounted.h>
 #include <Core/Geometry/IntVector.h>
+#include <Core/Grid/Variables/VariableMemoryPool.h>
 #include <Core/Util/Assert.h>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Malloc/Allocator.h>
 
 #include <sci_defs/kokkos_defs.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
 #ifdef UINTAH_ENABLE_KOKKOS
 #include <Kokkos_Core.hpp>
 #endif //UINTAH_ENABLE_KOKKOS
@@ -59,12 +66,50 @@ namespace Uintah {
     Array3Data
 
     DESCRIPTION
-    Long description...
+    The storage behind an Array3Window, allocated from the
+    VariableMemoryPool.  The base pointer is aligned to
+    Array3DataLayout::getAlignment() bytes and, with row padding
+    on, every x-row starts on such a boundary: rows are rowPitch()
+    elements apart, which may be more than size().x().  The padding
+    is never part of a window, so only code that walks the raw
+    memory (getPointer()) has to use the pitch.
 
     WARNING
 
    ****************************************/
 
+  /**************************************
+
+    CLASS
+    Array3DataLayout
+
+    DESCRIPTION
+    How Array3Data allocates its memory (the <Scheduler> options
+    <gridVariableAlignment> and <padGridVariableRows>).  Changes only
+    affect arrays allocated afterwards.
+
+   ****************************************/
+
+  class Array3DataLayout {
+    public:
+      // Power of two, at least the cache line size (64 bytes).
+      static void   setAlignment(size_t bytes);
+      static size_t getAlignment() { return s_alignment; }
+
+      // Pad x-rows to a multiple of the alignment (only for elements
+      // whose size divides the alignment).
+      static void setPadRows(bool pad) { s_pad_rows = pad; }
+      static bool getPadRows() { return s_pad_rows; }
+
+      // Distance in elements between the rows of an array whose rows
+      // have 'nx' elements of 'elemSize' bytes.
+      static int rowPitch(int nx, size_t elemSize);
+
+    private:
+      static size_t s_alignment;
+      static bool   s_pad_rows;
+  };
+
 #ifdef UINTAH_ENABLE_KOKKOS
 template <typename T>
 using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<Kokkos::Unmanaged> >;
@@ -78,6 +123,17 @@ using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<K
       inline IntVector size() const {
         return d_size;
       }
+
+      // Elements between consecutive x-rows in memory (>= size().x()).
+      inline int rowPitch() const {
+        return d_pitch;
+      }
+
+      // The size including the row padding, i.e. the dimensions of the
+      // memory behind getPointer().
+      inline IntVector allocatedSize() const {
+        return IntVector(d_pitch, d_size.y(), d_size.z());
+      }
       void copy(const IntVector& ts, const IntVector& te,
                 const Array3Data<T>* from,
                 const IntVector& fs, const IntVector& fe);
@@ -113,15 +169,26 @@ using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<K
 
 #ifdef UINTAH_ENABLE_KOKKOS
       inline KokkosData<T> getKokkosData() const {
+        // Row padding is not available with Kokkos.
         return KokkosData<T>(d_data, d_size.x(), d_size.y(), d_size.z());
       }
 #endif //UINTAH_ENABLE_KOKKOS
 
 
     private:
+      static inline void copyRow(T* dst, const T* src, long n) {
+        if(std::is_trivially_copyable<T>::value){
+          std::memmove(static_cast<void*>(dst), src, n*sizeof(T));
+        } else {
+          std::copy(src, src+n, dst);
+        }
+      }
+
       T*    d_data;
       T***  d_data3;
       IntVector d_size;
+      int   d_pitch;
+      size_t d_alignment;
 
       Array3Data& operator=(const Array3Data&);
       Array3Data(const Array3Data&);
@@ -140,16 +207,30 @@ using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<K
       CHECKARRAYBOUNDS(highIndex.z(), lowIndex.z(), d_size.z()+1);
       T* d = &d_data3[lowIndex.z()][lowIndex.y()][lowIndex.x()];
       IntVector s = highIndex-lowIndex;
-      for(int i=0;i<s.z();i++){
+      if(s.x() <= 0 || s.y() <= 0 || s.z() <= 0)
+        return;
+
+      // Whole rows without padding are one contiguous run per plane,
+      // and whole planes one run for the entire range.
+      long rowlen = s.x();
+      int nrows = s.y();
+      int nplanes = s.z();
+      if(s.x() == d_pitch) {
+        rowlen *= s.y();
+        nrows = 1;
+        if(s.y() == d_size.y()) {
+          rowlen *= s.z();
+          nplanes = 1;
+        }
+      }
+
+      for(int i=0;i<nplanes;i++){
         T* dd=d;
-        for(int j=0;j<s.y();j++){
-          T* ddd=dd;
-          for(int k=0;k<s.x();k++) {
-            ddd[k]=val;
-          }
-          dd+=d_size.x();
+        for(int j=0;j<nrows;j++){
+          std::fill_n(dd, rowlen, val);
+          dd+=d_pitch;
         }
-        d+=d_size.x()*d_size.y();
+        d+=(long)d_pitch*d_size.y();
       }
     }
 
@@ -166,7 +247,6 @@ using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<K
       CHECKARRAYBOUNDS(to_highIndex.x(), to_lowIndex.x(), d_size.x()+1);
       CHECKARRAYBOUNDS(to_highIndex.y(), to_lowIndex.y(), d_size.y()+1);
       CHECKARRAYBOUNDS(to_highIndex.z(), to_lowIndex.z(), d_size.z()+1);
-      T* dst = &d_data3[to_lowIndex.z()][to_lowIndex.y()][to_lowIndex.x()];
 
       CHECKARRAYBOUNDS(from_lowIndex.x(), 0, from->d_size.x());
       CHECKARRAYBOUNDS(from_lowIndex.y(), 0, from->d_size.y());
@@ -177,35 +257,57 @@ using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<K
           from->d_size.y()+1);
       CHECKARRAYBOUNDS(from_highIndex.z(), from_lowIndex.z(),
           from->d_size.z()+1);
-      T* src = &from->d_data3[from_lowIndex.z()][from_lowIndex.y()][from_lowIndex.x()];
 
       IntVector s = from_highIndex-from_lowIndex;
       //IntVector s_check = to_highIndex-to_lowIndex;
       // Check to make sure that the two window sizes are the same
       ASSERT(s == to_highIndex-to_lowIndex);
-      for(int i=0;i<s.z();i++){
+      if(s.x() <= 0 || s.y() <= 0 || s.z() <= 0)
+        return;
+
+      T* dst = &d_data3[to_lowIndex.z()][to_lowIndex.y()][to_lowIndex.x()];
+      const T* src = &from->d_data3[from_lowIndex.z()][from_lowIndex.y()][from_lowIndex.x()];
+
+      // Merge rows (and planes) that are contiguous in both arrays.
+      long rowlen = s.x();
+      int nrows = s.y();
+      int nplanes = s.z();
+      if(s.x() == d_pitch && s.x() == from->d_pitch) {
+        rowlen *= s.y();
+        nrows = 1;
+        if(s.y() == d_size.y() && s.y() == from->d_size.y()) {
+          rowlen *= s.z();
+          nplanes = 1;
+        }
+      }
+
+      for(int i=0;i<nplanes;i++){
         T* dd=dst;
-        T* ss=src;
-        for(int j=0;j<s.y();j++){
-          T* ddd=dd;
-          T* sss=ss;
-          for(int k=0;k<s.x();k++)
-            ddd[k]=sss[k];
-          dd+=d_size.x();
-          ss+=from->d_size.x();
+        const T* ss=src;
+        for(int j=0;j<nrows;j++){
+          copyRow(dd, ss, rowlen);
+          dd+=d_pitch;
+          ss+=from->d_pitch;
         }
-        dst+=d_size.x()*d_size.y();
-        src+=from->d_size.x()*from->d_size.y();
+        dst+=(long)d_pitch*d_size.y();
+        src+=(long)from->d_pitch*from->d_size.y();
       }
     }
 
   template<class T>
     Array3Data<T>::Array3Data(const IntVector& size)
     : d_size(size)
+    , d_pitch(Array3DataLayout::rowPitch(size.x(), sizeof(T)))
+    , d_alignment(std::max(Array3DataLayout::getAlignment(), alignof(T)))
     {
-      long s=d_size.x()*d_size.y()*d_size.z();
+      long s=(long)d_pitch*d_size.y()*d_size.z();
       if(s){
-        d_data=new T[s];
+        d_data=static_cast<T*>(VariableMemoryPool::allocate(s*sizeof(T), d_alignment));
+        if(!std::is_trivially_default_constructible<T>::value){
+          for(long i=0;i<s;i++){
+            new (d_data+i) T;
+          }
+        }
         d_data3=new T**[d_size.z()];
         d_data3[0]=new T*[d_size.z()*d_size.y()];
         d_data3[0][0]=d_data;
@@ -213,7 +315,7 @@ using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<K
           d_data3[i]=d_data3[i-1]+d_size.y();
         }
         for(int j=1;j<d_size.z()*d_size.y();j++){
-          d_data3[0][j]=d_data3[0][j-1]+d_size.x();
+          d_data3[0][j]=d_data3[0][j-1]+d_pitch;
         }
       } else {
         d_data=0;
@@ -225,7 +327,13 @@ using KokkosData = Kokkos::View<T***, Kokkos::LayoutLeft, Kokkos::MemoryTraits<K
     Array3Data<T>::~Array3Data()
     {
       if(d_data){
-        delete[] d_data;
+        long s=(long)d_pitch*d_size.y()*d_size.z();
+        if(!std::is_trivially_destructible<T>::value){
+          for(long i=0;i<s;i++){
+            d_data[i].~T();
+          }
+        }
+        VariableMemoryPool::deallocate(d_data, s*sizeof(T), d_alignment);
         d_data=0;
         delete[] d_data3[0];
         d_data3[0]=0;
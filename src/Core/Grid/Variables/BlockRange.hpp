@@ -31,7 +31,14 @@
 #include <Kokkos_Core.hpp>
 #endif //UINTAH_ENABLE_KOKKOS
 
+#ifndef UINTAH_ENABLE_KOKKOS
+#include <Core/Parallel/LoopThreadPool.h>
+#endif //UINTAH_ENABLE_KOKKOS
+
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <vector>
 
 namespace Uintah {
 
@@ -171,6 +178,81 @@ void parallel_reduce_min( BlockRange const & r, const Functor & f, ReductionType
 
 #else
 
+// The non-Kokkos backend runs on the LoopThreadPool.  The range is
+// split into (k, j) tiles of tile_j rows by tile_k planes, each
+// spanning the whole i range, which are handed out to the threads.
+// With a single thread, for small ranges and for loops nested in
+// another loop these are the plain serial loops.  Deterministic
+// reductions over ranges of at least min_parallel_size cells always
+// accumulate per tile, running the tiles inline when serial, so the
+// result is the same for any number of threads and nesting.
+namespace block_range_detail {
+
+  enum { tile_j = 8, tile_k = 1, min_parallel_size = 4096 };
+
+  inline bool run_serial( BlockRange const & r )
+  {
+    return LoopThreadPool::getNumThreads() <= 1 || LoopThreadPool::inLoop() || r.size() < min_parallel_size;
+  }
+
+  inline bool run_serial_reduce( BlockRange const & r )
+  {
+    return LoopThreadPool::getDeterministicReductions() ? r.size() < min_parallel_size : run_serial( r );
+  }
+
+  // Calls body(jb, je, kb, ke, tile, slot) for every tile of r, in
+  // tile order on the calling thread if the pool runs serially.
+  template <typename Body>
+  void for_each_tile( BlockRange const & r, const Body & body )
+  {
+    const int jb = r.begin(1); const int je = r.end(1);
+    const int kb = r.begin(2); const int ke = r.end(2);
+
+    const int nj = (je - jb + tile_j - 1) / tile_j;
+    const int nk = (ke - kb + tile_k - 1) / tile_k;
+
+    LoopThreadPool::run( nj * nk, [&]( int tile, int slot ) {
+      const int tjb = jb + (tile % nj) * tile_j;
+      const int tkb = kb + (tile / nj) * tile_k;
+      body( tjb, std::min( tjb + tile_j, je ), tkb, std::min( tkb + tile_k, ke ), tile, slot );
+    });
+  }
+
+  inline int num_tiles( BlockRange const & r )
+  {
+    return ( (r.end(1) - r.begin(1) + tile_j - 1) / tile_j ) * ( (r.end(2) - r.begin(2) + tile_k - 1) / tile_k );
+  }
+
+  // The partial results of a reduction, one per tile (deterministic
+  // order) or one per thread.
+  inline int num_partials( BlockRange const & r )
+  {
+    return LoopThreadPool::getDeterministicReductions() ? num_tiles( r ) : LoopThreadPool::getNumThreads();
+  }
+
+  inline int partial_index( int tile, int slot )
+  {
+    return LoopThreadPool::getDeterministicReductions() ? tile : slot;
+  }
+
+  // Adds partial sums, element by element for std::array (e.g. the
+  // norms of the PhaseField components).
+  template <typename T>
+  inline void sum_join( T & a, const T & b )
+  {
+    a += b;
+  }
+
+  template <typename T, std::size_t N>
+  inline void sum_join( std::array<T, N> & a, const std::array<T, N> & b )
+  {
+    for (std::size_t n=0; n<N; ++n) {
+      sum_join( a[n], b[n] );
+    }
+  }
+
+} // namespace block_range_detail
+
 template <typename Functor>
 void parallel_for( BlockRange const & r, const Functor & f )
 {
@@ -178,11 +260,22 @@ void parallel_for( BlockRange const & r, const Functor & f )
   const int jb = r.begin(1); const int je = r.end(1);
   const int kb = r.begin(2); const int ke = r.end(2);
 
-  for (int k=kb; k<ke; ++k) {
-  for (int j=jb; j<je; ++j) {
-  for (int i=ib; i<ie; ++i) {
-    f(i,j,k);
-  }}}
+  if ( block_range_detail::run_serial( r ) ) {
+    for (int k=kb; k<ke; ++k) {
+    for (int j=jb; j<je; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(i,j,k);
+    }}}
+    return;
+  }
+
+  block_range_detail::for_each_tile( r, [&]( int tjb, int tje, int tkb, int tke, int, int ) {
+    for (int k=tkb; k<tke; ++k) {
+    for (int j=tjb; j<tje; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(i,j,k);
+    }}}
+  });
 };
 
 template <typename Functor, typename Option>
@@ -192,11 +285,22 @@ void parallel_for( BlockRange const & r, const Functor & f, const Option& op )
   const int jb = r.begin(1); const int je = r.end(1);
   const int kb = r.begin(2); const int ke = r.end(2);
 
-  for (int k=kb; k<ke; ++k) {
-  for (int j=jb; j<je; ++j) {
-  for (int i=ib; i<ie; ++i) {
-    f(op,i,j,k);
-  }}}
+  if ( block_range_detail::run_serial( r ) ) {
+    for (int k=kb; k<ke; ++k) {
+    for (int j=jb; j<je; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(op,i,j,k);
+    }}}
+    return;
+  }
+
+  block_range_detail::for_each_tile( r, [&]( int tjb, int tje, int tkb, int tke, int, int ) {
+    for (int k=tkb; k<tke; ++k) {
+    for (int j=tjb; j<tje; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(op,i,j,k);
+    }}}
+  });
 };
 
 template <typename Functor, typename ReductionType>
@@ -206,13 +310,33 @@ void parallel_reduce_sum( BlockRange const & r, const Functor & f, ReductionType
   const int jb = r.begin(1); const int je = r.end(1);
   const int kb = r.begin(2); const int ke = r.end(2);
 
-  ReductionType tmp = red;
-  for (int k=kb; k<ke; ++k) {
-  for (int j=jb; j<je; ++j) {
-  for (int i=ib; i<ie; ++i) {
-    f(i,j,k,tmp);
-  }}}
-  red = tmp;
+  if ( block_range_detail::run_serial_reduce( r ) ) {
+    ReductionType tmp = red;
+    for (int k=kb; k<ke; ++k) {
+    for (int j=jb; j<je; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(i,j,k,tmp);
+    }}}
+    red = tmp;
+    return;
+  }
+
+  std::vector<ReductionType> partials( block_range_detail::num_partials( r ), ReductionType{} );
+
+  block_range_detail::for_each_tile( r, [&]( int tjb, int tje, int tkb, int tke, int tile, int slot ) {
+    const int p = block_range_detail::partial_index( tile, slot );
+    ReductionType tmp = partials[p];
+    for (int k=tkb; k<tke; ++k) {
+    for (int j=tjb; j<tje; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(i,j,k,tmp);
+    }}}
+    partials[p] = tmp;
+  });
+
+  for (const auto & partial : partials) {
+    block_range_detail::sum_join( red, partial );
+  }
 };
 
 template <typename Functor, typename ReductionType>
@@ -222,13 +346,35 @@ void parallel_reduce_min( BlockRange const & r, const Functor & f, ReductionType
   const int jb = r.begin(1); const int je = r.end(1);
   const int kb = r.begin(2); const int ke = r.end(2);
 
-  ReductionType tmp = red;
-  for (int k=kb; k<ke; ++k) {
-  for (int j=jb; j<je; ++j) {
-  for (int i=ib; i<ie; ++i) {
-    f(i,j,k,tmp);
-  }}}
-  red = tmp;
+  if ( block_range_detail::run_serial_reduce( r ) ) {
+    ReductionType tmp = red;
+    for (int k=kb; k<ke; ++k) {
+    for (int j=jb; j<je; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(i,j,k,tmp);
+    }}}
+    red = tmp;
+    return;
+  }
+
+  std::vector<ReductionType> partials( block_range_detail::num_partials( r ), red );
+
+  block_range_detail::for_each_tile( r, [&]( int tjb, int tje, int tkb, int tke, int tile, int slot ) {
+    const int p = block_range_detail::partial_index( tile, slot );
+    ReductionType tmp = partials[p];
+    for (int k=tkb; k<tke; ++k) {
+    for (int j=tjb; j<tje; ++j) {
+    for (int i=ib; i<ie; ++i) {
+      f(i,j,k,tmp);
+    }}}
+    partials[p] = tmp;
+  });
+
+  for (const auto & partial : partials) {
+    if ( partial < red ) {
+      red = partial;
+    }
+  }
 };
 
 #endif
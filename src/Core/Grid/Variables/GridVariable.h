@@ -41,6 +41,8 @@
 #include <sci_defs/pidx_defs.h>
 
 #include <cstring>
+#include <type_traits>
+#include <vector>
 
 namespace Uintah {
 
@@ -129,13 +131,14 @@ WARNING
       std::ostringstream str;
       str << siz.x() << "x" << siz.y() << "x" << siz.z();
       elems=str.str();
-      totsize=siz.x()*siz.y()*siz.z()*sizeof(T);
+      totsize=getDataSize();
       ptr = (void*)this->getPointer();
     }
 
+    // Bytes of memory behind getPointer(), including any row padding.
     virtual size_t getDataSize() const {
-      IntVector siz = this->size();
-      return siz.x() * siz.y() * siz.z() * sizeof(T);
+      IntVector siz = this->allocatedSize();
+      return (size_t)siz.x() * siz.y() * siz.z() * sizeof(T);
     }
 
     virtual bool copyOut(void* dst) const {
@@ -194,6 +197,35 @@ WARNING
       }
     }
 
+    // Each x-line of the window, adjacent lines merged.  Only doubles
+    // written as floats need converting.
+    virtual bool emitSegments( const IntVector& l, const IntVector& h, ProblemSpecP /*varnode*/,
+                               bool outputDoubleAsFloat, std::vector<Segment>& segments ) {
+      const TypeDescription* td = fun_getTypeDescription( (T*)nullptr );
+      if( !td->isFlat() || (outputDoubleAsFloat && std::is_same<T, double>::value) ) {
+        return false;
+      }
+
+      if( h.x() <= l.x() ) {
+        return true;
+      }
+      const size_t linesize = sizeof(T) * (h.x() - l.x());
+
+      for( int z = l.z(); z < h.z(); z++ ) {
+        for( int y = l.y(); y < h.y(); y++ ) {
+          const char* line = (const char*) &(*this)[IntVector(l.x(), y, z)];
+
+          if( !segments.empty() && segments.back().m_data + segments.back().m_size == line ) {
+            segments.back().m_size += linesize;
+          }
+          else {
+            segments.push_back( Segment{ line, linesize } );
+          }
+        }
+      }
+      return true;
+    }
+
     virtual void readNormal(std::istream& in, bool swapBytes)
     {
       const TypeDescription* td = fun_getTypeDescription((T*)0);
@@ -287,8 +319,9 @@ template<class T>
     high=this->getHighIndex();
     dataLow = this->getWindow()->getOffset();
     siz=this->size();
-    strides = IntVector(sizeof(T), (int)(sizeof(T)*siz.x()),
-                        (int)(sizeof(T)*siz.y()*siz.x()));
+    const int pitch = this->rowPitch();
+    strides = IntVector(sizeof(T), (int)(sizeof(T)*pitch),
+                        (int)(sizeof(T)*siz.y()*pitch));
   }
 
 } // end namespace Uintah
@@ -29,10 +29,60 @@
 #include <Core/Geometry/IntVector.h>
 #include <Core/Parallel/BufferInfo.h>
 
+#include <map>
+#include <mutex>
 #include <string>
+#include <tuple>
 
 using namespace Uintah;
 
+namespace {
+
+  // The datatype of a window only depends on its base type, size and
+  // the strides of the variable, which are the same every timestep
+  // between regrids.  The committed types are kept for the whole run
+  // (they may still be used by pending pack/unpack operations when a
+  // task graph is recompiled), up to a limit on their number.
+  struct WindowType {
+    MPI_Datatype m_base;
+    IntVector    m_size;
+    IntVector    m_strides;
+
+    bool operator<( const WindowType & other ) const
+    {
+      return std::make_tuple( m_base, m_size.x(), m_size.y(), m_size.z(), m_strides.x(), m_strides.y(), m_strides.z() ) <
+             std::make_tuple( other.m_base, other.m_size.x(), other.m_size.y(), other.m_size.z(),
+                              other.m_strides.x(), other.m_strides.y(), other.m_strides.z() );
+    }
+  };
+
+  const size_t                         g_max_window_types = 4096;
+  std::mutex                           g_window_types_mutex;
+  std::map<WindowType, MPI_Datatype> * g_window_types = new std::map<WindowType, MPI_Datatype>;  // never destroyed, see above
+
+  //______________________________________________________________________
+  //
+  MPI_Datatype
+  createWindowType( MPI_Datatype basetype, const IntVector & d, const IntVector & strides )
+  {
+    MPI_Datatype type1d;
+    Uintah::MPI::Type_create_hvector(d.x(), 1, strides.x(), basetype, &type1d);
+
+    MPI_Datatype type2d;
+    Uintah::MPI::Type_create_hvector(d.y(), 1, strides.y(), type1d, &type2d);
+    Uintah::MPI::Type_free(&type1d);
+
+    MPI_Datatype type3d;
+    Uintah::MPI::Type_create_hvector(d.z(), 1, strides.z(), type2d, &type3d);
+
+    Uintah::MPI::Type_free(   &type2d );
+    Uintah::MPI::Type_commit( &type3d );
+
+    return type3d;
+  }
+
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 void
@@ -49,20 +99,30 @@ GridVariableBase::getMPIBuffer(       BufferInfo & buffer,
   char* startbuf = (char*)getBasePointer();
   startbuf += strides.x()*off.x()+strides.y()*off.y()+strides.z()*off.z();
   IntVector d = high-low;
-  MPI_Datatype type1d;
-  Uintah::MPI::Type_create_hvector(d.x(), 1, strides.x(), basetype, &type1d);
 
-  MPI_Datatype type2d;
-  Uintah::MPI::Type_create_hvector(d.y(), 1, strides.y(), type1d, &type2d);
-  Uintah::MPI::Type_free(&type1d);
+  if( buffer.packsWindows() ) {
+    // The buffer copies the rows of the window itself.
+    d = Max( d, IntVector( 0, 0, 0 ) );
+    buffer.addWindow( startbuf, (size_t)d.x() * strides.x(), d.y(), d.z(), strides.y(), strides.z() );
+    return;
+  }
 
-  MPI_Datatype type3d;
-  Uintah::MPI::Type_create_hvector(d.z(), 1, strides.z(), type2d, &type3d);
+  WindowType key{ basetype, d, strides };
 
-  Uintah::MPI::Type_free(   &type2d );
-  Uintah::MPI::Type_commit( &type3d );
+  std::lock_guard<std::mutex> lock( g_window_types_mutex );
 
-  buffer.add( startbuf, 1, type3d, true );
+  auto iter = g_window_types->find( key );
+  if( iter != g_window_types->end() ) {
+    buffer.add( startbuf, 1, iter->second, false );
+  }
+  else if( g_window_types->size() < g_max_window_types ) {
+    MPI_Datatype type3d = createWindowType( basetype, d, strides );
+    g_window_types->emplace( key, type3d );
+    buffer.add( startbuf, 1, type3d, false );
+  }
+  else {
+    buffer.add( startbuf, 1, createWindowType( basetype, d, strides ), true );
+  }
 }
 
 //______________________________________________________________________
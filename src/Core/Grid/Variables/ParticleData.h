@@ -27,6 +27,11 @@
 
 #include <Core/Util/RefCounted.h>
 #include <Core/Grid/Variables/ParticleSubset.h> // For particleIndex
+#include <Core/Grid/Variables/VariableMemoryPool.h>
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
 
 namespace Uintah {
 
@@ -52,7 +57,8 @@ KEYWORDS
    ParticleData
 
 DESCRIPTION
-   Long description...
+   The storage behind a ParticleVariable, allocated from the
+   VariableMemoryPool.
   
 WARNING
   
@@ -67,18 +73,43 @@ WARNING
       //////////
       // Insert Documentation Here:
       void resize(int newSize) {
-        T* newdata = scinew T[newSize];
+        T* newdata = allocateData(newSize);
         if(data){
           int smaller = ((newSize < size ) ? newSize:size);
           for(int i = 0; i < smaller; i++)
             newdata[i] = data[i];
-          delete[] data;
+          freeData(data, size);
         }
         data = newdata;
         size = newSize;
       }
 
    private:
+      static const size_t alignment = alignof(T) > 64 ? alignof(T) : 64;
+
+      // The particle counts change every timestep, so the blocks are
+      // rounded up to a size class to be reused by the pool.
+      static size_t blockBytes(particleIndex n) {
+        return VariableMemoryPool::sizeClass(std::max(n, particleIndex(1))*sizeof(T));
+      }
+
+      static T* allocateData(particleIndex n) {
+        T* ptr = static_cast<T*>(VariableMemoryPool::allocate(blockBytes(n), alignment));
+        if(!std::is_trivially_default_constructible<T>::value){
+          for(particleIndex i=0;i<n;i++)
+            new (ptr+i) T;
+        }
+        return ptr;
+      }
+
+      static void freeData(T* ptr, particleIndex n) {
+        if(!std::is_trivially_destructible<T>::value){
+          for(particleIndex i=0;i<n;i++)
+            ptr[i].~T();
+        }
+        VariableMemoryPool::deallocate(ptr, blockBytes(n), alignment);
+      }
+
       ParticleData(const ParticleData<T>&);
       ParticleData<T>& operator=(const ParticleData<T>&);
       friend class ParticleVariable<T>;
@@ -99,14 +130,14 @@ WARNING
      ParticleData<T>::ParticleData(particleIndex size)
      : size(size)
       {
-        data = scinew T[size];
+        data = allocateData(size);
       }
       
    template<class T>
       ParticleData<T>::~ParticleData()
       {
         if(data)
-          delete[] data;
+          freeData(data, size);
       }
 
    template<class T>
@@ -130,6 +130,18 @@ ParticleSubset::fillset()
   }
 }
 
+//______________________________________________________________________
+//
+bool
+ParticleSubset::isContiguous() const
+{
+  for( unsigned int i = 0; i < d_numParticles; i++ ) {
+    if( d_particles[i] != (particleIndex) i ) {
+      return false;
+    }
+  }
+  return true;
+}
 //______________________________________________________________________
 //
 class compareIDFunctor
@@ -135,6 +135,10 @@ WARNING
       return d_numParticles;
     }
 
+    // True if the subset is the identity 0, 1, ..., numParticles()-1,
+    // i.e. the particles are stored densely and in order.  O(n).
+    bool isContiguous() const;
+
     void set(particleIndex idx, particleIndex value) {
       d_particles[idx] = value;
     }
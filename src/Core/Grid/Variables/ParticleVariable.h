@@ -46,6 +46,8 @@
 
 #include <iostream>
 #include <cstring>
+#include <type_traits>
+#include <vector>
 
 
 namespace Uintah {
@@ -165,6 +167,8 @@ public:
                            const ProcessorGroup* pg,
                            ParticleSubset* pset);
   virtual void emitNormal( std::ostream& out, const IntVector&, const IntVector&, ProblemSpecP, bool outputDoubleAsFloat );
+  virtual bool emitSegments( const IntVector&, const IntVector&, ProblemSpecP, bool outputDoubleAsFloat,
+                             std::vector<Segment>& segments );
   virtual void emitPIDX(       PIDXOutputContext & oc,
                                unsigned char     * buffer,
                          const IntVector         & /* l */,
@@ -550,6 +554,40 @@ template<class T>
     }
   }
 
+  // The runs of consecutive particles in the subset, i.e. the same
+  // writes emitNormal() makes.
+  template<class T>
+  bool
+  ParticleVariable<T>::emitSegments( const IntVector            & /* l */,
+                                     const IntVector            & /* h */,
+                                           ProblemSpecP           varnode,
+                                           bool                   outputDoubleAsFloat,
+                                           std::vector<Segment> & segments )
+  {
+    const TypeDescription* td = fun_getTypeDescription((T*)nullptr);
+
+    if( !td->isFlat() || (outputDoubleAsFloat && std::is_same<T, double>::value) ) {
+      return false;
+    }
+
+    if (varnode->findBlock("numParticles") == nullptr) {
+      varnode->appendElement("numParticles", d_pset->numParticles());
+    }
+
+    ParticleSubset::iterator iter = d_pset->begin();
+    while(iter != d_pset->end()){
+      particleIndex start = *iter;
+      iter++;
+      particleIndex end = start+1;
+      while(iter != d_pset->end() && *iter == end) {
+        end++;
+        iter++;
+      }
+      segments.push_back( Segment{ (const char*) &(*this)[start], sizeof(T)*(end-start) } );
+    }
+    return true;
+  }
+
   template<class T>
   void
   ParticleVariable<T>::emitPIDX(       PIDXOutputContext & oc,
@@ -34,11 +34,13 @@
 #include <Core/Util/Endian.h>
 #include <Core/Util/FancyAssert.h>
 #include <Core/Util/SizeTypeConvert.h>
+#include <Core/Util/Timers/Timers.hpp>
 
 #include <CCA/Ports/InputContext.h>
 #include <CCA/Ports/OutputContext.h>
 #include <CCA/Ports/PIDXOutputContext.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cerrno>
 #include <cstdio>
@@ -48,6 +50,10 @@
 
 #include <zlib.h>
 
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+
 
 using namespace Uintah;
 
@@ -83,31 +89,38 @@ Variable::emit(       OutputContext & oc
               , const std::string   & compressionModeHint
               )
 {
-  bool use_gzip = false;
-  bool used_gzip = false;
-  if (compressionModeHint == "gzip") {
-    use_gzip = true;
-  }
-  else if (compressionModeHint != "" && compressionModeHint != "none") {
+  if (!isValidCompressionMode(compressionModeHint)) {
     std::cout << "Invalid Compression Mode - throwing exception...\n";
     SCI_THROW(InvalidCompressionMode(compressionModeHint, "", __FILE__, __LINE__));
   }
 
-  used_gzip = use_gzip;
+  // Write the variable's memory directly if it can be described as
+  // contiguous segments, otherwise serialize it into a stream.
+  std::vector<Segment> segments;
+  if (emitSegments(l, h, oc.varnode, oc.outputDoubleAsFloat, segments)) {
+    return emitContiguous(oc, segments, compressionModeHint);
+  }
 
   std::ostringstream outstream;
   emitNormal(outstream, l, h, oc.varnode, oc.outputDoubleAsFloat);
 
+  // Asynchronous output - hand the serialized bytes back, the output
+  // thread compresses and writes them.
+  if (oc.staging != nullptr) {
+    *oc.staging = outstream.str();
+    oc.compressionMode = compressionModeHint;
+    return oc.staging->size();
+  }
+
   std::string preGzip = outstream.str();
   std::string buffer;  // trying to avoid copying the strings back and forth
-  std::string* writeoutString = &preGzip;
+  std::string compressionMode;
 
-  if (use_gzip) {
-    writeoutString = gzipCompress(&preGzip, &buffer);
-    if (writeoutString != &buffer) {
-      used_gzip = false;  // gzip wasn't better, so it wasn't used
-    }
-  }
+  Timers::Simple timer;
+  timer.start();
+  oc.uncompressedSize = preGzip.size();
+  std::string* writeoutString = compress(&preGzip, &buffer, compressionModeHint, compressionMode);
+  oc.compressionSeconds = timer().seconds();
 
   errno = -1;
   const char* writebuffer = (*writeoutString).c_str();
@@ -125,24 +138,168 @@ Variable::emit(       OutputContext & oc
     oc.cur += writebufferSize;
   }
 
-  std::string compressionMode = compressionModeHint;
-  if (used_gzip != use_gzip) {
-    // compression mode string changes
-    if (used_gzip) {
-      compressionMode = "gzip";
+  if (compressionMode != "") {
+    oc.varnode->appendElement("compression", compressionMode);
+  }
+
+  return writebufferSize;
+}
+
+//______________________________________________________________________
+//
+size_t
+Variable::emitContiguous(       OutputContext        & oc
+                        , const std::vector<Segment> & segments
+                        , const std::string          & compressionModeHint
+                        )
+{
+  size_t uncompressedSize = 0;
+  for (const auto & segment : segments) {
+    uncompressedSize += segment.m_size;
+  }
+
+  // Asynchronous output - one copy into the staging buffer.
+  if (oc.staging != nullptr) {
+    oc.staging->clear();
+    oc.staging->reserve(uncompressedSize);
+    for (const auto & segment : segments) {
+      oc.staging->append(segment.m_data, segment.m_size);
     }
-    else {
-      compressionMode = "";
+    oc.compressionMode = compressionModeHint;
+    return uncompressedSize;
+  }
+
+  // Only the compressed data is buffered.  gzip is only used if it
+  // turns out smaller than the original, the registry modes store
+  // incompressible chunks as is and are always used.
+  Timers::Simple timer;
+  timer.start();
+
+  std::string compressed;
+  std::string compressionMode;
+  if (compressionModeHint == "gzip") {
+    if (gzipCompress(segments, uncompressedSize, &compressed)) {
+      compressionMode = "gzip";
     }
   }
+  else if (compressionModeHint != "" && compressionModeHint != "none") {
+    CompressionCodecRegistry::compress(compressionModeHint, segments, compressed);
+    compressionMode = compressionModeHint;
+  }
+
+  oc.uncompressedSize   = uncompressedSize;
+  oc.compressionSeconds = timer().seconds();
 
-  if (compressionMode != "" && compressionMode != "none") {
+  size_t writebufferSize;
+  if (compressionMode != "") {
+    writeFully(oc.fd, oc.filename, std::vector<Segment>(1, Segment{compressed.data(), compressed.size()}));
+    writebufferSize = compressed.size();
     oc.varnode->appendElement("compression", compressionMode);
   }
+  else {
+    writeFully(oc.fd, oc.filename, segments);
+    writebufferSize = uncompressedSize;
+  }
+
+  oc.cur += writebufferSize;
 
   return writebufferSize;
 }
 
+//______________________________________________________________________
+//
+void
+Variable::writeFully(       int                    fd
+                    , const char                 * filename
+                    , const std::vector<Segment> & segments
+                    )
+{
+  std::vector<struct iovec> iov;
+  iov.reserve(std::min(segments.size(), (size_t)IOV_MAX));
+
+  size_t next = 0;
+  while (next < segments.size()) {
+    // Gather up to IOV_MAX segments per writev call.
+    iov.clear();
+    size_t wanted = 0;
+    for (; next < segments.size() && iov.size() < (size_t)IOV_MAX; ++next) {
+      if (segments[next].m_size > 0) {
+        iov.push_back({const_cast<char*>(segments[next].m_data), segments[next].m_size});
+        wanted += segments[next].m_size;
+      }
+    }
+
+    // Retry partial writes from where they stopped.
+    size_t first = 0;
+    while (wanted > 0) {
+      errno = -1;
+      ssize_t s = ::writev(fd, &iov[first], (int)(iov.size() - first));
+
+      if (s == -1 && errno == EINTR) {
+        continue;
+      }
+      if (s <= 0) {
+        std::cerr << "\nVariable::emit - writev system call failed writing to " << filename << " with errno " << errno << ": "
+                  << strerror(errno) << std::endl;
+        std::cerr << " * wanted to write: " << wanted << ", but actually wrote " << s << "\n\n";
+
+        SCI_THROW(ErrnoException("Variable::emit (writev call)", errno, __FILE__, __LINE__));
+      }
+
+      wanted -= s;
+      while (s > 0 && (size_t)s >= iov[first].iov_len) {
+        s -= iov[first].iov_len;
+        ++first;
+      }
+      if (s > 0) {
+        iov[first].iov_base = (char*)iov[first].iov_base + s;
+        iov[first].iov_len -= s;
+      }
+    }
+  }
+}
+
+//______________________________________________________________________
+//
+bool
+Variable::isValidCompressionMode( const std::string & compressionMode )
+{
+  return compressionMode == "" || compressionMode == "none" || compressionMode == "gzip" ||
+         CompressionCodecRegistry::isValid(compressionMode);
+}
+
+//______________________________________________________________________
+//
+std::string*
+Variable::compress(       std::string * pUncompressed
+                  ,       std::string * pBuffer
+                  , const std::string & compressionModeHint
+                  ,       std::string & compressionMode
+                  )
+{
+  compressionMode = "";
+
+  if (compressionModeHint == "" || compressionModeHint == "none") {
+    return pUncompressed;
+  }
+  else if (compressionModeHint != "gzip") {
+    pBuffer->clear();
+    CompressionCodecRegistry::compress(compressionModeHint, std::vector<Segment>(1, Segment{pUncompressed->data(), pUncompressed->size()}), *pBuffer);
+    compressionMode = compressionModeHint;
+    pUncompressed->erase();
+    return pBuffer;
+  }
+
+  std::string* result = gzipCompress(pUncompressed, pBuffer);
+
+  // gzip wasn't better, so it wasn't used
+  if (result == pBuffer) {
+    compressionMode = "gzip";
+  }
+
+  return result;
+}
+
 //______________________________________________________________________
 //
 #if HAVE_PIDX
@@ -195,7 +352,7 @@ Variable::gzipCompress( std::string* pUncompressed
   char* buf = const_cast<char*>(pBuffer->c_str());  // casting from const
   buf += sizeof(ssize_t);  // the first part will give the size of the uncompressed data
 
-  if (compress((Bytef*)buf, &compressBufsize, (const Bytef*)pUncompressed->c_str(), uncompressedSize) != Z_OK)
+  if (::compress((Bytef*)buf, &compressBufsize, (const Bytef*)pUncompressed->c_str(), uncompressedSize) != Z_OK)
     std::cerr << "compress failed in Uintah::Variable::gzipCompress\n";
 
   pBuffer->resize(compressBufsize + sizeof(ssize_t));
@@ -216,6 +373,75 @@ Variable::gzipCompress( std::string* pUncompressed
   }
 }
 
+//______________________________________________________________________
+//
+bool
+Variable::gzipCompress( const std::vector<Segment> & segments
+                      ,       size_t                 uncompressedSize
+                      ,       std::string          * pBuffer
+                      )
+{
+  // Same layout as gzipCompress(string*): the uncompressed size
+  // followed by the zlib stream.  deflate with the default level
+  // produces the same stream as compress() regardless of how the
+  // input is split up.
+  pBuffer->clear();
+  unsigned long size = uncompressedSize;
+  pBuffer->append((const char*)&size, sizeof(ssize_t));
+
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  if (deflateInit(&strm, Z_DEFAULT_COMPRESSION) != Z_OK) {
+    std::cerr << "deflateInit failed in Uintah::Variable::gzipCompress\n";
+    pBuffer->clear();
+    return false;
+  }
+
+  const size_t chunk = 1 << 18;
+  std::vector<char> out(chunk);
+  bool worse = false;
+
+  for (size_t i = 0; i <= segments.size() && !worse; ++i) {
+    const bool last = (i == segments.size());
+
+    // zlib counts in uInt, split huge segments.
+    const char * data = last ? nullptr : segments[i].m_data;
+    size_t       left = last ? 0       : segments[i].m_size;
+
+    do {
+      const uInt in = (uInt)std::min(left, (size_t)(1u << 30));
+      strm.next_in  = (Bytef*)data;
+      strm.avail_in = in;
+      data += in;
+      left -= in;
+
+      const int flush = last ? Z_FINISH : Z_NO_FLUSH;
+      int rc;
+      do {
+        strm.next_out  = (Bytef*)out.data();
+        strm.avail_out = (uInt)chunk;
+        rc = deflate(&strm, flush);
+        pBuffer->append(out.data(), chunk - strm.avail_out);
+
+        // gzip made it worse -- forget that
+        if (pBuffer->size() > uncompressedSize) {
+          worse = true;
+          break;
+        }
+      } while (strm.avail_out == 0 || (flush == Z_FINISH && rc != Z_STREAM_END));
+    } while (left > 0 && !worse);
+  }
+
+  deflateEnd(&strm);
+
+  if (worse) {
+    std::string().swap(*pBuffer);
+    return false;
+  }
+
+  return true;
+}
+
 //______________________________________________________________________
 //
 void
@@ -226,11 +452,15 @@ Variable::read(       InputContext & ic
               , const std::string  & compressionMode
               )
 {
-  bool use_gzip = false;
+  bool use_gzip  = false;
+  bool use_codec = false;
 
   if (compressionMode == "gzip") {
     use_gzip = true;
   }
+  else if (CompressionCodecRegistry::isValid(compressionMode)) {
+    use_codec = true;
+  }
   else if (compressionMode != "" && compressionMode != "none") {
     SCI_THROW(InvalidCompressionMode(compressionMode, "", __FILE__, __LINE__));
   }
@@ -296,6 +526,12 @@ Variable::read(       InputContext & ic
 
       uncompressedData = &bufferStr;
     }
+    //__________________________________
+    // CompressionCodecRegistry modes
+    else if (use_codec) {
+      CompressionCodecRegistry::decompress(compressionMode, data.data(), data.size(), bufferStr);
+      uncompressedData = &bufferStr;
+    }
 
     //__________________________________
     // uncompressed
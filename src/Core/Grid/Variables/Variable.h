@@ -25,12 +25,14 @@
 #ifndef CORE_GRID_VARIABLES_VARIABLE_H
 #define CORE_GRID_VARIABLES_VARIABLE_H
 
+#include <Core/IO/CompressionCodec.h>
 #include <Core/ProblemSpec/ProblemSpec.h>
 
 #include <sci_defs/pidx_defs.h>
 
 #include <string>
 #include <iosfwd>
+#include <vector>
 
 namespace Uintah {
 
@@ -128,6 +130,24 @@ public:
 
   virtual void readNormal( std::istream& in, bool swapbytes ) = 0;
 
+  // A contiguous piece of a variable's own memory.
+  typedef CompressionSegment Segment;
+
+  // Describes the bytes emitNormal() would produce as a list of
+  // pieces of the variable's memory, in output order, so emit() can
+  // write them directly without serializing into a stream first.
+  // Returns false if the data has to be converted (e.g. doubles
+  // written as floats) and emitNormal() must be used instead.
+  virtual bool emitSegments( const IntVector            & /* l */
+                           , const IntVector            & /* h */
+                           ,       ProblemSpecP           /* varnode */
+                           ,       bool                   /* outputDoubleAsFloat */
+                           ,       std::vector<Segment> & /* segments */
+                           )
+  {
+    return false;
+  }
+
   virtual void allocate( const Patch* patch, const IntVector& boundary ) = 0;
 
   virtual void getSizeInfo( std::string& elems, unsigned long& totsize, void*& ptr ) const = 0;
@@ -145,6 +165,19 @@ public:
 
   virtual RefCounted* getRefCounted() = 0;
 
+  // True for "", "none", "gzip" and the CompressionCodecRegistry modes.
+  static bool isValidCompressionMode( const std::string & compressionMode );
+
+  // Applies the compression mode hint to a serialized variable.
+  // Returns whichever of pUncompressed/pBuffer holds the bytes to be
+  // written and sets compressionMode to the mode actually used (empty
+  // if the data was left uncompressed).
+  static std::string* compress(       std::string * pUncompressed
+                              ,       std::string * pBuffer
+                              , const std::string & compressionModeHint
+                              ,       std::string & compressionMode
+                              );
+
 
 protected:
 
@@ -159,10 +192,31 @@ private:
   Variable( Variable && )                 = delete;
   Variable& operator=( Variable && )      = delete;
 
+  // emit() for variables described by emitSegments().
+  size_t emitContiguous(       OutputContext        & oc
+                       , const std::vector<Segment> & segments
+                       , const std::string          & compressionModeHint
+                       );
+
+  // writev()s the segments, retrying partial writes.
+  static void writeFully(       int                    fd
+                        , const char                 * filename
+                        , const std::vector<Segment> & segments
+                        );
+
+  // Streaming counterpart of gzipCompress() for emitSegments() data.
+  // Produces the same bytes as gzipCompress() would for the
+  // concatenated segments. Returns false (and leaves pBuffer empty)
+  // if compression does not make the data smaller.
+  static bool gzipCompress( const std::vector<Segment> & segments
+                          ,       size_t                 uncompressedSize
+                          ,       std::string          * pBuffer
+                          );
+
   // Compresses the string pointed to by pUncompressed and but the resulting
   // compressed data into the string pointed to by pBuffer.
   // Returns the pointer to whichever one is shortest and erases the  other one.
-  std::string* gzipCompress( std::string* pUncompressed
+  static std::string* gzipCompress( std::string* pUncompressed
                            , std::string* pBuffer
                            );
 
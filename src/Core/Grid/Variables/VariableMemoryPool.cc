@@ -0,0 +1,211 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Core/Grid/Variables/VariableMemoryPool.h>
+
+#include <Core/Exceptions/InternalError.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+using namespace Uintah;
+
+namespace {
+
+  typedef std::pair<size_t, size_t> SizeClass;  // (bytes, alignment)
+
+  std::mutex                               g_mutex;
+  std::map<SizeClass, std::vector<void*> > g_free;
+  std::atomic<size_t>                      g_budget{0};  // read without g_mutex to bypass a disabled pool
+  VariableMemoryPool::Stats                g_stats;
+
+  //______________________________________________________________________
+  //
+  void*
+  systemAllocate( size_t bytes, size_t alignment )
+  {
+    void* ptr = nullptr;
+    if( posix_memalign( &ptr, alignment, bytes ) != 0 ) {
+      std::ostringstream msg;
+      msg << "VariableMemoryPool: failed to allocate " << bytes << " bytes";
+      SCI_THROW( InternalError( msg.str(), __FILE__, __LINE__ ) );
+    }
+    return ptr;
+  }
+
+  //______________________________________________________________________
+  //  Frees retained blocks (other than those of 'keep') until 'bytes'
+  //  more fit into the budget.  Called with g_mutex held.
+  bool
+  makeRoom( size_t bytes, const SizeClass & keep )
+  {
+    auto iter = g_free.begin();
+    while( g_stats.m_retainedBytes + bytes > g_budget && iter != g_free.end() ) {
+      if( iter->first == keep ) {
+        ++iter;
+        continue;
+      }
+      while( !iter->second.empty() && g_stats.m_retainedBytes + bytes > g_budget ) {
+        free( iter->second.back() );
+        iter->second.pop_back();
+        g_stats.m_retainedBytes -= iter->first.first;
+      }
+      if( iter->second.empty() ) {
+        iter = g_free.erase( iter );
+      }
+      else {
+        ++iter;
+      }
+    }
+    return g_stats.m_retainedBytes + bytes <= g_budget;
+  }
+
+  // Frees the retained memory at exit.  Variables destroyed later
+  // go straight back to the system.
+  struct PoolGuard {
+    ~PoolGuard() {
+      VariableMemoryPool::setBudget( 0 );
+    }
+  } g_pool_guard;
+
+}
+
+//______________________________________________________________________
+//
+void
+VariableMemoryPool::setBudget( size_t bytes )
+{
+  std::lock_guard<std::mutex> lock( g_mutex );
+  g_budget.store( bytes, std::memory_order_relaxed );
+  makeRoom( 0, SizeClass( 0, 0 ) );
+}
+
+//______________________________________________________________________
+//
+size_t
+VariableMemoryPool::getBudget()
+{
+  return g_budget.load( std::memory_order_relaxed );
+}
+
+//______________________________________________________________________
+//  Powers of two up to 64 KiB, then eight classes per power of two, so
+//  at most 1/8 of a large block is unused.
+size_t
+VariableMemoryPool::sizeClass( size_t bytes )
+{
+  const size_t small = 64 * 1024;
+
+  size_t pow2 = 64;
+  while( pow2 < bytes ) {
+    pow2 *= 2;
+  }
+  if( pow2 <= small ) {
+    return pow2;
+  }
+
+  const size_t step = pow2 / 8;
+  return ( bytes + step - 1 ) / step * step;
+}
+
+//______________________________________________________________________
+//
+void*
+VariableMemoryPool::allocate( size_t bytes, size_t alignment )
+{
+  // a disabled pool (the default) must not serialize the allocations
+  if( g_budget.load( std::memory_order_relaxed ) > 0 ) {
+    std::lock_guard<std::mutex> lock( g_mutex );
+
+    if( g_budget > 0 ) {
+      auto iter = g_free.find( SizeClass( bytes, alignment ) );
+      if( iter != g_free.end() ) {
+        void* ptr = iter->second.back();
+        iter->second.pop_back();
+        if( iter->second.empty() ) {
+          g_free.erase( iter );
+        }
+        g_stats.m_retainedBytes -= bytes;
+        ++g_stats.m_hits;
+        return ptr;
+      }
+      ++g_stats.m_misses;
+    }
+  }
+
+  return systemAllocate( bytes, alignment );
+}
+
+//______________________________________________________________________
+//
+void
+VariableMemoryPool::deallocate( void * ptr, size_t bytes, size_t alignment )
+{
+  if( !ptr ) {
+    return;
+  }
+
+  if( g_budget.load( std::memory_order_relaxed ) > 0 ) {
+    std::lock_guard<std::mutex> lock( g_mutex );
+
+    const SizeClass size_class( bytes, alignment );
+    if( g_budget > 0 && makeRoom( bytes, size_class ) ) {
+      g_free[size_class].push_back( ptr );
+      g_stats.m_retainedBytes += bytes;
+      return;
+    }
+  }
+
+  free( ptr );
+}
+
+//______________________________________________________________________
+//
+void
+VariableMemoryPool::release()
+{
+  std::lock_guard<std::mutex> lock( g_mutex );
+
+  for( auto & size_class : g_free ) {
+    for( void* ptr : size_class.second ) {
+      free( ptr );
+    }
+  }
+  g_free.clear();
+  g_stats.m_retainedBytes = 0;
+}
+
+//______________________________________________________________________
+//
+VariableMemoryPool::Stats
+VariableMemoryPool::getStats()
+{
+  std::lock_guard<std::mutex> lock( g_mutex );
+  return g_stats;
+}
@@ -0,0 +1,96 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CORE_GRID_VARIABLES_VARIABLEMEMORYPOOL_H
+#define CORE_GRID_VARIABLES_VARIABLEMEMORYPOOL_H
+
+#include <cstddef>
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    VariableMemoryPool
+
+  GENERAL INFORMATION
+    VariableMemoryPool.h
+
+  DESCRIPTION
+    Recycles the memory of grid (Array3Data) and particle
+    (ParticleData) variables.
+
+    Every timestep the new DataWarehouse allocates variables of the
+    same shapes the old one frees.  Instead of going back to the
+    system allocator (large blocks are mmap'ed and munmap'ed, and
+    their pages faulted in again), freed blocks are kept in size
+    classes keyed by (bytes, alignment) and handed out again.
+
+    The retained memory is bounded by a budget (the <Scheduler>
+    option <variablePoolMB>).  A freed block that does not fit
+    evicts blocks of other size classes, so the pool follows the
+    shapes after a regrid.  A budget of 0 (the default) disables
+    the pool.
+
+    Variables whose size changes every timestep (particles) round
+    their requests up with sizeClass(), otherwise they would rarely
+    find a block of their exact size.
+
+    All functions are thread safe.
+
+****************************************/
+
+class VariableMemoryPool {
+
+public:
+
+  struct Stats {
+    unsigned long m_hits{0};           // allocations served from the pool
+    unsigned long m_misses{0};         // allocations from the system
+    size_t        m_retainedBytes{0};  // free memory held by the pool
+  };
+
+  static void   setBudget( size_t bytes );
+  static size_t getBudget();
+
+  // 'alignment' is a power of two.  Throws an InternalError when out
+  // of memory.
+  static void* allocate( size_t bytes, size_t alignment );
+
+  // 'bytes' and 'alignment' as given to allocate().
+  static void  deallocate( void * ptr, size_t bytes, size_t alignment );
+
+  // 'bytes' rounded up to the next of a set of sizes, the same for
+  // allocate() and deallocate() whether or not the pool is enabled.
+  static size_t sizeClass( size_t bytes );
+
+  // Returns all retained memory to the system.
+  static void  release();
+
+  static Stats getStats();
+};
+
+} // End namespace Uintah
+
+#endif // CORE_GRID_VARIABLES_VARIABLEMEMORYPOOL_H
@@ -39,7 +39,9 @@ SRCS += \
         $(SRCDIR)/ListOfCellsIterator.cc        \
         $(SRCDIR)/DifferenceIterator.cc         \
         $(SRCDIR)/UnionIterator.cc              \
+        $(SRCDIR)/VariableMemoryPool.cc         \
         $(SRCDIR)/ComputeSet.cc                 \
+        $(SRCDIR)/Array3Data.cc                 \
         $(SRCDIR)/ComputeSet_special.cc         \
         $(SRCDIR)/GridVariableBase.cc           \
         $(SRCDIR)/LocallyComputedPatchVarMap.cc \
@@ -72,6 +72,7 @@ PSELIBS := \
         Core/Exceptions  \
         Core/Util        \
         Core/Containers  \
+        Core/IO          \
         Core/Parallel    \
         Core/ProblemSpec \
         Core/Exceptions  \
@@ -0,0 +1,543 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Core/IO/CompressionCodec.h>
+
+#include <Core/Exceptions/InternalError.h>
+#include <Core/Exceptions/InvalidCompressionMode.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <thread>
+
+#include <zlib.h>
+
+using namespace Uintah;
+
+namespace {
+
+  const size_t CHUNK_SIZE   = 1 << 20;  // multiple of the shuffle word size
+  const size_t SHUFFLE_WORD = 8;
+
+  //______________________________________________________________________
+  //  Little-endian header words.
+  void
+  put64( std::string & out, uint64_t value )
+  {
+    for( int i = 0; i < 8; ++i ) {
+      out.push_back( (char) ((value >> (8 * i)) & 0xff) );
+    }
+  }
+
+  uint64_t
+  get64( const char * in )
+  {
+    uint64_t value = 0;
+    for( int i = 0; i < 8; ++i ) {
+      value |= (uint64_t) (unsigned char) in[i] << (8 * i);
+    }
+    return value;
+  }
+
+  //______________________________________________________________________
+  //  Byte transpose of 8 byte words; a trailing partial word is copied.
+  void
+  shuffle( const char * in, size_t size, char * out )
+  {
+    const size_t n = size / SHUFFLE_WORD;
+    for( size_t b = 0; b < SHUFFLE_WORD; ++b ) {
+      for( size_t i = 0; i < n; ++i ) {
+        out[b * n + i] = in[i * SHUFFLE_WORD + b];
+      }
+    }
+    memcpy( out + n * SHUFFLE_WORD, in + n * SHUFFLE_WORD, size - n * SHUFFLE_WORD );
+  }
+
+  void
+  unshuffle( const char * in, size_t size, char * out )
+  {
+    const size_t n = size / SHUFFLE_WORD;
+    for( size_t b = 0; b < SHUFFLE_WORD; ++b ) {
+      for( size_t i = 0; i < n; ++i ) {
+        out[i * SHUFFLE_WORD + b] = in[b * n + i];
+      }
+    }
+    memcpy( out + n * SHUFFLE_WORD, in + n * SHUFFLE_WORD, size - n * SHUFFLE_WORD );
+  }
+
+  //______________________________________________________________________
+  //  Runs work(i) for i in [0, n) on up to 'numThreads' threads and
+  //  rethrows the first exception.
+  void
+  parallelFor( size_t n, int numThreads, const std::function<void(size_t)> & work )
+  {
+    std::atomic<size_t> next{0};
+    std::exception_ptr  error;
+    std::atomic<bool>   failed{false};
+
+    auto worker = [&]() {
+      for( size_t i = next++; i < n && !failed; i = next++ ) {
+        try {
+          work( i );
+        }
+        catch( ... ) {
+          if( !failed.exchange( true ) ) {
+            error = std::current_exception();
+          }
+        }
+      }
+    };
+
+    const size_t helpers = std::min( (size_t) std::max( numThreads, 1 ), n ) - (n > 0 ? 1 : 0);
+
+    std::vector<std::thread> threads;
+    for( size_t t = 0; t < helpers; ++t ) {
+      threads.push_back( std::thread( worker ) );
+    }
+    worker();
+    for( auto & thread : threads ) {
+      thread.join();
+    }
+
+    if( error ) {
+      std::rethrow_exception( error );
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  class LZCodec : public CompressionCodec {
+
+  public:
+
+    // LZ4-style sequences: a token (literal length << 4 | match
+    // length - 4), extra length bytes for values >= 15, the literals
+    // and a 16 bit match offset.  The last sequence has literals only.
+
+    virtual void compress( const char * in, size_t size, std::string & out ) const
+    {
+      const unsigned char * src = (const unsigned char *) in;
+
+      std::vector<uint32_t> table( HASH_SIZE, 0 );  // position + 1
+
+      size_t ip     = 0;
+      size_t anchor = 0;
+      const size_t limit = size > MF_LIMIT ? size - MF_LIMIT : 0;
+
+      while( ip < limit ) {
+        const uint32_t seq  = read32( src + ip );
+        const uint32_t hash = (seq * 2654435761u) >> (32 - HASH_LOG);
+        const size_t   ref  = table[hash];
+        table[hash] = (uint32_t) (ip + 1);
+
+        if( ref == 0 || ip - (ref - 1) > MAX_OFFSET || read32( src + ref - 1 ) != seq ) {
+          // Skip faster through incompressible data.
+          ip += 1 + ((ip - anchor) >> 6);
+          continue;
+        }
+
+        const size_t match  = ref - 1;
+        const size_t maxlen = size - LAST_LITERALS - ip;
+        size_t len = MIN_MATCH;
+        while( len < maxlen && src[match + len] == src[ip + len] ) {
+          ++len;
+        }
+
+        putSequence( out, src + anchor, ip - anchor, len, ip - match );
+
+        ip    += len;
+        anchor = ip;
+      }
+
+      // Last literals
+      putSequence( out, src + anchor, size - anchor, 0, 0 );
+    }
+
+    virtual void decompress( const char * in, size_t size, char * out, size_t outSize ) const
+    {
+      const unsigned char * ip     = (const unsigned char *) in;
+      const unsigned char * ip_end = ip + size;
+      unsigned char       * op     = (unsigned char *) out;
+      unsigned char       * op_end = op + outSize;
+
+      while( ip < ip_end ) {
+        const unsigned token = *ip++;
+
+        size_t literals = token >> 4;
+        if( literals == 15 ) {
+          literals += getLength( ip, ip_end );
+        }
+        if( literals > (size_t) (ip_end - ip) || literals > (size_t) (op_end - op) ) {
+          corrupt();
+        }
+        memcpy( op, ip, literals );
+        ip += literals;
+        op += literals;
+
+        if( ip == ip_end ) {
+          break;  // last sequence
+        }
+
+        if( ip_end - ip < 2 ) {
+          corrupt();
+        }
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        size_t len = token & 15;
+        if( len == 15 ) {
+          len += getLength( ip, ip_end );
+        }
+        len += MIN_MATCH;
+
+        if( offset == 0 || offset > (size_t) (op - (unsigned char *) out) || len > (size_t) (op_end - op) ) {
+          corrupt();
+        }
+
+        // May overlap - copy forward byte by byte.
+        const unsigned char * match = op - offset;
+        for( size_t i = 0; i < len; ++i ) {
+          op[i] = match[i];
+        }
+        op += len;
+      }
+
+      if( op != op_end ) {
+        corrupt();
+      }
+    }
+
+  private:
+
+    static const int    HASH_LOG      = 14;
+    static const size_t HASH_SIZE     = 1 << HASH_LOG;
+    static const size_t MIN_MATCH     = 4;
+    static const size_t MAX_OFFSET    = 65535;
+    static const size_t LAST_LITERALS = 5;
+    static const size_t MF_LIMIT      = 12;
+
+    static uint32_t read32( const unsigned char * p )
+    {
+      uint32_t value;
+      memcpy( &value, p, sizeof( value ) );
+      return value;
+    }
+
+    static void putLength( std::string & out, size_t length )
+    {
+      while( length >= 255 ) {
+        out.push_back( (char) 255 );
+        length -= 255;
+      }
+      out.push_back( (char) length );
+    }
+
+    static size_t getLength( const unsigned char *& ip, const unsigned char * ip_end )
+    {
+      size_t length = 0;
+      unsigned byte;
+      do {
+        if( ip == ip_end ) {
+          corrupt();
+        }
+        byte    = *ip++;
+        length += byte;
+      } while( byte == 255 );
+      return length;
+    }
+
+    // A match length of 0 marks the last (literals only) sequence.
+    static void putSequence( std::string & out, const unsigned char * literals, size_t numLiterals,
+                             size_t matchLength, size_t offset )
+    {
+      const size_t ml = matchLength ? matchLength - MIN_MATCH : 0;
+
+      out.push_back( (char) ((std::min( numLiterals, (size_t) 15 ) << 4) | std::min( ml, (size_t) 15 )) );
+      if( numLiterals >= 15 ) {
+        putLength( out, numLiterals - 15 );
+      }
+      out.append( (const char *) literals, numLiterals );
+
+      if( matchLength ) {
+        out.push_back( (char) (offset & 0xff) );
+        out.push_back( (char) (offset >> 8) );
+        if( ml >= 15 ) {
+          putLength( out, ml - 15 );
+        }
+      }
+    }
+
+    static void corrupt()
+    {
+      SCI_THROW( InternalError( "LZCodec::decompress: corrupt data", __FILE__, __LINE__ ) );
+    }
+  };
+
+  //______________________________________________________________________
+  //
+  class ZlibCodec : public CompressionCodec {
+
+  public:
+
+    virtual void compress( const char * in, size_t size, std::string & out ) const
+    {
+      const size_t start = out.size();
+      uLongf       bound = compressBound( size );
+
+      out.resize( start + bound );
+      if( ::compress( (Bytef *) &out[start], &bound, (const Bytef *) in, size ) != Z_OK ) {
+        SCI_THROW( InternalError( "ZlibCodec::compress: compress failed", __FILE__, __LINE__ ) );
+      }
+      out.resize( start + bound );
+    }
+
+    virtual void decompress( const char * in, size_t size, char * out, size_t outSize ) const
+    {
+      uLongf length = outSize;
+      if( ::uncompress( (Bytef *) out, &length, (const Bytef *) in, size ) != Z_OK || length != outSize ) {
+        SCI_THROW( InternalError( "ZlibCodec::decompress: uncompress failed", __FILE__, __LINE__ ) );
+      }
+    }
+  };
+
+}
+
+int CompressionCodecRegistry::s_num_threads = 1;
+
+//______________________________________________________________________
+//
+std::map<std::string, std::shared_ptr<CompressionCodec>> &
+CompressionCodecRegistry::codecs()
+{
+  static std::map<std::string, std::shared_ptr<CompressionCodec>> s_codecs = {
+    { "lz",   std::make_shared<LZCodec>()   },
+    { "zlib", std::make_shared<ZlibCodec>() }
+  };
+  return s_codecs;
+}
+
+//______________________________________________________________________
+//
+void
+CompressionCodecRegistry::registerCodec( const std::string & name, std::shared_ptr<CompressionCodec> codec )
+{
+  codecs()[name] = codec;
+}
+
+//______________________________________________________________________
+//
+std::vector<std::string>
+CompressionCodecRegistry::codecNames()
+{
+  std::vector<std::string> names;
+  for( auto & codec : codecs() ) {
+    names.push_back( codec.first );
+  }
+  return names;
+}
+
+//______________________________________________________________________
+//
+void
+CompressionCodecRegistry::setNumThreads( int numThreads )
+{
+  s_num_threads = std::max( numThreads, 1 );
+}
+
+//______________________________________________________________________
+//
+int
+CompressionCodecRegistry::getNumThreads()
+{
+  return s_num_threads;
+}
+
+//______________________________________________________________________
+//
+CompressionCodecRegistry::Mode
+CompressionCodecRegistry::parse( const std::string & mode )
+{
+  Mode result;
+  std::string name = mode;
+
+  const std::string filter = "shuffle+";
+  if( name.compare( 0, filter.size(), filter ) == 0 ) {
+    result.m_shuffle = true;
+    name = name.substr( filter.size() );
+  }
+
+  auto iter = codecs().find( name );
+  if( iter != codecs().end() ) {
+    result.m_codec = iter->second.get();
+  }
+  return result;
+}
+
+//______________________________________________________________________
+//
+bool
+CompressionCodecRegistry::isValid( const std::string & mode )
+{
+  return parse( mode ).m_codec != nullptr;
+}
+
+//______________________________________________________________________
+//
+void
+CompressionCodecRegistry::compress( const std::string                     & mode
+                                  , const std::vector<CompressionSegment> & segments
+                                  ,       std::string                     & out
+                                  )
+{
+  const Mode codec = parse( mode );
+  if( codec.m_codec == nullptr ) {
+    SCI_THROW( InvalidCompressionMode( mode, "", __FILE__, __LINE__ ) );
+  }
+
+  // Offset of each segment in the concatenated data.
+  std::vector<size_t> offsets( segments.size() + 1, 0 );
+  for( size_t i = 0; i < segments.size(); ++i ) {
+    offsets[i + 1] = offsets[i] + segments[i].m_size;
+  }
+  const size_t total     = offsets.back();
+  const size_t numChunks = (total + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  std::vector<std::string> chunks( numChunks );
+
+  parallelFor( numChunks, s_num_threads, [&]( size_t c ) {
+    const size_t begin = c * CHUNK_SIZE;
+    const size_t size  = std::min( CHUNK_SIZE, total - begin );
+
+    // Use the data in place if the chunk lies within one segment.
+    size_t seg = std::upper_bound( offsets.begin(), offsets.end(), begin ) - offsets.begin() - 1;
+    const char * data = nullptr;
+    std::string  gathered;
+
+    if( begin + size <= offsets[seg + 1] && !codec.m_shuffle ) {
+      data = segments[seg].m_data + (begin - offsets[seg]);
+    }
+    else {
+      gathered.resize( size );
+      for( size_t done = 0; done < size; ++seg ) {
+        const size_t from = begin + done - offsets[seg];
+        const size_t n    = std::min( segments[seg].m_size - from, size - done );
+        memcpy( &gathered[done], segments[seg].m_data + from, n );
+        done += n;
+      }
+
+      if( codec.m_shuffle ) {
+        std::string shuffled( size, '\0' );
+        shuffle( gathered.data(), size, &shuffled[0] );
+        gathered.swap( shuffled );
+      }
+      data = gathered.data();
+    }
+
+    codec.m_codec->compress( data, size, chunks[c] );
+
+    // Store chunks that did not compress.
+    if( chunks[c].size() >= size ) {
+      chunks[c].assign( data, size );
+    }
+  } );
+
+  put64( out, total );
+  put64( out, CHUNK_SIZE );
+  put64( out, numChunks );
+  for( auto & chunk : chunks ) {
+    put64( out, chunk.size() );
+  }
+  for( auto & chunk : chunks ) {
+    out.append( chunk );
+    std::string().swap( chunk );
+  }
+}
+
+//______________________________________________________________________
+//
+void
+CompressionCodecRegistry::decompress( const std::string & mode
+                                    , const char        * in
+                                    ,       size_t        size
+                                    ,       std::string & out
+                                    )
+{
+  const Mode codec = parse( mode );
+  if( codec.m_codec == nullptr ) {
+    SCI_THROW( InvalidCompressionMode( mode, "", __FILE__, __LINE__ ) );
+  }
+
+  if( size < 24 ) {
+    SCI_THROW( InternalError( "CompressionCodecRegistry::decompress: truncated header", __FILE__, __LINE__ ) );
+  }
+
+  const uint64_t total     = get64( in );
+  const uint64_t chunkSize = get64( in + 8 );
+  const uint64_t numChunks = get64( in + 16 );
+
+  if( chunkSize == 0 || numChunks != (total + chunkSize - 1) / chunkSize || 24 + 8 * numChunks > size ) {
+    SCI_THROW( InternalError( "CompressionCodecRegistry::decompress: corrupt header", __FILE__, __LINE__ ) );
+  }
+
+  // Where each compressed chunk starts.
+  std::vector<size_t> starts( numChunks + 1 );
+  starts[0] = 24 + 8 * numChunks;
+  for( uint64_t c = 0; c < numChunks; ++c ) {
+    starts[c + 1] = starts[c] + get64( in + 24 + 8 * c );
+  }
+  if( starts[numChunks] != size ) {
+    SCI_THROW( InternalError( "CompressionCodecRegistry::decompress: corrupt chunk sizes", __FILE__, __LINE__ ) );
+  }
+
+  out.resize( total );
+
+  parallelFor( numChunks, s_num_threads, [&]( size_t c ) {
+    const size_t begin    = c * chunkSize;
+    const size_t length   = std::min( (size_t) chunkSize, (size_t) (total - begin) );
+    const char * chunk    = in + starts[c];
+    const size_t csize    = starts[c + 1] - starts[c];
+
+    std::string tmp;
+    char * dest = &out[begin];
+    if( codec.m_shuffle ) {
+      tmp.resize( length );
+      dest = &tmp[0];
+    }
+
+    if( csize == length ) {
+      memcpy( dest, chunk, length );
+    }
+    else {
+      codec.m_codec->decompress( chunk, csize, dest, length );
+    }
+
+    if( codec.m_shuffle ) {
+      unshuffle( tmp.data(), length, &out[begin] );
+    }
+  } );
+}
@@ -0,0 +1,166 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CORE_IO_COMPRESSIONCODEC_H
+#define CORE_IO_COMPRESSIONCODEC_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Uintah {
+
+// A contiguous piece of the data to compress.
+struct CompressionSegment {
+  const char * m_data;
+  size_t       m_size;
+};
+
+// Compression statistics of one variable, accumulated over patches.
+struct CompressionStats {
+  std::string m_mode;
+  size_t      m_uncompressedBytes{0};
+  size_t      m_compressedBytes{0};
+  double      m_seconds{0};
+
+  void add( const std::string & mode, size_t uncompressedBytes, size_t compressedBytes, double seconds )
+  {
+    m_mode               = mode;
+    m_uncompressedBytes += uncompressedBytes;
+    m_compressedBytes   += compressedBytes;
+    m_seconds           += seconds;
+  }
+};
+
+/**************************************
+
+  CLASS
+    CompressionCodec
+
+  DESCRIPTION
+    A block compressor usable for UDA variables.  Codecs only see one
+    chunk at a time, chunking, filtering and threading are done by
+    CompressionCodecRegistry.
+
+****************************************/
+
+class CompressionCodec {
+
+public:
+
+  virtual ~CompressionCodec() {}
+
+  // Appends the compressed form of [in, in + size) to 'out'.
+  virtual void compress( const char * in, size_t size, std::string & out ) const = 0;
+
+  // Decompresses [in, in + size) into exactly 'outSize' bytes at
+  // 'out'. Throws an InternalError if the data is corrupt.
+  virtual void decompress( const char * in, size_t size, char * out, size_t outSize ) const = 0;
+};
+
+/**************************************
+
+  CLASS
+    CompressionCodecRegistry
+
+  DESCRIPTION
+    The compression modes available for <save compression="...">
+    besides the legacy "gzip" (which Variable handles itself to keep
+    the existing UDA format).
+
+    A mode is a codec name optionally preceded by the "shuffle"
+    filter, e.g. "lz", "shuffle+lz" or "shuffle+zlib".  The shuffle
+    filter transposes the bytes of 8 byte words (i.e. doubles) so
+    the exponent bytes end up next to each other, which usually
+    compresses much better.
+
+    Built in codecs:
+      lz   - a fast LZ77 byte coder (LZ4-style block format)
+      zlib - deflate at the default level
+
+    Compressed data is split into chunks that are (de)compressed in
+    parallel when setNumThreads() > 1.  The layout is
+
+      uint64 uncompressed size
+      uint64 chunk size
+      uint64 number of chunks
+      uint64 compressed size of every chunk
+      chunk data
+
+    with all integers little-endian.  A chunk that does not compress
+    is stored as is (its compressed size equals its size), so data
+    written with a mode is always in this layout.
+
+****************************************/
+
+class CompressionCodecRegistry {
+
+public:
+
+  // Makes 'codec' available under 'name' (replacing any previous one).
+  static void registerCodec( const std::string & name, std::shared_ptr<CompressionCodec> codec );
+
+  // True if 'mode' names a registered codec (with optional filter).
+  static bool isValid( const std::string & mode );
+
+  // The names of the registered codecs.
+  static std::vector<std::string> codecNames();
+
+  // Number of threads used to (de)compress the chunks of one variable.
+  static void setNumThreads( int numThreads );
+  static int  getNumThreads();
+
+  // Appends the compressed form of the concatenated segments to 'out'.
+  // Throws an InvalidCompressionMode for an unknown mode.
+  static void compress( const std::string                     & mode
+                      , const std::vector<CompressionSegment> & segments
+                      ,       std::string                     & out
+                      );
+
+  // Replaces 'out' with the decompressed data.
+  static void decompress( const std::string & mode
+                        , const char        * in
+                        ,       size_t        size
+                        ,       std::string & out
+                        );
+
+private:
+
+  struct Mode {
+    const CompressionCodec * m_codec{nullptr};
+    bool                     m_shuffle{false};
+  };
+
+  static Mode parse( const std::string & mode );
+
+  static std::map<std::string, std::shared_ptr<CompressionCodec>> & codecs();
+
+  static int s_num_threads;
+};
+
+} // End namespace Uintah
+
+#endif // CORE_IO_COMPRESSIONCODEC_H
@@ -33,6 +33,7 @@ include $(SCIRUN_SCRIPTS)/smallso_prologue.mk
 SRCDIR := Core/IO
 
 SRCS += \
+	$(SRCDIR)/CompressionCodec.cc \
 	$(SRCDIR)/UintahZlibUtil.cc \
 	$(SRCDIR)/UintahIFStreamUtil.cc
 
@@ -0,0 +1,160 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef CORE_MATH_PHILOX_H
+#define CORE_MATH_PHILOX_H
+
+#include <cstdint>
+
+// fix the random numbers for debugging purposes, as in MersenneTwister.h
+//#define FIXED_RANDOM_NUM
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    Philox
+
+  GENERAL INFORMATION
+    Philox.h
+
+  DESCRIPTION
+    Counter based random number generator, Philox4x32-10 of
+    Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"
+    (SC11).
+
+    The n-th block of four 32 bit numbers of a stream is a bijection of
+    the 128 bit counter (n, stream[0], stream[1], stream[2]) under the
+    64 bit key.  A stream is therefore selected by its key and counter
+    alone, needs no state besides n and can be created anywhere, e.g.
+    one stream per ray indexed by its cell and ray number.  The numbers
+    do not depend on which thread draws them or in which order the
+    streams are used.
+
+    The accessors follow MTRand (MersenneTwister.h).
+
+****************************************/
+
+class Philox {
+
+public:
+
+  Philox( uint32_t key0, uint32_t key1, uint32_t stream0, uint32_t stream1, uint32_t stream2 )
+    : m_key{ key0, key1 }
+    , m_ctr{ 0, stream0, stream1, stream2 }
+  {}
+
+  uint32_t randInt()                      // integer in [0,2^32-1]
+  {
+    if( m_used == 4 ) {
+      block( m_key, m_ctr, m_out );
+      ++m_ctr[0];
+      m_used = 0;
+    }
+    return m_out[ m_used++ ];
+  }
+
+  uint32_t randInt( uint32_t n )          // integer in [0,n]
+  {
+    // Find which bits are used in n
+    uint32_t used = n;
+    used |= used >> 1;
+    used |= used >> 2;
+    used |= used >> 4;
+    used |= used >> 8;
+    used |= used >> 16;
+
+    // Draw numbers until one is found in [0,n]
+    uint32_t i;
+    do {
+      i = randInt() & used;
+    } while( i > n );
+    return i;
+  }
+
+  double rand()                           // real number in [0,1]
+  {
+#ifdef FIXED_RANDOM_NUM
+    return 0.3;
+#else
+    return double( randInt() ) * ( 1.0/4294967295.0 );
+#endif
+  }
+
+  double randExc()                        // real number in [0,1)
+  {
+    return double( randInt() ) * ( 1.0/4294967296.0 );
+  }
+
+  double randDblExc()                     // real number in (0,1)
+  {
+#ifdef FIXED_RANDOM_NUM
+    return 0.3;
+#else
+    return ( double( randInt() ) + 0.5 ) * ( 1.0/4294967296.0 );
+#endif
+  }
+
+  // The block of four numbers of counter 'ctr' under 'key'
+  static void block( const uint32_t key[2], const uint32_t ctr[4], uint32_t out[4] )
+  {
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+    uint32_t c0 = ctr[0];
+    uint32_t c1 = ctr[1];
+    uint32_t c2 = ctr[2];
+    uint32_t c3 = ctr[3];
+
+    for( int r = 0; r < 10; r++ ) {
+      const uint64_t p0 = uint64_t( 0xD2511F53u ) * c0;
+      const uint64_t p1 = uint64_t( 0xCD9E8D57u ) * c2;
+
+      c0 = uint32_t( p1 >> 32 ) ^ c1 ^ k0;
+      c1 = uint32_t( p1 );
+      c2 = uint32_t( p0 >> 32 ) ^ c3 ^ k1;
+      c3 = uint32_t( p0 );
+
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+private:
+
+  uint32_t m_key[2];
+  uint32_t m_ctr[4];                      // m_ctr[0] is the next block
+  uint32_t m_out[4];
+  int      m_used{4};                     // numbers of m_out drawn
+};
+
+} // End namespace Uintah
+
+#endif // CORE_MATH_PHILOX_H
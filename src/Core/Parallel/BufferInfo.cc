@@ -63,7 +63,7 @@ BufferInfo::~BufferInfo()
 unsigned int
 BufferInfo::count() const
 {
-  return (int)m_datatypes.size();
+  return (int)( m_datatypes.size() + m_windows.size() );
 }
 
 //_____________________________________________________________________________
@@ -82,6 +82,22 @@ BufferInfo::add( void         * startbuf
   m_free_datatypes.push_back( free_datatype );
 }
 
+//_____________________________________________________________________________
+//
+void
+BufferInfo::addWindow( void      * startbuf
+                     , size_t      row_bytes
+                     , int         ny
+                     , int         nz
+                     , ptrdiff_t   y_stride
+                     , ptrdiff_t   z_stride
+                     )
+{
+  ASSERT( packsWindows() );
+  ASSERT( !m_have_datatype );
+  m_windows.push_back( Window{ (char*)startbuf, row_bytes, ny, nz, y_stride, z_stride } );
+}
+
 //_____________________________________________________________________________
 //
 void
@@ -91,6 +107,7 @@ BufferInfo::get_type( void        *& out_buf
                     )
 {
   ASSERT(count() > 0);
+  ASSERT(m_windows.empty());
 
   if( !m_have_datatype ) {
     if( count() == 1 ) {
@@ -28,6 +28,7 @@
 
 #include <Core/Parallel/UintahMPI.h>
 
+#include <cstddef>
 #include <vector>
 
 namespace Uintah {
@@ -84,6 +85,20 @@ class BufferInfo {
             , bool           free_datatype
             );
 
+    // True if strided windows may be given with addWindow() instead of
+    // as derived datatypes, i.e. the buffer copies them itself.
+    virtual bool packsWindows() const { return false; }
+
+    // A window of nz planes of ny rows, each row 'row_bytes'
+    // contiguous bytes.  Only if packsWindows().
+    void addWindow( void      * startbuf
+                  , size_t      row_bytes
+                  , int         ny
+                  , int         nz
+                  , ptrdiff_t   y_stride
+                  , ptrdiff_t   z_stride
+                  );
+
     void addSendlist( RefCounted * );
 
     Sendlist* takeSendlist();
@@ -91,6 +106,19 @@ class BufferInfo {
 
   protected:
 
+    struct Window {
+      char      * m_start;
+      size_t      m_row_bytes;
+      int         m_ny;
+      int         m_nz;
+      ptrdiff_t   m_y_stride;
+      ptrdiff_t   m_z_stride;
+
+      size_t bytes() const { return m_row_bytes * m_ny * m_nz; }
+    };
+
+    std::vector<Window>         m_windows;
+
     Sendlist                  * m_send_list{nullptr};
     std::vector<void*>          m_start_bufs;
     std::vector<int>            m_counts;
@@ -0,0 +1,271 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <Core/Parallel/LoopThreadPool.h>
+#include <Core/Util/PerfCounters.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Uintah;
+
+namespace {
+
+  struct Loop {
+    Loop( int numBlocks, const std::function<void(int, int)> & body )
+      : m_num_blocks( numBlocks )
+      , m_body( body )
+    {}
+
+    const int                                m_num_blocks;
+    const std::function<void(int, int)>    & m_body;
+
+    std::atomic<int>   m_next_block{0};
+    std::atomic<bool>  m_failed{false};
+
+    // guarded by g_mutex
+    int                m_next_slot{1};  // slot 0 is the caller's
+    int                m_active_workers{0};
+    std::exception_ptr m_error;
+    uint64_t           m_counts[PerfCounters::NumEvents] = { 0, 0 };  // of the workers
+  };
+
+  std::mutex               g_mutex;
+  std::condition_variable  g_work_cv;
+  std::condition_variable  g_done_cv;
+  std::deque<Loop*>        g_pending;  // loops that may have unclaimed blocks
+  std::vector<std::thread> g_workers;
+  bool                     g_shutdown{false};
+
+  std::atomic<int>         g_num_threads{1};
+  std::atomic<bool>        g_deterministic{true};
+
+  thread_local bool        t_in_loop{false};
+
+  //______________________________________________________________________
+  //
+  void
+  runBlocks( Loop & loop, int slot )
+  {
+    const bool in_loop = t_in_loop;
+    t_in_loop = true;
+
+    int block;
+    while( ( block = loop.m_next_block++ ) < loop.m_num_blocks ) {
+      if( loop.m_failed ) {
+        continue;
+      }
+      try {
+        loop.m_body( block, slot );
+      }
+      catch( ... ) {
+        std::lock_guard<std::mutex> lock( g_mutex );
+        if( !loop.m_error ) {
+          loop.m_error = std::current_exception();
+        }
+        loop.m_failed = true;
+      }
+    }
+
+    t_in_loop = in_loop;
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  removePending( Loop * loop )
+  {
+    auto iter = std::find( g_pending.begin(), g_pending.end(), loop );
+    if( iter != g_pending.end() ) {
+      g_pending.erase( iter );
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  worker()
+  {
+    while( true ) {
+      Loop * loop;
+      int    slot;
+      {
+        std::unique_lock<std::mutex> lock( g_mutex );
+        g_work_cv.wait( lock, []{ return g_shutdown || !g_pending.empty(); } );
+
+        if( g_shutdown ) {
+          return;
+        }
+        loop = g_pending.front();
+        slot = loop->m_next_slot++;
+        ++loop->m_active_workers;
+      }
+
+      // The counters of the blocks run here go to the loop's caller.
+      const bool counting = PerfCounters::isEnabled();
+      uint64_t start[PerfCounters::NumEvents];
+      uint64_t end[PerfCounters::NumEvents];
+      if( counting ) {
+        PerfCounters::read( start );
+      }
+
+      runBlocks( *loop, slot );
+
+      if( counting ) {
+        PerfCounters::read( end );
+      }
+
+      {
+        // All blocks are claimed, nobody else needs to join.
+        std::lock_guard<std::mutex> lock( g_mutex );
+        removePending( loop );
+        if( counting ) {
+          for( int i = 0; i < PerfCounters::NumEvents; ++i ) {
+            loop->m_counts[i] += end[i] - start[i];
+          }
+        }
+        --loop->m_active_workers;
+      }
+      g_done_cv.notify_all();
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  stopWorkers()
+  {
+    {
+      std::lock_guard<std::mutex> lock( g_mutex );
+      g_shutdown = true;
+    }
+    g_work_cv.notify_all();
+
+    for( auto & thread : g_workers ) {
+      thread.join();
+    }
+    g_workers.clear();
+    g_shutdown = false;
+  }
+
+  // Joins the workers at exit.
+  struct WorkerGuard {
+    ~WorkerGuard() { stopWorkers(); }
+  } g_worker_guard;
+
+}
+
+//______________________________________________________________________
+//
+void
+LoopThreadPool::setNumThreads( int numThreads )
+{
+  numThreads = std::max( numThreads, 1 );
+
+  if( numThreads != g_num_threads ) {
+    stopWorkers();
+    g_num_threads = numThreads;
+  }
+}
+
+//______________________________________________________________________
+//
+int
+LoopThreadPool::getNumThreads()
+{
+  return g_num_threads;
+}
+
+//______________________________________________________________________
+//
+void
+LoopThreadPool::setDeterministicReductions( bool deterministic )
+{
+  g_deterministic = deterministic;
+}
+
+//______________________________________________________________________
+//
+bool
+LoopThreadPool::getDeterministicReductions()
+{
+  return g_deterministic;
+}
+
+//______________________________________________________________________
+//
+bool
+LoopThreadPool::inLoop()
+{
+  return t_in_loop;
+}
+
+//______________________________________________________________________
+//
+void
+LoopThreadPool::run( int numBlocks, const std::function<void(int, int)> & body )
+{
+  if( g_num_threads <= 1 || numBlocks <= 1 || t_in_loop ) {
+    for( int block = 0; block < numBlocks; ++block ) {
+      body( block, 0 );
+    }
+    return;
+  }
+
+  Loop loop( numBlocks, body );
+
+  {
+    std::lock_guard<std::mutex> lock( g_mutex );
+
+    // Started lazily so builds that never run a threaded loop have
+    // no extra threads.
+    if( g_workers.empty() ) {
+      for( int i = 1; i < g_num_threads; ++i ) {
+        g_workers.push_back( std::thread( worker ) );
+      }
+    }
+    g_pending.push_back( &loop );
+  }
+  g_work_cv.notify_all();
+
+  runBlocks( loop, 0 );
+
+  {
+    std::unique_lock<std::mutex> lock( g_mutex );
+    removePending( &loop );
+    g_done_cv.wait( lock, [&loop]{ return loop.m_active_workers == 0; } );
+  }
+
+  PerfCounters::credit( loop.m_counts );
+
+  if( loop.m_error ) {
+    std::rethrow_exception( loop.m_error );
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef CORE_PARALLEL_LOOPTHREADPOOL_H
+#define CORE_PARALLEL_LOOPTHREADPOOL_H
+
+#include <functional>
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    LoopThreadPool
+
+  GENERAL INFORMATION
+    LoopThreadPool.h
+
+  DESCRIPTION
+    The threads behind the non-Kokkos parallel_for/parallel_reduce
+    of BlockRange.hpp.
+
+    A loop is split into a number of blocks which are handed out
+    dynamically to the pool threads and to the calling thread, which
+    always takes part in its own loop.  Any number of threads (e.g.
+    the UnifiedScheduler's task threads) may run loops concurrently;
+    the pool threads help whichever loops are pending.
+
+    A loop started from inside a block (nested parallelism) runs
+    serially on the calling thread.
+
+    When the PerfCounters are enabled the counts of the pool threads
+    running blocks of a loop are credited to the calling thread.
+
+    The number of threads (pool threads plus the caller) defaults to
+    1, i.e. everything runs serially on the caller.  sus sets it from
+    -nthreadsperpartition in non-Kokkos builds.
+
+****************************************/
+
+class LoopThreadPool {
+
+public:
+
+  // Number of threads working on one loop, including the caller.
+  // Must not be called while loops are running.
+  static void setNumThreads( int numThreads );
+  static int  getNumThreads();
+
+  // If true (the default) reductions combine the per block partial
+  // results in block order, so the result does not depend on the
+  // number of threads or on the scheduling.  Otherwise there is one
+  // partial result per thread.  Set from <deterministicLoopReductions>
+  // in the <Scheduler> block of the ups file.
+  static void setDeterministicReductions( bool deterministic );
+  static bool getDeterministicReductions();
+
+  // True if the calling thread is running a block of a loop.
+  static bool inLoop();
+
+  // Calls body(block, slot) for every block in [0, numBlocks), with
+  // 'slot' in [0, getNumThreads()) unique among the threads running
+  // this loop at the same time.  Returns when all blocks are done.
+  // The first exception thrown by 'body' is rethrown (the blocks not
+  // yet started are then skipped).
+  static void run( int numBlocks, const std::function<void(int, int)> & body );
+};
+
+} // End namespace Uintah
+
+#endif // CORE_PARALLEL_LOOPTHREADPOOL_H
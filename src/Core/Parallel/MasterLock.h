@@ -42,7 +42,7 @@ class MasterLock
 
   // This lock can be used as follows:
   //
-  // 1.) Same functionality as std::mutex, e.g., create, lock(), and unlock()
+  // 1.) Same functionality as std::mutex, e.g., create, lock(), try_lock() and unlock()
   //
   //      OR
   //
@@ -64,16 +64,18 @@ class MasterLock
 #if defined(_OPENMP) && defined(UINTAH_ENABLE_KOKKOS)
 
     // per OMP standard, a flush region without a list is implied for omp_{set/unset}_lock
-    void lock()   { omp_set_lock( &m_lock ); }
-    void unlock() { omp_unset_lock( &m_lock ); }
+    void lock()     { omp_set_lock( &m_lock ); }
+    void unlock()   { omp_unset_lock( &m_lock ); }
+    bool try_lock() { return omp_test_lock( &m_lock ); }
 
     MasterLock()  { omp_init_lock( &m_lock ); }
     ~MasterLock() { omp_destroy_lock( &m_lock ); }
 
 #else
 
-    void lock()   { m_mutex.lock(); }
-    void unlock() { m_mutex.unlock(); }
+    void lock()     { m_mutex.lock(); }
+    void unlock()   { m_mutex.unlock(); }
+    bool try_lock() { return m_mutex.try_lock(); }
 
     MasterLock()  {}
     ~MasterLock() {}
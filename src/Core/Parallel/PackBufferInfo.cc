@@ -25,6 +25,7 @@
 #include <Core/Parallel/PackBufferInfo.h>
 #include <Core/Exceptions/InternalError.h>
 #include <Core/Malloc/Allocator.h>
+#include <Core/Parallel/LoopThreadPool.h>
 #include <Core/Parallel/Parallel.h>
 #include <Core/Util/Assert.h>
 #include <Core/Util/RefCounted.h>
@@ -34,6 +35,15 @@ using namespace Uintah;
 #include <iostream>
 #include <string.h>
 
+namespace {
+
+  // Messages smaller than this are copied by the calling thread only.
+  const size_t g_min_parallel_bytes = 256 * 1024;
+
+}
+
+bool PackBufferInfo::s_explicit_packing = false;
+
 
 //_____________________________________________________________________________
 //
@@ -56,12 +66,16 @@ PackBufferInfo::get_type( void         *& out_buf
                         , int&            out_count
                         , MPI_Datatype  & out_datatype
                         , MPI_Comm        comm
+                        , PackedBuffer  * buffer
                         )
 {
   ASSERT(count() > 0);
   if (!m_have_datatype) {
     int packed_size;
     int total_packed_size = 0;
+    for (const Window & window : m_windows) {
+      total_packed_size += window.bytes();
+    }
     for (unsigned int i = 0; i < m_start_bufs.size(); i++) {
       if (m_counts[i] > 0) {
         Uintah::MPI::Pack_size(m_counts[i], m_datatypes[i], comm, &packed_size);
@@ -69,7 +83,16 @@ PackBufferInfo::get_type( void         *& out_buf
       }
     }
 
-    m_packed_buffer = scinew PackedBuffer(total_packed_size);
+    if (buffer && buffer->getBufSize() >= total_packed_size) {
+      m_packed_buffer = buffer;
+    }
+    else if (buffer) {
+      // Outgrown (e.g. more particles), leave room to grow further.
+      m_packed_buffer = scinew PackedBuffer(total_packed_size + total_packed_size / 4);
+    }
+    else {
+      m_packed_buffer = scinew PackedBuffer(total_packed_size);
+    }
     m_packed_buffer->addReference();
 
     m_datatype = MPI_PACKED;
@@ -102,7 +125,7 @@ PackBufferInfo::pack( MPI_Comm comm, int & out_count )
 {
   ASSERT(m_have_datatype);
 
-  int position = 0;
+  int position = copyWindows(true);
   int bufsize = m_packed_buffer->getBufSize();
   //for each buffer
   for (unsigned int i = 0; i < m_start_bufs.size(); i++) {
@@ -129,7 +152,7 @@ PackBufferInfo::unpack( MPI_Comm comm, MPI_Status & status )
 
   unsigned long bufsize = m_packed_buffer->getBufSize();
 
-  int position = 0;
+  int position = copyWindows(false);
   for (unsigned int i = 0; i < m_start_bufs.size(); i++) {
     if (m_counts[i] > 0) {
       Uintah::MPI::Unpack(m_buffer, bufsize, &position, m_start_bufs[i], m_counts[i], m_datatypes[i], comm);
@@ -137,3 +160,77 @@ PackBufferInfo::unpack( MPI_Comm comm, MPI_Status & status )
   }
 }
 
+
+//_____________________________________________________________________________
+//
+size_t
+PackBufferInfo::copyWindows( bool pack )
+{
+  if (m_windows.empty()) {
+    return 0;
+  }
+
+  // One block per plane of every window.
+  struct Plane {
+    const Window * m_window;
+    char         * m_start;   // in the variable
+    char         * m_packed;  // in the buffer
+  };
+
+  std::vector<Plane> planes;
+  char* packed = (char*)m_buffer;
+  for (const Window & window : m_windows) {
+    for (int z = 0; z < window.m_nz; z++) {
+      planes.push_back( Plane{ &window, window.m_start + z * window.m_z_stride, packed } );
+      packed += window.m_row_bytes * window.m_ny;
+    }
+  }
+  const size_t bytes = packed - (char*)m_buffer;
+
+  auto copyPlane = [&]( int block, int /*slot*/ ) {
+    const Plane  & plane  = planes[block];
+    const Window & window = *plane.m_window;
+
+    if (window.m_y_stride == (ptrdiff_t)window.m_row_bytes) {
+      // contiguous plane
+      const size_t plane_bytes = window.m_row_bytes * window.m_ny;
+      pack ? memcpy(plane.m_packed, plane.m_start, plane_bytes) : memcpy(plane.m_start, plane.m_packed, plane_bytes);
+      return;
+    }
+
+    char* row    = plane.m_start;
+    char* packed = plane.m_packed;
+
+    if (window.m_row_bytes <= 64 && window.m_row_bytes % sizeof(double) == 0) {
+      // short rows (x faces), a memcpy call per row costs more than the copy
+      const size_t words = window.m_row_bytes / sizeof(double);
+      for (int y = 0; y < window.m_ny; y++) {
+        for (size_t w = 0; w < words; w++) {
+          double* var_word    = (double*)row + w;
+          double* packed_word = (double*)packed + w;
+          pack ? memcpy(packed_word, var_word, sizeof(double)) : memcpy(var_word, packed_word, sizeof(double));
+        }
+        row    += window.m_y_stride;
+        packed += window.m_row_bytes;
+      }
+      return;
+    }
+
+    for (int y = 0; y < window.m_ny; y++) {
+      pack ? memcpy(packed, row, window.m_row_bytes) : memcpy(row, packed, window.m_row_bytes);
+      row    += window.m_y_stride;
+      packed += window.m_row_bytes;
+    }
+  };
+
+  if (bytes < g_min_parallel_bytes) {
+    for (size_t block = 0; block < planes.size(); block++) {
+      copyPlane(block, 0);
+    }
+  }
+  else {
+    LoopThreadPool::run(planes.size(), copyPlane);
+  }
+
+  return bytes;
+}
@@ -63,10 +63,13 @@ class PackBufferInfo : public BufferInfo {
 
     ~PackBufferInfo();
 
+    // Packs into 'buffer' if it is large enough, otherwise into a
+    // newly allocated one.
     void get_type( void         *& out_buf
                  , int&            out_count
                  , MPI_Datatype  & out_datatype
                  , MPI_Comm        comm
+                 , PackedBuffer  * buffer = nullptr
                  );
 
     void get_type( void         *&
@@ -76,6 +79,18 @@ class PackBufferInfo : public BufferInfo {
 
     void pack( MPI_Comm comm, int & out_count );
 
+    PackedBuffer * getPackedBuffer() const { return m_packed_buffer; }
+
+    // Explicit packing: grid variable windows are copied row by row
+    // into the front of the packed buffer (on the LoopThreadPool for
+    // large messages) instead of being described by MPI derived
+    // datatypes and packed by MPI_Pack.  Both sides of a message
+    // must use the same mode.
+    static void setExplicitPacking( bool explicitPacking ) { s_explicit_packing = explicitPacking; }
+    static bool getExplicitPacking()                       { return s_explicit_packing; }
+
+    virtual bool packsWindows() const { return s_explicit_packing; }
+
     void unpack( MPI_Comm comm, MPI_Status & status );
 
     // PackBufferInfo is to be an AfterCommuncationHandler object for the
@@ -89,6 +104,12 @@ class PackBufferInfo : public BufferInfo {
 
   private:
 
+    // Copies the windows to (pack) or from the packed buffer, returns
+    // the number of bytes.
+    size_t copyWindows( bool pack );
+
+    static bool s_explicit_packing;
+
     // disable copy and assignment
     PackedBuffer * m_packed_buffer{nullptr};
 
@@ -26,6 +26,7 @@
 
 #include <Core/Exceptions/InternalError.h>
 #include <Core/Malloc/Allocator.h>
+#include <Core/Parallel/LoopThreadPool.h>
 #include <Core/Parallel/ProcessorGroup.h>
 #include <Core/Parallel/UintahMPI.h>
 
@@ -213,6 +214,12 @@ Parallel::initializeManager( int& argc , char**& argv )
     s_threads_per_partition = 1;
 #endif
   }
+#else
+  // Without Kokkos the threads per partition are the threads of the
+  // BlockRange parallel_for/parallel_reduce loops.
+  if ( s_threads_per_partition > 0 ) {
+    LoopThreadPool::setNumThreads( s_threads_per_partition );
+  }
 #endif // UINTAH_ENABLE_KOKKOS
 
 #ifdef THREADED_MPI_AVAILABLE
@@ -287,6 +294,9 @@ Parallel::initializeManager( int& argc , char**& argv )
     if (s_num_threads > 0) {
       std::cout << "Parallel: " << s_num_threads << " threads per MPI process\n";
     }
+    if ( s_threads_per_partition > 1 ) {
+      std::cout << "Parallel: " << s_threads_per_partition << " threads per parallel_for/parallel_reduce loop\n";
+    }
 #endif
 
     std::cout << "Parallel: MPI Level Required: " << required << ", provided: " << provided << "\n";
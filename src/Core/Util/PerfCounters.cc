@@ -0,0 +1,187 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include <Core/Util/PerfCounters.h>
+
+#include <atomic>
+#include <cstring>
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+using namespace Uintah;
+
+namespace {
+
+  std::atomic<bool> g_enabled{false};
+  std::atomic<bool> g_available{true};
+
+  thread_local uint64_t t_credited[PerfCounters::NumEvents] = { 0, 0 };
+
+#ifdef __linux__
+
+  // The events of one thread, read together as a group.
+  struct ThreadCounters {
+
+    ThreadCounters()
+    {
+      const uint64_t configs[PerfCounters::NumEvents] = {
+          PERF_COUNT_HW_CPU_CYCLES
+        , PERF_COUNT_HW_CACHE_MISSES  // last level cache
+      };
+
+      for (int i = 0; i < PerfCounters::NumEvents; i++) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = configs[i];
+        attr.disabled       = (i == 0);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP;
+
+        // this thread, any cpu
+        m_fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, (i == 0) ? -1 : m_fds[0], 0);
+        if (m_fds[i] < 0) {
+          close();
+          g_available = false;
+          return;
+        }
+      }
+      ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~ThreadCounters()
+    {
+      close();
+    }
+
+    void close()
+    {
+      for (int i = 0; i < PerfCounters::NumEvents; i++) {
+        if (m_fds[i] >= 0) {
+          ::close(m_fds[i]);
+          m_fds[i] = -1;
+        }
+      }
+    }
+
+    bool read( uint64_t counts[PerfCounters::NumEvents] )
+    {
+      if (m_fds[0] < 0) {
+        return false;
+      }
+      uint64_t buffer[1 + PerfCounters::NumEvents];  // number of events, values
+      if (::read(m_fds[0], buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer)) {
+        return false;
+      }
+      for (int i = 0; i < PerfCounters::NumEvents; i++) {
+        counts[i] = buffer[1 + i];
+      }
+      return true;
+    }
+
+    int m_fds[PerfCounters::NumEvents] = { -1, -1 };
+  };
+
+#endif
+
+}
+
+//______________________________________________________________________
+//
+void
+PerfCounters::enable( bool enabled )
+{
+  g_enabled = enabled;
+}
+
+//______________________________________________________________________
+//
+bool
+PerfCounters::isEnabled()
+{
+  return g_enabled;
+}
+
+//______________________________________________________________________
+//
+bool
+PerfCounters::available()
+{
+#ifdef __linux__
+  return g_available;
+#else
+  return false;
+#endif
+}
+
+//______________________________________________________________________
+//
+void
+PerfCounters::read( uint64_t counts[NumEvents] )
+{
+  for (int i = 0; i < NumEvents; i++) {
+    counts[i] = 0;
+  }
+
+#ifdef __linux__
+  if (g_enabled && g_available) {
+    thread_local ThreadCounters t_counters;
+    if (t_counters.read(counts)) {
+      for (int i = 0; i < NumEvents; i++) {
+        counts[i] += t_credited[i];
+      }
+    }
+  }
+#endif
+}
+
+//______________________________________________________________________
+//
+void
+PerfCounters::credit( const uint64_t counts[NumEvents] )
+{
+  for (int i = 0; i < NumEvents; i++) {
+    t_credited[i] += counts[i];
+  }
+}
+
+//______________________________________________________________________
+//
+const char*
+PerfCounters::name( Event event )
+{
+  switch (event) {
+    case Cycles:    return "cycles";
+    case LLCMisses: return "LLC misses";
+    default:        return "unknown";
+  }
+}
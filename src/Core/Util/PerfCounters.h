@@ -0,0 +1,83 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef CORE_UTIL_PERFCOUNTERS_H
+#define CORE_UTIL_PERFCOUNTERS_H
+
+#include <cstdint>
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    PerfCounters
+
+  GENERAL INFORMATION
+    PerfCounters.h
+
+  DESCRIPTION
+    Hardware event counters of the calling thread, read through the
+    Linux perf_event_open interface (user space events only).
+
+    The counters of a thread are opened the first time it reads them
+    while counting is enabled.  If they can not be opened (not Linux,
+    no PMU access, kernel.perf_event_paranoid too high) read() returns
+    zeros and available() turns false.
+
+    Work done on behalf of a thread by other threads (the
+    LoopThreadPool workers running blocks of its loops) is credited
+    to it with credit(), so read() covers the whole loop.
+
+****************************************/
+
+class PerfCounters {
+
+public:
+
+  enum Event {
+      Cycles = 0
+    , LLCMisses
+    , NumEvents
+  };
+
+  static void enable( bool enabled );
+  static bool isEnabled();
+
+  // False once the counters failed to open on some thread.
+  static bool available();
+
+  // Current counts of the calling thread, zeros if disabled or unavailable.
+  static void read( uint64_t counts[NumEvents] );
+
+  // Adds counts of other threads to the later read()s of the calling thread.
+  static void credit( const uint64_t counts[NumEvents] );
+
+  static const char* name( Event event );
+};
+
+} // End namespace Uintah
+
+#endif // CORE_UTIL_PERFCOUNTERS_H
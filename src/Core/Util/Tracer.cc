@@ -0,0 +1,401 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include <Core/Util/Tracer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace Uintah;
+
+bool Tracer::s_enabled = false;
+
+namespace {
+
+  struct Event {
+    uint64_t m_start;
+    uint64_t m_duration;
+    uint32_t m_name;       // 0: the category's name
+    int32_t  m_args[3];
+    uint8_t  m_category;
+  };
+
+  const size_t g_chunk_size = 1 << 16;
+
+  struct ThreadBuffer {
+    int                                       m_tid;
+    std::string                               m_thread_name;
+    std::vector<std::unique_ptr<Event[]> >    m_chunks;
+    size_t                                    m_num_events{0};
+    size_t                                    m_dropped{0};
+    std::vector<std::string>                  m_names{ std::string() };
+    std::unordered_map<std::string, uint32_t> m_name_ids;
+    std::unordered_map<const std::string*, uint32_t> m_name_ptrs;   // task names live in the Tasks
+  };
+
+  const char * g_category_names[Tracer::NumCategories] = {
+    "task", "send", "recv", "unpack", "wait", "scrub", "reduction", "execute"
+  };
+
+  const char * g_default_names[Tracer::NumCategories] = {
+    "task", "MPI_Isend", "MPI_Irecv", "unpack", "wait", "scrub", "reduction", "execute"
+  };
+
+  const char * g_arg_names[Tracer::NumCategories][3] = {
+      { "patch", "matl" , nullptr }
+    , { "peer" , "tag"  , "bytes" }
+    , { "peer" , "tag"  , "bytes" }
+    , { nullptr, nullptr, nullptr }
+    , { nullptr, nullptr, nullptr }
+    , { "patch", nullptr, nullptr }
+    , { nullptr, nullptr, nullptr }
+    , { "graph", "iteration", nullptr }
+  };
+
+  const char g_magic[8] = { 'U', 'T', 'R', 'A', 'C', 'E', '1', '\0' };
+
+  std::mutex                                 g_mutex;          // guards g_buffers
+  std::vector<std::unique_ptr<ThreadBuffer> > g_buffers;
+  std::string                                g_filename;
+  Tracer::Format                             g_format{Tracer::JSON};
+  size_t                                     g_max_events{0};
+  std::chrono::steady_clock::time_point      g_origin;
+
+  thread_local ThreadBuffer                * t_buffer{nullptr};
+
+  //______________________________________________________________________
+  //
+  ThreadBuffer *
+  threadBuffer()
+  {
+    if( t_buffer == nullptr ) {
+      std::lock_guard<std::mutex> lock( g_mutex );
+      g_buffers.emplace_back( new ThreadBuffer );
+      t_buffer = g_buffers.back().get();
+      t_buffer->m_tid = g_buffers.size() - 1;
+      t_buffer->m_thread_name = "thread " + std::to_string( t_buffer->m_tid );
+    }
+    return t_buffer;
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  writeString( std::ostream & out, const std::string & str )
+  {
+    out << '"';
+    for( char c : str ) {
+      if( c == '"' || c == '\\' ) {
+        out << '\\' << c;
+      }
+      else if( (unsigned char)c < 0x20 ) {
+        out << ' ';
+      }
+      else {
+        out << c;
+      }
+    }
+    out << '"';
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  writeSeparator( std::ostream & out, bool & first )
+  {
+    if( !first ) {
+      out << ",\n";
+    }
+    first = false;
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  writeThread( std::ostream & out, int rank, int tid, const std::string & threadName, bool & first )
+  {
+    if( tid == 0 ) {
+      writeSeparator( out, first );
+      out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+          << ",\"args\":{\"name\":\"rank " << rank << "\"}},\n"
+          << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << rank
+          << ",\"args\":{\"sort_index\":" << rank << "}}";
+    }
+    writeSeparator( out, first );
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":" << tid << ",\"args\":{\"name\":";
+    writeString( out, threadName );
+    out << "}}";
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  writeEvent( std::ostream & out, const Event & event, const std::string & name, int rank, int tid, bool & first )
+  {
+    writeSeparator( out, first );
+
+    out << "{\"name\":";
+    writeString( out, name.empty() ? g_default_names[event.m_category] : name );
+
+    char times[64];
+    snprintf( times, sizeof(times), ",\"ts\":%.3f,\"dur\":%.3f", event.m_start * 1.e-3, event.m_duration * 1.e-3 );
+
+    out << ",\"cat\":\"" << g_category_names[event.m_category] << "\",\"ph\":\"X\"" << times
+        << ",\"pid\":" << rank << ",\"tid\":" << tid << ",\"args\":{";
+
+    bool first_arg = true;
+    for( int i = 0; i < 3; i++ ) {
+      const char* arg_name = g_arg_names[event.m_category][i];
+      if( arg_name && event.m_args[i] >= 0 ) {
+        out << ( first_arg ? "\"" : ",\"" ) << arg_name << "\":" << event.m_args[i];
+        first_arg = false;
+      }
+    }
+    out << "}}";
+  }
+
+  //______________________________________________________________________
+  //
+  template <typename T>
+  void
+  writeBinary( std::ostream & out, const T & value )
+  {
+    out.write( reinterpret_cast<const char*>( &value ), sizeof(T) );
+  }
+
+  template <typename T>
+  bool
+  readBinary( std::istream & in, T & value )
+  {
+    return (bool)in.read( reinterpret_cast<char*>( &value ), sizeof(T) );
+  }
+
+  void
+  writeBinary( std::ostream & out, const std::string & str )
+  {
+    writeBinary( out, (uint32_t)str.size() );
+    out.write( str.data(), str.size() );
+  }
+
+  bool
+  readBinary( std::istream & in, std::string & str )
+  {
+    uint32_t size;
+    if( !readBinary( in, size ) ) {
+      return false;
+    }
+    str.resize( size );
+    return size == 0 || (bool)in.read( &str[0], size );
+  }
+}
+
+//______________________________________________________________________
+//
+void
+Tracer::enable( const std::string & filename, Format format, size_t maxEventsPerThread )
+{
+  g_filename   = filename;
+  g_format     = format;
+  g_max_events = maxEventsPerThread;
+  g_origin     = std::chrono::steady_clock::now();
+  s_enabled    = true;
+}
+
+//______________________________________________________________________
+//
+uint64_t
+Tracer::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - g_origin ).count();
+}
+
+//______________________________________________________________________
+//
+void
+Tracer::setThreadName( const std::string & name )
+{
+  threadBuffer()->m_thread_name = name;
+}
+
+//______________________________________________________________________
+//
+void
+Tracer::record( Category category, uint64_t start, uint64_t end, const std::string * name, const int args[3] )
+{
+  ThreadBuffer* buffer = threadBuffer();
+
+  if( buffer->m_num_events >= g_max_events ) {
+    buffer->m_dropped++;
+    return;
+  }
+
+  uint32_t name_id = 0;
+  if( name ) {
+    // Look the name up by address first, the strings may however
+    // have been freed and the address reused, so compare.
+    auto ptr_iter = buffer->m_name_ptrs.find( name );
+    if( ptr_iter != buffer->m_name_ptrs.end() && buffer->m_names[ptr_iter->second] == *name ) {
+      name_id = ptr_iter->second;
+    }
+    else {
+      auto iter = buffer->m_name_ids.find( *name );
+      if( iter == buffer->m_name_ids.end() ) {
+        name_id = buffer->m_names.size();
+        buffer->m_names.push_back( *name );
+        buffer->m_name_ids[*name] = name_id;
+      }
+      else {
+        name_id = iter->second;
+      }
+      buffer->m_name_ptrs[name] = name_id;
+    }
+  }
+
+  const size_t chunk = buffer->m_num_events / g_chunk_size;
+  if( chunk == buffer->m_chunks.size() ) {
+    buffer->m_chunks.emplace_back( new Event[g_chunk_size] );
+  }
+
+  Event& event = buffer->m_chunks[chunk][buffer->m_num_events % g_chunk_size];
+  event.m_start      = start;
+  event.m_duration   = end - start;
+  event.m_name       = name_id;
+  event.m_args[0]    = args[0];
+  event.m_args[1]    = args[1];
+  event.m_args[2]    = args[2];
+  event.m_category   = category;
+
+  buffer->m_num_events++;
+}
+
+//______________________________________________________________________
+//
+size_t
+Tracer::dump( int rank )
+{
+  std::lock_guard<std::mutex> lock( g_mutex );
+
+  const std::string filename = g_filename + "." + std::to_string( rank ) + ( g_format == JSON ? ".json" : ".bin" );
+  std::ofstream out( filename.c_str(), std::ios::binary );
+  if( !out ) {
+    std::cerr << "Tracer: could not open " << filename << "\n";
+  }
+
+  size_t dropped = 0;
+
+  if( g_format == JSON ) {
+    bool first = true;
+    out << "{\"traceEvents\":[\n";
+    for( auto & buffer : g_buffers ) {
+      writeThread( out, rank, buffer->m_tid, buffer->m_thread_name, first );
+      for( size_t i = 0; i < buffer->m_num_events; i++ ) {
+        const Event& event = buffer->m_chunks[i / g_chunk_size][i % g_chunk_size];
+        writeEvent( out, event, buffer->m_names[event.m_name], rank, buffer->m_tid, first );
+      }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  }
+  else {
+    out.write( g_magic, sizeof(g_magic) );
+    writeBinary( out, (int32_t)rank );
+    writeBinary( out, (uint32_t)g_buffers.size() );
+    for( auto & buffer : g_buffers ) {
+      writeBinary( out, (int32_t)buffer->m_tid );
+      writeBinary( out, buffer->m_thread_name );
+      writeBinary( out, (uint32_t)buffer->m_names.size() );
+      for( const std::string & name : buffer->m_names ) {
+        writeBinary( out, name );
+      }
+      writeBinary( out, (uint64_t)buffer->m_num_events );
+      for( size_t chunk = 0; chunk < buffer->m_chunks.size(); chunk++ ) {
+        const size_t events = std::min( g_chunk_size, buffer->m_num_events - chunk * g_chunk_size );
+        out.write( reinterpret_cast<const char*>( buffer->m_chunks[chunk].get() ), events * sizeof(Event) );
+      }
+    }
+  }
+
+  for( auto & buffer : g_buffers ) {
+    dropped += buffer->m_dropped;
+    buffer->m_chunks.clear();
+    buffer->m_num_events = 0;
+    buffer->m_dropped    = 0;
+  }
+
+  return dropped;
+}
+
+//______________________________________________________________________
+//
+bool
+Tracer::binaryToJSON( std::istream & in, std::ostream & out, bool & first )
+{
+  char     magic[sizeof(g_magic)];
+  int32_t  rank;
+  uint32_t num_threads;
+
+  if( !in.read( magic, sizeof(magic) ) || std::memcmp( magic, g_magic, sizeof(magic) ) != 0 ||
+      !readBinary( in, rank ) || !readBinary( in, num_threads ) ) {
+    return false;
+  }
+
+  for( uint32_t t = 0; t < num_threads; t++ ) {
+    int32_t     tid;
+    std::string thread_name;
+    uint32_t    num_names;
+    if( !readBinary( in, tid ) || !readBinary( in, thread_name ) || !readBinary( in, num_names ) ) {
+      return false;
+    }
+
+    std::vector<std::string> names( num_names );
+    for( uint32_t i = 0; i < num_names; i++ ) {
+      if( !readBinary( in, names[i] ) ) {
+        return false;
+      }
+    }
+
+    uint64_t num_events;
+    if( !readBinary( in, num_events ) ) {
+      return false;
+    }
+
+    writeThread( out, rank, tid, thread_name, first );
+    for( uint64_t i = 0; i < num_events; i++ ) {
+      Event event;
+      if( !readBinary( in, event ) || event.m_name >= num_names || event.m_category >= NumCategories ) {
+        return false;
+      }
+      writeEvent( out, event, names[event.m_name], rank, tid, first );
+    }
+  }
+  return true;
+}
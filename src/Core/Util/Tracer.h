@@ -0,0 +1,157 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef CORE_UTIL_TRACER_H
+#define CORE_UTIL_TRACER_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace Uintah {
+
+/**************************************
+
+  CLASS
+    Tracer
+
+  GENERAL INFORMATION
+    Tracer.h
+
+  DESCRIPTION
+    Timeline of what every thread of a rank was doing: task
+    executions, MPI sends and receives (post, unpack), waits, scrubs
+    and reductions.
+
+    Every thread records into its own buffer, so recording takes no
+    locks; the first event of a thread registers its buffer.  When
+    tracing is disabled a Scope costs one branch.
+
+    dump() writes the events of all threads of the rank in the Chrome
+    trace event format (chrome://tracing, ui.perfetto.dev) or in a
+    compact binary format, one file per rank.  The tool trace_merge
+    combines the files of all ranks into one JSON trace.  dump() must
+    not be called while other threads record.
+
+    The timestamps are relative to enable(); the schedulers call it
+    right after a barrier so the ranks' timelines line up.
+
+****************************************/
+
+class Tracer {
+
+public:
+
+  enum Category : uint8_t {
+      Task = 0
+    , Send           // packing and posting a message
+    , Recv           // posting a receive
+    , Unpack         // unpacking a received message
+    , Wait           // blocked on MPI requests
+    , Scrub
+    , Reduction
+    , Execute        // a task graph execution
+    , NumCategories
+  };
+
+  enum Format {
+      JSON = 0
+    , Binary
+  };
+
+  // Starts recording, events beyond maxEventsPerThread are dropped.
+  static void enable( const std::string & filename, Format format, size_t maxEventsPerThread );
+
+  static bool isEnabled() { return s_enabled; }
+
+  // Nanoseconds since enable().
+  static uint64_t now();
+
+  // Name of the calling thread in the trace (default "thread <n>").
+  static void setThreadName( const std::string & name );
+
+  // 'name' may be null, then the category names the event.  The
+  // meaning of the args depends on the category (see Scope).
+  static void record( Category category, uint64_t start, uint64_t end, const std::string * name, const int args[3] );
+
+  // Writes <filename>.<rank>.json or .bin, returns the number of
+  // dropped events.  The buffers are emptied.
+  static size_t dump( int rank );
+
+  // Appends the events of a binary trace file to 'out' as JSON trace
+  // events, separated by ",\n" (preceded by one unless 'first').
+  // Returns false if 'in' is not a trace file.
+  static bool binaryToJSON( std::istream & in, std::ostream & out, bool & first );
+
+  // RAII event:  Task - patch, matl;  Send, Recv - peer rank, tag, bytes;
+  // Scrub - patch;  Execute - task graph, iteration.
+  class Scope {
+
+  public:
+
+    Scope( Category category, const std::string * name = nullptr )
+      : m_active( s_enabled )
+      , m_category( category )
+      , m_name( name )
+    {
+      if( m_active ) {
+        m_start = now();
+      }
+    }
+
+    ~Scope()
+    {
+      if( m_active ) {
+        record( m_category, m_start, now(), m_name, m_args );
+      }
+    }
+
+    void setArgs( int arg0, int arg1 = -1, int arg2 = -1 )
+    {
+      m_args[0] = arg0;
+      m_args[1] = arg1;
+      m_args[2] = arg2;
+    }
+
+  private:
+
+    Scope( const Scope & )            = delete;
+    Scope& operator=( const Scope & ) = delete;
+
+    const bool          m_active;
+    const Category      m_category;
+    const std::string * m_name;
+    uint64_t            m_start{0};
+    int                 m_args[3]{-1, -1, -1};
+  };
+
+private:
+
+  static bool s_enabled;
+};
+
+} // End namespace Uintah
+
+#endif // CORE_UTIL_TRACER_H
@@ -35,11 +35,13 @@ SRCS += \
         $(SRCDIR)/Endian.cc             \
         $(SRCDIR)/Environment.cc        \
         $(SRCDIR)/FileUtils.cc          \
+        $(SRCDIR)/PerfCounters.cc       \
         $(SRCDIR)/ProgressiveWarning.cc \
         $(SRCDIR)/RWS.cc                \
         $(SRCDIR)/SizeTypeConvert.cc    \
         $(SRCDIR)/soloader.cc           \
         $(SRCDIR)/StringUtil.cc         \
+        $(SRCDIR)/Tracer.cc             \
         $(SRCDIR)/XMLUtils.cc           \
         $(SRCDIR)/Util.cc
 
@@ -2,7 +2,15 @@
 
 from sys import argv,exit
 from os import environ
-from helpers.runSusTests import runSusTests, ignorePerformanceTests
+from helpers.runSusTests import runSusTests, ignorePerformanceTests, getInputsDir
+from helpers.modUPS import modUPS
+
+the_dir = "%s/%s" % ( getInputsDir(),"MPM" )
+
+# const_test_nhp with the batched stress update, compared with the gold standard of const_test_nhp
+const_test_nhp_batch_ups = modUPS( the_dir, \
+                                   "const_test_nhp.ups", \
+                                   ["<time_integrator>explicit</time_integrator> <batch_stress_update>true</batch_stress_update>"] )
 
 #______________________________________________________________________
 #  Test syntax: ( "folder name", "input file", # processors, "OS", ["flags1","flag2"])
@@ -26,6 +34,8 @@ from helpers.runSusTests import runSusTests, ignorePerformanceTests
 #       postProcessRun          - start test from an existing uda in the checkpoints directory.  Compute new quantities and save them in a new uda
 #       startFromCheckpoint     - start test from checkpoint. (/home/rt/CheckPoints/..../testname.uda.000)
 #       sus_options="string"    - Additional command line options for sus command
+#       gold_standard=[test]    - compare with the gold standard of another test, e.g. of the same input
+#                                 with an option that must not change the results beyond the tolerances
 #
 #  Notes:
 #  1) The "folder name" must be the same as input file without the extension.
@@ -46,6 +56,7 @@ NIGHTLYTESTS = [
 #                  ("const_test_hypo",                     "const_test_hypo.ups",                     1,  "ALL", ["exactComparison"] ),
 #                  ("const_test_cmr",                      "const_test_cmr.ups",                      1,  "ALL", ["exactComparison"] ),
                   ("const_test_nhp",                      "const_test_nhp.ups",                      1,  "ALL", ["exactComparison"] ),
+                  ("const_test_nhp_batch",                const_test_nhp_batch_ups,                  1,  "ALL", ["gold_standard=const_test_nhp","abs_tolerance=1e-12","rel_tolerance=1e-9"] ),
                   ("const_test_vs",                       "const_test_vs.ups",                       1,  "ALL", ["exactComparison"] ),
                   ("adiCuJC4000s696K",                    "adiCuJC4000s696K.ups",                    1,  "ALL", ["exactComparison"] ),
 #                  ("adiCuMTS4000s696K",                   "adiCuMTS4000s696K.ups",                   1,  "All", ["exactComparison"] ),
@@ -295,6 +295,7 @@ def runSusTests(argv, TESTS, application, callback = nullCallback):
     sus_options     = ""
     startFrom       = "inputFile"
     create_gs0      = "no"           #create the gold standard
+    gs_testname     = testname       # test whose gold standard is compared with
     
 
     environ['SCI_DEBUG'] = ''   # reset it for each test
@@ -345,6 +346,7 @@ def runSusTests(argv, TESTS, application, callback = nullCallback):
         #    abs_tolerance=<number>
         #    rel_tolerance=<number>
         #    sus_option=" "
+        #    gold_standard=<test>
         tmp = flags[i].rsplit('=')
         if tmp[0] == "sus_options":
            sus_options      = tmp[1]
@@ -352,6 +354,8 @@ def runSusTests(argv, TESTS, application, callback = nullCallback):
           abs_tolerance     = tmp[1]
         if tmp[0] == "rel_tolerance":
           rel_tolerance     = tmp[1]
+        if tmp[0] == "gold_standard":
+          gs_testname       = tmp[1]
         if flags[i] == "exactComparison":
           abs_tolerance     = 0.0
           rel_tolerance     = 0.0
@@ -393,7 +397,7 @@ def runSusTests(argv, TESTS, application, callback = nullCallback):
 
     tests_to_do = [do_uda_comparisons, do_memory, do_performance]
     tolerances  = [abs_tolerance, rel_tolerance]
-    varBucket   = [sus_options, do_plots]
+    varBucket   = [sus_options, do_plots, gs_testname]
 
     ran_any_tests = 1
 
@@ -404,8 +408,14 @@ def runSusTests(argv, TESTS, application, callback = nullCallback):
     
     try:
       chdir(compare_root)
-      chdir(testname)
+      chdir(gs_testname)
     except Exception:
+      # never create the gold standard of another test from this one
+      if gs_testname != testname :
+        print( "ERROR: The gold standard of the (%s) test, which the (%s) test is compared with, does not exist." % (gs_testname, testname) )
+        print( "Run the (%s) test first" % gs_testname )
+        exit(1)
+
       if environ['LOCAL_OR_NIGHTLY_TEST'] == "local" :
         print( "ERROR: The gold standard for the (%s) test does not exist." % testname )
         print( "To generate it run: \n   make gold_standards" )
@@ -595,6 +605,7 @@ def runSusTest(test, susdir, inputxml, compare_root, application, dbg_opt, max_p
 
   sus_options             = varBucket[0]
   do_plots                = varBucket[1]
+  gs_testname             = varBucket[2]
   do_uda_comparison_test  = tests_to_do[0]
   do_memory_test          = tests_to_do[1]
   do_performance_test     = tests_to_do[2]
@@ -888,7 +899,7 @@ def runSusTest(test, susdir, inputxml, compare_root, application, dbg_opt, max_p
       rel_tol= tolerances[1]
       
       compUda_RC = system("compare_sus_runs %s %s %s %s %s %s %s > compare_sus_runs.log.txt 2>&1" % 
-                          (testname, getcwd(), compare_root, susdir,abs_tol, rel_tol, create_gs))
+                          (gs_testname, getcwd(), compare_root, susdir,abs_tol, rel_tol, create_gs))
       
       if compUda_RC != 0:
         if compUda_RC == 10 * 256:
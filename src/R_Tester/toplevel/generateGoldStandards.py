@@ -331,6 +331,7 @@ def generateGS() :
             #  Defaults
             sus_options  = ""
             do_gpu       = 0    # run test if gpu is supported 
+            other_gs     = 0    # compared with the gold standard of another test
             
             #__________________________________
             # parse user flags for the gpu and sus_options
@@ -348,6 +349,12 @@ def generateGS() :
                 if tmp[0] == "sus_options":
                   sus_options = tmp[1]
                   print( "\n sus_option: %s \n"%(sus_options) )
+                if tmp[0] == "gold_standard":
+                  other_gs = 1
+
+            if other_gs == 1:
+              print( "\nSkipping test %s, it is compared with the gold standard of another test\n" % getTestName( test ) )
+              continue
 
             if do_gpu == 1:
             
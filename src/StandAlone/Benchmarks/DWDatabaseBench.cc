@@ -0,0 +1,325 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ *  DWDatabaseBench.cc: Multithreaded DataWarehouse variable database benchmark.
+ *
+ *  Each thread owns a set of patches and repeatedly runs the access pattern of
+ *  a task: put its computed variables into the "new" DW, read neighbor variables
+ *  from the "old" DW, then get and scrub its own variables. The same workload is
+ *  run against the lock-free DWDatabase and against a replica of the previous
+ *  implementation that serialized every operation on one global lock.
+ */
+
+#include <CCA/Components/Schedulers/OnDemandDataWarehouse.h>
+
+#include <Core/Geometry/IntVector.h>
+#include <Core/Grid/Grid.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/CCVariable.h>
+#include <Core/Grid/Variables/VarLabel.h>
+#include <Core/Parallel/MasterLock.h>
+#include <Core/Util/Timers/Timers.hpp>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace Uintah;
+
+namespace {
+
+const int NUM_LABELS      = 16;
+const int NUM_READS       = 4;
+const int PATCHES_DEFAULT = 8;
+const int ITERS_DEFAULT   = 200;
+
+//______________________________________________________________________
+//
+// Replica of the DWDatabase before sharding: one process-wide lock around
+// an std::unordered_map key lookup and the variable/scrub vectors.
+struct LegacyHash {
+  size_t operator()( const VarLabelMatl<Patch> & v ) const {
+    size_t h = 0u;
+    const char* str = v.m_label->getName().data();
+    while (int c = *str++) {
+      h = h * 7 + c;
+    }
+    return ((((size_t)v.m_label) << (sizeof(size_t) / 2) ^ ((size_t)v.m_label) >> (sizeof(size_t) / 2)) ^ (size_t)v.m_domain ^ (size_t)v.m_matl_index);
+  }
+};
+
+Uintah::MasterLock g_legacy_lock{};
+
+class LegacyDatabase {
+
+public:
+
+  ~LegacyDatabase()
+  {
+    for (auto var : m_vars) {
+      delete var;
+    }
+  }
+
+  void insert( const VarLabel * label, int matl, const Patch * patch )
+  {
+    VarLabelMatl<Patch> v(label, matl, patch);
+    if (m_keys.find(v) == m_keys.end()) {
+      m_keys.insert(std::make_pair(v, static_cast<int>(m_vars.size())));
+      m_vars.push_back(nullptr);
+      m_scrubs.push_back(0);
+    }
+  }
+
+  bool exists( const VarLabel * label, int matl, const Patch * patch ) const
+  {
+    std::lock_guard<Uintah::MasterLock> lock(g_legacy_lock);
+    int idx = lookup(label, matl, patch);
+    return idx != -1 && m_vars[idx] != nullptr;
+  }
+
+  void put( const VarLabel * label, int matl, const Patch * patch, Variable * var )
+  {
+    std::lock_guard<Uintah::MasterLock> lock(g_legacy_lock);
+    int idx = lookup(label, matl, patch);
+    delete m_vars[idx];
+    m_vars[idx] = var;
+  }
+
+  Variable* get( const VarLabel * label, int matl, const Patch * patch ) const
+  {
+    std::lock_guard<Uintah::MasterLock> lock(g_legacy_lock);
+    return m_vars[lookup(label, matl, patch)];
+  }
+
+  void setScrubCount( const VarLabel * label, int matl, const Patch * patch, int count )
+  {
+    std::lock_guard<Uintah::MasterLock> lock(g_legacy_lock);
+    m_scrubs[lookup(label, matl, patch)] = count;
+  }
+
+  int decrementScrubCount( const VarLabel * label, int matl, const Patch * patch )
+  {
+    std::lock_guard<Uintah::MasterLock> lock(g_legacy_lock);
+    int idx = lookup(label, matl, patch);
+    int rt = __sync_sub_and_fetch(&m_scrubs[idx], 1);
+    if (rt == 0) {
+      delete m_vars[idx];
+      m_vars[idx] = nullptr;
+    }
+    return rt;
+  }
+
+private:
+
+  int lookup( const VarLabel * label, int matl, const Patch * patch ) const
+  {
+    auto iter = m_keys.find(VarLabelMatl<Patch>(label, matl, patch));
+    return (iter == m_keys.end()) ? -1 : iter->second;
+  }
+
+  std::unordered_map<VarLabelMatl<Patch>, int, LegacyHash> m_keys;
+  std::vector<Variable*>                                   m_vars;
+  std::vector<int>                                         m_scrubs;
+};
+
+//______________________________________________________________________
+//
+// Thin adapter so both databases run the exact same workload
+struct ShardedDatabase {
+
+  ShardedDatabase()  { m_db.doReserve(&m_keys); }
+
+  void insert( const VarLabel * label, int matl, const Patch * patch ) { m_keys.insert(label, matl, patch); }
+  void reserve()                                                       { m_db.doReserve(&m_keys); }
+
+  bool exists( const VarLabel * label, int matl, const Patch * patch ) const         { return m_db.exists(label, matl, patch); }
+  void put( const VarLabel * label, int matl, const Patch * patch, Variable * var )  { m_db.put(label, matl, patch, var, false, true); }
+  Variable* get( const VarLabel * label, int matl, const Patch * patch ) const       { return m_db.get(label, matl, patch); }
+  void setScrubCount( const VarLabel * label, int matl, const Patch * patch, int c ) { m_db.setScrubCount(label, matl, patch, c); }
+  int  decrementScrubCount( const VarLabel * label, int matl, const Patch * patch )  { return m_db.decrementScrubCount(label, matl, patch); }
+
+  KeyDatabase<Patch> m_keys;
+  DWDatabase<Patch>  m_db;
+};
+
+void reserve( LegacyDatabase  &    ) {}
+void reserve( ShardedDatabase & db ) { db.reserve(); }
+
+//______________________________________________________________________
+//
+template<class Database>
+double runBenchmark( int                                     num_threads
+                   , int                                     iterations
+                   , const std::vector<const VarLabel*>    & labels
+                   , const std::vector<const Patch*>       & patches
+                   ,       long                            & total_ops
+                   )
+{
+  Database old_dw;
+  Database new_dw;
+
+  for (auto patch : patches) {
+    for (auto label : labels) {
+      old_dw.insert(label, 0, patch);
+      new_dw.insert(label, 0, patch);
+    }
+  }
+  reserve(old_dw);
+  reserve(new_dw);
+
+  for (auto patch : patches) {
+    for (auto label : labels) {
+      old_dw.put(label, 0, patch, new CCVariable<double>());
+    }
+  }
+
+  const int patches_per_thread = static_cast<int>(patches.size()) / num_threads;
+  std::vector<long> ops(num_threads, 0);
+
+  auto worker = [&](int t) {
+    long count = 0;
+    const int first = t * patches_per_thread;
+    for (int iter = 0; iter < iterations; ++iter) {
+      for (int p = first; p < first + patches_per_thread; ++p) {
+        const Patch* patch    = patches[p];
+        const Patch* neighbor = patches[(p + patches_per_thread) % patches.size()];
+
+        for (auto label : labels) {
+          new_dw.put(label, 0, patch, new CCVariable<double>());
+          new_dw.setScrubCount(label, 0, patch, NUM_READS);
+          count += 2;
+        }
+        for (auto label : labels) {
+          for (int r = 0; r < NUM_READS; ++r) {
+            if (old_dw.exists(label, 0, neighbor)) {
+              old_dw.get(label, 0, neighbor);
+            }
+            new_dw.get(label, 0, patch);
+            new_dw.decrementScrubCount(label, 0, patch);
+            count += 4;
+          }
+        }
+      }
+    }
+    ops[t] = count;
+  };
+
+  Timers::Simple timer;
+  timer.start();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back(worker, t);
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  timer.stop();
+
+  total_ops = 0;
+  for (auto count : ops) {
+    total_ops += count;
+  }
+  return timer().seconds();
+}
+
+void usage()
+{
+  std::cerr << "Usage: DWDatabaseBench <threads> [<patches per thread>] [<iterations>]" << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "  <threads>             Number of threads hammering the databases." << std::endl;
+  std::cerr << "  <patches per thread>  Patches owned by each thread, " << NUM_LABELS << " variables each (default " << PATCHES_DEFAULT << ")." << std::endl;
+  std::cerr << "  <iterations>          Timesteps to simulate (default " << ITERS_DEFAULT << ")." << std::endl;
+}
+
+} // namespace
+
+
+int main( int argc, char** argv )
+{
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  const int num_threads        = atoi(argv[1]);
+  const int patches_per_thread = (argc > 2) ? atoi(argv[2]) : PATCHES_DEFAULT;
+  const int iterations         = (argc > 3) ? atoi(argv[3]) : ITERS_DEFAULT;
+
+  if (num_threads <= 0 || patches_per_thread <= 0 || iterations <= 0) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  std::vector<const VarLabel*> labels;
+  for (int l = 0; l < NUM_LABELS; ++l) {
+    std::ostringstream name;
+    name << "bench_var_" << l;
+    labels.push_back(VarLabel::create(name.str(), CCVariable<double>::getTypeDescription()));
+  }
+
+  Grid grid;
+  grid.addLevel(Point(0, 0, 0), Vector(1, 1, 1));
+  LevelP level = grid.getLevel(0);
+
+  std::vector<const Patch*> patches;
+  for (int p = 0; p < num_threads * patches_per_thread; ++p) {
+    IntVector low(p * 16, 0, 0);
+    IntVector high((p + 1) * 16, 16, 16);
+    patches.push_back(level->addPatch(low, high, low, high, &grid));
+  }
+
+  std::cout << "DWDatabase Benchmark: " << num_threads << " thread(s), "
+            << patches.size() << " patches, " << NUM_LABELS << " variables per patch, "
+            << iterations << " iteration(s)" << std::endl;
+
+  long legacy_ops  = 0;
+  long sharded_ops = 0;
+  double legacy_time  = runBenchmark<LegacyDatabase>(num_threads, iterations, labels, patches, legacy_ops);
+  double sharded_time = runBenchmark<ShardedDatabase>(num_threads, iterations, labels, patches, sharded_ops);
+
+  const double legacy_rate  = legacy_ops / legacy_time / 1.0e6;
+  const double sharded_rate = sharded_ops / sharded_time / 1.0e6;
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "  global lock : " << legacy_time  << " s  (" << legacy_rate  << " Mops/s)" << std::endl;
+  std::cout << "  lock-free   : " << sharded_time << " s  (" << sharded_rate << " Mops/s)" << std::endl;
+  std::cout << "  speedup     : " << sharded_rate / legacy_rate << "x" << std::endl;
+
+  for (auto label : labels) {
+    VarLabel::destroy(label);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,371 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ *  InterpolatorBench.cc: Particle shape function benchmark.
+ *
+ *  Evaluates the nodes, weights and shape function derivatives of every
+ *  particle of a patch with each interpolator, once per particle through the
+ *  virtual ParticleInterpolator interface and once per block of particles
+ *  through BatchInterpolator, and reports particles/s.  The batched results
+ *  are checked against the virtual ones.
+ *
+ *  Usage: InterpolatorBench [cells per side] [particles per cell] [repetitions]
+ */
+
+#include <Core/Geometry/Point.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Grid/BSplineInterpolator.h>
+#include <Core/Grid/BatchInterpolator.h>
+#include <Core/Grid/GIMPInterpolator.h>
+#include <Core/Grid/Grid.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/LinearInterpolator.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/TOBSplineInterpolator.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Grid/cpdiInterpolator.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Util/Timers/Timers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Uintah;
+
+namespace {
+
+  //______________________________________________________________________
+  //  The particles' contribution to a few node sums, so that the work
+  //  is not optimized away.
+  struct Sums {
+    double S{0};
+    double nodeS{0};
+    double dS{0};
+  };
+
+  volatile double g_sink;
+
+  void
+  consume( const Sums & sums )
+  {
+    g_sink = sums.S + sums.nodeS + sums.dS;
+  }
+
+  struct Particles {
+    ParticleSubset           * pset;
+    ParticleVariable<Point>    px;
+    ParticleVariable<Matrix3>  psize;
+  };
+
+  //______________________________________________________________________
+  //
+  Sums
+  runVirtual( ParticleInterpolator * interpolator, Particles & particles, bool gradients )
+  {
+    const int              NN = interpolator->size();
+    std::vector<IntVector> ni( NN );
+    std::vector<double>    S( NN );
+    std::vector<Vector>    d_S( NN );
+
+    Sums sums;
+    for( ParticleSubset::iterator iter = particles.pset->begin(); iter != particles.pset->end(); iter++ ) {
+      particleIndex idx = *iter;
+
+      if( gradients ) {
+        interpolator->findCellAndWeightsAndShapeDerivatives( particles.px[idx], ni, S, d_S, particles.psize[idx] );
+        for( int k = 0; k < NN; k++ ) {
+          sums.dS += d_S[k].x() + d_S[k].y() + d_S[k].z();
+        }
+      }
+      else {
+        interpolator->findCellAndWeights( particles.px[idx], ni, S, particles.psize[idx] );
+      }
+
+      for( int k = 0; k < NN; k++ ) {
+        sums.S     += S[k];
+        sums.nodeS += S[k] * ( ni[k].x() + ni[k].y() + ni[k].z() );
+      }
+    }
+    return sums;
+  }
+
+  //______________________________________________________________________
+  //
+  template<class Kernel>
+  Sums
+  runBatched( const Patch * patch, const Kernel & kernel, Particles & particles, bool gradients )
+  {
+    typedef BatchInterpolator<Kernel> Batch;
+    Batch batch( patch, kernel );
+    const int NN = batch.size();
+
+    Sums sums;
+    batch.forEachBlock( particles.pset, particles.px, particles.psize, gradients,
+                        [&]( const typename Batch::Block & b, const particleIndex * ) {
+      double S     = 0;
+      double nodeS = 0;
+      double dS    = 0;
+      for( int k = 0; k < NN; k++ ) {
+        for( int p = 0; p < b.count; p++ ) {
+          S     += b.S[k][p];
+          nodeS += b.S[k][p] * ( b.ni_x[k][p] + b.ni_y[k][p] + b.ni_z[k][p] );
+        }
+        if( gradients ) {
+          for( int p = 0; p < b.count; p++ ) {
+            dS += b.dS_x[k][p] + b.dS_y[k][p] + b.dS_z[k][p];
+          }
+        }
+      }
+      sums.S     += S;
+      sums.nodeS += nodeS;
+      sums.dS    += dS;
+    } );
+    return sums;
+  }
+
+  //______________________________________________________________________
+  //  Equal up to rounding, the batched kernels may be compiled with
+  //  other options (e.g. fused multiply-adds) than the library.
+  bool
+  close( double a, double b )
+  {
+    return std::fabs( a - b ) <= 1.e-12 * std::max( 1.0, std::fabs( a ) );
+  }
+
+  bool
+  close( const Vector & a, const Vector & b )
+  {
+    return close( a.x(), b.x() ) && close( a.y(), b.y() ) && close( a.z(), b.z() );
+  }
+
+  //______________________________________________________________________
+  //  The weights and derivatives of a particle summed per node, as the
+  //  kernels may order or pad the nodes differently.
+  struct NodeWeight {
+    IntVector node;
+    double    S;
+    Vector    d_S;
+  };
+
+  void
+  addNodeWeight( std::vector<NodeWeight> & weights, const IntVector & node, double S, const Vector & d_S )
+  {
+    for( size_t n = 0; n < weights.size(); n++ ) {
+      if( weights[n].node == node ) {
+        weights[n].S   += S;
+        weights[n].d_S += d_S;
+        return;
+      }
+    }
+    NodeWeight w = { node, S, d_S };
+    weights.push_back( w );
+  }
+
+  bool
+  sameNodeWeights( const std::vector<NodeWeight> & a, const std::vector<NodeWeight> & b )
+  {
+    if( a.size() != b.size() ) {
+      return false;
+    }
+    for( size_t n = 0; n < a.size(); n++ ) {
+      bool found = false;
+      for( size_t m = 0; !found && m < b.size(); m++ ) {
+        found = ( a[n].node == b[m].node && close( a[n].S, b[m].S ) && close( a[n].d_S, b[m].d_S ) );
+      }
+      if( !found ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //______________________________________________________________________
+  //  Number of particles whose batched nodes, weights or derivatives
+  //  differ from those of the virtual interpolator.
+  template<class Kernel>
+  int
+  verify( const Patch * patch, ParticleInterpolator * interpolator, const Kernel & kernel, Particles & particles )
+  {
+    typedef BatchInterpolator<Kernel> Batch;
+    Batch batch( patch, kernel );
+
+    const int              NN = interpolator->size();
+    std::vector<IntVector> ni( NN );
+    std::vector<double>    S( NN );
+    std::vector<Vector>    d_S( NN );
+
+    std::vector<NodeWeight> expected;
+    std::vector<NodeWeight> batched;
+
+    int errors = 0;
+    batch.forEachBlock( particles.pset, particles.px, particles.psize, true,
+                        [&]( const typename Batch::Block & b, const particleIndex * idx ) {
+      for( int p = 0; p < b.count; p++ ) {
+        interpolator->findCellAndWeightsAndShapeDerivatives( particles.px[idx[p]], ni, S, d_S, particles.psize[idx[p]] );
+
+        expected.clear();
+        batched.clear();
+        for( int k = 0; k < NN; k++ ) {
+          addNodeWeight( expected, ni[k], S[k], d_S[k] );
+        }
+        for( int k = 0; k < batch.size(); k++ ) {
+          addNodeWeight( batched, b.node( k, p ), b.S[k][p], b.gradient( k, p ) );
+        }
+        if( !sameNodeWeights( expected, batched ) ) {
+          errors++;
+        }
+      }
+    } );
+    return errors;
+  }
+
+  //______________________________________________________________________
+  //  Best of 'reps' runs of 'f', in seconds
+  template<class F>
+  double
+  bestTime( int reps, F f )
+  {
+    double best = 0;
+    for( int r = 0; r < reps; r++ ) {
+      Timers::Simple timer;
+      timer.start();
+      f();
+      timer.stop();
+      best = ( r == 0 ) ? timer().seconds() : std::min( best, timer().seconds() );
+    }
+    return best;
+  }
+
+  //______________________________________________________________________
+  //
+  template<class Kernel>
+  int
+  compare( const std::string    & name
+         , const Patch          * patch
+         , ParticleInterpolator * interpolator
+         , const Kernel         & kernel
+         , Particles            & particles
+         , int                    reps
+         )
+  {
+    const double nParticles = particles.pset->numParticles();
+
+    for( int gradients = 0; gradients < 2; gradients++ ) {
+      const double tVirtual = bestTime( reps, [&]() { consume( runVirtual( interpolator, particles, gradients ) ); } );
+      const double tBatched = bestTime( reps, [&]() { consume( runBatched( patch, kernel, particles, gradients ) ); } );
+
+      printf( "%-12s %-9s | %10.2f %10.2f | %7.2f\n", name.c_str(), gradients ? "S, d_S" : "S",
+              nParticles / tVirtual * 1.e-6, nParticles / tBatched * 1.e-6, tVirtual / tBatched );
+    }
+
+    const int errors = verify( patch, interpolator, kernel, particles );
+    if( errors > 0 ) {
+      printf( "  ERROR: %s: %d particles differ from the virtual interpolator\n", name.c_str(), errors );
+    }
+    return errors;
+  }
+}
+
+//______________________________________________________________________
+//
+int
+main( int argc, char *argv[] )
+{
+  const int cells = ( argc > 1 ) ? atoi( argv[1] ) : 24;
+  const int ppc   = ( argc > 2 ) ? atoi( argv[2] ) : 8;
+  const int reps  = ( argc > 3 ) ? atoi( argv[3] ) : 5;
+
+  if( cells < 8 || ppc < 1 || reps < 1 ) {
+    printf( "Usage: %s [cells per side (>= 8)] [particles per cell] [repetitions]\n", argv[0] );
+    return 1;
+  }
+
+  Grid grid;
+  Level* level = grid.addLevel( Point( 0, 0, 0 ), Vector( 0.1, 0.1, 0.1 ) );
+  const Patch* patch = level->addPatch( IntVector( 0, 0, 0 ), IntVector( cells, cells, cells ),
+                                        IntVector( 0, 0, 0 ), IntVector( cells, cells, cells ), &grid );
+  level->finalizeLevel();
+
+  // The particles fill all cells, so the BSplines' boundary nodes are
+  // exercised too.
+  const unsigned int nParticles = cells * cells * cells * ppc;
+
+  Particles particles;
+  particles.pset = new ParticleSubset( nParticles, 0, patch );
+  particles.pset->addReference();
+  particles.px.allocate( particles.pset );
+  particles.psize.allocate( particles.pset );
+
+  std::mt19937 gen( 1234 );
+  std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+  // Particles are generated cell by cell, with a half cell wide,
+  // slightly sheared domain.
+  const double h = 0.5 / std::cbrt( ppc );
+  unsigned int p = 0;
+  for( int i = 0; i < cells; i++ ) {
+    for( int j = 0; j < cells; j++ ) {
+      for( int k = 0; k < cells; k++ ) {
+        for( int n = 0; n < ppc; n++, p++ ) {
+          particles.px[p]    = Point( ( i + unit( gen ) ) * 0.1, ( j + unit( gen ) ) * 0.1, ( k + unit( gen ) ) * 0.1 );
+          particles.psize[p] = Matrix3( 2 * h, 0.1 * h * unit( gen ), 0,
+                                        0, 2 * h, 0.1 * h * unit( gen ),
+                                        0.1 * h * unit( gen ), 0, 2 * h );
+        }
+      }
+    }
+  }
+
+  printf( "InterpolatorBench: %d^3 cells, %d particles per cell, %u particles, %d repetitions\n",
+          cells, ppc, nParticles, reps );
+  printf( "%-12s %-9s | %10s %10s | %7s\n", "interpolator", "computes", "virtual", "batched", "speedup" );
+  printf( "%-12s %-9s | %10s %10s |\n", "", "", "Mpart/s", "Mpart/s" );
+
+  LinearInterpolator    linear( patch );
+  GIMPInterpolator      gimp( patch );
+  cpdiInterpolator      cpdi( patch, 0.9 );
+  TOBSplineInterpolator bspline3( patch );
+  BSplineInterpolator   bspline4( patch );
+
+  int errors = 0;
+  errors += compare( "linear",     patch, &linear,   LinearKernel(),          particles, reps );
+  errors += compare( "gimp",       patch, &gimp,     GIMPKernel(),            particles, reps );
+  errors += compare( "cpdi",       patch, &cpdi,     cpdiKernel( 0.9 ),       particles, reps );
+  errors += compare( "3rdorderBS", patch, &bspline3, TOBSplineKernel(),       particles, reps );
+  errors += compare( "4thorderBS", patch, &bspline4, BSplineKernel( patch ),  particles, reps );
+
+  if( particles.pset->removeReference() ) {
+    delete particles.pset;
+  }
+  return errors > 0 ? 1 : 0;
+}
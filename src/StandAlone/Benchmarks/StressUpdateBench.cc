@@ -0,0 +1,348 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ *  StressUpdateBench.cc: Constitutive model stress update benchmark.
+ *
+ *  Updates the stress of the particles of a patch with the models ported to
+ *  BatchStress, once particle by particle through the scalar update of the
+ *  model and once per block through its batched update (the loading and
+ *  storing of the lanes included), and reports particles/s.  The batched
+ *  results are checked against the scalar ones, field by field relative to
+ *  the largest magnitude of the field.
+ *
+ *  Usage: StressUpdateBench [particles] [repetitions]
+ */
+
+#include <CCA/Components/MPM/Materials/ConstitutiveModel/ArrudaBoyce8Chain.h>
+#include <CCA/Components/MPM/Materials/ConstitutiveModel/BatchStress.h>
+#include <CCA/Components/MPM/Materials/ConstitutiveModel/UCNH.h>
+
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Util/Timers/Timers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace Uintah;
+
+namespace {
+
+  // Material constants (steel like)
+  const double g_shear = 80.e9;
+  const double g_bulk  = 160.e9;
+  const double g_K     = 1.e9;      // UCNH hardening modulus
+  const double g_beta  = 2.0;       // ArrudaBoyce8 locking stretch
+
+  //______________________________________________________________________
+  //
+  struct Particles {
+    ParticleSubset           * pset;
+
+    // inputs
+    ParticleVariable<Matrix3>  F_old;
+    ParticleVariable<Matrix3>  F_new;
+    ParticleVariable<Matrix3>  bElBar;
+    ParticleVariable<double>   plasticStrain;
+    ParticleVariable<double>   yieldStress;
+  };
+
+  // The outputs a model does not compute stay zero.
+  struct Outputs {
+    ParticleVariable<Matrix3>  stress;
+    ParticleVariable<Matrix3>  bElBar;
+    ParticleVariable<double>   plasticStrain;
+
+    void allocate( ParticleSubset * pset )
+    {
+      stress.allocate( pset );
+      bElBar.allocate( pset );
+      plasticStrain.allocate( pset );
+
+      for( ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++ ) {
+        stress[*iter].set( 0.0 );
+        bElBar[*iter].set( 0.0 );
+        plasticStrain[*iter] = 0.0;
+      }
+    }
+  };
+
+  //______________________________________________________________________
+  //
+  void
+  ucnhScalar( Particles & particles, bool plasticity, Outputs & out )
+  {
+    for( ParticleSubset::iterator iter = particles.pset->begin(); iter != particles.pset->end(); iter++ ) {
+      particleIndex idx = *iter;
+
+      const double J = particles.F_new[idx].Determinant();
+      UCNH::updateStress( particles.F_old[idx], particles.F_new[idx], particles.bElBar[idx],
+                          particles.plasticStrain[idx], particles.yieldStress[idx], J,
+                          g_shear, g_bulk, g_K, plasticity,
+                          out.bElBar[idx], out.plasticStrain[idx], out.stress[idx] );
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  ucnhBatched( Particles & particles, bool plasticity, Outputs & out )
+  {
+    BatchStress::forEachBlock( particles.pset, [&]( const particleIndex * idx, int count ) {
+      UCNH::StressLanes s;
+      BatchStress::load( particles.F_old,         idx, count, s.F_old );
+      BatchStress::load( particles.F_new,         idx, count, s.F_new );
+      BatchStress::load( particles.bElBar,        idx, count, s.bElBar );
+      BatchStress::load( particles.plasticStrain, idx, count, s.plasticStrain );
+      BatchStress::load( particles.yieldStress,   idx, count, s.yieldStress );
+      BatchStress::determinant( s.F_new, s.J );
+
+      UCNH::updateStress( s, g_shear, g_bulk, g_K, plasticity );
+
+      BatchStress::store( s.bElBar,        idx, count, out.bElBar );
+      BatchStress::store( s.plasticStrain, idx, count, out.plasticStrain );
+      BatchStress::store( s.stress,        idx, count, out.stress );
+    } );
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  arrudaBoyceScalar( Particles & particles, bool, Outputs & out )
+  {
+    for( ParticleSubset::iterator iter = particles.pset->begin(); iter != particles.pset->end(); iter++ ) {
+      particleIndex idx = *iter;
+
+      const double J = particles.F_new[idx].Determinant();
+      ArrudaBoyce8Chain::updateStress( particles.F_new[idx], J, g_shear, g_bulk, g_beta, out.stress[idx] );
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  void
+  arrudaBoyceBatched( Particles & particles, bool, Outputs & out )
+  {
+    BatchStress::forEachBlock( particles.pset, [&]( const particleIndex * idx, int count ) {
+      ArrudaBoyce8Chain::StressLanes s;
+      BatchStress::load( particles.F_new, idx, count, s.F_New );
+      BatchStress::determinant( s.F_New, s.J_New );
+
+      ArrudaBoyce8Chain::updateStress( s, g_shear, g_bulk, g_beta );
+
+      BatchStress::store( s.stress, idx, count, out.stress );
+    } );
+  }
+
+  //______________________________________________________________________
+  //  Equal up to rounding, the batched kernels evaluate some expressions
+  //  in another order, take cube roots with BatchStress::cbrt and may be
+  //  compiled with other options (e.g. fused multiply-adds).  The rounding
+  //  errors of a value scale with the magnitude of the whole field rather
+  //  than with the value itself (e.g. a plastic strain increment is the
+  //  difference of stresses), so 'scale' is the largest magnitude of the
+  //  field.
+  bool
+  close( double a, double b, double scale )
+  {
+    return std::fabs( a - b ) <= 1.e-12 * std::max( scale, std::fabs( a ) );
+  }
+
+  bool
+  close( const Matrix3 & a, const Matrix3 & b, double scale )
+  {
+    return ( a - b ).Norm() <= 1.e-12 * std::max( scale, a.Norm() );
+  }
+
+  double
+  magnitude( ParticleSubset * pset, const ParticleVariable<double> & var )
+  {
+    double scale = 0.0;
+    for( ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++ ) {
+      scale = std::max( scale, std::fabs( var[*iter] ) );
+    }
+    return scale;
+  }
+
+  double
+  magnitude( ParticleSubset * pset, const ParticleVariable<Matrix3> & var )
+  {
+    double scale = 0.0;
+    for( ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++ ) {
+      scale = std::max( scale, var[*iter].Norm() );
+    }
+    return scale;
+  }
+
+  //______________________________________________________________________
+  //  Number of particles whose batched results differ from the scalar ones.
+  int
+  verify( ParticleSubset * pset, const Outputs & scalar, const Outputs & batched, bool plasticity )
+  {
+    const double stressScale        = magnitude( pset, scalar.stress );
+    const double bElBarScale        = magnitude( pset, scalar.bElBar );
+    const double plasticStrainScale = magnitude( pset, scalar.plasticStrain );
+
+    int errors = 0;
+    for( ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++ ) {
+      particleIndex idx = *iter;
+
+      bool same = close( scalar.stress[idx], batched.stress[idx], stressScale ) &&
+                  close( scalar.bElBar[idx], batched.bElBar[idx], bElBarScale );
+      if( plasticity ) {
+        same = same && close( scalar.plasticStrain[idx], batched.plasticStrain[idx], plasticStrainScale );
+      }
+      if( !same ) {
+        errors++;
+      }
+    }
+    return errors;
+  }
+
+  //______________________________________________________________________
+  //  Best of 'reps' runs of 'f', in seconds
+  template<class F>
+  double
+  bestTime( int reps, F f )
+  {
+    double best = 0;
+    for( int r = 0; r < reps; r++ ) {
+      Timers::Simple timer;
+      timer.start();
+      f();
+      timer.stop();
+      best = ( r == 0 ) ? timer().seconds() : std::min( best, timer().seconds() );
+    }
+    return best;
+  }
+
+  //______________________________________________________________________
+  //
+  typedef void (*Update)( Particles &, bool, Outputs & );
+
+  int
+  compare( const std::string & name
+         , Update              scalarUpdate
+         , Update              batchedUpdate
+         , bool                plasticity
+         , Particles         & particles
+         , int                 reps
+         )
+  {
+    const double nParticles = particles.pset->numParticles();
+
+    Outputs scalar;
+    Outputs batched;
+    scalar.allocate( particles.pset );
+    batched.allocate( particles.pset );
+
+    const double tScalar  = bestTime( reps, [&]() { scalarUpdate( particles, plasticity, scalar ); } );
+    const double tBatched = bestTime( reps, [&]() { batchedUpdate( particles, plasticity, batched ); } );
+
+    int yielded = 0;
+    if( plasticity ) {
+      for( ParticleSubset::iterator iter = particles.pset->begin(); iter != particles.pset->end(); iter++ ) {
+        yielded += ( scalar.plasticStrain[*iter] > particles.plasticStrain[*iter] );
+      }
+    }
+
+    printf( "%-18s %7.1f%% | %10.2f %10.2f | %7.2f\n", name.c_str(), 100.0 * yielded / nParticles,
+            nParticles / tScalar * 1.e-6, nParticles / tBatched * 1.e-6, tScalar / tBatched );
+
+    const int errors = verify( particles.pset, scalar, batched, plasticity );
+    if( errors > 0 ) {
+      printf( "  ERROR: %s: %d particles differ from the scalar update\n", name.c_str(), errors );
+    }
+    return errors;
+  }
+}
+
+//______________________________________________________________________
+//
+int
+main( int argc, char *argv[] )
+{
+  const int nParticles = ( argc > 1 ) ? atoi( argv[1] ) : 1000000;
+  const int reps       = ( argc > 2 ) ? atoi( argv[2] ) : 5;
+
+  if( nParticles < 1 || reps < 1 ) {
+    printf( "Usage: %s [particles] [repetitions]\n", argv[0] );
+    return 1;
+  }
+
+  Particles particles;
+  particles.pset = new ParticleSubset( nParticles, 0, nullptr );
+  particles.pset->addReference();
+  particles.F_old.allocate( particles.pset );
+  particles.F_new.allocate( particles.pset );
+  particles.bElBar.allocate( particles.pset );
+  particles.plasticStrain.allocate( particles.pset );
+  particles.yieldStress.allocate( particles.pset );
+
+  std::mt19937 gen( 1234 );
+  std::uniform_real_distribution<double> unit( -1.0, 1.0 );
+
+  auto perturbed = [&]( double amplitude ) {
+    Matrix3 A;
+    A.Identity();
+    for( int i = 0; i < 3; i++ ) {
+      for( int j = 0; j < 3; j++ ) {
+        A( i, j ) += amplitude * unit( gen );
+      }
+    }
+    return A;
+  };
+
+  // Moderately deformed particles with a small increment.  The yield
+  // stresses are spread so that some of the particles yield.
+  for( int p = 0; p < nParticles; p++ ) {
+    particles.F_old[p]         = perturbed( 0.05 );
+    particles.F_new[p]         = perturbed( 0.002 ) * particles.F_old[p];
+    const Matrix3 Fe           = perturbed( 0.002 );
+    particles.bElBar[p]        = Fe * Fe.Transpose() / std::pow( Fe.Determinant(), 2.0 / 3.0 );
+    particles.plasticStrain[p] = 0.01 * ( 1.0 + unit( gen ) );
+    particles.yieldStress[p]   = 8.e8 * ( 1.0 + 0.5 * unit( gen ) );
+  }
+
+  printf( "StressUpdateBench: %d particles, %d repetitions, %d lanes\n", nParticles, reps, BatchStress::s_width );
+  printf( "%-18s %8s | %10s %10s | %7s\n", "model", "yielded", "scalar", "batched", "speedup" );
+  printf( "%-18s %8s | %10s %10s |\n", "", "", "Mpart/s", "Mpart/s" );
+
+  int errors = 0;
+  errors += compare( "UCNH",             ucnhScalar, ucnhBatched, false, particles, reps );
+  errors += compare( "UCNH plasticity",  ucnhScalar, ucnhBatched, true,  particles, reps );
+  errors += compare( "ArrudaBoyce8",     arrudaBoyceScalar, arrudaBoyceBatched, false, particles, reps );
+
+  if( particles.pset->removeReference() ) {
+    delete particles.pset;
+  }
+  return errors > 0 ? 1 : 0;
+}
@@ -67,4 +67,37 @@ endif
 
 include $(SCIRUN_SCRIPTS)/program.mk
 
+##############################################
+# DataWarehouse variable database benchmark
+
+SRCS    := $(SRCDIR)/DWDatabaseBench.cc
+
+PROGRAM := $(SRCDIR)/DWDatabaseBench
+
+include $(SCIRUN_SCRIPTS)/program.mk
+
+##############################################
+# Particle interpolator benchmark
+
+SRCS    := $(SRCDIR)/InterpolatorBench.cc
+
+PROGRAM := $(SRCDIR)/InterpolatorBench
+
+include $(SCIRUN_SCRIPTS)/program.mk
+
+##############################################
+# Constitutive model stress update benchmark
+
+SRCS    := $(SRCDIR)/StressUpdateBench.cc
+
+PROGRAM := $(SRCDIR)/StressUpdateBench
+
+include $(SCIRUN_SCRIPTS)/program.mk
+
 SimpleMath: prereqs StandAlone/Benchmarks/SimpleMath
+
+DWDatabaseBench: prereqs StandAlone/Benchmarks/DWDatabaseBench
+
+InterpolatorBench: prereqs StandAlone/Benchmarks/InterpolatorBench
+
+StressUpdateBench: prereqs StandAlone/Benchmarks/StressUpdateBench
@@ -166,6 +166,7 @@ static void usage( const std::string& message,
     std::cerr << "-gpucheck            : returns 1 if sus was compiled with CUDA and there is a GPU available. \n";
     std::cerr << "                     : returns 2 if sus was not compiled with CUDA or there are no GPUs available. \n";
     std::cerr << "-nthreads <#>        : number of threads per MPI process, requires multi-threaded Unified scheduler\n";
+    std::cerr << "-nthreadsperpartition <#> : number of threads per Kokkos partition, or without Kokkos per parallel_for/parallel_reduce loop\n";
     std::cerr << "-layout NxMxO        : Eg: 2x1x1.  MxNxO must equal number tof boxes you are using.\n";
     std::cerr << "-local_filesystem    : If using MPI, use this flag if each node has a local disk.\n";
     std::cerr << "-emit_taskgraphs     : Output taskgraph information\n";
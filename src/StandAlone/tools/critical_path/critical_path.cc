@@ -0,0 +1,389 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+//______________________________________________________________________
+//
+// critical_path - critical path analysis of the task graphs recorded by
+// the schedulers (<Scheduler><ExecutedTaskGraph>).  Give it the files
+// of all ranks of one execution, e.g. executed_graph.10.0.*.txt.
+//
+// The graph has the executed tasks as nodes, weighted by their measured
+// duration (start of doit() to done()), the internal dependencies as
+// edges of weight 0 and the MPI messages as edges weighted by the time
+// from the end of the sending task to the completion of the receive.
+// Reported are the longest path through this graph, the slack of the
+// tasks (how much later a task could have started without lengthening
+// it) and the communication on the path.  Resource limits (threads)
+// are not modeled, the path is a lower bound of the timestep.
+//
+// Usage: critical_path [-n <path entries>] [-slack <file>] <files>
+//______________________________________________________________________
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+  struct Edge {
+    int    m_from;
+    int    m_to;
+    double m_weight;    // microseconds
+    bool   m_mpi;
+  };
+
+  struct Node {
+    int         m_rank;
+    int         m_id;
+    double      m_start;       // microseconds, < 0 if not executed
+    double      m_end;
+    std::string m_name;
+    std::string m_type;        // the task name without patches and materials
+
+    double      m_earliest{0}; // earliest start
+    double      m_latest{0};   // latest start
+    int         m_critical_pred{-1};
+    int         m_critical_edge{-1};
+
+    double duration() const { return ( m_start >= 0 && m_end >= m_start ) ? m_end - m_start : 0; }
+  };
+
+  struct Recv {
+    int    m_node;
+    int    m_from_rank;
+    int    m_tag;
+    double m_received;
+  };
+
+  //______________________________________________________________________
+  //
+  std::string
+  taskType( const std::string & name )
+  {
+    std::string::size_type pos = name.find( " (" );
+    return ( pos == std::string::npos ) ? name : name.substr( 0, pos );
+  }
+
+  //______________________________________________________________________
+  //
+  bool
+  readGraph( const char                                  * filename
+           , std::vector<Node>                           & nodes
+           , std::vector<Edge>                           & edges
+           , std::map<std::tuple<int, int, int>, int>    & sends
+           , std::vector<Recv>                           & recvs
+           )
+  {
+    std::ifstream in( filename );
+    if( !in ) {
+      std::cerr << "ERROR: could not open " << filename << "\n";
+      return false;
+    }
+
+    int rank = -1;
+    std::map<int, int> nodes_by_id;
+    std::string line;
+
+    while( std::getline( in, line ) ) {
+      if( line.empty() || line[0] == '#' ) {
+        continue;
+      }
+
+      std::istringstream fields( line );
+      std::string kind;
+      fields >> kind;
+
+      if( kind == "rank" ) {
+        fields >> rank;
+      }
+      else if( kind == "task" ) {
+        Node node;
+        node.m_rank = rank;
+        fields >> node.m_id >> node.m_start >> node.m_end;
+        std::getline( fields >> std::ws, node.m_name );
+        node.m_type = taskType( node.m_name );
+        nodes_by_id[node.m_id] = nodes.size();
+        nodes.push_back( node );
+      }
+      else if( kind == "dep" ) {
+        int from, to;
+        fields >> from >> to;
+        edges.push_back( Edge{ nodes_by_id.at( from ), nodes_by_id.at( to ), 0, false } );
+      }
+      else if( kind == "send" ) {
+        int from, to_rank, tag;
+        fields >> from >> to_rank >> tag;
+        sends[std::make_tuple( rank, to_rank, tag )] = nodes_by_id.at( from );
+      }
+      else if( kind == "recv" ) {
+        int to;
+        Recv recv;
+        fields >> to >> recv.m_from_rank >> recv.m_tag >> recv.m_received;
+        recv.m_node = nodes_by_id.at( to );
+        recvs.push_back( recv );
+      }
+
+      if( fields.fail() ) {
+        std::cerr << "ERROR: " << filename << ": can not parse '" << line << "'\n";
+        return false;
+      }
+    }
+
+    if( rank < 0 ) {
+      std::cerr << "ERROR: " << filename << " is not an executed task graph\n";
+      return false;
+    }
+    return true;
+  }
+}
+
+//______________________________________________________________________
+//
+int
+main( int argc, char *argv[] )
+{
+  int         max_entries = 50;
+  std::string slack_file;
+  std::vector<const char*> files;
+
+  for( int i = 1; i < argc; i++ ) {
+    if( std::strcmp( argv[i], "-n" ) == 0 && i + 1 < argc ) {
+      max_entries = atoi( argv[++i] );
+    }
+    else if( std::strcmp( argv[i], "-slack" ) == 0 && i + 1 < argc ) {
+      slack_file = argv[++i];
+    }
+    else {
+      files.push_back( argv[i] );
+    }
+  }
+
+  if( files.empty() ) {
+    std::cout << "Usage: " << argv[0] << " [-n <path entries>] [-slack <file>] executed_graph.<timestep>.<n>.*.txt\n";
+    return 1;
+  }
+
+  //__________________________________
+  // read the graphs of all ranks and connect the messages
+  std::vector<Node> nodes;
+  std::vector<Edge> edges;
+  std::map<std::tuple<int, int, int>, int> sends;   // (from rank, to rank, tag) -> sending task
+  std::vector<Recv> recvs;
+
+  for( const char* file : files ) {
+    try {
+      if( !readGraph( file, nodes, edges, sends, recvs ) ) {
+        return 1;
+      }
+    }
+    catch( const std::out_of_range & ) {
+      std::cerr << "ERROR: " << file << " refers to an unknown task\n";
+      return 1;
+    }
+  }
+
+  int num_messages = 0;
+  for( const Recv & recv : recvs ) {
+    const Node& to = nodes[recv.m_node];
+    auto iter = sends.find( std::make_tuple( recv.m_from_rank, to.m_rank, recv.m_tag ) );
+    if( iter == sends.end() ) {
+      continue;  // the sender's graph was not given, or nothing was sent
+    }
+    const Node& from = nodes[iter->second];
+    if( from.m_start < 0 || to.m_start < 0 || recv.m_received < 0 ) {
+      continue;
+    }
+    edges.push_back( Edge{ iter->second, recv.m_node, std::max( 0.0, recv.m_received - from.m_end ), true } );
+    num_messages++;
+  }
+
+  //__________________________________
+  // topological order
+  const int num_nodes = nodes.size();
+  std::vector<std::vector<int> > out_edges( num_nodes );
+  std::vector<std::vector<int> > in_edges( num_nodes );
+  for( int e = 0; e < (int)edges.size(); e++ ) {
+    out_edges[edges[e].m_from].push_back( e );
+    in_edges[edges[e].m_to].push_back( e );
+  }
+
+  std::vector<int> order;
+  std::vector<int> pending( num_nodes );
+  for( int n = 0; n < num_nodes; n++ ) {
+    pending[n] = in_edges[n].size();
+    if( pending[n] == 0 ) {
+      order.push_back( n );
+    }
+  }
+  for( size_t i = 0; i < order.size(); i++ ) {
+    for( int e : out_edges[order[i]] ) {
+      if( --pending[edges[e].m_to] == 0 ) {
+        order.push_back( edges[e].m_to );
+      }
+    }
+  }
+  if( (int)order.size() != num_nodes ) {
+    std::cerr << "ERROR: the dependencies have a cycle\n";
+    return 1;
+  }
+
+  //__________________________________
+  // earliest starts (forward) and latest starts (backward)
+  double length = 0;
+  int    last   = -1;
+  for( int n : order ) {
+    Node& node = nodes[n];
+    for( int e : in_edges[n] ) {
+      const double ready = nodes[edges[e].m_from].m_earliest + nodes[edges[e].m_from].duration() + edges[e].m_weight;
+      if( node.m_critical_pred < 0 || ready > node.m_earliest ) {
+        node.m_earliest      = ready;
+        node.m_critical_pred = edges[e].m_from;
+        node.m_critical_edge = e;
+      }
+    }
+    if( node.m_earliest + node.duration() >= length ) {
+      length = node.m_earliest + node.duration();
+      last   = n;
+    }
+  }
+
+  for( auto iter = order.rbegin(); iter != order.rend(); ++iter ) {
+    Node& node = nodes[*iter];
+    double latest_end = length;
+    for( int e : out_edges[*iter] ) {
+      latest_end = std::min( latest_end, nodes[edges[e].m_to].m_latest - edges[e].m_weight );
+    }
+    node.m_latest = latest_end - node.duration();
+  }
+
+  double first_start = -1;
+  double last_end    = 0;
+  for( const Node& node : nodes ) {
+    if( node.m_start >= 0 ) {
+      first_start = ( first_start < 0 ) ? node.m_start : std::min( first_start, node.m_start );
+      last_end    = std::max( last_end, node.m_end );
+    }
+  }
+  const double makespan = last_end - std::max( first_start, 0.0 );
+
+  //__________________________________
+  // the path, from its last task back
+  std::vector<int> path;
+  for( int n = last; n >= 0; n = nodes[n].m_critical_pred ) {
+    path.push_back( n );
+  }
+  std::reverse( path.begin(), path.end() );
+
+  double path_compute = 0;
+  double path_comm    = 0;
+  int    path_msgs    = 0;
+  for( int n : path ) {
+    path_compute += nodes[n].duration();
+    if( nodes[n].m_critical_edge >= 0 && edges[nodes[n].m_critical_edge].m_mpi ) {
+      path_comm += edges[nodes[n].m_critical_edge].m_weight;
+      path_msgs++;
+    }
+  }
+
+  printf( "critical_path: %d ranks, %d tasks, %d dependencies (%d messages)\n",
+          (int)files.size(), num_nodes, (int)edges.size(), num_messages );
+  printf( "  measured time:          %12.3f ms\n", makespan * 1.e-3 );
+  printf( "  critical path:          %12.3f ms (%.1f%% of the measured time)\n",
+          length * 1.e-3, makespan > 0 ? 100 * length / makespan : 0.0 );
+  printf( "    tasks:                %12.3f ms in %d tasks\n", path_compute * 1.e-3, (int)path.size() );
+  printf( "    communication:        %12.3f ms in %d messages\n", path_comm * 1.e-3, path_msgs );
+
+  printf( "\n  critical path (start and times in ms, 'comm' is the message latency into the task):\n" );
+  printf( "  %10s %10s %10s %5s  %s\n", "start", "duration", "comm", "rank", "task" );
+  for( int i = 0; i < (int)path.size(); i++ ) {
+    if( max_entries > 0 && i == max_entries ) {
+      printf( "  ... %d more\n", (int)path.size() - max_entries );
+      break;
+    }
+    const Node& node = nodes[path[i]];
+    char comm[32] = "-";
+    if( node.m_critical_edge >= 0 && edges[node.m_critical_edge].m_mpi ) {
+      snprintf( comm, sizeof(comm), "%.3f", edges[node.m_critical_edge].m_weight * 1.e-3 );
+    }
+    printf( "  %10.3f %10.3f %10s %5d  %s\n", node.m_start * 1.e-3, node.duration() * 1.e-3, comm, node.m_rank, node.m_name.c_str() );
+  }
+
+  //__________________________________
+  // per task type
+  struct TypeStats {
+    int    m_count{0};
+    double m_total{0};
+    double m_on_path{0};
+    double m_min_slack{-1};
+    double m_sum_slack{0};
+  };
+  std::map<std::string, TypeStats> types;
+  for( const Node& node : nodes ) {
+    TypeStats& stats = types[node.m_type];
+    const double slack = std::max( 0.0, node.m_latest - node.m_earliest );
+    stats.m_count++;
+    stats.m_total     += node.duration();
+    stats.m_sum_slack += slack;
+    stats.m_min_slack  = ( stats.m_min_slack < 0 ) ? slack : std::min( stats.m_min_slack, slack );
+  }
+  for( int n : path ) {
+    types[nodes[n].m_type].m_on_path += nodes[n].duration();
+  }
+
+  std::vector<std::pair<std::string, TypeStats> > sorted( types.begin(), types.end() );
+  std::sort( sorted.begin(), sorted.end(), []( const std::pair<std::string, TypeStats> & a, const std::pair<std::string, TypeStats> & b ) {
+      return ( a.second.m_on_path != b.second.m_on_path ) ? a.second.m_on_path > b.second.m_on_path : a.second.m_total > b.second.m_total;
+    } );
+
+  printf( "\n  task types (times in ms):\n" );
+  printf( "  %6s %12s %12s %12s %12s  %s\n", "count", "total", "on path", "min slack", "mean slack", "task" );
+  for( const auto & type : sorted ) {
+    const TypeStats& stats = type.second;
+    printf( "  %6d %12.3f %12.3f %12.3f %12.3f  %s\n", stats.m_count, stats.m_total * 1.e-3, stats.m_on_path * 1.e-3,
+            stats.m_min_slack * 1.e-3, stats.m_sum_slack / stats.m_count * 1.e-3, type.first.c_str() );
+  }
+
+  //__________________________________
+  if( !slack_file.empty() ) {
+    std::ofstream out( slack_file.c_str() );
+    out << "# rank id start(us) duration(us) earliest(us) latest(us) slack(us) task\n";
+    for( const Node& node : nodes ) {
+      char line[160];
+      snprintf( line, sizeof(line), "%d %d %.3f %.3f %.3f %.3f %.3f ", node.m_rank, node.m_id, node.m_start, node.duration(),
+                node.m_earliest, node.m_latest, std::max( 0.0, node.m_latest - node.m_earliest ) );
+      out << line << node.m_name << "\n";
+    }
+  }
+
+  return 0;
+}
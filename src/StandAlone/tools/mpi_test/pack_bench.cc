@@ -0,0 +1,221 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+//______________________________________________________________________
+//
+// pack_bench - compares packing ghost windows of a grid variable with
+// MPI derived datatypes (MPI_Pack) against the explicit row copies of
+// PackBufferInfo (<explicitPacking>), for faces, edges and slabs of a
+// patch.  Every rank exchanges the windows with its neighbor rank (or
+// with itself when run on one rank) the way the MPIScheduler does:
+// pack, send, receive, unpack.
+//
+// Usage: mpirun -np 2 pack_bench [cells per side] [threads] [repetitions]
+//______________________________________________________________________
+
+#include <Core/Grid/Variables/CCVariable.h>
+#include <Core/Parallel/LoopThreadPool.h>
+#include <Core/Parallel/PackBufferInfo.h>
+#include <Core/Parallel/UintahMPI.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Uintah;
+
+namespace {
+
+  struct Shape {
+    std::string m_name;
+    IntVector   m_low;
+    IntVector   m_high;
+  };
+
+  //______________________________________________________________________
+  // Exchanges [low, high) of 'send' into 'recv', returns the pack and
+  // unpack times.
+  void
+  exchange( CCVariable<double> & send
+          , CCVariable<double> & recv
+          , const Shape        & shape
+          , int                  peer
+          , double             & packTime
+          , double             & unpackTime
+          )
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+
+    PackBufferInfo recvbuff;
+    recv.getMPIBuffer( recvbuff, shape.m_low, shape.m_high );
+
+    void*        rbuf;
+    int          rcount;
+    MPI_Datatype rtype;
+    recvbuff.get_type( rbuf, rcount, rtype, comm );
+
+    MPI_Request requests[2];
+    Uintah::MPI::Irecv( rbuf, rcount, rtype, peer, 0, comm, &requests[0] );
+
+    double start = Uintah::MPI::Wtime();
+
+    PackBufferInfo sendbuff;
+    send.getMPIBuffer( sendbuff, shape.m_low, shape.m_high );
+
+    void*        sbuf;
+    int          scount;
+    MPI_Datatype stype;
+    sendbuff.get_type( sbuf, scount, stype, comm );
+    sendbuff.pack( comm, scount );
+
+    packTime += Uintah::MPI::Wtime() - start;
+
+    Uintah::MPI::Isend( sbuf, scount, stype, peer, 0, comm, &requests[1] );
+    Uintah::MPI::Waitall( 2, requests, MPI_STATUSES_IGNORE );
+
+    start = Uintah::MPI::Wtime();
+
+    MPI_Status status;
+    recvbuff.unpack( comm, status );
+
+    unpackTime += Uintah::MPI::Wtime() - start;
+  }
+}
+
+//______________________________________________________________________
+//
+int
+main( int argc, char *argv[] )
+{
+  Uintah::MPI::Init( &argc, &argv );
+
+  int rank;
+  int nRanks;
+  Uintah::MPI::Comm_rank( MPI_COMM_WORLD, &rank );
+  Uintah::MPI::Comm_size( MPI_COMM_WORLD, &nRanks );
+
+  const int n       = ( argc > 1 ) ? atoi( argv[1] ) : 64;
+  const int threads = ( argc > 2 ) ? atoi( argv[2] ) : 1;
+  const int reps    = ( argc > 3 ) ? atoi( argv[3] ) : 20;
+
+  if( n < 4 || threads < 1 || reps < 1 ) {
+    if( rank == 0 ) {
+      printf( "Usage: mpirun -np 2 %s [cells per side] [threads] [repetitions]\n", argv[0] );
+    }
+    Uintah::MPI::Finalize();
+    return 1;
+  }
+
+  LoopThreadPool::setNumThreads( threads );
+
+  const int peer = ( nRanks == 1 ) ? 0 : ( rank ^ 1 );
+  if( peer >= nRanks ) {
+    // odd rank count, the last rank sits out
+    Uintah::MPI::Finalize();
+    return 0;
+  }
+
+  // A patch with two ghost cells.
+  const IntVector low( -2, -2, -2 );
+  const IntVector high( n + 2, n + 2, n + 2 );
+
+  CCVariable<double> send;
+  CCVariable<double> recv;
+  send.allocate( low, high );
+  recv.allocate( low, high );
+
+  for( CellIterator iter( low, high ); !iter.done(); iter++ ) {
+    const IntVector c = *iter;
+    send[c] = rank * 1.e9 + ( c.x() + 2 ) + 1.e3 * ( c.y() + 2 ) + 1.e6 * ( c.z() + 2 );
+  }
+
+  const std::vector<Shape> shapes = {
+      { "x face, 1 layer" , IntVector( 0, 0, 0 )         , IntVector( 1, n, n ) }
+    , { "y face, 1 layer" , IntVector( 0, 0, 0 )         , IntVector( n, 1, n ) }
+    , { "z face, 1 layer" , IntVector( 0, 0, 0 )         , IntVector( n, n, 1 ) }
+    , { "x face, 2 layers", IntVector( 0, 0, 0 )         , IntVector( 2, n, n ) }
+    , { "y face, 2 layers", IntVector( 0, 0, 0 )         , IntVector( n, 2, n ) }
+    , { "z face, 2 layers", IntVector( 0, 0, 0 )         , IntVector( n, n, 2 ) }
+    , { "x edge"          , IntVector( 0, 0, 0 )         , IntVector( n, 2, 2 ) }
+    , { "z edge"          , IntVector( 0, 0, 0 )         , IntVector( 2, 2, n ) }
+    , { "interior slab"   , IntVector( 0, 0, n / 4 )     , IntVector( n, n, n / 2 ) }
+    , { "whole patch"     , low                          , high }
+  };
+
+  if( rank == 0 ) {
+    printf( "pack_bench: %d^3 cells, %d ranks, %d threads, %d repetitions\n", n, nRanks, threads, reps );
+    printf( "%-18s %10s | %12s %12s | %12s %12s | %8s\n", "window", "KB",
+            "MPI pack", "MPI unpack", "expl. pack", "expl. unpack", "speedup" );
+  }
+
+  int errors = 0;
+
+  for( const Shape & shape : shapes ) {
+    double times[2][2] = { { 0, 0 }, { 0, 0 } };
+
+    for( int mode = 0; mode < 2; mode++ ) {
+      PackBufferInfo::setExplicitPacking( mode == 1 );
+
+      recv.initialize( -1.0 );
+
+      // one untimed exchange to warm up
+      double dummy = 0;
+      exchange( send, recv, shape, peer, dummy, dummy );
+
+      for( int r = 0; r < reps; r++ ) {
+        exchange( send, recv, shape, peer, times[mode][0], times[mode][1] );
+      }
+
+      for( CellIterator iter( shape.m_low, shape.m_high ); !iter.done(); iter++ ) {
+        const IntVector c = *iter;
+        if( recv[c] != send[c] - rank * 1.e9 + peer * 1.e9 ) {
+          errors++;
+        }
+      }
+    }
+
+    // slowest rank
+    double max_times[2][2];
+    Uintah::MPI::Reduce( times, max_times, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
+
+    if( rank == 0 ) {
+      const IntVector d = shape.m_high - shape.m_low;
+      const double kb = d.x() * d.y() * d.z() * sizeof( double ) / 1024.0;
+      const double us = 1.e6 / reps;
+      printf( "%-18s %10.1f | %10.1fus %10.1fus | %10.1fus %10.1fus | %8.2f\n", shape.m_name.c_str(), kb,
+              max_times[0][0] * us, max_times[0][1] * us, max_times[1][0] * us, max_times[1][1] * us,
+              ( max_times[0][0] + max_times[0][1] ) / ( max_times[1][0] + max_times[1][1] ) );
+    }
+  }
+
+  int total_errors;
+  Uintah::MPI::Allreduce( &errors, &total_errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD );
+  if( rank == 0 && total_errors > 0 ) {
+    printf( "ERROR: %d cells received wrong values\n", total_errors );
+  }
+
+  Uintah::MPI::Finalize();
+  return total_errors > 0 ? 1 : 0;
+}
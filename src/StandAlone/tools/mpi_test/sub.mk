@@ -75,3 +75,11 @@ SRCS    := $(SRCDIR)/mpi_test.cc
 
 include $(SCIRUN_SCRIPTS)/program.mk
 
+##############################################
+# pack_bench
+
+PROGRAM := $(SRCDIR)/pack_bench
+SRCS    := $(SRCDIR)/pack_bench.cc
+
+include $(SCIRUN_SCRIPTS)/program.mk
+
@@ -0,0 +1,325 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+//______________________________________________________________________
+//
+// particle_bench - throughput of an interpolateParticlesToGrid style
+// particle to grid loop (mass and momentum, linear interpolation) on
+// one patch, for
+//
+//   fragmented - the particle subset indexes a larger variable in
+//                random order, as after particles were deleted or the
+//                subset was sorted and the data carried forward
+//   compacted  - the data gathered (as Relocate does) into a dense
+//                variable addressed by the identity subset
+//
+// The cost of the compacting gather itself is reported too.  Then the
+// dense particles are shuffled, as particles that moved between cells
+// over many relocations would be, and sorted by cell along the Morton
+// and Hilbert curves with ParticleSort (<particle_sort_interval>).
+//
+// Usage: particle_bench [cells per side] [particles per cell] [repetitions]
+//______________________________________________________________________
+
+#include <CCA/Components/MPM/Core/ParticleSort.h>
+
+#include <Core/Geometry/Point.h>
+#include <Core/Geometry/Vector.h>
+#include <Core/Grid/Grid.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/LinearInterpolator.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/NCVariable.h>
+#include <Core/Grid/Variables/ParticleSubset.h>
+#include <Core/Grid/Variables/ParticleVariable.h>
+#include <Core/Math/Matrix3.h>
+#include <Core/Util/Timers/Timers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace Uintah;
+
+namespace {
+
+  //______________________________________________________________________
+  //
+  struct GridVars {
+    NCVariable<double> gmass;
+    NCVariable<Vector> gvelocity;
+  };
+
+  //______________________________________________________________________
+  //
+  void
+  interpolateParticlesToGrid( const Patch                    * patch
+                            ,       ParticleSubset           * pset
+                            , const ParticleVariable<Point>  & px
+                            , const ParticleVariable<double> & pmass
+                            , const ParticleVariable<Vector> & pvelocity
+                            , const ParticleVariable<Matrix3>& psize
+                            ,       GridVars                 & grid
+                            )
+  {
+    LinearInterpolator interpolator( patch );
+    std::vector<IntVector> ni( interpolator.size() );
+    std::vector<double>    S( interpolator.size() );
+
+    grid.gmass.initialize( 0.0 );
+    grid.gvelocity.initialize( Vector( 0.0 ) );
+
+    for( ParticleSubset::iterator iter = pset->begin(); iter != pset->end(); iter++ ) {
+      particleIndex idx = *iter;
+
+      int NN = interpolator.findCellAndWeights( px[idx], ni, S, psize[idx] );
+
+      const Vector pmom = pvelocity[idx] * pmass[idx];
+      for( int k = 0; k < NN; k++ ) {
+        grid.gmass[ni[k]]     += pmass[idx] * S[k];
+        grid.gvelocity[ni[k]] += pmom * S[k];
+      }
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  template<class T>
+  void
+  compact( ParticleSubset * pset, ParticleSubset * dense, ParticleVariable<T> & var )
+  {
+    std::vector<ParticleSubset*>       subsets( 1, pset );
+    std::vector<ParticleVariableBase*> srcs( 1, &var );
+
+    ParticleVariable<T> result;
+    result.gather( dense, subsets, srcs, 0 );
+    var.copyPointer( result );
+  }
+
+  //______________________________________________________________________
+  //
+  double
+  relativeDifference( double a, double b )
+  {
+    return std::abs( a - b ) / std::max( std::abs( a ), std::abs( b ) );
+  }
+}
+
+//______________________________________________________________________
+//
+int
+main( int argc, char *argv[] )
+{
+  const int cells = ( argc > 1 ) ? atoi( argv[1] ) : 32;
+  const int ppc   = ( argc > 2 ) ? atoi( argv[2] ) : 8;
+  const int reps  = ( argc > 3 ) ? atoi( argv[3] ) : 5;
+
+  if( cells < 1 || ppc < 1 || reps < 1 ) {
+    std::cout << "Usage: " << argv[0] << " [cells per side] [particles per cell] [repetitions]\n";
+    return 1;
+  }
+
+  Grid grid;
+  Level* level = grid.addLevel( Point( 0, 0, 0 ), Vector( 1, 1, 1 ) );
+  const Patch* patch = level->addPatch( IntVector( 0, 0, 0 ), IntVector( cells, cells, cells ),
+                                        IntVector( 0, 0, 0 ), IntVector( cells, cells, cells ), &grid );
+  level->finalizeLevel();
+
+  const unsigned int nParticles = cells * cells * cells * ppc;
+
+  // The fragmented variables hold twice as many slots as particles,
+  // the live ones are spread over them in random order.
+  const unsigned int nSlots = 2 * nParticles;
+
+  std::mt19937 gen( 1234 );
+  std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+  std::vector<particleIndex> slots( nSlots );
+  for( unsigned int i = 0; i < nSlots; i++ ) {
+    slots[i] = i;
+  }
+  std::shuffle( slots.begin(), slots.end(), gen );
+  slots.resize( nParticles );
+
+  ParticleSubset* allSlots = new ParticleSubset( nSlots, 0, patch );
+  ParticleSubset* pset     = new ParticleSubset( 0, 0, patch );
+  ParticleSubset* dense    = new ParticleSubset( nParticles, 0, patch );
+  allSlots->addReference();
+  pset->addReference();
+  dense->addReference();
+
+  for( unsigned int i = 0; i < nParticles; i++ ) {
+    pset->addParticle( slots[i] );
+  }
+
+  ParticleVariable<Point>   px( allSlots );
+  ParticleVariable<double>  pmass( allSlots );
+  ParticleVariable<Vector>  pvelocity( allSlots );
+  ParticleVariable<Matrix3> psize( allSlots );
+
+  // Particles are generated cell by cell, i.e. in the order of the
+  // dense storage after a relocation.
+  unsigned int p = 0;
+  for( int i = 0; i < cells; i++ ) {
+    for( int j = 0; j < cells; j++ ) {
+      for( int k = 0; k < cells; k++ ) {
+        for( int n = 0; n < ppc; n++, p++ ) {
+          particleIndex idx = slots[p];
+          px[idx]        = Point( i + unit( gen ), j + unit( gen ), k + unit( gen ) );
+          pmass[idx]     = 1.0 + unit( gen );
+          pvelocity[idx] = Vector( unit( gen ), unit( gen ), unit( gen ) );
+          psize[idx]     = Matrix3( 1, 0, 0, 0, 1, 0, 0, 0, 1 );
+        }
+      }
+    }
+  }
+
+  GridVars gridVars;
+  gridVars.gmass.allocate( patch, IntVector( 1, 1, 1 ) );
+  gridVars.gvelocity.allocate( patch, IntVector( 1, 1, 1 ) );
+
+  std::cout << "particle_bench: " << cells << "^3 cells, " << ppc << " particles per cell, "
+            << nParticles << " particles, " << reps << " repetitions\n";
+
+  //__________________________________
+  // fragmented
+  double fragmented = 0;
+  for( int r = 0; r < reps; r++ ) {
+    Timers::Simple timer;
+    timer.start();
+    interpolateParticlesToGrid( patch, pset, px, pmass, pvelocity, psize, gridVars );
+    timer.stop();
+    fragmented = ( r == 0 ) ? timer().seconds() : std::min( fragmented, timer().seconds() );
+  }
+  const double massFragmented = gridVars.gmass[IntVector( cells / 2, cells / 2, cells / 2 )];
+
+  //__________________________________
+  // compacting gather
+  Timers::Simple compactTimer;
+  compactTimer.start();
+  compact( pset, dense, px );
+  compact( pset, dense, pmass );
+  compact( pset, dense, pvelocity );
+  compact( pset, dense, psize );
+  compactTimer.stop();
+
+  //__________________________________
+  // compacted
+  double compacted = 0;
+  for( int r = 0; r < reps; r++ ) {
+    Timers::Simple timer;
+    timer.start();
+    interpolateParticlesToGrid( patch, dense, px, pmass, pvelocity, psize, gridVars );
+    timer.stop();
+    compacted = ( r == 0 ) ? timer().seconds() : std::min( compacted, timer().seconds() );
+  }
+  const double massCompacted = gridVars.gmass[IntVector( cells / 2, cells / 2, cells / 2 )];
+
+  std::cout << "  fragmented: " << fragmented << " s, " << nParticles / fragmented * 1.e-6 << " Mparticles/s\n"
+            << "  compaction: " << compactTimer().seconds() << " s\n"
+            << "  compacted:  " << compacted << " s, " << nParticles / compacted * 1.e-6 << " Mparticles/s\n"
+            << "  speedup:    " << fragmented / compacted << "\n";
+
+  if( massFragmented != massCompacted ) {
+    std::cout << "  ERROR: grid mass differs (" << massFragmented << " vs " << massCompacted << ")\n";
+    return 1;
+  }
+
+  //__________________________________
+  // shuffled, then sorted along the curves
+  const char* names[] = { "morton", "hilbert" };
+
+  for( int c = 0; c < 2; c++ ) {
+    std::vector<particleIndex> perm( nParticles );
+    for( unsigned int i = 0; i < nParticles; i++ ) {
+      perm[i] = i;
+    }
+    std::shuffle( perm.begin(), perm.end(), gen );
+
+    ParticleSubset* shuffled = new ParticleSubset( 0, 0, patch );
+    shuffled->addReference();
+    for( unsigned int i = 0; i < nParticles; i++ ) {
+      shuffled->addParticle( perm[i] );
+    }
+    compact( shuffled, dense, px );
+    compact( shuffled, dense, pmass );
+    compact( shuffled, dense, pvelocity );
+    compact( shuffled, dense, psize );
+
+    double times[2] = { 0, 0 };
+    double mass[2]  = { 0, 0 };
+    Timers::Simple sortTimer;
+
+    for( int sorted = 0; sorted < 2; sorted++ ) {
+      if( sorted ) {
+        constParticleVariable<Point> cpx;
+        cpx.copyPointer( px );
+        const std::vector<ParticleVariableBase*> vars = { &px, &pmass, &pvelocity, &psize };
+
+        sortTimer.start();
+        ParticleSort::sortParticles( ParticleSort::getCurve( names[c] ), patch, dense, cpx, vars );
+        sortTimer.stop();
+      }
+
+      for( int r = 0; r < reps; r++ ) {
+        Timers::Simple timer;
+        timer.start();
+        interpolateParticlesToGrid( patch, dense, px, pmass, pvelocity, psize, gridVars );
+        timer.stop();
+        times[sorted] = ( r == 0 ) ? timer().seconds() : std::min( times[sorted], timer().seconds() );
+      }
+      mass[sorted] = gridVars.gmass[IntVector( cells / 2, cells / 2, cells / 2 )];
+    }
+
+    std::cout << "  " << names[c] << ":\n"
+              << "    shuffled: " << times[0] << " s, " << nParticles / times[0] * 1.e-6 << " Mparticles/s\n"
+              << "    sort:     " << sortTimer().seconds() << " s\n"
+              << "    sorted:   " << times[1] << " s, " << nParticles / times[1] * 1.e-6 << " Mparticles/s\n"
+              << "    speedup:  " << times[0] / times[1] << "\n";
+
+    // the sums run in a different order
+    if( relativeDifference( mass[0], massCompacted ) > 1.e-12 || relativeDifference( mass[1], massCompacted ) > 1.e-12 ) {
+      std::cout << "  ERROR: grid mass differs (" << mass[0] << ", " << mass[1] << " vs " << massCompacted << ")\n";
+      return 1;
+    }
+
+    if( shuffled->removeReference() ) {
+      delete shuffled;
+    }
+  }
+
+  if( allSlots->removeReference() ) {
+    delete allSlots;
+  }
+  if( pset->removeReference() ) {
+    delete pset;
+  }
+  if( dense->removeReference() ) {
+    delete dense;
+  }
+  return 0;
+}
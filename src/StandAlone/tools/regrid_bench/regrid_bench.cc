@@ -0,0 +1,413 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+//______________________________________________________________________
+//
+// regrid_bench - weak scaling of TiledRegridder::regrid.  The real
+// components (load balancer, scheduler, data warehouse and regridder)
+// are set up from an in-memory input file, as sus does.  Every rank
+// adds a cube of coarse cells to the domain, and the refinement flags
+// are balls centered in each of the cubes, reaching into the
+// neighboring cubes.
+//
+// The first regrid adds a fine level.  The timed regrids then build a
+// third level from the flags on the first two, which is where the
+// tiles are exchanged between the ranks owning neighboring patches
+// before they are coarsened.
+//
+// The new grids are checked: they must be identical on all ranks,
+// every flagged cell must be covered by the next finer level, and
+// every patch of the finest level must be nested in the level below.
+//
+// The times of the regrid phases are printed by the regridder with
+// SCI_DEBUG=RegridTimes:+.
+//
+// Usage: mpirun -np N regrid_bench [coarse cells per rank per side] [repetitions]
+//______________________________________________________________________
+
+#include <CCA/Components/Application/ApplicationCommon.h>
+#include <CCA/Components/DataArchiver/DataArchiver.h>
+#include <CCA/Components/LoadBalancers/LoadBalancerCommon.h>
+#include <CCA/Components/LoadBalancers/LoadBalancerFactory.h>
+#include <CCA/Components/Regridder/RegridderCommon.h>
+#include <CCA/Components/Regridder/RegridderFactory.h>
+#include <CCA/Components/Schedulers/SchedulerCommon.h>
+#include <CCA/Components/Schedulers/SchedulerFactory.h>
+#include <CCA/Ports/DataWarehouse.h>
+#include <Core/Exceptions/Exception.h>
+#include <Core/Grid/Grid.h>
+#include <Core/Grid/Level.h>
+#include <Core/Grid/Patch.h>
+#include <Core/Grid/Variables/CCVariable.h>
+#include <Core/Grid/Variables/CellIterator.h>
+#include <Core/Grid/Variables/VarLabel.h>
+#include <Core/Parallel/Parallel.h>
+#include <Core/Parallel/ProcessorGroup.h>
+#include <Core/Parallel/UintahMPI.h>
+#include <Core/ProblemSpec/ProblemSpec.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace Uintah;
+
+namespace {
+
+  const int    g_refinement_ratio = 2;
+  const int    g_min_patch_size   = 8;
+  const double g_radius[2]        = { 0.45, 0.35 };  // of the flagged balls on levels 0 and 1, in cubes
+
+  IntVector g_rank_dims;
+
+  //______________________________________________________________________
+  // The regridder only needs the application port to be there.
+  class BenchApplication : public ApplicationCommon {
+
+  public:
+
+    BenchApplication( const ProcessorGroup * myworld ) : ApplicationCommon( myworld, nullptr ) {}
+
+    virtual void problemSetup( const ProblemSpecP &, const ProblemSpecP &, GridP & ) {}
+    virtual void scheduleInitialize( const LevelP &, SchedulerP & ) {}
+    virtual void scheduleRestartInitialize( const LevelP &, SchedulerP & ) {}
+    virtual void scheduleComputeStableTimeStep( const LevelP &, SchedulerP & ) {}
+  };
+
+  //______________________________________________________________________
+  // Every rank's cube is a unit cube of the domain.
+  std::string
+  inputFile( int cellsPerRank )
+  {
+    const IntVector patches    = g_rank_dims * 2;
+    const IntVector resolution = g_rank_dims * cellsPerRank;
+
+    std::ostringstream ups;
+    ups << "<Uintah_specification>\n"
+        << "  <Grid doAMR=\"true\">\n"
+        << "    <Level>\n"
+        << "      <Box label=\"bench\">\n"
+        << "        <lower>      [0,0,0] </lower>\n"
+        << "        <upper>      [" << g_rank_dims.x() << "," << g_rank_dims.y() << "," << g_rank_dims.z() << "] </upper>\n"
+        << "        <resolution> [" << resolution.x() << "," << resolution.y() << "," << resolution.z() << "] </resolution>\n"
+        << "        <patches>    [" << patches.x() << "," << patches.y() << "," << patches.z() << "] </patches>\n"
+        << "        <extraCells> [1,1,1] </extraCells>\n"
+        << "      </Box>\n"
+        << "    </Level>\n"
+        << "  </Grid>\n"
+        << "  <AMR>\n"
+        << "    <Regridder type=\"Tiled\">\n"
+        << "      <max_levels>               3 </max_levels>\n"
+        << "      <simple_refinement_ratio>  " << g_refinement_ratio << " </simple_refinement_ratio>\n"
+        << "      <min_patch_size>           [[" << g_min_patch_size << "," << g_min_patch_size << "," << g_min_patch_size << "]] </min_patch_size>\n"
+        << "      <min_boundary_cells>       [1,1,1] </min_boundary_cells>\n"
+        << "    </Regridder>\n"
+        << "  </AMR>\n"
+        << "</Uintah_specification>\n";
+    return ups.str();
+  }
+
+  //______________________________________________________________________
+  // Inside the ball of one of the cubes next to the point.
+  bool
+  flagged( const Point & p, double radius )
+  {
+    for( int k = -1; k <= 1; k++ ) {
+      for( int j = -1; j <= 1; j++ ) {
+        for( int i = -1; i <= 1; i++ ) {
+          const IntVector cube( (int)std::floor( p.x() ) + i, (int)std::floor( p.y() ) + j, (int)std::floor( p.z() ) + k );
+          if( cube.x() < 0 || cube.y() < 0 || cube.z() < 0 || cube.x() >= g_rank_dims.x() || cube.y() >= g_rank_dims.y() || cube.z() >= g_rank_dims.z() ) {
+            continue;
+          }
+          const Vector d = p - ( cube.asVector() + Vector( 0.5, 0.5, 0.5 ) ).asPoint();
+          if( d.length2() <= radius * radius ) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  //______________________________________________________________________
+  // Puts the refinement flags on this rank's patches of the coarser levels.
+  void
+  putFlags( const GridP & grid, LoadBalancer * lb, DataWarehouse * dw, const VarLabel * label, int myRank )
+  {
+    for( int l = 0; l < grid->numLevels(); l++ ) {
+      const LevelP level = grid->getLevel( l );
+      const PatchSubset * patches = lb->getPerProcessorPatchSet( level )->getSubset( myRank );
+
+      for( int p = 0; p < patches->size(); p++ ) {
+        const Patch * patch = patches->get( p );
+        CCVariable<int> flags;
+        dw->allocateAndPut( flags, label, 0, patch );
+        for( CellIterator iter = patch->getExtraCellIterator(); !iter.done(); iter++ ) {
+          flags[*iter] = flagged( level->getCellPosition( *iter ), g_radius[l] );
+        }
+      }
+    }
+  }
+
+  //______________________________________________________________________
+  // The number of cells of [low, high) not covered by the patches of a level.
+  long
+  uncovered( const LevelP & level, const IntVector & low, const IntVector & high )
+  {
+    Level::selectType patches;
+    level->selectPatches( low, high, patches );
+
+    long cells = ( high - low ).x() * (long)( high - low ).y() * ( high - low ).z();
+    for( size_t i = 0; i < patches.size(); i++ ) {
+      const IntVector d = Min( high, patches[i]->getCellHighIndex() ) - Max( low, patches[i]->getCellLowIndex() );
+      if( d.x() > 0 && d.y() > 0 && d.z() > 0 ) {
+        cells -= d.x() * (long)d.y() * d.z();
+      }
+    }
+    return cells;
+  }
+
+  //______________________________________________________________________
+  // Counts the errors of a new grid seen from this rank.
+  int
+  checkGrid( const GridP & oldGrid, const GridP & newGrid, LoadBalancer * lb, DataWarehouse * dw, const VarLabel * label, const ProcessorGroup * world )
+  {
+    int errors = 0;
+    const IntVector ratio( g_refinement_ratio );
+
+    // the same grid on every rank
+    unsigned long checksum = newGrid->numLevels();
+    for( int l = 0; l < newGrid->numLevels(); l++ ) {
+      const LevelP level = newGrid->getLevel( l );
+      for( int p = 0; p < level->numPatches(); p++ ) {
+        const Patch * patch = level->getPatch( p );
+        const IntVector low  = patch->getCellLowIndex();
+        const IntVector high = patch->getCellHighIndex();
+        for( int d = 0; d < 3; d++ ) {
+          checksum = checksum * 1000003 + low[d];
+          checksum = checksum * 1000003 + high[d];
+        }
+      }
+    }
+    unsigned long minmax[2] = { checksum, ~checksum };
+    Uintah::MPI::Allreduce( MPI_IN_PLACE, minmax, 2, MPI_UNSIGNED_LONG, MPI_MIN, world->getComm() );
+    if( minmax[0] != ~minmax[1] ) {
+      errors++;
+    }
+
+    // every flagged cell on this rank is refined
+    for( int l = 0; l < oldGrid->numLevels() && l + 1 < newGrid->numLevels(); l++ ) {
+      const LevelP fineLevel = newGrid->getLevel( l + 1 );
+      const PatchSubset * patches = lb->getPerProcessorPatchSet( oldGrid->getLevel( l ) )->getSubset( world->myRank() );
+
+      for( int p = 0; p < patches->size(); p++ ) {
+        const Patch * patch = patches->get( p );
+        constCCVariable<int> flags;
+        dw->get( flags, label, 0, patch, Ghost::None, 0 );
+        for( CellIterator iter = patch->getCellIterator(); !iter.done(); iter++ ) {
+          if( flags[*iter] && uncovered( fineLevel, *iter * ratio, ( *iter + IntVector( 1, 1, 1 ) ) * ratio ) > 0 ) {
+            errors++;
+          }
+        }
+      }
+    }
+
+    // the finest level is nested, split between the ranks
+    if( newGrid->numLevels() > 2 ) {
+      const LevelP fineLevel = newGrid->getLevel( 2 );
+      const LevelP coarseLevel = newGrid->getLevel( 1 );
+      for( int p = world->myRank(); p < fineLevel->numPatches(); p += world->nRanks() ) {
+        const Patch * patch = fineLevel->getPatch( p );
+        if( uncovered( coarseLevel, patch->getCellLowIndex() / ratio, patch->getCellHighIndex() / ratio ) > 0 ) {
+          errors++;
+        }
+      }
+    }
+    else {
+      errors++;
+    }
+
+    return errors;
+  }
+}
+
+//______________________________________________________________________
+//
+int
+main( int argc, char *argv[] )
+{
+  Uintah::Parallel::initializeManager( argc, argv );
+
+  const ProcessorGroup * world = Uintah::Parallel::getRootProcessorGroup();
+  const int myRank = world->myRank();
+  const int nRanks = world->nRanks();
+
+  const int cellsPerRank = ( argc > 1 ) ? atoi( argv[1] ) : 16;
+  const int reps         = ( argc > 2 ) ? atoi( argv[2] ) : 5;
+
+  int dims[3] = { 0, 0, 0 };
+  Uintah::MPI::Dims_create( nRanks, 3, dims );
+  g_rank_dims = IntVector( dims[0], dims[1], dims[2] );
+
+  // two coarse patches per rank per side, whose fine tiles must be
+  // whole; the tile indices of the finest level must fit in 10 bits
+  const IntVector fineTiles = g_rank_dims * cellsPerRank * g_refinement_ratio * g_refinement_ratio / g_min_patch_size;
+  if( cellsPerRank < g_min_patch_size || cellsPerRank % g_min_patch_size != 0 || reps < 1 ||
+      fineTiles.x() > 1024 || fineTiles.y() > 1024 || fineTiles.z() > 1024 ) {
+    if( myRank == 0 ) {
+      printf( "Usage: mpirun -np N %s [coarse cells per rank per side] [repetitions]\n", argv[0] );
+      printf( "       the cells per rank must be a multiple of %d\n", g_min_patch_size );
+    }
+    Uintah::Parallel::finalizeManager();
+    return 1;
+  }
+
+  int total_errors = 0;
+
+  try {
+    ProblemSpecP ups = scinew ProblemSpec( inputFile( cellsPerRank ) );
+
+    //__________________________________
+    // the components, wired as in sus
+    BenchApplication * application = scinew BenchApplication( world );
+
+    LoadBalancerCommon * loadBalancer = LoadBalancerFactory::create( ups, world );
+    loadBalancer->attachPort( "application", application );
+
+    SchedulerCommon * scheduler = SchedulerFactory::create( ups, world );
+    scheduler->attachPort( "load balancer", loadBalancer );
+    scheduler->attachPort( "application", application );
+    loadBalancer->attachPort( "scheduler", scheduler );
+    scheduler->addReference();
+
+    // never set up, the scheduler only needs the port
+    DataArchiver * dataArchiver = scinew DataArchiver( world );
+    scheduler->attachPort( "output", dataArchiver );
+
+    RegridderCommon * regridder = RegridderFactory::create( ups, world );
+    regridder->attachPort( "scheduler", scheduler );
+    regridder->attachPort( "load balancer", loadBalancer );
+    regridder->attachPort( "application", application );
+
+    regridder->getComponents();
+    scheduler->getComponents();
+    loadBalancer->getComponents();
+
+    //__________________________________
+    // the set up of the simulation controller
+    GridP grid = scinew Grid();
+    grid->problemSetup( ups, world, true );
+
+    regridder->problemSetup( ups, grid, application->getMaterialManagerP() );
+
+    scheduler->problemSetup( ups, application->getMaterialManagerP() );
+    scheduler->setInitTimestep( true );
+    scheduler->initialize( 1, 1 );
+    scheduler->advanceDataWarehouse( grid, true );
+
+    loadBalancer->setDimensionality( true, true, true );
+    loadBalancer->problemSetup( ups, grid, application->getMaterialManagerP() );
+    loadBalancer->possiblyDynamicallyReallocate( grid, LoadBalancer::INIT_LB );
+
+    const VarLabel * flagLabel = VarLabel::find( "DilatedCellsRegrid" );
+
+    //__________________________________
+    // add the first fine level
+    putFlags( grid, loadBalancer, scheduler->getLastDW(), flagLabel, myRank );
+
+    GridP oldGrid = regridder->regrid( grid.get_rep(), 1 );
+    if( oldGrid == grid ) {
+      throw InternalError( "regrid_bench: the first regrid did not add a level", __FILE__, __LINE__ );
+    }
+
+    loadBalancer->possiblyDynamicallyReallocate( oldGrid, LoadBalancer::REGRID_LB );
+    scheduler->advanceDataWarehouse( oldGrid, true );
+    putFlags( oldGrid, loadBalancer, scheduler->getLastDW(), flagLabel, myRank );
+
+    //__________________________________
+    // the timed regrids, which coarsen the flags of the new level
+    double seconds = 0;
+    GridP  newGrid;
+
+    for( int r = 0; r < reps; r++ ) {
+      newGrid = nullptr;
+      Uintah::MPI::Barrier( world->getComm() );
+
+      const double start = Uintah::MPI::Wtime();
+      newGrid = regridder->regrid( oldGrid.get_rep(), r + 2 );
+      seconds += Uintah::MPI::Wtime() - start;
+
+      if( newGrid == oldGrid ) {
+        throw InternalError( "regrid_bench: the timed regrid did not change the grid", __FILE__, __LINE__ );
+      }
+    }
+
+    int errors = checkGrid( oldGrid, newGrid, loadBalancer, scheduler->getLastDW(), flagLabel, world );
+    Uintah::MPI::Allreduce( &errors, &total_errors, 1, MPI_INT, MPI_SUM, world->getComm() );
+
+    double max_seconds;
+    Uintah::MPI::Reduce( &seconds, &max_seconds, 1, MPI_DOUBLE, MPI_MAX, 0, world->getComm() );
+
+    if( myRank == 0 ) {
+      printf( "regrid_bench: %d ranks (%d x %d x %d), %d^3 coarse cells per rank, %d repetitions\n",
+              nRanks, dims[0], dims[1], dims[2], cellsPerRank, reps );
+      for( int l = 0; l < newGrid->numLevels(); l++ ) {
+        printf( "  level %d: %6d patches, %8.1f per rank\n", l, newGrid->getLevel( l )->numPatches(), newGrid->getLevel( l )->numPatches() / (double)nRanks );
+      }
+      printf( "  regrid: %10.3fms\n", max_seconds * 1.e3 / reps );
+      if( total_errors > 0 ) {
+        printf( "ERROR: %d errors in the new grid\n", total_errors );
+      }
+    }
+
+    //__________________________________
+    // clean up
+    newGrid = nullptr;
+    oldGrid = nullptr;
+    grid    = nullptr;
+
+    regridder->releaseComponents();
+    scheduler->releaseComponents();
+    loadBalancer->releaseComponents();
+
+    scheduler->removeReference();
+
+    delete regridder;
+    delete dataArchiver;
+    delete scheduler;
+    delete loadBalancer;
+    delete application;
+  }
+  catch( Exception & e ) {
+    std::cerr << "regrid_bench: rank " << myRank << ": " << e.message() << "\n";
+    Uintah::Parallel::finalizeManager( Uintah::Parallel::Abort );
+    return 1;
+  }
+
+  Uintah::Parallel::finalizeManager();
+  return total_errors > 0 ? 1 : 0;
+}
@@ -67,11 +67,15 @@ include $(SCIRUN_SCRIPTS)/program.mk
 
 SUBDIRS := \
         $(SRCDIR)/compare_mms \
+        $(SRCDIR)/critical_path \
         $(SRCDIR)/dumpfields  \
         $(SRCDIR)/extractors  \
         $(SRCDIR)/fsspeed     \
         $(SRCDIR)/graphview   \
         $(SRCDIR)/mpi_test    \
+        $(SRCDIR)/particle_bench \
+        $(SRCDIR)/regrid_bench \
+        $(SRCDIR)/trace_merge  \
         $(SRCDIR)/pfs         \
         $(SRCDIR)/puda
 
@@ -0,0 +1,112 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 1997-2019 The University of Utah
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+//______________________________________________________________________
+//
+// trace_merge - combines the per rank trace files written by the
+// schedulers (<Scheduler><Trace>) into one Chrome trace event file,
+// which can be loaded in chrome://tracing or ui.perfetto.dev.  The
+// input files may be JSON (.json) or binary (.bin) traces.
+//
+// Usage: trace_merge <output.json> <trace.0.json|bin> [trace.1.json|bin ...]
+//______________________________________________________________________
+
+#include <Core/Util/Tracer.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace Uintah;
+
+namespace {
+
+  const std::string g_json_header = "{\"traceEvents\":[";
+
+  //______________________________________________________________________
+  // The JSON traces have the header and the closing bracket on lines
+  // of their own and one event per line.
+  bool
+  copyJSON( std::istream & in, std::ostream & out, bool & first )
+  {
+    std::string line;
+    if( !std::getline( in, line ) || line != g_json_header ) {
+      return false;
+    }
+
+    while( std::getline( in, line ) ) {
+      if( line.empty() || line[0] == ']' ) {
+        continue;
+      }
+      if( line.back() == ',' ) {
+        line.pop_back();
+      }
+      if( !first ) {
+        out << ",\n";
+      }
+      first = false;
+      out << line;
+    }
+    return true;
+  }
+}
+
+//______________________________________________________________________
+//
+int
+main( int argc, char *argv[] )
+{
+  if( argc < 3 ) {
+    std::cout << "Usage: " << argv[0] << " <output.json> <trace.0.json|bin> [trace.1.json|bin ...]\n";
+    return 1;
+  }
+
+  std::ofstream out( argv[1] );
+  if( !out ) {
+    std::cerr << "ERROR: could not open " << argv[1] << "\n";
+    return 1;
+  }
+
+  out << g_json_header << "\n";
+
+  bool first = true;
+  for( int i = 2; i < argc; i++ ) {
+    std::ifstream in( argv[i], std::ios::binary );
+    if( !in ) {
+      std::cerr << "ERROR: could not open " << argv[i] << "\n";
+      return 1;
+    }
+
+    const bool binary = ( in.peek() != '{' );
+    const bool ok = binary ? Tracer::binaryToJSON( in, out, first ) : copyJSON( in, out, first );
+    if( !ok ) {
+      std::cerr << "ERROR: " << argv[i] << " is not a trace file (or is truncated)\n";
+      return 1;
+    }
+  }
+
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  return 0;
+}